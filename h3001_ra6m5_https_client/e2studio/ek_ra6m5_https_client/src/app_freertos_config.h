@@ -0,0 +1,44 @@
+/***********************************************************************************************************************
+ * File Name    : app_freertos_config.h
+ * Description  : Custom FreeRTOSConfig.h of the FreeRTOS module, included ahead of the generated configuration. Hooks
+ *                the tickless idle sleep into the residency counters of app_power.c, the heap into the accounting
+ *                of heap_trace.c and the run time stats into the cycle counter of sys_stats.c, which also notes when
+ *                the running task was switched in
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef APP_FREERTOS_CONFIG_H_
+#define APP_FREERTOS_CONFIG_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Called by the port with interrupts masked, right before the WFI of a tickless sleep. The idle time is in ticks */
+void app_power_sleep_enter(uint32_t expected_ticks);
+
+/* Called by vTaskStepTick() with the ticks the kernel skipped while asleep */
+void app_power_ticks_stepped(uint32_t ticks);
+
+/* Called by heap_4 with the scheduler suspended, p_block is NULL when an allocation failed */
+void heap_trace_on_malloc(void * p_block, size_t size);
+void heap_trace_on_free(void * p_block, size_t size);
+
+/* Run time stats in core clock cycles, 64 bit so that they do not wrap */
+void sys_stats_run_time_start(void);
+uint64_t sys_stats_run_time(void);
+void sys_stats_task_switched_in(void);
+
+#define configPRE_SLEEP_PROCESSING(x)               app_power_sleep_enter((uint32_t) (x))
+#define traceINCREASE_TICK_COUNT(x)                 app_power_ticks_stepped((uint32_t) (x))
+#define traceMALLOC(p, size)                        heap_trace_on_malloc((p), (size_t) (size))
+#define traceFREE(p, size)                          heap_trace_on_free((p), (size_t) (size))
+#define configRUN_TIME_COUNTER_TYPE                 uint64_t
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    sys_stats_run_time_start()
+#define portGET_RUN_TIME_COUNTER_VALUE()            sys_stats_run_time()
+#define traceTASK_SWITCHED_IN()                     sys_stats_task_switched_in()
+
+#endif /* APP_FREERTOS_CONFIG_H_ */
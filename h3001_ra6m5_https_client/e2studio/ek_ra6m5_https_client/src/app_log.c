@@ -0,0 +1,131 @@
+/***********************************************************************************************************************
+ * File Name    : app_log.c
+ * Description  : This file keeps the runtime log level of every module, sets it from the console and measures the
+ *                cost of a filtered log call.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_SYS)
+
+#include "common_utils.h"
+#include "app_timing.h"
+#include "app_log.h"
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/* Runtime threshold of every module, read by every leveled call */
+uint8_t g_app_log_level[APP_LOG_MOD_COUNT] =
+{
+    APP_LOG_LEVEL_DEFAULT, APP_LOG_LEVEL_DEFAULT, APP_LOG_LEVEL_DEFAULT, APP_LOG_LEVEL_DEFAULT, APP_LOG_LEVEL_DEFAULT
+};
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+#define APP_LOG_BENCH_TAG               "#LOGLEVEL"
+#define APP_LOG_BENCH_ITERATIONS        (100U)
+
+static const char * const g_module_names[APP_LOG_MOD_COUNT] = {"app", "net", "tls", "fs", "sys"};
+static const char * const g_level_names[APP_LOG_LEVEL_DEBUG + 1U] = {"off", "err", "warn", "info", "debug"};
+static const uint8_t g_module_floors[APP_LOG_MOD_COUNT] =
+{
+    APP_LOG_FLOOR_APP, APP_LOG_FLOOR_NET, APP_LOG_FLOOR_TLS, APP_LOG_FLOOR_FS, APP_LOG_FLOOR_SYS
+};
+
+/*******************************************************************************************************************//**
+ * @brief      Sets the runtime level of a module or of all of them. A level above the module's compile time floor is
+ *             accepted, the calls above the floor stay compiled out.
+ * @param[in]  p_module                     Module name or "all".
+ * @param[in]  p_level                      Level name: off, err, warn, info or debug.
+ * @retval     FSP_SUCCESS                  Level set.
+ * @retval     FSP_ERR_INVALID_ARGUMENT     Unknown module or level.
+ **********************************************************************************************************************/
+fsp_err_t app_log_set_level(const char * p_module, const char * p_level)
+{
+    uint32_t level = RESET_VALUE;
+    bool all = (0 == strcmp (p_module, "all"));
+    bool found = false;
+
+    while ((level <= APP_LOG_LEVEL_DEBUG) && (0 != strcmp (p_level, g_level_names[level])))
+    {
+        level++;
+    }
+    if (level > APP_LOG_LEVEL_DEBUG)
+    {
+        return FSP_ERR_INVALID_ARGUMENT;
+    }
+
+    for (uint32_t i = 0; i < APP_LOG_MOD_COUNT; i++)
+    {
+        if (all || (0 == strcmp (p_module, g_module_names[i])))
+        {
+            g_app_log_level[i] = (uint8_t) level;
+            found              = true;
+        }
+    }
+    return found ? FSP_SUCCESS : FSP_ERR_INVALID_ARGUMENT;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints the runtime level and the compile time floor of every module.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void app_log_print_levels(void)
+{
+    APP_PRINT("\r\nLog levels (runtime / compiled in):\r\n");
+    for (uint32_t i = 0; i < APP_LOG_MOD_COUNT; i++)
+    {
+        APP_PRINT("\t%s\t%s / %s\r\n", g_module_names[i], g_level_names[g_app_log_level[i]],
+                  g_level_names[g_module_floors[i]]);
+    }
+    APP_PRINT("Set with \"log <module>|all off|err|warn|info|debug\"\r\n");
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Times a debug call of this module filtered out at runtime against no call at all, and prints the cycles
+ *             of each:
+ *               #LOGLEVEL,call,cycles
+ *             A call above the compile time floor costs what no call costs.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void app_log_bench(void)
+{
+    uint8_t level = g_app_log_level[APP_LOG_MOD_SYS];
+    uint32_t none_cycles = RESET_VALUE;
+    uint32_t filtered_cycles = RESET_VALUE;
+    uint32_t start = RESET_VALUE;
+
+    app_timing_init ();
+    g_app_log_level[APP_LOG_MOD_SYS] = APP_LOG_LEVEL_ERR;
+    for (uint32_t i = 0; i < APP_LOG_BENCH_ITERATIONS; i++)
+    {
+        start        = app_timing_cycles ();
+        __DSB ();
+        none_cycles += app_timing_cycles () - start;
+
+        start = app_timing_cycles ();
+        APP_DBG_PRINT("\r\nSample %d journaled, %d pending\r\n", i + 1000U, i);
+        __DSB ();
+        filtered_cycles += app_timing_cycles () - start;
+    }
+    g_app_log_level[APP_LOG_MOD_SYS] = level;
+
+    APP_PRINT("\r\n%s,call,cycles\r\n", APP_LOG_BENCH_TAG);
+    APP_PRINT("%s,none,%d\r\n", APP_LOG_BENCH_TAG, none_cycles / APP_LOG_BENCH_ITERATIONS);
+    APP_PRINT("%s,%s,%d\r\n", APP_LOG_BENCH_TAG,
+              (APP_LOG_FLOOR_SYS >= APP_LOG_LEVEL_DEBUG) ? "filtered at runtime" : "compiled out",
+              filtered_cycles / APP_LOG_BENCH_ITERATIONS);
+    APP_PRINT("%s,end\r\n", APP_LOG_BENCH_TAG);
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
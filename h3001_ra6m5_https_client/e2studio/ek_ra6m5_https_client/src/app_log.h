@@ -0,0 +1,82 @@
+/***********************************************************************************************************************
+ * File Name    : app_log.h
+ * Description  : Contains macros, data structures and functions used by the log levels of the modules
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef APP_LOG_H_
+#define APP_LOG_H_
+
+#include "hal_data.h"
+
+#define APP_LOG_LEVEL_OFF               (0U)
+#define APP_LOG_LEVEL_ERR               (1U)
+#define APP_LOG_LEVEL_WARN              (2U)
+#define APP_LOG_LEVEL_INFO              (3U)
+#define APP_LOG_LEVEL_DEBUG             (4U)
+
+/*
+ * Compile time floor: calls of a module above its floor compile to nothing, format string included. Set
+ * APP_LOG_BUILD_LEVEL, or the floor of a single module, in the build configuration, e.g. -DAPP_LOG_BUILD_LEVEL=1 for a
+ * production build that keeps the errors only. tools/log_size.py measures what that saves.
+ */
+#ifndef APP_LOG_BUILD_LEVEL
+#define APP_LOG_BUILD_LEVEL             (APP_LOG_LEVEL_DEBUG)
+#endif
+#ifndef APP_LOG_FLOOR_APP
+#define APP_LOG_FLOOR_APP               (APP_LOG_BUILD_LEVEL)
+#endif
+#ifndef APP_LOG_FLOOR_NET
+#define APP_LOG_FLOOR_NET               (APP_LOG_BUILD_LEVEL)
+#endif
+#ifndef APP_LOG_FLOOR_TLS
+#define APP_LOG_FLOOR_TLS               (APP_LOG_BUILD_LEVEL)
+#endif
+#ifndef APP_LOG_FLOOR_FS
+#define APP_LOG_FLOOR_FS                (APP_LOG_BUILD_LEVEL)
+#endif
+#ifndef APP_LOG_FLOOR_SYS
+#define APP_LOG_FLOOR_SYS               (APP_LOG_BUILD_LEVEL)
+#endif
+
+/* Runtime threshold of every module at boot, changed with the "log" command */
+#define APP_LOG_LEVEL_DEFAULT           (APP_LOG_LEVEL_INFO)
+
+typedef enum e_app_log_module
+{
+    APP_LOG_MOD_APP = 0,                /* User thread: uplink, HTTP requests and provisioning */
+    APP_LOG_MOD_NET,                    /* Network cache and diagnostics */
+    APP_LOG_MOD_TLS,                    /* TLS session, credentials and certificate pinning */
+    APP_LOG_MOD_FS,                     /* LittleFS and the sample journal */
+    APP_LOG_MOD_SYS,                    /* Startup, power, memory and console */
+    APP_LOG_MOD_COUNT
+} app_log_module_t;
+
+/* Module of the log calls of a file: define APP_LOG_MODULE before the first #include of the file, APP otherwise */
+#ifndef APP_LOG_MODULE
+#define APP_LOG_MODULE                  (APP_LOG_MOD_APP)
+#endif
+
+#define APP_LOG_FLOOR(mod_)             ((APP_LOG_MOD_NET == (mod_)) ? APP_LOG_FLOOR_NET :                            \
+                                         (APP_LOG_MOD_TLS == (mod_)) ? APP_LOG_FLOOR_TLS :                            \
+                                         (APP_LOG_MOD_FS == (mod_)) ? APP_LOG_FLOOR_FS :                              \
+                                         (APP_LOG_MOD_SYS == (mod_)) ? APP_LOG_FLOOR_SYS : APP_LOG_FLOOR_APP)
+
+/*
+ * True when a call of the file at the level passes both filters. The floor is a constant, so a call above it is dead
+ * code; the threshold costs a byte load and a compare.
+ */
+#define APP_LOG_ENABLED(lvl_)           (((lvl_) <= APP_LOG_FLOOR(APP_LOG_MODULE)) &&                                 \
+                                         ((lvl_) <= g_app_log_level[APP_LOG_MODULE]))
+
+extern uint8_t g_app_log_level[APP_LOG_MOD_COUNT];
+
+fsp_err_t app_log_set_level(const char * p_module, const char * p_level);
+void app_log_print_levels(void);
+void app_log_bench(void);
+
+#endif /* APP_LOG_H_ */
@@ -0,0 +1,51 @@
+/***********************************************************************************************************************
+ * File Name    : app_mbedtls_config.h
+ * Description  : User configuration of the mbedTLS module, included by mbedtls/build_info.h after the generated
+ *                configuration through MBEDTLS_USER_CONFIG_FILE in the compiler defines. Selects the TLS record buffer
+ *                profile, so the library, tls_session.c and the TLS pool of mem_pool.h size the records alike
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef APP_MBEDTLS_CONFIG_H_
+#define APP_MBEDTLS_CONFIG_H_
+
+/*
+ * Record buffer profile, 1 for the small profile: IN 4096 / OUT 2048 bytes instead of 16384 / 16384, about 26 KB less
+ * per session in the TLS pool. The server is asked for 4096 byte records with max_fragment_length and the session is
+ * capped to TLS 1.2. This switch lives here and not in user_app.h because the mbedTLS sources read it too.
+ */
+#define TLS_SMALL_RECORDS               (0)
+
+/*
+ * Certificate handshake message of HTTPS_HOST_ADDRESS in bytes, header included, as tools/tls_chain_size.py measures
+ * it; 0 = not measured. mbedTLS does not reassemble a handshake message spread over several records, so the small
+ * profile is only used when the whole message fits one record. Otherwise the build falls back to the full profile.
+ */
+#define TLS_SERVER_CERT_MSG_LEN         (0)
+
+#define TLS_SMALL_IN_CONTENT_LEN        (4096)
+#define TLS_SMALL_OUT_CONTENT_LEN       (2048)
+#define TLS_FULL_CONTENT_LEN            (16384)
+
+#if TLS_SMALL_RECORDS && (TLS_SERVER_CERT_MSG_LEN > 0) && (TLS_SERVER_CERT_MSG_LEN <= TLS_SMALL_IN_CONTENT_LEN)
+#define TLS_RECORD_PROFILE_SMALL        (1)
+#else
+#define TLS_RECORD_PROFILE_SMALL        (0)
+#endif
+
+/* Overrides the SSL Options of the FSP configurator, this profile is the only place the lengths are set */
+#undef MBEDTLS_SSL_IN_CONTENT_LEN
+#undef MBEDTLS_SSL_OUT_CONTENT_LEN
+#if TLS_RECORD_PROFILE_SMALL
+#define MBEDTLS_SSL_IN_CONTENT_LEN      (TLS_SMALL_IN_CONTENT_LEN)
+#define MBEDTLS_SSL_OUT_CONTENT_LEN     (TLS_SMALL_OUT_CONTENT_LEN)
+#else
+#define MBEDTLS_SSL_IN_CONTENT_LEN      (TLS_FULL_CONTENT_LEN)
+#define MBEDTLS_SSL_OUT_CONTENT_LEN     (TLS_FULL_CONTENT_LEN)
+#endif
+
+#endif /* APP_MBEDTLS_CONFIG_H_ */
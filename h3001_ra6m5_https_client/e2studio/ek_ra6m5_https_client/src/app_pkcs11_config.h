@@ -0,0 +1,21 @@
+/***********************************************************************************************************************
+ * File Name    : app_pkcs11_config.h
+ * Description  : Custom iot_pkcs11_config.h of the PKCS#11 module. Declares the allocator set as PKCS11 Malloc and
+ *                PKCS11 Free in the module configuration
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef APP_PKCS11_CONFIG_H_
+#define APP_PKCS11_CONFIG_H_
+
+#include <stddef.h>
+
+/* Fixed block pool of mem_pool.c, falls back to the FreeRTOS heap */
+void * mem_pool_pkcs11_malloc(size_t size);
+void mem_pool_pkcs11_free(void * p_block);
+
+#endif /* APP_PKCS11_CONFIG_H_ */
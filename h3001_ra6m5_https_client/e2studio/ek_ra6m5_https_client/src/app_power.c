@@ -0,0 +1,129 @@
+/***********************************************************************************************************************
+ * File Name    : app_power.c
+ * Description  : This file counts the tickless idle sleeps of FreeRTOS. The kernel suppresses the tick while every task
+ *                is blocked and the port sleeps in WFI until the next task timeout or an interrupt. The hooks of
+ *                app_freertos_config.h count the sleeps and the ticks slept, the user thread reports the idle residency
+ *                and the wakeups per hour.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_SYS)
+
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "app_power.h"
+
+#if (configUSE_TICKLESS_IDLE == 0)
+ #warning "Tickless idle is disabled in the FreeRTOS module, the sleep counters stay at zero"
+#endif
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+static app_power_stats_t g_power_stats;             /* Written by the idle task with interrupts masked */
+static uint32_t g_expected_ticks = RESET_VALUE;     /* Idle time of the sleep in progress */
+
+/* Start of the window reported by the next app_power_print_stats() */
+static TickType_t g_window_tick = RESET_VALUE;
+static app_power_stats_t g_window_stats;
+
+/*******************************************************************************************************************//**
+ * @brief      Selects Sleep mode as the low power mode entered by WFI. Sleep mode stops the CPU only: SysTick keeps
+ *             the time across a tickless sleep and the Ethernet controller keeps receiving into its descriptors.
+ *             Software Standby would stop both, neither can wake the MCU from there, so Sleep is the deepest mode the
+ *             application can use while it keeps its HTTPS session.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void app_power_init(void)
+{
+    R_BSP_RegisterProtectDisable (BSP_REG_PROTECT_OM_LPC_BATT);
+    R_SYSTEM->SBYCR_b.SSBY = 0U;
+    R_BSP_RegisterProtectEnable (BSP_REG_PROTECT_OM_LPC_BATT);
+
+    g_window_tick = xTaskGetTickCount ();
+}
+
+/*******************************************************************************************************************//**
+ * @brief      configPRE_SLEEP_PROCESSING(), the port executes WFI on return.
+ * @param[in]  expected_ticks               Ticks until the next task timeout.
+ * @retval     None
+ **********************************************************************************************************************/
+void app_power_sleep_enter(uint32_t expected_ticks)
+{
+    g_expected_ticks = expected_ticks;
+    g_power_stats.sleeps++;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      traceINCREASE_TICK_COUNT(), the ticks the kernel skipped after a sleep. Called by the port with
+ *             interrupts still masked. The last tick of a sleep that ran to its timeout comes from SysTick.
+ * @param[in]  ticks                        Ticks slept.
+ * @retval     None
+ **********************************************************************************************************************/
+void app_power_ticks_stepped(uint32_t ticks)
+{
+    g_power_stats.ticks_slept += ticks;
+    g_power_stats.ticks_max    = (ticks > g_power_stats.ticks_max) ? ticks : g_power_stats.ticks_max;
+    g_power_stats.early       += ((ticks + 1U) < g_expected_ticks) ? 1U : 0U;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns the counters since boot.
+ * @param[out] p_stats                      Receives the counters.
+ * @retval     None
+ **********************************************************************************************************************/
+void app_power_get_stats(app_power_stats_t * p_stats)
+{
+    taskENTER_CRITICAL();
+    *p_stats = g_power_stats;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints the idle residency and the wakeups per hour since boot and since the previous call.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void app_power_print_stats(void)
+{
+    app_power_stats_t stats;
+    TickType_t now = xTaskGetTickCount ();
+    uint64_t uptime_ms = (uint64_t) now * portTICK_PERIOD_MS;
+    uint64_t window_ms = (uint64_t) (now - g_window_tick) * portTICK_PERIOD_MS;
+    uint32_t sleeps = RESET_VALUE;
+    uint64_t slept_ms = RESET_VALUE;
+
+    app_power_get_stats (&stats);
+    if ((0U == uptime_ms) || (0U == window_ms))
+    {
+        return;
+    }
+
+    APP_PRINT("\r\nIdle: %d%% of %d s in tickless sleep, %d wakeups (%d per hour), %d early, longest sleep %d ms\r\n",
+              (uint32_t) ((stats.ticks_slept * portTICK_PERIOD_MS * 100U) / uptime_ms), (uint32_t) (uptime_ms / 1000U),
+              stats.sleeps, (uint32_t) (((uint64_t) stats.sleeps * 3600000U) / uptime_ms), stats.early,
+              stats.ticks_max * portTICK_PERIOD_MS);
+
+    sleeps   = stats.sleeps - g_window_stats.sleeps;
+    slept_ms = (stats.ticks_slept - g_window_stats.ticks_slept) * portTICK_PERIOD_MS;
+    APP_PRINT("\tlast %d s: %d%% asleep, %d wakeups (%d per hour), %d early\r\n", (uint32_t) (window_ms / 1000U),
+              (uint32_t) ((slept_ms * 100U) / window_ms), sleeps,
+              (uint32_t) (((uint64_t) sleeps * 3600000U) / window_ms), stats.early - g_window_stats.early);
+
+    g_window_tick  = now;
+    g_window_stats = stats;
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
@@ -0,0 +1,29 @@
+/***********************************************************************************************************************
+ * File Name    : app_power.h
+ * Description  : Contains macros, data structures and functions used to count the tickless idle sleeps
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef APP_POWER_H_
+#define APP_POWER_H_
+
+#include "hal_data.h"
+#include "app_freertos_config.h"
+
+typedef struct st_app_power_stats
+{
+    uint32_t sleeps;                    /* Tickless sleeps, every one ends in a wakeup */
+    uint32_t early;                     /* Sleeps ended by an interrupt before the next task timeout */
+    uint64_t ticks_slept;               /* Ticks stepped over by the kernel after the sleeps */
+    uint32_t ticks_max;                 /* Longest single sleep */
+} app_power_stats_t;
+
+void app_power_init(void);
+void app_power_get_stats(app_power_stats_t * p_stats);
+void app_power_print_stats(void);
+
+#endif /* APP_POWER_H_ */
@@ -0,0 +1,233 @@
+/***********************************************************************************************************************
+ * File Name    : app_startup.c
+ * Description  : This file tracks the startup stages of the application in an event group so that independent steps
+ *                can run side by side, and prints the time at which each stage completed.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_SYS)
+
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "littlefs_app.h"
+#include "core_http_client.h"
+#include "transport_mbedtls_pkcs11.h"
+#include "user_app.h"
+#include "credential_cache.h"
+#include "boot_profile.h"
+#include "net_cache.h"
+#include "wall_clock.h"
+#include "sample_journal.h"
+#include "app_startup.h"
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+static EventGroupHandle_t g_startup_events = NULL;
+static StaticEventGroup_t g_startup_events_mem;
+
+/* Tick count at which each stage completed, index is the bit position */
+static TickType_t g_stage_done_tick[STARTUP_STAGE_COUNT];
+
+static const char * const g_stage_name[STARTUP_STAGE_COUNT] =
+{
+    "Crypto engine",
+    "LittleFS",
+    "Provisioning",
+    "Credential cache",
+    "Sensor + first sample",
+    "Network up",
+    "TLS connected",
+    "First POST",
+};
+
+static void startup_storage_task(void * pvParameters);
+
+/*******************************************************************************************************************//**
+ * @brief      Creates the startup event group. Must be called before any other app_startup function.
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  Event group ready.
+ * @retval     FSP_ERR_OUT_OF_MEMORY        Event group could not be created.
+ **********************************************************************************************************************/
+fsp_err_t app_startup_init(void)
+{
+    g_startup_events = xEventGroupCreateStatic (&g_startup_events_mem);
+    return (NULL == g_startup_events) ? FSP_ERR_OUT_OF_MEMORY : FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Initializes the LittleFS port and reads the network cache and the wall clock references. Marks
+ *             STARTUP_EVT_STORAGE_READY on success.
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  Upon successful mount.
+ * @retval     Any other Error Code         Upon unsuccessful mount.
+ **********************************************************************************************************************/
+fsp_err_t app_startup_storage_mount(void)
+{
+    fsp_err_t err = hal_littlefs_init ();
+
+    if (FSP_SUCCESS != err)
+    {
+        APP_PRINT("** Failed in hal_littlefs_init () function ** \r\n");
+        return err;
+    }
+
+    /* Read before the link comes up so that the DHCP hook can use the stored lease */
+    if (FSP_SUCCESS == net_cache_load ())
+    {
+        APP_INFO_PRINT("\r\nNetwork cache loaded\r\n");
+    }
+
+    /* References of earlier boots, to date their journaled samples */
+    (void) wall_clock_load ();
+
+    /* Without a journal samples are only lost while the uplink is down */
+    if (FSP_SUCCESS != sample_journal_init ())
+    {
+        APP_ERR_PRINT("** Sample journal not available ** \r\n");
+    }
+    app_startup_done (STARTUP_EVT_STORAGE_READY);
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Provisions the client credentials and builds the credential cache. Needs the crypto engine and LittleFS,
+ *             but no network. Marks STARTUP_EVT_PROVISIONED and STARTUP_EVT_CREDENTIALS_READY on success.
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  Upon successful provisioning and cache initialization.
+ * @retval     Any other Error Code         Upon failure.
+ **********************************************************************************************************************/
+fsp_err_t app_startup_credentials_load(void)
+{
+    fsp_err_t err = FSP_SUCCESS;
+
+    /*Perform device provisioning using specified TLS client credentials*/
+    if (pdPASS != provision_alt_key ())
+    {
+        APP_PRINT("\r\nFailed in network_init() function\r\n");
+        return FSP_ERR_ASSERTION;
+    }
+    app_startup_done (STARTUP_EVT_PROVISIONED);
+
+    /*Parse the root CA and open the client credentials once for every later connect*/
+    err = credential_cache_init ();
+    if (FSP_SUCCESS != err)
+    {
+        APP_PRINT("\r\nFailed in credential_cache_init() function\r\n");
+        return err;
+    }
+    app_startup_done (STARTUP_EVT_CREDENTIALS_READY);
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Starts the storage and credential stages in their own task. The caller continues with the sensor and
+ *             network bring-up and later waits for STARTUP_EVT_CREDENTIALS_READY.
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  Task created.
+ * @retval     FSP_ERR_OUT_OF_MEMORY        Task could not be created.
+ **********************************************************************************************************************/
+fsp_err_t app_startup_storage_start(void)
+{
+    BaseType_t status = xTaskCreate (startup_storage_task, STARTUP_STORAGE_TASK_NAME, STARTUP_STORAGE_TASK_STACK, NULL,
+                                     STARTUP_STORAGE_TASK_PRIORITY, NULL);
+
+    return (pdPASS == status) ? FSP_SUCCESS : FSP_ERR_OUT_OF_MEMORY;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Marks a stage as complete and records the time of its first completion.
+ * @param[in]  stage                        One STARTUP_EVT_ bit.
+ * @retval     None
+ **********************************************************************************************************************/
+void app_startup_done(EventBits_t stage)
+{
+    EventBits_t bits = xEventGroupGetBits (g_startup_events);
+
+    for (uint32_t i = 0; i < STARTUP_STAGE_COUNT; i++)
+    {
+        /* Only the first completion counts */
+        if ((((EventBits_t) 1U << i) == stage) && (0U == (bits & stage)))
+        {
+            g_stage_done_tick[i] = xTaskGetTickCount ();
+            boot_profile_mark (g_stage_name[i]);
+        }
+    }
+    (void) xEventGroupSetBits (g_startup_events, stage);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Reports a failed stage to every waiter.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void app_startup_fail(void)
+{
+    (void) xEventGroupSetBits (g_startup_events, STARTUP_EVT_FAILED);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Blocks until all requested stages are complete or any stage failed.
+ * @param[in]  stages                       STARTUP_EVT_ bits to wait for.
+ * @retval     Event bits at return, STARTUP_EVT_FAILED is set on failure.
+ **********************************************************************************************************************/
+EventBits_t app_startup_wait(EventBits_t stages)
+{
+    EventBits_t bits = RESET_VALUE;
+
+    do
+    {
+        bits = xEventGroupWaitBits (g_startup_events, stages | STARTUP_EVT_FAILED, pdFALSE, pdFALSE, portMAX_DELAY);
+    } while (((bits & stages) != stages) && (0U == (bits & STARTUP_EVT_FAILED)));
+
+    return bits;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints the completion time of every stage since the scheduler started. tools/startup_sim.py plays the
+ *             same stages on the host, staged and sequential, from the durations read here.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void app_startup_report(void)
+{
+    EventBits_t bits = xEventGroupGetBits (g_startup_events);
+
+    APP_PRINT("\r\nStartup timeline (%s, ms since scheduler start):\r\n",
+              (APP_STARTUP_PARALLEL == ENABLE) ? "staged" : "sequential");
+    for (uint32_t i = 0; i < STARTUP_STAGE_COUNT; i++)
+    {
+        if (0U != (bits & ((EventBits_t) 1U << i)))
+        {
+            APP_PRINT("\t%s : %d\r\n", g_stage_name[i], g_stage_done_tick[i] * portTICK_PERIOD_MS);
+        }
+    }
+    boot_profile_print (false);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      LittleFS mount, provisioning and credential cache, run while DHCP and the sensor bring-up proceed.
+ **********************************************************************************************************************/
+static void startup_storage_task(void * pvParameters)
+{
+    FSP_PARAMETER_NOT_USED(pvParameters);
+
+    if ((FSP_SUCCESS != app_startup_storage_mount ()) || (FSP_SUCCESS != app_startup_credentials_load ()))
+    {
+        app_startup_fail ();
+    }
+    vTaskDelete (NULL);
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
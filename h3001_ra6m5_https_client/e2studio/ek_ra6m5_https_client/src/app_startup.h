@@ -0,0 +1,44 @@
+/***********************************************************************************************************************
+ * File Name    : app_startup.h
+ * Description  : Contains macros, data structures and functions used to stage the application startup
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef APP_STARTUP_H_
+#define APP_STARTUP_H_
+
+#include "hal_data.h"
+#include "FreeRTOS.h"
+#include "event_groups.h"
+
+/* Startup stages, one event bit each. A stage only waits for the bits it depends on */
+#define STARTUP_EVT_CRYPTO_READY        (1UL << 0)  /* mbedtls_platform_setup() done */
+#define STARTUP_EVT_STORAGE_READY       (1UL << 1)  /* LittleFS mounted */
+#define STARTUP_EVT_PROVISIONED         (1UL << 2)  /* Client credentials in the PKCS#11 store */
+#define STARTUP_EVT_CREDENTIALS_READY   (1UL << 3)  /* Credential cache built */
+#define STARTUP_EVT_SENSOR_READY        (1UL << 4)  /* HS3001 initialized, first sample queued */
+#define STARTUP_EVT_NETWORK_UP          (1UL << 5)  /* DHCP lease obtained */
+#define STARTUP_EVT_CONNECTED           (1UL << 6)  /* TLS session to HTTPS_HOST_ADDRESS open */
+#define STARTUP_EVT_FIRST_POST          (1UL << 7)  /* First sample accepted by the server */
+#define STARTUP_EVT_FAILED              (1UL << 23) /* A stage failed, its error is printed */
+#define STARTUP_STAGE_COUNT             (8U)
+
+/* Task running LittleFS mount, provisioning and the credential cache while DHCP is in progress */
+#define STARTUP_STORAGE_TASK_NAME       "Startup"
+#define STARTUP_STORAGE_TASK_STACK      (2048U)     /* Words */
+#define STARTUP_STORAGE_TASK_PRIORITY   (2U)
+
+fsp_err_t app_startup_init(void);
+fsp_err_t app_startup_storage_mount(void);
+fsp_err_t app_startup_credentials_load(void);
+fsp_err_t app_startup_storage_start(void);
+void app_startup_done(EventBits_t stage);
+void app_startup_fail(void);
+EventBits_t app_startup_wait(EventBits_t stages);
+void app_startup_report(void);
+
+#endif /* APP_STARTUP_H_ */
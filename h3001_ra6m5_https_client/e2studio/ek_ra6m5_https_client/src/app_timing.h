@@ -0,0 +1,40 @@
+/***********************************************************************************************************************
+ * File Name    : app_timing.h
+ * Description  : Contains the DWT cycle counter helpers used to time the Application
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef APP_TIMING_H_
+#define APP_TIMING_H_
+
+#include "hal_data.h"
+
+/* Convert a DWT cycle count into micro seconds at the current core clock */
+#define APP_TIMING_CYCLES_TO_US(cycles)     ((uint32_t) (((uint64_t) (cycles) * 1000000ULL) / SystemCoreClock))
+
+/*******************************************************************************************************************//**
+ * @brief      Enables the DWT cycle counter. Safe to call more than once.
+ **********************************************************************************************************************/
+static inline void app_timing_init(void)
+{
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    if (0U == (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        DWT->CYCCNT = 0U;
+        DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns the free running DWT cycle count. Differences are wrap safe for intervals below 2^32 cycles.
+ **********************************************************************************************************************/
+static inline uint32_t app_timing_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+#endif /* APP_TIMING_H_ */
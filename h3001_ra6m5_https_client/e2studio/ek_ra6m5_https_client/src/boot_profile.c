@@ -0,0 +1,168 @@
+/***********************************************************************************************************************
+ * File Name    : boot_profile.c
+ * Description  : This file records a timestamp for each boot step, from R_BSP_WarmStart() to the HTTPS connection,
+ *                and prints them as a timeline. The timelines of this and the previous boot live in no-init RAM so
+ *                that the last boot can be inspected after a reset or from a debugger.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_SYS)
+
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "app_timing.h"
+#include "boot_profile.h"
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/* Intervals shorter than this are taken from the cycle counter, longer ones from the tick count (CYCCNT wraps) */
+#define BOOT_PROFILE_CYCLES_MAX_MS      (10000U)
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+/* Neither is touched by the C runtime start-up, both keep their content across a reset */
+static boot_profile_t g_boot_profile BSP_PLACE_IN_SECTION(".noinit");
+static boot_profile_t g_boot_profile_last BSP_PLACE_IN_SECTION(".noinit");
+
+static void boot_profile_record(const char * p_name, uint32_t tick);
+
+/*******************************************************************************************************************//**
+ * @brief      Starts a new timeline. Called from R_BSP_WarmStart(BSP_WARM_START_RESET), before clock setup and before
+ *             .data/.bss are initialized, so it only touches no-init RAM and the DWT. The timeline of the previous
+ *             boot is kept in g_boot_profile_last.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void boot_profile_reset(void)
+{
+    app_timing_init ();
+    DWT->CYCCNT = 0U;
+
+    if ((BOOT_PROFILE_MAGIC == g_boot_profile.magic) && (g_boot_profile.count <= BOOT_PROFILE_MAX_EVENTS))
+    {
+        g_boot_profile_last = g_boot_profile;
+    }
+    g_boot_profile.magic         = BOOT_PROFILE_MAGIC;
+    g_boot_profile.count         = 0U;
+    g_boot_profile.core_clock_hz = 0U;
+    boot_profile_record ("Reset", BOOT_PROFILE_NO_TICK);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Records an event before the scheduler runs (cycle count only).
+ * @param[in]  p_name                       Event name, truncated to BOOT_PROFILE_NAME_LEN - 1 characters.
+ * @retval     None
+ **********************************************************************************************************************/
+void boot_profile_mark_early(const char * p_name)
+{
+    boot_profile_record (p_name, BOOT_PROFILE_NO_TICK);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Records an event from task context. Safe to call from several tasks.
+ * @param[in]  p_name                       Event name, truncated to BOOT_PROFILE_NAME_LEN - 1 characters.
+ * @retval     None
+ **********************************************************************************************************************/
+void boot_profile_mark(const char * p_name)
+{
+    boot_profile_record (p_name, (uint32_t) xTaskGetTickCount ());
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints a timeline as a table: time since reset and time since the previous event, in micro seconds.
+ *             Events before the clock setup ran on the reset clock and are scaled with the final clock.
+ * @param[in]  last_boot                    true prints the previous boot, false the current one.
+ * @retval     None
+ **********************************************************************************************************************/
+void boot_profile_print(bool last_boot)
+{
+    const boot_profile_t * p_profile = last_boot ? &g_boot_profile_last : &g_boot_profile;
+    uint32_t clock_hz = RESET_VALUE;
+    uint64_t total_us = RESET_VALUE;
+    uint64_t delta_us = RESET_VALUE;
+
+    if ((BOOT_PROFILE_MAGIC != p_profile->magic) || (p_profile->count > BOOT_PROFILE_MAX_EVENTS))
+    {
+        APP_PRINT("\r\nNo %s boot timeline recorded\r\n", last_boot ? "previous" : "current");
+        return;
+    }
+    clock_hz = (0U != p_profile->core_clock_hz) ? p_profile->core_clock_hz : SystemCoreClock;
+
+    APP_PRINT("\r\nBoot timeline (%s boot, %d events, %d Hz)\r\n", last_boot ? "previous" : "current",
+              p_profile->count, clock_hz);
+    APP_PRINT("\tsince reset [us]\tstep [us]\tevent\r\n");
+    for (uint32_t i = 0; i < p_profile->count; i++)
+    {
+        const boot_profile_event_t * p_event = &p_profile->events[i];
+        delta_us = 0U;
+        if (i > 0U)
+        {
+            const boot_profile_event_t * p_prev = &p_profile->events[i - 1U];
+            uint32_t tick_delta_ms = RESET_VALUE;
+
+            if ((BOOT_PROFILE_NO_TICK != p_event->tick) && (BOOT_PROFILE_NO_TICK != p_prev->tick))
+            {
+                tick_delta_ms = (p_event->tick - p_prev->tick) * portTICK_PERIOD_MS;
+            }
+            if (tick_delta_ms < BOOT_PROFILE_CYCLES_MAX_MS)
+            {
+                delta_us = ((uint64_t) (p_event->cycles - p_prev->cycles) * 1000000ULL) / clock_hz;
+            }
+            else
+            {
+                delta_us = (uint64_t) tick_delta_ms * 1000ULL;
+            }
+        }
+        total_us += delta_us;
+        APP_PRINT("\t%u\t\t%u\t\t%s\r\n", (uint32_t) total_us, (uint32_t) delta_us, p_event->name);
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Appends one event. Events beyond BOOT_PROFILE_MAX_EVENTS are dropped.
+ **********************************************************************************************************************/
+static void boot_profile_record(const char * p_name, uint32_t tick)
+{
+    boot_profile_event_t * p_event = NULL;
+    uint32_t i = RESET_VALUE;
+
+    FSP_CRITICAL_SECTION_DEFINE;
+    FSP_CRITICAL_SECTION_ENTER;
+    if ((BOOT_PROFILE_MAGIC == g_boot_profile.magic) && (g_boot_profile.count < BOOT_PROFILE_MAX_EVENTS))
+    {
+        p_event = &g_boot_profile.events[g_boot_profile.count];
+        g_boot_profile.count++;
+        p_event->cycles = DWT->CYCCNT;
+        p_event->tick   = tick;
+    }
+    FSP_CRITICAL_SECTION_EXIT;
+
+    if (NULL == p_event)
+    {
+        return;
+    }
+
+    /* No library calls, this also runs before the C runtime is set up */
+    for (i = 0U; (i < (BOOT_PROFILE_NAME_LEN - 1U)) && ('\0' != p_name[i]); i++)
+    {
+        p_event->name[i] = p_name[i];
+    }
+    p_event->name[i] = '\0';
+
+    if (BOOT_PROFILE_NO_TICK != tick)
+    {
+        g_boot_profile.core_clock_hz = SystemCoreClock;
+    }
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
@@ -0,0 +1,43 @@
+/***********************************************************************************************************************
+ * File Name    : boot_profile.h
+ * Description  : Contains macros, data structures and functions used by the boot timeline profiler
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef BOOT_PROFILE_H_
+#define BOOT_PROFILE_H_
+
+#include "hal_data.h"
+
+#define BOOT_PROFILE_MAGIC              (0x544F4F42UL)      /* "BOOT" */
+#define BOOT_PROFILE_MAX_EVENTS         (40U)
+#define BOOT_PROFILE_NAME_LEN           (20U)
+
+/* Ticks are only recorded once the scheduler runs, earlier events carry BOOT_PROFILE_NO_TICK */
+#define BOOT_PROFILE_NO_TICK            (0xFFFFFFFFUL)
+
+typedef struct st_boot_profile_event
+{
+    char     name[BOOT_PROFILE_NAME_LEN];
+    uint32_t cycles;                    /* DWT->CYCCNT */
+    uint32_t tick;                      /* xTaskGetTickCount() or BOOT_PROFILE_NO_TICK */
+} boot_profile_event_t;
+
+typedef struct st_boot_profile
+{
+    uint32_t             magic;
+    uint32_t             count;
+    uint32_t             core_clock_hz;  /* SystemCoreClock once the clocks are set up */
+    boot_profile_event_t events[BOOT_PROFILE_MAX_EVENTS];
+} boot_profile_t;
+
+void boot_profile_reset(void);
+void boot_profile_mark_early(const char * p_name);
+void boot_profile_mark(const char * p_name);
+void boot_profile_print(bool last_boot);
+
+#endif /* BOOT_PROFILE_H_ */
@@ -0,0 +1,249 @@
+/***********************************************************************************************************************
+ * File Name    : cert_pin.c
+ * Description  : This file implements the optional server certificate pinning. After one fully validated handshake
+ *                the SHA-256 of the leaf SubjectPublicKeyInfo is stored in LittleFS, later handshakes accept a leaf
+ *                with the same key without looking up a trust anchor.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_TLS)
+
+#include "common_utils.h"
+#include "mbedtls/sha256.h"
+#include "cert_pin.h"
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+typedef struct st_cert_pin_ctx
+{
+    cert_pin_mode_t   mode;
+    bool              leaf_seen;
+    bool              leaf_matched;
+    cert_pin_record_t captured;
+} cert_pin_ctx_t;
+
+static cert_pin_record_t g_pin;
+static bool g_pin_loaded = false;
+static bool g_pin_valid = false;
+static uint32_t g_pin_reuse = RESET_VALUE;
+static cert_pin_ctx_t g_pin_ctx;
+
+static void cert_pin_load(void);
+static fsp_err_t cert_pin_store(const cert_pin_record_t * p_record);
+static void cert_pin_capture(const mbedtls_x509_crt * crt, cert_pin_record_t * p_record);
+static int cert_pin_verify(void * p_ctx, mbedtls_x509_crt * crt, int depth, uint32_t * flags);
+static int cert_pin_no_anchor(void * p_ctx, mbedtls_x509_crt const * child, mbedtls_x509_crt ** candidate_cas);
+
+/*******************************************************************************************************************//**
+ * @brief      Installs the trust settings for the next handshake. With a valid pin the root CA is replaced by an empty
+ *             trust anchor callback and the verify callback accepts the leaf on a matching SPKI hash; otherwise the
+ *             root CA is used and the verify callback only records the leaf.
+ *
+ * @param[in]  p_conf                       SSL configuration of the session being set up.
+ * @param[in]  p_root_ca                    Parsed root CA used for full validation.
+ * @retval     Mode used for this handshake.
+ **********************************************************************************************************************/
+cert_pin_mode_t cert_pin_configure(mbedtls_ssl_config * p_conf, mbedtls_x509_crt * p_root_ca)
+{
+    cert_pin_load ();
+
+    memset (&g_pin_ctx, 0, sizeof(g_pin_ctx));
+    g_pin_ctx.mode = (g_pin_valid && (g_pin_reuse < CERT_PIN_MAX_REUSE)) ? CERT_PIN_MODE_PINNED : CERT_PIN_MODE_FULL;
+
+    if (CERT_PIN_MODE_PINNED == g_pin_ctx.mode)
+    {
+        mbedtls_ssl_conf_ca_cb (p_conf, cert_pin_no_anchor, NULL);
+    }
+    else
+    {
+        mbedtls_ssl_conf_ca_chain (p_conf, p_root_ca, NULL);
+    }
+    mbedtls_ssl_conf_verify (p_conf, cert_pin_verify, &g_pin_ctx);
+
+    return g_pin_ctx.mode;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Updates the pin after a handshake. A successful full validation stores the captured leaf if it changed,
+ *             a rejected pinned handshake drops the pin so that the retry runs a full validation.
+ *
+ * @param[in]  mode                         Mode returned by cert_pin_configure() for this handshake.
+ * @param[in]  handshake_result             Return value of mbedtls_ssl_handshake().
+ * @retval     None
+ **********************************************************************************************************************/
+void cert_pin_handshake_done(cert_pin_mode_t mode, int handshake_result)
+{
+    if (CERT_PIN_MODE_PINNED == mode)
+    {
+        if (0 == handshake_result)
+        {
+            g_pin_reuse++;
+        }
+        else if (g_pin_ctx.leaf_seen && !g_pin_ctx.leaf_matched)
+        {
+            APP_WARN_PRINT("\r\nPinned server key mismatch or expiry, falling back to full validation\r\n");
+            cert_pin_invalidate ();
+        }
+        else
+        {
+            /* Network failure, keep the pin */
+        }
+        return;
+    }
+
+    if ((0 != handshake_result) || !g_pin_ctx.leaf_seen)
+    {
+        return;
+    }
+
+    g_pin_reuse = RESET_VALUE;
+    if (g_pin_valid && (0 == memcmp (&g_pin, &g_pin_ctx.captured, sizeof(g_pin))))
+    {
+        return;
+    }
+
+    if (FSP_SUCCESS == cert_pin_store (&g_pin_ctx.captured))
+    {
+        g_pin       = g_pin_ctx.captured;
+        g_pin_valid = true;
+        APP_INFO_PRINT("\r\nServer certificate pinned for the next connections\r\n");
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Drops the pin from RAM and LittleFS.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void cert_pin_invalidate(void)
+{
+    g_pin_valid = false;
+    g_pin_reuse = RESET_VALUE;
+    (void) lfs_remove (&g_rm_littlefs0_lfs, CERT_PIN_FILE_NAME);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Reads the pin record from LittleFS on first use.
+ **********************************************************************************************************************/
+static void cert_pin_load(void)
+{
+    lfs_file_t file;
+    lfs_ssize_t read_len = RESET_VALUE;
+
+    if (g_pin_loaded)
+    {
+        return;
+    }
+    g_pin_loaded = true;
+
+    if (LFS_ERR_OK != lfs_file_open (&g_rm_littlefs0_lfs, &file, CERT_PIN_FILE_NAME, LFS_O_RDONLY))
+    {
+        return;
+    }
+    read_len = lfs_file_read (&g_rm_littlefs0_lfs, &file, &g_pin, sizeof(g_pin));
+    (void) lfs_file_close (&g_rm_littlefs0_lfs, &file);
+
+    g_pin_valid = ((lfs_ssize_t) sizeof(g_pin) == read_len) && (CERT_PIN_MAGIC == g_pin.magic)
+                  && (CERT_PIN_VERSION == g_pin.version);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Writes the pin record, LittleFS commits the new file contents atomically on close.
+ **********************************************************************************************************************/
+static fsp_err_t cert_pin_store(const cert_pin_record_t * p_record)
+{
+    lfs_file_t file;
+    lfs_ssize_t written = RESET_VALUE;
+    int lfs_err = LFS_ERR_OK;
+
+    lfs_err = lfs_file_open (&g_rm_littlefs0_lfs, &file, CERT_PIN_FILE_NAME, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+    if (LFS_ERR_OK != lfs_err)
+    {
+        APP_ERR_PRINT("** Failed to open %s: %d ** \r\n", CERT_PIN_FILE_NAME, lfs_err);
+        return FSP_ERR_WRITE_FAILED;
+    }
+    written = lfs_file_write (&g_rm_littlefs0_lfs, &file, p_record, sizeof(*p_record));
+    lfs_err = lfs_file_close (&g_rm_littlefs0_lfs, &file);
+
+    return (((lfs_ssize_t) sizeof(*p_record) == written) && (LFS_ERR_OK == lfs_err)) ? FSP_SUCCESS :
+           FSP_ERR_WRITE_FAILED;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Fills a pin record from the SPKI and expiry of a leaf certificate.
+ **********************************************************************************************************************/
+static void cert_pin_capture(const mbedtls_x509_crt * crt, cert_pin_record_t * p_record)
+{
+    memset (p_record, 0, sizeof(*p_record));
+    p_record->magic         = CERT_PIN_MAGIC;
+    p_record->version       = CERT_PIN_VERSION;
+    p_record->valid_to_year = crt->valid_to.year;
+    p_record->valid_to_mon  = crt->valid_to.mon;
+    p_record->valid_to_day  = crt->valid_to.day;
+    (void) mbedtls_sha256 (crt->pk_raw.p, crt->pk_raw.len, p_record->spki_sha256, 0);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      X.509 verify callback. mbedTLS calls it from the top of the chain down to the leaf (depth 0).
+ *             In full mode the leaf is captured only if the chain verified cleanly. In pinned mode the issuer levels
+ *             are left to the leaf decision: a leaf with the pinned SPKI and the pinned expiry date clears the
+ *             "not trusted" flag, anything else keeps it and fails the handshake.
+ **********************************************************************************************************************/
+static int cert_pin_verify(void * p_ctx, mbedtls_x509_crt * crt, int depth, uint32_t * flags)
+{
+    cert_pin_ctx_t * p_pin_ctx = (cert_pin_ctx_t *) p_ctx;
+
+    if (0 != depth)
+    {
+        if (CERT_PIN_MODE_PINNED == p_pin_ctx->mode)
+        {
+            *flags &= ~((uint32_t) MBEDTLS_X509_BADCERT_NOT_TRUSTED);
+        }
+        return 0;
+    }
+
+    p_pin_ctx->leaf_seen = true;
+    cert_pin_capture (crt, &p_pin_ctx->captured);
+
+    if (CERT_PIN_MODE_FULL == p_pin_ctx->mode)
+    {
+        /* Only a leaf that chains to the root CA may become the pin */
+        p_pin_ctx->leaf_seen = (0U == *flags);
+        return 0;
+    }
+
+    p_pin_ctx->leaf_matched = (0 == memcmp (&p_pin_ctx->captured, &g_pin, sizeof(g_pin)));
+    if (p_pin_ctx->leaf_matched)
+    {
+        *flags &= ~((uint32_t) MBEDTLS_X509_BADCERT_NOT_TRUSTED);
+    }
+    else
+    {
+        *flags |= MBEDTLS_X509_BADCERT_NOT_TRUSTED;
+    }
+    return 0;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Trusted CA callback for pinned mode. Offering no anchor skips the root CA lookup and its signature check.
+ **********************************************************************************************************************/
+static int cert_pin_no_anchor(void * p_ctx, mbedtls_x509_crt const * child, mbedtls_x509_crt ** candidate_cas)
+{
+    FSP_PARAMETER_NOT_USED(p_ctx);
+    FSP_PARAMETER_NOT_USED(child);
+    *candidate_cas = NULL;
+    return 0;
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
@@ -0,0 +1,46 @@
+/***********************************************************************************************************************
+ * File Name    : cert_pin.h
+ * Description  : Contains macros, data structures and functions used for server certificate pinning
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef CERT_PIN_H_
+#define CERT_PIN_H_
+
+#include "hal_data.h"
+#include "mbedtls/ssl.h"
+
+/* LittleFS file holding the pinned leaf of HTTPS_HOST_ADDRESS */
+#define CERT_PIN_FILE_NAME          "/tls_pin"
+#define CERT_PIN_MAGIC              (0x4E495053UL)      /* "SPIN" */
+#define CERT_PIN_VERSION            (1U)
+#define CERT_PIN_HASH_LEN           (32U)
+
+/* Pinned handshakes allowed per boot before a full chain validation refreshes the pin */
+#define CERT_PIN_MAX_REUSE          (64U)
+
+typedef enum e_cert_pin_mode
+{
+    CERT_PIN_MODE_FULL   = 0,   /* Chain validated against the root CA, leaf SPKI captured */
+    CERT_PIN_MODE_PINNED = 1    /* Leaf accepted on a matching SPKI hash, no trust anchor lookup */
+} cert_pin_mode_t;
+
+typedef struct st_cert_pin_record
+{
+    uint32_t magic;
+    uint32_t version;
+    uint8_t  spki_sha256[CERT_PIN_HASH_LEN];
+    int32_t  valid_to_year;
+    int32_t  valid_to_mon;
+    int32_t  valid_to_day;
+} cert_pin_record_t;
+
+cert_pin_mode_t cert_pin_configure(mbedtls_ssl_config * p_conf, mbedtls_x509_crt * p_root_ca);
+void cert_pin_handshake_done(cert_pin_mode_t mode, int handshake_result);
+void cert_pin_invalidate(void);
+
+#endif /* CERT_PIN_H_ */
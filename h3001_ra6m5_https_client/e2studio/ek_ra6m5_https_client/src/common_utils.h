@@ -20,6 +20,8 @@
 
 /* SEGGER RTT and error related headers */
 #include "SEGGER_RTT/SEGGER_RTT.h"
+#include "app_log.h"
+#include "rtt_streams.h"
 
 
 #define BIT_SHIFT_8  (8u)
@@ -44,16 +46,44 @@
                                 "\r\n********************************************************************************\r\n"
 
 
-#define SEGGER_INDEX            (0)
+#define SEGGER_INDEX            (RTT_STREAM_TERMINAL)
 
-#define APP_PRINT(fn_, ...)      (SEGGER_RTT_printf (SEGGER_INDEX,(fn_), ##__VA_ARGS__))
+/* Set to 1 to send the log as tokens for tools/log_decode.py instead of formatting it on the target, see log_token.h.
+ * The console then takes commands with no menu or replies shown on the terminal. */
+#define APP_LOG_TOKENIZED       (0u)
 
-#define APP_ERR_PRINT(fn_, ...)  if(LVL_ERR)\
-        SEGGER_RTT_printf (SEGGER_INDEX, "[ERR] In Function: %s(), %s",__FUNCTION__,(fn_),##__VA_ARGS__);
+#if APP_LOG_TOKENIZED
+#include "log_token.h"
 
-#define APP_ERR_TRAP(err)        if(err) {\
-        SEGGER_RTT_printf(SEGGER_INDEX, "\r\nReturned Error Code: 0x%x  \r\n", err);\
-        __asm("BKPT #0\n");} /* trap upon the error  */
+#define APP_PRINT(fn_, ...)      (LOG_TOKEN_PRINT(fn_, ##__VA_ARGS__))
+
+#define APP_ERR_PRINT(fn_, ...)  do { if(APP_LOG_ENABLED(APP_LOG_LEVEL_ERR))\
+        LOG_TOKEN_PRINT("[ERR] In Function: %s(), " fn_, __FUNCTION__, ##__VA_ARGS__); } while (0)
+
+#define APP_ERR_TRAP(err)        do { if(err) {\
+        LOG_TOKEN_PRINT("\r\nReturned Error Code: 0x%x  \r\n", err);\
+        __asm("BKPT #0\n");} } while (0) /* trap upon the error  */
+#else
+#define APP_PRINT(fn_, ...)      (rtt_stream_text (SEGGER_RTT_printf (SEGGER_INDEX,(fn_), ##__VA_ARGS__)))
+
+#define APP_ERR_PRINT(fn_, ...)  do { if(APP_LOG_ENABLED(APP_LOG_LEVEL_ERR))\
+        rtt_stream_text (SEGGER_RTT_printf (SEGGER_INDEX, "[ERR] In Function: %s(), %s",__FUNCTION__,(fn_),\
+                                            ##__VA_ARGS__)); } while (0)
+
+#define APP_ERR_TRAP(err)        do { if(err) {\
+        rtt_stream_text (SEGGER_RTT_printf(SEGGER_INDEX, "\r\nReturned Error Code: 0x%x  \r\n", err));\
+        __asm("BKPT #0\n");} } while (0) /* trap upon the error  */
+#endif
+
+/* Diagnostics filtered by the level of the file's module, see app_log.h. Console replies use APP_PRINT. */
+#define APP_WARN_PRINT(fn_, ...) do { if(APP_LOG_ENABLED(APP_LOG_LEVEL_WARN))\
+        APP_PRINT(fn_, ##__VA_ARGS__); } while (0)
+
+#define APP_INFO_PRINT(fn_, ...) do { if(APP_LOG_ENABLED(APP_LOG_LEVEL_INFO))\
+        APP_PRINT(fn_, ##__VA_ARGS__); } while (0)
+
+#define APP_DBG_PRINT(fn_, ...)  do { if(APP_LOG_ENABLED(APP_LOG_LEVEL_DEBUG))\
+        APP_PRINT(fn_, ##__VA_ARGS__); } while (0)
 
 #define APP_READ(read_data)     (SEGGER_RTT_Read (SEGGER_INDEX, (read_data), BUFFER_SIZE_DOWN))
 
@@ -0,0 +1,300 @@
+/***********************************************************************************************************************
+ * File Name    : console.c
+ * Description  : This file takes command lines from RTT in a task of its own and hands complete lines to the user
+ *                thread, which runs them from a command table. The task sleeps on a notification and only polls the
+ *                RTT input while a debugger is attached, at an interval that adapts to the input activity.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_SYS)
+
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "console.h"
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+static const console_command_t * gp_commands = NULL;
+static uint32_t g_command_count = RESET_VALUE;
+static console_stats_t g_console_stats;
+static TaskHandle_t g_console_task = NULL;
+static QueueHandle_t g_console_queue = NULL;
+static StaticQueue_t g_console_queue_mem;
+static uint8_t g_console_queue_storage[CONSOLE_QUEUE_LEN * CONSOLE_LINE_LEN];
+static char g_console_line[CONSOLE_LINE_LEN];       /* Line being received, owned by the console task */
+static uint32_t g_console_line_len = RESET_VALUE;
+static bool g_console_line_truncated = false;
+
+static void console_task(void * pvParameters);
+static bool console_debugger_attached(void);
+static bool console_read_input(void);
+static void console_submit_line(void);
+
+/*******************************************************************************************************************//**
+ * @brief      Starts the console task with the application command table. The table must stay valid.
+ * @param[in]  p_commands                   Commands, in the order console_print_help() lists them.
+ * @param[in]  count                        Number of commands.
+ * @retval     FSP_SUCCESS                  Console running.
+ * @retval     FSP_ERR_OUT_OF_MEMORY        Task or queue could not be created.
+ **********************************************************************************************************************/
+fsp_err_t console_start(const console_command_t * p_commands, uint32_t count)
+{
+    if (NULL != g_console_task)
+    {
+        return FSP_SUCCESS;
+    }
+
+    gp_commands     = p_commands;
+    g_command_count = count;
+    g_console_queue = xQueueCreateStatic (CONSOLE_QUEUE_LEN, CONSOLE_LINE_LEN, g_console_queue_storage,
+                                          &g_console_queue_mem);
+    if ((NULL == g_console_queue)
+        || (pdPASS != xTaskCreate (console_task, CONSOLE_TASK_NAME, CONSOLE_TASK_STACK, NULL, CONSOLE_TASK_PRIORITY,
+                                   &g_console_task)))
+    {
+        return FSP_ERR_OUT_OF_MEMORY;
+    }
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Wakes the console task to look for input, for input sources that can signal it.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void console_notify(void)
+{
+    if (NULL != g_console_task)
+    {
+        xTaskNotifyGive (g_console_task);
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      console_notify() for interrupt handlers.
+ * @param[out] p_higher_priority_task_woken Set to pdTRUE when a context switch is due on exit.
+ * @retval     None
+ **********************************************************************************************************************/
+void console_notify_from_isr(BaseType_t * p_higher_priority_task_woken)
+{
+    if (NULL != g_console_task)
+    {
+        vTaskNotifyGiveFromISR (g_console_task, p_higher_priority_task_woken);
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Waits for the next complete input line.
+ * @param[out] p_line                       Buffer of CONSOLE_LINE_LEN bytes, receives the NUL terminated line.
+ * @param[in]  timeout                      Ticks to wait.
+ * @retval     true                         A line was received.
+ * @retval     false                        Timeout.
+ **********************************************************************************************************************/
+bool console_receive(char * p_line, TickType_t timeout)
+{
+    if (NULL == g_console_queue)
+    {
+        vTaskDelay (timeout);
+        return false;
+    }
+    return (pdTRUE == xQueueReceive (g_console_queue, p_line, timeout));
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Splits a line into words and runs the command named by the first word, or by its menu number. "help"
+ *             lists the commands. The line is modified.
+ * @param[in]  p_line                       NUL terminated command line.
+ * @param[in]  p_context                    Passed to the command handler.
+ * @retval     FSP_SUCCESS                  Empty line, help, or the handler succeeded.
+ * @retval     FSP_ERR_NOT_FOUND            Unknown command.
+ * @retval     Any other Error Code         Returned by the handler.
+ **********************************************************************************************************************/
+fsp_err_t console_execute(char * p_line, void * p_context)
+{
+    char * p_argv[CONSOLE_MAX_ARGS] = {NULL};
+    uint32_t argc = RESET_VALUE;
+    char * p_next = p_line;
+
+    while ((argc < CONSOLE_MAX_ARGS) && ('\0' != *p_next))
+    {
+        while ((' ' == *p_next) || ('\t' == *p_next))
+        {
+            *p_next++ = '\0';
+        }
+        if ('\0' == *p_next)
+        {
+            break;
+        }
+        p_argv[argc++] = p_next;
+        while (('\0' != *p_next) && (' ' != *p_next) && ('\t' != *p_next))
+        {
+            p_next++;
+        }
+        if ('\0' != *p_next)
+        {
+            *p_next++ = '\0';
+        }
+    }
+
+    if (0U == argc)
+    {
+        return FSP_SUCCESS;
+    }
+    if (0 == strcmp (p_argv[0], "help"))
+    {
+        console_print_help ();
+        console_print_stats ();
+        return FSP_SUCCESS;
+    }
+    for (uint32_t i = 0; i < g_command_count; i++)
+    {
+        if ((0 == strcmp (p_argv[0], gp_commands[i].p_name))
+            || ((NULL != gp_commands[i].p_alias) && (0 == strcmp (p_argv[0], gp_commands[i].p_alias))))
+        {
+            return gp_commands[i].p_handler (argc, p_argv, p_context);
+        }
+    }
+
+    APP_PRINT("\r\nUnknown command \"%s\", type help for the list\r\n", p_argv[0]);
+    return FSP_ERR_NOT_FOUND;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints the command table as the menu.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void console_print_help(void)
+{
+    APP_PRINT("\r\nSelect from the below menu options, by number or by name");
+    for (uint32_t i = 0; i < g_command_count; i++)
+    {
+        APP_PRINT("\r\n %s. %s: %s", (NULL != gp_commands[i].p_alias) ? gp_commands[i].p_alias : " ",
+                  gp_commands[i].p_name, gp_commands[i].p_help);
+    }
+    APP_PRINT("\r\n");
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints the console task wakeups and line counters.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void console_print_stats(void)
+{
+    APP_PRINT("\r\nConsole: debugger %s, %d wakeups, %d lines, %d dropped, %d truncated\r\n",
+              console_debugger_attached () ? "attached" : "detached", g_console_stats.wakeups, g_console_stats.lines,
+              g_console_stats.dropped, g_console_stats.truncated);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Console task. Polls the RTT input while a debugger is attached, shortening the interval on input and
+ *             backing off while it is idle. A line without line end is taken when the input pauses. Detached, the
+ *             task adds no wakeups of its own.
+ **********************************************************************************************************************/
+static void console_task(void * pvParameters)
+{
+    uint32_t poll_ms = CONSOLE_POLL_MAX_MS;
+    TickType_t wait = RESET_VALUE;
+
+    FSP_PARAMETER_NOT_USED(pvParameters);
+
+    while (true)
+    {
+        wait = console_debugger_attached () ? pdMS_TO_TICKS(poll_ms) : portMAX_DELAY;
+        (void) ulTaskNotifyTake (pdTRUE, wait);
+        g_console_stats.wakeups++;
+
+        if (console_read_input ())
+        {
+            poll_ms = CONSOLE_POLL_MIN_MS;
+        }
+        else
+        {
+            if (0U != g_console_line_len)
+            {
+                console_submit_line ();
+            }
+            poll_ms = ((2U * poll_ms) < CONSOLE_POLL_MAX_MS) ? (2U * poll_ms) : CONSOLE_POLL_MAX_MS;
+        }
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Halting debug is enabled while a debugger is connected, RTT input can only come from it.
+ **********************************************************************************************************************/
+static bool console_debugger_attached(void)
+{
+    return (0U != (DCB->DHCSR & DCB_DHCSR_C_DEBUGEN_Msk));
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Reads what the RTT input holds into the line, submitting every line that ends on CR or LF.
+ * @retval     true when input was read.
+ **********************************************************************************************************************/
+static bool console_read_input(void)
+{
+    char input[BUFFER_SIZE_DOWN];
+    unsigned len = RESET_VALUE;
+    bool received = false;
+
+    while (0U != (len = SEGGER_RTT_Read (SEGGER_INDEX, input, sizeof(input))))
+    {
+        received = true;
+        for (unsigned i = 0; i < len; i++)
+        {
+            if (('\r' == input[i]) || ('\n' == input[i]))
+            {
+                if (0U != g_console_line_len)
+                {
+                    console_submit_line ();
+                }
+            }
+            else if (('\b' == input[i]) || (0x7F == input[i]))
+            {
+                g_console_line_len -= (0U != g_console_line_len) ? 1U : 0U;
+            }
+            else if (g_console_line_len < (CONSOLE_LINE_LEN - 1U))
+            {
+                g_console_line[g_console_line_len++] = input[i];
+            }
+            else
+            {
+                g_console_line_truncated = true;
+            }
+        }
+    }
+    return received;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Hands the received line to the user thread. A line arriving while both queue slots are taken is
+ *             dropped, the user thread is busy with an earlier command.
+ **********************************************************************************************************************/
+static void console_submit_line(void)
+{
+    g_console_line[g_console_line_len] = '\0';
+    g_console_stats.lines++;
+    g_console_stats.truncated += g_console_line_truncated ? 1U : 0U;
+    if (pdTRUE != xQueueSend (g_console_queue, g_console_line, 0))
+    {
+        g_console_stats.dropped++;
+    }
+    g_console_line_len       = RESET_VALUE;
+    g_console_line_truncated = false;
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
@@ -0,0 +1,60 @@
+/***********************************************************************************************************************
+ * File Name    : console.h
+ * Description  : Contains macros, data structures and functions used by the RTT command console
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+#include "hal_data.h"
+#include "FreeRTOS.h"
+
+#define CONSOLE_TASK_NAME           "Console"
+#define CONSOLE_TASK_STACK          (256U)      /* Words */
+#define CONSOLE_TASK_PRIORITY       (2U)
+
+/* RTT input has no interrupt, it is polled while a debugger is attached: every CONSOLE_POLL_MIN_MS after input,
+ * doubling up to CONSOLE_POLL_MAX_MS while the input is idle. Without a debugger the task has no timeout of its own
+ * and sleeps until console_notify(), which the user thread calls when it wakes, to notice a debugger attached later */
+#define CONSOLE_POLL_MIN_MS         (10U)
+#define CONSOLE_POLL_MAX_MS         (160U)
+
+/* A line ends at CR or LF, or when the input pauses for a poll: the RTT Viewer sends a line in one piece and may
+ * leave out the line end */
+#define CONSOLE_LINE_LEN            (48U)
+#define CONSOLE_MAX_ARGS            (4U)
+#define CONSOLE_QUEUE_LEN           (2U)        /* Lines waiting for the user thread */
+
+/* Runs in the task calling console_execute(), p_context is passed through from there */
+typedef fsp_err_t (* console_handler_t)(uint32_t argc, char * p_argv[], void * p_context);
+
+typedef struct st_console_command
+{
+    const char * p_name;
+    const char * p_alias;               /* Menu number, NULL for none */
+    const char * p_help;
+    console_handler_t p_handler;
+} console_command_t;
+
+typedef struct st_console_stats
+{
+    uint32_t wakeups;
+    uint32_t lines;
+    uint32_t dropped;                   /* Lines lost while the user thread was busy */
+    uint32_t truncated;                 /* Lines longer than CONSOLE_LINE_LEN */
+} console_stats_t;
+
+fsp_err_t console_start(const console_command_t * p_commands, uint32_t count);
+void console_notify(void);
+void console_notify_from_isr(BaseType_t * p_higher_priority_task_woken);
+bool console_receive(char * p_line, TickType_t timeout);
+fsp_err_t console_execute(char * p_line, void * p_context);
+void console_print_help(void);
+void console_print_stats(void);
+
+#endif /* CONSOLE_H_ */
@@ -0,0 +1,490 @@
+/***********************************************************************************************************************
+ * File Name    : credential_cache.c
+ * Description  : This file keeps the parsed TLS credentials alive for the lifetime of the device so that reconnects
+ *                do not have to decode the root CA or reload the client credentials from PKCS#11 again.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_TLS)
+
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "core_pkcs11_config.h"
+#include "core_pkcs11.h"
+#include "pkcs11.h"
+#include "mbedtls/entropy.h"
+#include "psa/crypto.h"
+#include "core_http_client.h"
+#include "transport_mbedtls_pkcs11.h"
+#include "user_app.h"
+#include "app_timing.h"
+#include "credential_cache.h"
+#include "mem_pool.h"
+#include "heap_trace.h"
+#include "tls_session.h"
+#include "sys_stats.h"
+#include "task.h"
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+/* Parsed (DER) credentials, alive until credential_cache_deinit() */
+static mbedtls_x509_crt g_root_ca;
+static mbedtls_x509_crt g_client_cert;
+static mbedtls_pk_context g_client_key;
+static mbedtls_entropy_context g_entropy;
+static mbedtls_ctr_drbg_context g_ctr_drbg;
+
+/* PKCS#11 session and private key handle kept open for signing */
+static CK_FUNCTION_LIST_PTR gp_p11_function_list = NULL;
+static CK_SESSION_HANDLE g_p11_session = CK_INVALID_HANDLE;
+static CK_OBJECT_HANDLE g_p11_private_key = CK_INVALID_HANDLE;
+static CK_OBJECT_HANDLE g_p11_client_cert = CK_INVALID_HANDLE;
+
+static bool g_cache_ready = false;
+
+/* credential_cache_benchmark() only: the session reads the credentials parsed for it instead of the cached ones */
+static bool g_bench_uncached = false;
+static mbedtls_x509_crt g_bench_root_ca;
+static mbedtls_x509_crt g_bench_client_cert;
+static TlsTransportParams_t g_bench_transport;
+
+/* Accumulated cost of one benchmark step */
+typedef struct st_credential_cache_bench
+{
+    uint64_t cycles;
+    uint64_t cpu;                       /* Run time of the calling task, core clock cycles */
+    uint32_t peak_heap;                 /* Highest transient heap and pool bytes of one iteration */
+    uint32_t start_cycles;
+    configRUN_TIME_COUNTER_TYPE start_cpu;
+    uint32_t start_held;
+} credential_cache_bench_t;
+
+static fsp_err_t load_client_cert(mbedtls_x509_crt * p_crt, CK_OBJECT_HANDLE cert_handle);
+static int pkcs11_rsa_sign(void * ctx, int (*f_rng)(void *, unsigned char *, size_t), void * p_rng,
+                           mbedtls_md_type_t md_alg, unsigned int hashlen, const unsigned char * hash,
+                           unsigned char * sig);
+static int pkcs11_rsa_decrypt(void * ctx, size_t * olen, const unsigned char * input, unsigned char * output,
+                              size_t output_max_len);
+static size_t pkcs11_rsa_key_len(void * ctx);
+static TlsTransportStatus_t credential_cache_bench_cycle(bool cached, credential_cache_bench_t * p_bench);
+static void credential_cache_bench_start(credential_cache_bench_t * p_bench);
+static void credential_cache_bench_stop(credential_cache_bench_t * p_bench);
+static void credential_cache_bench_print(const char * p_name, const credential_cache_bench_t * p_bench, uint32_t count);
+
+/*******************************************************************************************************************//**
+ * @brief      Parses the trusted root CA and the provisioned client certificate once and opens the PKCS#11 session
+ *             used for client authentication. Must be called after provision_alt_key().
+ *
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  Upon successful cache initialization.
+ * @retval     Any other Error Code         Upon unsuccessful cache initialization.
+ **********************************************************************************************************************/
+fsp_err_t credential_cache_init(void)
+{
+    CK_RV xResult = CKR_OK;
+    int mbedtls_err = RESET_VALUE;
+
+    if (g_cache_ready)
+    {
+        return FSP_SUCCESS;
+    }
+
+    mbedtls_x509_crt_init (&g_root_ca);
+    mbedtls_x509_crt_init (&g_client_cert);
+    mbedtls_pk_init (&g_client_key);
+    mbedtls_entropy_init (&g_entropy);
+    mbedtls_ctr_drbg_init (&g_ctr_drbg);
+
+    /* TLS 1.3 runs its key schedule and ECDHE through PSA */
+    if (PSA_SUCCESS != psa_crypto_init ())
+    {
+        APP_ERR_PRINT("** psa_crypto_init failed ** \r\n");
+        credential_cache_deinit ();
+        return FSP_ERR_ASSERTION;
+    }
+
+    /* Seed the DRBG once, every TLS session draws from it */
+    mbedtls_err = mbedtls_ctr_drbg_seed (&g_ctr_drbg, mbedtls_entropy_func, &g_entropy, NULL, 0);
+    if (0 != mbedtls_err)
+    {
+        APP_ERR_PRINT("** mbedtls_ctr_drbg_seed failed: -0x%x ** \r\n", -mbedtls_err);
+        credential_cache_deinit ();
+        return FSP_ERR_ASSERTION;
+    }
+
+    /* Decode the PEM root CA a single time, the parsed chain holds the DER copy in g_root_ca.raw */
+    mbedtls_err = mbedtls_x509_crt_parse (&g_root_ca, (const unsigned char *) HTTPS_TRUSTED_ROOT_CA,
+                                          sizeof(HTTPS_TRUSTED_ROOT_CA));
+    if (0 != mbedtls_err)
+    {
+        APP_ERR_PRINT("** Failed to parse HTTPS_TRUSTED_ROOT_CA: -0x%x ** \r\n", -mbedtls_err);
+        credential_cache_deinit ();
+        return FSP_ERR_INVALID_DATA;
+    }
+
+    /* Keep one PKCS#11 session open and resolve the object handles once */
+    xResult = C_GetFunctionList (&gp_p11_function_list);
+    if (CKR_OK == xResult)
+    {
+        xResult = xInitializePkcs11Session (&g_p11_session);
+    }
+    if (CKR_OK == xResult)
+    {
+        xResult = xFindObjectWithLabelAndClass (g_p11_session, pkcs11configLABEL_DEVICE_PRIVATE_KEY_FOR_TLS,
+                                                sizeof(pkcs11configLABEL_DEVICE_PRIVATE_KEY_FOR_TLS) - 1U,
+                                                CKO_PRIVATE_KEY, &g_p11_private_key);
+    }
+    if (CKR_OK == xResult)
+    {
+        xResult = xFindObjectWithLabelAndClass (g_p11_session, pkcs11configLABEL_DEVICE_CERTIFICATE_FOR_TLS,
+                                                sizeof(pkcs11configLABEL_DEVICE_CERTIFICATE_FOR_TLS) - 1U,
+                                                CKO_CERTIFICATE, &g_p11_client_cert);
+    }
+    if ((CKR_OK != xResult) || (CK_INVALID_HANDLE == g_p11_private_key) || (CK_INVALID_HANDLE == g_p11_client_cert))
+    {
+        APP_ERR_PRINT("** Failed to open the PKCS#11 client credentials: 0x%x ** \r\n", xResult);
+        credential_cache_deinit ();
+        return FSP_ERR_NOT_FOUND;
+    }
+
+    if (FSP_SUCCESS != load_client_cert (&g_client_cert, g_p11_client_cert))
+    {
+        credential_cache_deinit ();
+        return FSP_ERR_INVALID_DATA;
+    }
+
+    /* The private key never leaves PKCS#11, mbedTLS signs through the open session */
+    mbedtls_err = mbedtls_pk_setup_rsa_alt (&g_client_key, NULL, pkcs11_rsa_decrypt, pkcs11_rsa_sign,
+                                            pkcs11_rsa_key_len);
+    if (0 != mbedtls_err)
+    {
+        APP_ERR_PRINT("** mbedtls_pk_setup_rsa_alt failed: -0x%x ** \r\n", -mbedtls_err);
+        credential_cache_deinit ();
+        return FSP_ERR_ASSERTION;
+    }
+
+    g_cache_ready = true;
+    APP_INFO_PRINT("\r\nTLS credential cache ready (root CA %d bytes DER, client cert %d bytes DER)\r\n",
+                   g_root_ca.raw.len, g_client_cert.raw.len);
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Releases the cached credentials and closes the PKCS#11 session.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void credential_cache_deinit(void)
+{
+    mbedtls_pk_free (&g_client_key);
+    mbedtls_x509_crt_free (&g_client_cert);
+    mbedtls_x509_crt_free (&g_root_ca);
+    mbedtls_ctr_drbg_free (&g_ctr_drbg);
+    mbedtls_entropy_free (&g_entropy);
+
+    if ((NULL != gp_p11_function_list) && (CK_INVALID_HANDLE != g_p11_session))
+    {
+        (void) gp_p11_function_list->C_CloseSession (g_p11_session);
+    }
+    g_p11_session     = CK_INVALID_HANDLE;
+    g_p11_private_key = CK_INVALID_HANDLE;
+    g_p11_client_cert = CK_INVALID_HANDLE;
+    g_cache_ready     = false;
+}
+
+mbedtls_x509_crt * credential_cache_root_ca(void)
+{
+    return g_bench_uncached ? &g_bench_root_ca : &g_root_ca;
+}
+
+mbedtls_x509_crt * credential_cache_client_cert(void)
+{
+    return g_bench_uncached ? &g_bench_client_cert : &g_client_cert;
+}
+
+mbedtls_pk_context * credential_cache_private_key(void)
+{
+    return &g_client_key;
+}
+
+mbedtls_ctr_drbg_context * credential_cache_rng(void)
+{
+    return &g_ctr_drbg;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Compares the credential work of a connect before the cache (PEM root CA decode and PKCS#11 certificate
+ *             reload) with the cached path: first the parse steps on their own, then whole tls_session_connect() and
+ *             tls_session_disconnect() cycles to HTTPS_HOST_ADDRESS with fresh and with cached credentials. Prints the
+ *             average time, the CPU time of the calling task and the peak transient heap (heap and pool bytes above
+ *             the start, highest of all iterations) over RTT. Needs the network and no other TLS session open.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void credential_cache_benchmark(void)
+{
+    mbedtls_x509_crt root_ca;
+    mbedtls_x509_crt client_cert;
+    credential_cache_bench_t pem = {RESET_VALUE};
+    credential_cache_bench_t der = {RESET_VALUE};
+    credential_cache_bench_t p11 = {RESET_VALUE};
+    credential_cache_bench_t cycle[2] = {{RESET_VALUE}};
+    uint32_t failed[2] = {RESET_VALUE};
+
+    if (!g_cache_ready)
+    {
+        APP_PRINT("\r\nCredential cache not initialized, benchmark skipped\r\n");
+        return;
+    }
+
+    app_timing_init ();
+
+    for (uint32_t i = 0; i < CREDENTIAL_CACHE_BENCH_ITERATIONS; i++)
+    {
+        /* Uncached: base64 decode and X.509 parse of the PEM root CA */
+        mbedtls_x509_crt_init (&root_ca);
+        credential_cache_bench_start (&pem);
+        (void) mbedtls_x509_crt_parse (&root_ca, (const unsigned char *) HTTPS_TRUSTED_ROOT_CA,
+                                       sizeof(HTTPS_TRUSTED_ROOT_CA));
+        credential_cache_bench_stop (&pem);
+        mbedtls_x509_crt_free (&root_ca);
+
+        /* Same certificate from its DER form, no base64 step */
+        mbedtls_x509_crt_init (&root_ca);
+        credential_cache_bench_start (&der);
+        (void) mbedtls_x509_crt_parse_der (&root_ca, g_root_ca.raw.p, g_root_ca.raw.len);
+        credential_cache_bench_stop (&der);
+        mbedtls_x509_crt_free (&root_ca);
+
+        /* Uncached: client certificate reloaded from the PKCS#11 store and parsed */
+        mbedtls_x509_crt_init (&client_cert);
+        credential_cache_bench_start (&p11);
+        (void) load_client_cert (&client_cert, g_p11_client_cert);
+        credential_cache_bench_stop (&p11);
+        mbedtls_x509_crt_free (&client_cert);
+
+        /* Whole reconnects, alternating so that both see the same network conditions */
+        for (uint32_t cached = 0; cached < 2U; cached++)
+        {
+            if (TLS_TRANSPORT_SUCCESS != credential_cache_bench_cycle (0U != cached, &cycle[cached]))
+            {
+                failed[cached]++;
+            }
+        }
+    }
+
+    APP_PRINT("\r\nCredential cache benchmark (%d iterations, average per connect, peak of all iterations)\r\n",
+              CREDENTIAL_CACHE_BENCH_ITERATIONS);
+    APP_PRINT("\t                              time us   CPU us  peak heap\r\n");
+    credential_cache_bench_print ("Root CA PEM parse         ", &pem, CREDENTIAL_CACHE_BENCH_ITERATIONS);
+    credential_cache_bench_print ("Root CA DER parse         ", &der, CREDENTIAL_CACHE_BENCH_ITERATIONS);
+    credential_cache_bench_print ("Client cert PKCS#11 reload", &p11, CREDENTIAL_CACHE_BENCH_ITERATIONS);
+    credential_cache_bench_print ("Reconnect, uncached       ", &cycle[0],
+                                  CREDENTIAL_CACHE_BENCH_ITERATIONS - failed[0]);
+    credential_cache_bench_print ("Reconnect, cached         ", &cycle[1],
+                                  CREDENTIAL_CACHE_BENCH_ITERATIONS - failed[1]);
+    if ((0U != failed[0]) || (0U != failed[1]))
+    {
+        APP_PRINT("\t%d uncached and %d cached reconnects failed and are not averaged\r\n", failed[0], failed[1]);
+    }
+#if (HEAP_TRACE_ENABLE != ENABLE)
+    APP_PRINT("\tPeak heap needs HEAP_TRACE_ENABLE\r\n");
+#endif
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Reads the DER client certificate from its PKCS#11 object and parses it into p_crt.
+ **********************************************************************************************************************/
+static fsp_err_t load_client_cert(mbedtls_x509_crt * p_crt, CK_OBJECT_HANDLE cert_handle)
+{
+    CK_RV xResult = CKR_OK;
+    CK_ATTRIBUTE xTemplate = { CKA_VALUE, NULL, 0 };
+    int mbedtls_err = RESET_VALUE;
+
+    /* First call reports the object size */
+    xResult = gp_p11_function_list->C_GetAttributeValue (g_p11_session, cert_handle, &xTemplate, 1);
+    if ((CKR_OK != xResult) || (0U == xTemplate.ulValueLen))
+    {
+        APP_ERR_PRINT("** Failed to size the client certificate object: 0x%x ** \r\n", xResult);
+        return FSP_ERR_NOT_FOUND;
+    }
+
+    xTemplate.pValue = mem_pool_pkcs11_malloc (xTemplate.ulValueLen);
+    if (NULL == xTemplate.pValue)
+    {
+        return FSP_ERR_OUT_OF_MEMORY;
+    }
+
+    xResult = gp_p11_function_list->C_GetAttributeValue (g_p11_session, cert_handle, &xTemplate, 1);
+    if (CKR_OK == xResult)
+    {
+        mbedtls_err = mbedtls_x509_crt_parse_der (p_crt, (const unsigned char *) xTemplate.pValue,
+                                                  xTemplate.ulValueLen);
+    }
+    mem_pool_pkcs11_free (xTemplate.pValue);
+
+    if ((CKR_OK != xResult) || (0 != mbedtls_err))
+    {
+        APP_ERR_PRINT("** Failed to load the client certificate: 0x%x / -0x%x ** \r\n", xResult, -mbedtls_err);
+        return FSP_ERR_INVALID_DATA;
+    }
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      RSA-ALT sign callback. Wraps the SHA-256 digest in its DigestInfo and signs it with CKM_RSA_PKCS through
+ *             the cached PKCS#11 session and private key handle.
+ **********************************************************************************************************************/
+static int pkcs11_rsa_sign(void * ctx, int (*f_rng)(void *, unsigned char *, size_t), void * p_rng,
+                           mbedtls_md_type_t md_alg, unsigned int hashlen, const unsigned char * hash,
+                           unsigned char * sig)
+{
+    CK_RV xResult = CKR_OK;
+    CK_MECHANISM xMech = { CKM_RSA_PKCS, NULL, 0 };
+    uint8_t digest_info[pkcs11RSA_SIGNATURE_INPUT_LENGTH] = { RESET_VALUE };
+    CK_ULONG sig_len = (CK_ULONG) pkcs11_rsa_key_len (ctx);
+
+    FSP_PARAMETER_NOT_USED(f_rng);
+    FSP_PARAMETER_NOT_USED(p_rng);
+
+    if ((MBEDTLS_MD_SHA256 != md_alg) || (32U != hashlen))
+    {
+        return MBEDTLS_ERR_PK_FEATURE_UNAVAILABLE;
+    }
+
+    xResult = vAppendSHA256AlgorithmIdentifierSequence (hash, digest_info);
+    if (CKR_OK == xResult)
+    {
+        xResult = gp_p11_function_list->C_SignInit (g_p11_session, &xMech, g_p11_private_key);
+    }
+    if (CKR_OK == xResult)
+    {
+        xResult = gp_p11_function_list->C_Sign (g_p11_session, digest_info, sizeof(digest_info), sig, &sig_len);
+    }
+
+    return (CKR_OK == xResult) ? 0 : MBEDTLS_ERR_PK_BAD_INPUT_DATA;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      RSA-ALT decrypt callback. A TLS client never decrypts with its own key.
+ **********************************************************************************************************************/
+static int pkcs11_rsa_decrypt(void * ctx, size_t * olen, const unsigned char * input, unsigned char * output,
+                              size_t output_max_len)
+{
+    FSP_PARAMETER_NOT_USED(ctx);
+    FSP_PARAMETER_NOT_USED(olen);
+    FSP_PARAMETER_NOT_USED(input);
+    FSP_PARAMETER_NOT_USED(output);
+    FSP_PARAMETER_NOT_USED(output_max_len);
+    return MBEDTLS_ERR_PK_FEATURE_UNAVAILABLE;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      RSA-ALT key length callback. The modulus length comes from the cached client certificate.
+ **********************************************************************************************************************/
+static size_t pkcs11_rsa_key_len(void * ctx)
+{
+    FSP_PARAMETER_NOT_USED(ctx);
+    return mbedtls_pk_get_len (&g_client_cert.pk);
+}
+/*******************************************************************************************************************//**
+ * @brief      One benchmark reconnect: tls_session_connect() and tls_session_disconnect(). Uncached, the root CA is
+ *             decoded from PEM and the client certificate reloaded from PKCS#11 first, as every connect did before
+ *             the cache, and the session uses those copies.
+ **********************************************************************************************************************/
+static TlsTransportStatus_t credential_cache_bench_cycle(bool cached, credential_cache_bench_t * p_bench)
+{
+    NetworkContext_t context = {&g_bench_transport};
+    TlsTransportStatus_t status = TLS_TRANSPORT_SUCCESS;
+    credential_cache_bench_t cycle = *p_bench;
+
+    (void) memset (&g_bench_transport, 0, sizeof(g_bench_transport));
+    credential_cache_bench_start (&cycle);
+    if (!cached)
+    {
+        mbedtls_x509_crt_init (&g_bench_root_ca);
+        mbedtls_x509_crt_init (&g_bench_client_cert);
+        (void) mbedtls_x509_crt_parse (&g_bench_root_ca, (const unsigned char *) HTTPS_TRUSTED_ROOT_CA,
+                                       sizeof(HTTPS_TRUSTED_ROOT_CA));
+        (void) load_client_cert (&g_bench_client_cert, g_p11_client_cert);
+        g_bench_uncached = true;
+    }
+    status = tls_session_connect (&context, HTTPS_HOST_ADDRESS, HTTPS_PORT, SOCKET_SEND_RECV_TIME_OUT_MS,
+                                  SOCKET_SEND_RECV_TIME_OUT_MS);
+    if (TLS_TRANSPORT_SUCCESS == status)
+    {
+        tls_session_disconnect (&context);
+    }
+    if (!cached)
+    {
+        g_bench_uncached = false;
+        mbedtls_x509_crt_free (&g_bench_client_cert);
+        mbedtls_x509_crt_free (&g_bench_root_ca);
+    }
+    credential_cache_bench_stop (&cycle);
+
+    /* A failed reconnect would skew the averages */
+    if (TLS_TRANSPORT_SUCCESS == status)
+    {
+        *p_bench = cycle;
+    }
+    return status;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Starts one iteration of a benchmark step: restarts the heap peaks and takes the counters.
+ **********************************************************************************************************************/
+static void credential_cache_bench_start(credential_cache_bench_t * p_bench)
+{
+    heap_trace_stats_t heap;
+
+    heap_trace_reset_peaks ();
+    heap_trace_get_total (&heap);
+    p_bench->start_held   = heap.current;
+    p_bench->start_cpu    = sys_stats_task_run_time ();
+    p_bench->start_cycles = app_timing_cycles ();
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Ends one iteration of a benchmark step and adds it to the step.
+ **********************************************************************************************************************/
+static void credential_cache_bench_stop(credential_cache_bench_t * p_bench)
+{
+    uint32_t cycles = app_timing_cycles () - p_bench->start_cycles;
+    configRUN_TIME_COUNTER_TYPE cpu = sys_stats_task_run_time () - p_bench->start_cpu;
+    heap_trace_stats_t heap;
+
+    heap_trace_get_total (&heap);
+    p_bench->cycles   += cycles;
+    p_bench->cpu      += cpu;
+    p_bench->peak_heap = ((heap.peak - p_bench->start_held) > p_bench->peak_heap) ?
+                         (heap.peak - p_bench->start_held) : p_bench->peak_heap;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints one benchmark step, averaged over the iterations that count.
+ **********************************************************************************************************************/
+static void credential_cache_bench_print(const char * p_name, const credential_cache_bench_t * p_bench, uint32_t count)
+{
+    if (0U == count)
+    {
+        APP_PRINT("\t%s :        -        -          -\r\n", p_name);
+        return;
+    }
+    APP_PRINT("\t%s : %8u %8u %10u\r\n", p_name, APP_TIMING_CYCLES_TO_US(p_bench->cycles / count),
+              APP_TIMING_CYCLES_TO_US(p_bench->cpu / count), p_bench->peak_heap);
+}
+
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
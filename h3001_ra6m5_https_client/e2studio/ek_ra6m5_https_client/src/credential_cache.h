@@ -0,0 +1,30 @@
+/***********************************************************************************************************************
+ * File Name    : credential_cache.h
+ * Description  : Contains macros, data structures and functions used by the TLS credential cache
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef CREDENTIAL_CACHE_H_
+#define CREDENTIAL_CACHE_H_
+
+#include "hal_data.h"
+#include "mbedtls/x509_crt.h"
+#include "mbedtls/pk.h"
+#include "mbedtls/ctr_drbg.h"
+
+/* Iterations of every step of credential_cache_benchmark() */
+#define CREDENTIAL_CACHE_BENCH_ITERATIONS       (10U)
+
+fsp_err_t credential_cache_init(void);
+void credential_cache_deinit(void);
+mbedtls_x509_crt * credential_cache_root_ca(void);
+mbedtls_x509_crt * credential_cache_client_cert(void);
+mbedtls_pk_context * credential_cache_private_key(void);
+mbedtls_ctr_drbg_context * credential_cache_rng(void);
+void credential_cache_benchmark(void);
+
+#endif /* CREDENTIAL_CACHE_H_ */
@@ -0,0 +1,379 @@
+/***********************************************************************************************************************
+ * File Name    : crypto_bench.c
+ * Description  : This file times the mbedTLS primitives used by the HTTPS client so that cipher suites and key types
+ *                can be chosen on numbers. Each primitive runs through the normal mbedTLS API, which the FSP routes
+ *                to the Secure Crypto Engine or to the software implementation as configured.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_TLS)
+
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/sha512.h"
+#include "mbedtls/gcm.h"
+#include "mbedtls/ecdh.h"
+#include "mbedtls/ecdsa.h"
+#include "mbedtls/rsa.h"
+#include "credential_cache.h"
+#include "app_timing.h"
+#include "crypto_bench.h"
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/* Implementation selected by the FSP configuration for each row */
+#if defined(MBEDTLS_SHA256_ALT) || defined(MBEDTLS_SHA256_PROCESS_ALT)
+#define CRYPTO_BENCH_PATH_SHA256    "hw"
+#else
+#define CRYPTO_BENCH_PATH_SHA256    "sw"
+#endif
+#if defined(MBEDTLS_SHA512_ALT) || defined(MBEDTLS_SHA512_PROCESS_ALT)
+#define CRYPTO_BENCH_PATH_SHA512    "hw"
+#else
+#define CRYPTO_BENCH_PATH_SHA512    "sw"
+#endif
+#if defined(MBEDTLS_AES_ALT) || defined(MBEDTLS_GCM_ALT)
+#define CRYPTO_BENCH_PATH_GCM       "hw"
+#else
+#define CRYPTO_BENCH_PATH_GCM       "sw"
+#endif
+#if defined(MBEDTLS_ECP_ALT) || defined(MBEDTLS_ECDH_COMPUTE_SHARED_ALT)
+#define CRYPTO_BENCH_PATH_ECDH      "hw"
+#else
+#define CRYPTO_BENCH_PATH_ECDH      "sw"
+#endif
+#if defined(MBEDTLS_ECDSA_SIGN_ALT)
+#define CRYPTO_BENCH_PATH_ECDSA     "hw"
+#else
+#define CRYPTO_BENCH_PATH_ECDSA     "sw"
+#endif
+#if defined(MBEDTLS_RSA_ALT)
+#define CRYPTO_BENCH_PATH_RSA       "hw"
+#else
+#define CRYPTO_BENCH_PATH_RSA       "sw"
+#endif
+
+#define CRYPTO_BENCH_HASH_LEN       (32U)
+#define CRYPTO_BENCH_GCM_IV_LEN     (12U)
+#define CRYPTO_BENCH_GCM_TAG_LEN    (16U)
+#define CRYPTO_BENCH_RSA_BITS       (2048U)
+#define CRYPTO_BENCH_RSA_EXPONENT   (65537)
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+static uint8_t g_bench_in[CRYPTO_BENCH_DATA_LEN];
+static uint8_t g_bench_out[CRYPTO_BENCH_DATA_LEN];
+
+static void crypto_bench_report(const char * p_name, const char * p_path, uint32_t op_bytes, uint32_t iterations,
+                                uint64_t cycles);
+static int crypto_bench_hash(void);
+static int crypto_bench_gcm(uint32_t key_bits);
+static int crypto_bench_ecdh(void);
+static int crypto_bench_ecdsa(void);
+static int crypto_bench_rsa(void);
+
+/*******************************************************************************************************************//**
+ * @brief      Runs every benchmark row and prints the results over RTT. Uses the DRBG of the credential cache, so
+ *             credential_cache_init() must have succeeded.
+ *
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  All rows completed.
+ * @retval     FSP_ERR_ASSERTION            A primitive returned an error, the failing row is printed.
+ **********************************************************************************************************************/
+fsp_err_t crypto_bench_run(void)
+{
+    int mbedtls_err = RESET_VALUE;
+
+    for (uint32_t i = 0; i < CRYPTO_BENCH_DATA_LEN; i++)
+    {
+        g_bench_in[i] = (uint8_t) i;
+    }
+
+    app_timing_init ();
+    APP_PRINT("\r\n%s,algorithm,path,op_bytes,iterations,total_us,ops_per_s,bytes_per_s\r\n", CRYPTO_BENCH_TAG);
+
+    mbedtls_err = crypto_bench_hash ();
+    if (0 == mbedtls_err)
+    {
+        mbedtls_err = crypto_bench_gcm (128U);
+    }
+    if (0 == mbedtls_err)
+    {
+        mbedtls_err = crypto_bench_gcm (256U);
+    }
+    if (0 == mbedtls_err)
+    {
+        mbedtls_err = crypto_bench_ecdh ();
+    }
+    if (0 == mbedtls_err)
+    {
+        mbedtls_err = crypto_bench_ecdsa ();
+    }
+    if (0 == mbedtls_err)
+    {
+        mbedtls_err = crypto_bench_rsa ();
+    }
+
+    APP_PRINT("%s,end\r\n", CRYPTO_BENCH_TAG);
+    if (0 != mbedtls_err)
+    {
+        APP_ERR_PRINT("** Crypto benchmark aborted: -0x%x ** \r\n", -mbedtls_err);
+        return FSP_ERR_ASSERTION;
+    }
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints one result line. Rates are derived from the accumulated cycle count at the current core clock.
+ **********************************************************************************************************************/
+static void crypto_bench_report(const char * p_name, const char * p_path, uint32_t op_bytes, uint32_t iterations,
+                                uint64_t cycles)
+{
+    uint64_t total_us = (cycles * 1000000ULL) / SystemCoreClock;
+    uint64_t ops_per_s = RESET_VALUE;
+    uint64_t bytes_per_s = RESET_VALUE;
+
+    if (0U == total_us)
+    {
+        total_us = 1U;
+    }
+    ops_per_s   = ((uint64_t) iterations * 1000000ULL) / total_us;
+    bytes_per_s = ((uint64_t) iterations * op_bytes * 1000000ULL) / total_us;
+
+    APP_PRINT("%s,%s,%s,%u,%u,%u,%u,%u\r\n", CRYPTO_BENCH_TAG, p_name, p_path, op_bytes, iterations,
+              (uint32_t) total_us, (uint32_t) ops_per_s, (uint32_t) bytes_per_s);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      SHA-256 and SHA-512 over CRYPTO_BENCH_DATA_LEN bytes.
+ **********************************************************************************************************************/
+static int crypto_bench_hash(void)
+{
+    uint64_t cycles = RESET_VALUE;
+    uint32_t start = RESET_VALUE;
+    int mbedtls_err = RESET_VALUE;
+
+    for (uint32_t i = 0; (i < CRYPTO_BENCH_HASH_ITERATIONS) && (0 == mbedtls_err); i++)
+    {
+        start = app_timing_cycles ();
+        mbedtls_err = mbedtls_sha256 (g_bench_in, CRYPTO_BENCH_DATA_LEN, g_bench_out, 0);
+        cycles += app_timing_cycles () - start;
+    }
+    if (0 != mbedtls_err)
+    {
+        return mbedtls_err;
+    }
+    crypto_bench_report ("sha256", CRYPTO_BENCH_PATH_SHA256, CRYPTO_BENCH_DATA_LEN, CRYPTO_BENCH_HASH_ITERATIONS,
+                         cycles);
+
+#if defined(MBEDTLS_SHA512_C)
+    cycles = RESET_VALUE;
+    for (uint32_t i = 0; (i < CRYPTO_BENCH_HASH_ITERATIONS) && (0 == mbedtls_err); i++)
+    {
+        start = app_timing_cycles ();
+        mbedtls_err = mbedtls_sha512 (g_bench_in, CRYPTO_BENCH_DATA_LEN, g_bench_out, 0);
+        cycles += app_timing_cycles () - start;
+    }
+    if (0 != mbedtls_err)
+    {
+        return mbedtls_err;
+    }
+    crypto_bench_report ("sha512", CRYPTO_BENCH_PATH_SHA512, CRYPTO_BENCH_DATA_LEN, CRYPTO_BENCH_HASH_ITERATIONS,
+                         cycles);
+#endif
+    return 0;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      AES-GCM authenticated encryption of CRYPTO_BENCH_DATA_LEN bytes with a 128 or 256 bit key.
+ **********************************************************************************************************************/
+static int crypto_bench_gcm(uint32_t key_bits)
+{
+    mbedtls_gcm_context gcm;
+    uint8_t key[32] = {RESET_VALUE};
+    uint8_t iv[CRYPTO_BENCH_GCM_IV_LEN] = {RESET_VALUE};
+    uint8_t tag[CRYPTO_BENCH_GCM_TAG_LEN];
+    uint64_t cycles = RESET_VALUE;
+    uint32_t start = RESET_VALUE;
+    int mbedtls_err = RESET_VALUE;
+
+    mbedtls_gcm_init (&gcm);
+    mbedtls_err = mbedtls_gcm_setkey (&gcm, MBEDTLS_CIPHER_ID_AES, key, key_bits);
+    for (uint32_t i = 0; (i < CRYPTO_BENCH_AEAD_ITERATIONS) && (0 == mbedtls_err); i++)
+    {
+        iv[0] = (uint8_t) i;
+        start = app_timing_cycles ();
+        mbedtls_err = mbedtls_gcm_crypt_and_tag (&gcm, MBEDTLS_GCM_ENCRYPT, CRYPTO_BENCH_DATA_LEN, iv, sizeof(iv),
+                                                 NULL, 0, g_bench_in, g_bench_out, sizeof(tag), tag);
+        cycles += app_timing_cycles () - start;
+    }
+    mbedtls_gcm_free (&gcm);
+
+    if (0 == mbedtls_err)
+    {
+        crypto_bench_report ((128U == key_bits) ? "aes128_gcm" : "aes256_gcm", CRYPTO_BENCH_PATH_GCM,
+                             CRYPTO_BENCH_DATA_LEN, CRYPTO_BENCH_AEAD_ITERATIONS, cycles);
+    }
+    return mbedtls_err;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      ECDH P-256 as done by a TLS client: ephemeral key generation plus shared secret computation.
+ **********************************************************************************************************************/
+static int crypto_bench_ecdh(void)
+{
+    mbedtls_ecp_group grp;
+    mbedtls_mpi d_peer;
+    mbedtls_mpi d;
+    mbedtls_mpi z;
+    mbedtls_ecp_point q_peer;
+    mbedtls_ecp_point q;
+    uint64_t cycles = RESET_VALUE;
+    uint32_t start = RESET_VALUE;
+    int mbedtls_err = RESET_VALUE;
+
+    mbedtls_ecp_group_init (&grp);
+    mbedtls_mpi_init (&d_peer);
+    mbedtls_mpi_init (&d);
+    mbedtls_mpi_init (&z);
+    mbedtls_ecp_point_init (&q_peer);
+    mbedtls_ecp_point_init (&q);
+
+    mbedtls_err = mbedtls_ecp_group_load (&grp, MBEDTLS_ECP_DP_SECP256R1);
+    if (0 == mbedtls_err)
+    {
+        /* Fixed peer share, as received in a ServerKeyExchange */
+        mbedtls_err = mbedtls_ecdh_gen_public (&grp, &d_peer, &q_peer, mbedtls_ctr_drbg_random,
+                                               credential_cache_rng ());
+    }
+    for (uint32_t i = 0; (i < CRYPTO_BENCH_ECC_ITERATIONS) && (0 == mbedtls_err); i++)
+    {
+        start = app_timing_cycles ();
+        mbedtls_err = mbedtls_ecdh_gen_public (&grp, &d, &q, mbedtls_ctr_drbg_random, credential_cache_rng ());
+        if (0 == mbedtls_err)
+        {
+            mbedtls_err = mbedtls_ecdh_compute_shared (&grp, &z, &q_peer, &d, mbedtls_ctr_drbg_random,
+                                                       credential_cache_rng ());
+        }
+        cycles += app_timing_cycles () - start;
+    }
+
+    mbedtls_ecp_point_free (&q);
+    mbedtls_ecp_point_free (&q_peer);
+    mbedtls_mpi_free (&z);
+    mbedtls_mpi_free (&d);
+    mbedtls_mpi_free (&d_peer);
+    mbedtls_ecp_group_free (&grp);
+
+    if (0 == mbedtls_err)
+    {
+        crypto_bench_report ("ecdh_p256", CRYPTO_BENCH_PATH_ECDH, 0U, CRYPTO_BENCH_ECC_ITERATIONS, cycles);
+    }
+    return mbedtls_err;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      ECDSA P-256 sign and verify of a SHA-256 digest.
+ **********************************************************************************************************************/
+static int crypto_bench_ecdsa(void)
+{
+    mbedtls_ecdsa_context ecdsa;
+    uint8_t sig[MBEDTLS_ECDSA_MAX_LEN];
+    size_t sig_len = RESET_VALUE;
+    uint64_t sign_cycles = RESET_VALUE;
+    uint64_t verify_cycles = RESET_VALUE;
+    uint32_t start = RESET_VALUE;
+    int mbedtls_err = RESET_VALUE;
+
+    mbedtls_ecdsa_init (&ecdsa);
+    mbedtls_err = mbedtls_ecdsa_genkey (&ecdsa, MBEDTLS_ECP_DP_SECP256R1, mbedtls_ctr_drbg_random,
+                                        credential_cache_rng ());
+    for (uint32_t i = 0; (i < CRYPTO_BENCH_ECC_ITERATIONS) && (0 == mbedtls_err); i++)
+    {
+        start = app_timing_cycles ();
+        mbedtls_err = mbedtls_ecdsa_write_signature (&ecdsa, MBEDTLS_MD_SHA256, g_bench_out, CRYPTO_BENCH_HASH_LEN,
+                                                     sig, sizeof(sig), &sig_len, mbedtls_ctr_drbg_random,
+                                                     credential_cache_rng ());
+        sign_cycles += app_timing_cycles () - start;
+        if (0 == mbedtls_err)
+        {
+            start = app_timing_cycles ();
+            mbedtls_err = mbedtls_ecdsa_read_signature (&ecdsa, g_bench_out, CRYPTO_BENCH_HASH_LEN, sig, sig_len);
+            verify_cycles += app_timing_cycles () - start;
+        }
+    }
+    mbedtls_ecdsa_free (&ecdsa);
+
+    if (0 == mbedtls_err)
+    {
+        crypto_bench_report ("ecdsa_p256_sign", CRYPTO_BENCH_PATH_ECDSA, 0U, CRYPTO_BENCH_ECC_ITERATIONS,
+                             sign_cycles);
+        crypto_bench_report ("ecdsa_p256_verify", CRYPTO_BENCH_PATH_ECDSA, 0U, CRYPTO_BENCH_ECC_ITERATIONS,
+                             verify_cycles);
+    }
+    return mbedtls_err;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      RSA-2048 PKCS#1 v1.5 sign and verify of a SHA-256 digest. The key is generated first and its generation
+ *             time is reported as a single operation row.
+ **********************************************************************************************************************/
+static int crypto_bench_rsa(void)
+{
+    mbedtls_rsa_context rsa;
+    uint8_t sig[CRYPTO_BENCH_RSA_BITS / 8U];
+    TickType_t start_tick = RESET_VALUE;
+    uint64_t sign_cycles = RESET_VALUE;
+    uint64_t verify_cycles = RESET_VALUE;
+    uint32_t start = RESET_VALUE;
+    int mbedtls_err = RESET_VALUE;
+
+    mbedtls_rsa_init (&rsa);
+
+    /* Key generation can exceed the 32-bit cycle counter range, time it in ticks */
+    start_tick  = xTaskGetTickCount ();
+    mbedtls_err = mbedtls_rsa_gen_key (&rsa, mbedtls_ctr_drbg_random, credential_cache_rng (), CRYPTO_BENCH_RSA_BITS,
+                                       CRYPTO_BENCH_RSA_EXPONENT);
+    if (0 == mbedtls_err)
+    {
+        crypto_bench_report ("rsa2048_keygen", CRYPTO_BENCH_PATH_RSA, 0U, 1U,
+                             ((uint64_t) (xTaskGetTickCount () - start_tick) * portTICK_PERIOD_MS * SystemCoreClock)
+                             / 1000U);
+    }
+
+    for (uint32_t i = 0; (i < CRYPTO_BENCH_RSA_SIGN_ITERATIONS) && (0 == mbedtls_err); i++)
+    {
+        start = app_timing_cycles ();
+        mbedtls_err = mbedtls_rsa_pkcs1_sign (&rsa, mbedtls_ctr_drbg_random, credential_cache_rng (), MBEDTLS_MD_SHA256,
+                                              CRYPTO_BENCH_HASH_LEN, g_bench_out, sig);
+        sign_cycles += app_timing_cycles () - start;
+    }
+    for (uint32_t i = 0; (i < CRYPTO_BENCH_RSA_VERIFY_ITERATIONS) && (0 == mbedtls_err); i++)
+    {
+        start = app_timing_cycles ();
+        mbedtls_err = mbedtls_rsa_pkcs1_verify (&rsa, MBEDTLS_MD_SHA256, CRYPTO_BENCH_HASH_LEN, g_bench_out, sig);
+        verify_cycles += app_timing_cycles () - start;
+    }
+    mbedtls_rsa_free (&rsa);
+
+    if (0 == mbedtls_err)
+    {
+        crypto_bench_report ("rsa2048_sign", CRYPTO_BENCH_PATH_RSA, 0U, CRYPTO_BENCH_RSA_SIGN_ITERATIONS, sign_cycles);
+        crypto_bench_report ("rsa2048_verify", CRYPTO_BENCH_PATH_RSA, 0U, CRYPTO_BENCH_RSA_VERIFY_ITERATIONS,
+                             verify_cycles);
+    }
+    return mbedtls_err;
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
@@ -0,0 +1,35 @@
+/***********************************************************************************************************************
+ * File Name    : crypto_bench.h
+ * Description  : Contains macros, data structures and functions used by the crypto self-benchmark
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef CRYPTO_BENCH_H_
+#define CRYPTO_BENCH_H_
+
+#include "hal_data.h"
+
+/* Message size for the hash and AEAD rows */
+#define CRYPTO_BENCH_DATA_LEN           (1024U)
+
+/* Operations timed per row */
+#define CRYPTO_BENCH_HASH_ITERATIONS    (256U)
+#define CRYPTO_BENCH_AEAD_ITERATIONS    (256U)
+#define CRYPTO_BENCH_ECC_ITERATIONS     (16U)
+#define CRYPTO_BENCH_RSA_SIGN_ITERATIONS    (4U)
+#define CRYPTO_BENCH_RSA_VERIFY_ITERATIONS  (32U)
+
+/*
+ * Every result is printed as one comma separated line:
+ *   #BENCH,<algorithm>,<hw|sw>,<bytes per op>,<iterations>,<total us>,<ops/s>,<bytes/s>
+ * preceded by a "#BENCH,algorithm,..." header and followed by "#BENCH,end".
+ */
+#define CRYPTO_BENCH_TAG                "#BENCH"
+
+fsp_err_t crypto_bench_run(void);
+
+#endif /* CRYPTO_BENCH_H_ */
@@ -1,4 +1,5 @@
 #include "hal_data.h"
+#include "boot_profile.h"
 
 FSP_CPP_HEADER
 void R_BSP_WarmStart(bsp_warm_start_event_t event);
@@ -28,6 +29,7 @@ void R_BSP_WarmStart(bsp_warm_start_event_t event)
 {
     if (BSP_WARM_START_RESET == event)
     {
+        boot_profile_reset ();
 #if BSP_FEATURE_FLASH_LP_VERSION != 0
 
         /* Enable reading from data flash. */
@@ -38,9 +40,15 @@ void R_BSP_WarmStart(bsp_warm_start_event_t event)
 #endif
     }
 
+    if (BSP_WARM_START_POST_CLOCK == event)
+    {
+        boot_profile_mark_early ("Clocks set up");
+    }
+
     if (BSP_WARM_START_POST_C == event)
     {
         /* C runtime environment and system clocks are setup. */
+        boot_profile_mark_early ("C runtime ready");
 
         /* Configure pins. */
         R_IOPORT_Open (&IOPORT_CFG_CTRL, &IOPORT_CFG_NAME);
@@ -50,6 +58,7 @@ void R_BSP_WarmStart(bsp_warm_start_event_t event)
         /* Setup SDRAM and initialize it. Must configure pins first. */
         R_BSP_SdramInit(true);
 #endif
+        boot_profile_mark_early ("Pins configured");
     }
 }
 
@@ -0,0 +1,479 @@
+/***********************************************************************************************************************
+ * File Name    : heap_trace.c
+ * Description  : This file charges every FreeRTOS heap block and every fixed pool block to the subsystem that
+ *                allocated it: TLS, PKCS#11, TCP or the application. heap_4 calls the hooks of app_freertos_config.h
+ *                with the scheduler suspended, the block is tagged from the tag a wrapper set for the allocation or
+ *                from the calling task and remembered in a small address table, so that the free is charged back to
+ *                the same subsystem. Optionally each event is streamed as a binary record on the RTT metrics channel.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_SYS)
+
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "FreeRTOS_IP.h"
+#include "user_app.h"
+#include "app_timing.h"
+#include "rtt_streams.h"
+#include "heap_trace.h"
+
+#if ((HEAP_TRACE_SLOTS & (HEAP_TRACE_SLOTS - 1U)) != 0U)
+ #error "HEAP_TRACE_SLOTS must be a power of two"
+#endif
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+#define HEAP_TRACE_SIZE_MASK            (0x00FFFFFFUL)
+#define HEAP_TRACE_TAG_SHIFT            (24U)
+#define HEAP_TRACE_OP_SHIFT             (28U)
+#define HEAP_TRACE_SLOT_MASK            (HEAP_TRACE_SLOTS - 1U)
+
+/* Live heap block, free when address is 0 */
+typedef struct st_heap_trace_slot
+{
+    uint32_t address;
+    uint32_t size_tag;                  /* Size in bits 0-23, subsystem in bits 24-27 */
+} heap_trace_slot_t;
+
+typedef struct st_heap_trace_record
+{
+    uint32_t cycles;
+    uint32_t address;
+    uint32_t info;
+} heap_trace_record_t;
+
+/* Everything below is written with the scheduler suspended, no interrupt allocates */
+static heap_trace_slot_t g_slots[HEAP_TRACE_SLOTS];
+static uint32_t g_slots_used = RESET_VALUE;
+static heap_trace_stats_t g_stats[HEAP_TRACE_TAG_COUNT];
+static heap_trace_stats_t g_total;                  /* All subsystems together */
+static size_t g_heap_low = SIZE_MAX;                /* Lowest free FreeRTOS heap since boot or the peak reset */
+static uint32_t g_untracked = RESET_VALUE;          /* Allocations that found the table full, never charged */
+static uint32_t g_unknown_frees = RESET_VALUE;      /* Frees of blocks not in the table */
+
+/* Tag of the allocation a wrapper is making, HEAP_TRACE_TAG_COUNT when none */
+static heap_trace_tag_t g_pending_tag = HEAP_TRACE_TAG_COUNT;
+
+static const char * const g_tag_names[HEAP_TRACE_TAG_COUNT] = {"app", "TLS", "PKCS#11", "TCP"};
+
+static bool g_streaming = false;
+static uint32_t g_records = RESET_VALUE;
+static uint32_t g_dropped = RESET_VALUE;
+
+void heap_trace_on_malloc(void * p_block, size_t size);
+void heap_trace_on_free(void * p_block, size_t size);
+static heap_trace_tag_t heap_trace_caller_tag(void);
+static uint32_t heap_trace_hash(uint32_t address);
+static bool heap_trace_insert(uint32_t address, uint32_t size, heap_trace_tag_t tag);
+static bool heap_trace_remove(uint32_t address, uint32_t * p_size, heap_trace_tag_t * p_tag);
+static void heap_trace_charge(heap_trace_tag_t tag, uint32_t size);
+static void heap_trace_emit(heap_trace_op_t op, heap_trace_tag_t tag, uint32_t address, uint32_t size);
+
+/*******************************************************************************************************************//**
+ * @brief      Starts the cycle counter of the allocation trace. The accounting runs from the first allocation of the
+ *             kernel, before this call.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void heap_trace_init(void)
+{
+#if (HEAP_TRACE_RTT == ENABLE)
+    app_timing_init ();
+#endif
+}
+
+/*******************************************************************************************************************//**
+ * @brief      pvPortMalloc() charged to the given subsystem instead of the calling task's.
+ * @param[in]  tag                          Subsystem.
+ * @param[in]  size                         Bytes.
+ * @retval     Block, NULL when out of memory.
+ **********************************************************************************************************************/
+void * heap_trace_malloc(heap_trace_tag_t tag, size_t size)
+{
+    void * p_block = NULL;
+
+    vTaskSuspendAll ();
+    g_pending_tag = tag;
+    p_block       = pvPortMalloc (size);
+    g_pending_tag = HEAP_TRACE_TAG_COUNT;
+    (void) xTaskResumeAll ();
+    return p_block;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      vPortFree(), the block is charged back to the subsystem that allocated it.
+ * @param[in]  p_block                      Block to free, may be NULL.
+ * @retval     None
+ **********************************************************************************************************************/
+void heap_trace_free(void * p_block)
+{
+    vPortFree (p_block);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Charges a fixed pool block taken or given back by mem_pool.c. Requests and session bounds of the pool
+ *             are only traced, they are what tools/heap_trace.py sizes the pool classes from.
+ * @param[in]  tag                          Subsystem of the pool.
+ * @param[in]  op                           HEAP_TRACE_OP_POOL_TAKE, _GIVE, _REQUEST or HEAP_TRACE_OP_SESSION.
+ * @param[in]  p_block                      Block.
+ * @param[in]  size                         Block size of its class, the requested size or the session bound.
+ * @retval     None
+ **********************************************************************************************************************/
+void heap_trace_pool_event(heap_trace_tag_t tag, heap_trace_op_t op, void * p_block, uint32_t size)
+{
+#if (HEAP_TRACE_ENABLE == ENABLE)
+    heap_trace_stats_t * p_stats = &g_stats[tag];
+
+    vTaskSuspendAll ();
+    if (HEAP_TRACE_OP_POOL_TAKE == op)
+    {
+        p_stats->pooled += size;
+        g_total.pooled  += size;
+        heap_trace_charge (tag, size);
+    }
+    else if (HEAP_TRACE_OP_POOL_GIVE == op)
+    {
+        p_stats->pooled  -= size;
+        p_stats->current -= size;
+        p_stats->frees++;
+        g_total.pooled  -= size;
+        g_total.current -= size;
+        g_total.frees++;
+    }
+    heap_trace_emit (op, tag, (uint32_t) p_block, size);
+    (void) xTaskResumeAll ();
+#else
+    FSP_PARAMETER_NOT_USED(tag);
+    FSP_PARAMETER_NOT_USED(op);
+    FSP_PARAMETER_NOT_USED(p_block);
+    FSP_PARAMETER_NOT_USED(size);
+#endif
+}
+
+/*******************************************************************************************************************//**
+ * @brief      traceMALLOC() of heap_4, called with the scheduler suspended.
+ * @param[in]  p_block                      Block, NULL when the heap is exhausted.
+ * @param[in]  size                         Bytes taken from the heap including the block header.
+ * @retval     None
+ **********************************************************************************************************************/
+void heap_trace_on_malloc(void * p_block, size_t size)
+{
+#if (HEAP_TRACE_ENABLE == ENABLE)
+    heap_trace_tag_t tag = HEAP_TRACE_TAG_APP;
+#endif
+
+    /* heap_4 has taken the block off its free bytes already */
+    g_heap_low = (xPortGetFreeHeapSize () < g_heap_low) ? xPortGetFreeHeapSize () : g_heap_low;
+#if (HEAP_TRACE_ENABLE == ENABLE)
+    tag = heap_trace_caller_tag ();
+    if (NULL == p_block)
+    {
+        g_stats[tag].failed++;
+        g_total.failed++;
+        heap_trace_emit (HEAP_TRACE_OP_FAILED, tag, 0U, (uint32_t) size);
+        return;
+    }
+    if (!heap_trace_insert ((uint32_t) p_block, (uint32_t) size, tag))
+    {
+        g_untracked++;
+        return;
+    }
+    heap_trace_charge (tag, (uint32_t) size);
+    heap_trace_emit (HEAP_TRACE_OP_MALLOC, tag, (uint32_t) p_block, (uint32_t) size);
+#else
+    FSP_PARAMETER_NOT_USED(p_block);
+    FSP_PARAMETER_NOT_USED(size);
+#endif
+}
+
+/*******************************************************************************************************************//**
+ * @brief      traceFREE() of heap_4, called with the scheduler suspended. The size charged at allocation is used,
+ *             heap_4 may hand out a block slightly larger than the size it traced.
+ * @param[in]  p_block                      Block.
+ * @param[in]  size                         Block size, unused.
+ * @retval     None
+ **********************************************************************************************************************/
+void heap_trace_on_free(void * p_block, size_t size)
+{
+#if (HEAP_TRACE_ENABLE == ENABLE)
+    uint32_t charged = RESET_VALUE;
+    heap_trace_tag_t tag = HEAP_TRACE_TAG_APP;
+
+    FSP_PARAMETER_NOT_USED(size);
+    if (!heap_trace_remove ((uint32_t) p_block, &charged, &tag))
+    {
+        g_unknown_frees++;
+        return;
+    }
+    g_stats[tag].current -= charged;
+    g_stats[tag].frees++;
+    g_total.current -= charged;
+    g_total.frees++;
+    heap_trace_emit (HEAP_TRACE_OP_FREE, tag, (uint32_t) p_block, charged);
+#else
+    FSP_PARAMETER_NOT_USED(p_block);
+    FSP_PARAMETER_NOT_USED(size);
+#endif
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns a consistent copy of the counters of a subsystem.
+ * @param[in]  tag                          Subsystem.
+ * @param[out] p_stats                      Counters.
+ * @retval     None
+ **********************************************************************************************************************/
+void heap_trace_get_stats(heap_trace_tag_t tag, heap_trace_stats_t * p_stats)
+{
+    vTaskSuspendAll ();
+    *p_stats = g_stats[tag];
+    (void) xTaskResumeAll ();
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns a consistent copy of the counters of all subsystems together. Its peak is the highest sum of the
+ *             bytes held, not the sum of the peaks of the subsystems.
+ * @param[out] p_stats                      Counters.
+ * @retval     None
+ **********************************************************************************************************************/
+void heap_trace_get_total(heap_trace_stats_t * p_stats)
+{
+    vTaskSuspendAll ();
+    *p_stats = g_total;
+    (void) xTaskResumeAll ();
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Restarts the peaks and the lowest free heap at the bytes held now, to measure the peak of one operation
+ *             such as a handshake.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void heap_trace_reset_peaks(void)
+{
+    vTaskSuspendAll ();
+    for (uint32_t i = 0; i < HEAP_TRACE_TAG_COUNT; i++)
+    {
+        g_stats[i].peak = g_stats[i].current;
+    }
+    g_total.peak = g_total.current;
+    g_heap_low   = xPortGetFreeHeapSize ();
+    (void) xTaskResumeAll ();
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns the lowest free FreeRTOS heap since boot or heap_trace_reset_peaks(). Unlike
+ *             xPortGetMinimumEverFreeHeapSize() it covers one operation, and it counts every block, tracked or not.
+ * @param[in]  None
+ * @retval     Bytes.
+ **********************************************************************************************************************/
+size_t heap_trace_heap_low(void)
+{
+    size_t low = RESET_VALUE;
+
+    vTaskSuspendAll ();
+    low = (SIZE_MAX != g_heap_low) ? g_heap_low : xPortGetFreeHeapSize ();
+    (void) xTaskResumeAll ();
+    return low;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Starts or stops the allocation trace on the RTT channel. A start record carries the core clock.
+ * @param[in]  on                           true to start.
+ * @retval     FSP_SUCCESS                  Trace started or stopped.
+ * @retval     FSP_ERR_UNSUPPORTED          HEAP_TRACE_RTT or HEAP_TRACE_ENABLE is disabled.
+ **********************************************************************************************************************/
+fsp_err_t heap_trace_stream(bool on)
+{
+#if (HEAP_TRACE_RTT == ENABLE) && (HEAP_TRACE_ENABLE == ENABLE)
+    vTaskSuspendAll ();
+    g_streaming = on;
+    heap_trace_emit (HEAP_TRACE_OP_START, HEAP_TRACE_TAG_APP, SystemCoreClock, 0U);
+    (void) xTaskResumeAll ();
+    return FSP_SUCCESS;
+#else
+    FSP_PARAMETER_NOT_USED(on);
+    return FSP_ERR_UNSUPPORTED;
+#endif
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints the bytes held per subsystem and the counters of the address table and the trace.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void heap_trace_print_stats(void)
+{
+#if (HEAP_TRACE_ENABLE == ENABLE)
+    heap_trace_stats_t stats;
+
+    APP_PRINT("\r\nHeap by subsystem (bytes, heap block headers and pool blocks included):\r\n");
+    APP_PRINT("\t\t current     peak   pooled   allocs    frees failed\r\n");
+    for (uint32_t i = 0; i < HEAP_TRACE_TAG_COUNT; i++)
+    {
+        heap_trace_get_stats ((heap_trace_tag_t) i, &stats);
+        APP_PRINT("\t%s\t%8u %8u %8u %8u %8u %6u\r\n", g_tag_names[i], stats.current, stats.peak, stats.pooled,
+                  stats.allocs, stats.frees, stats.failed);
+    }
+    heap_trace_get_total (&stats);
+    APP_PRINT("\tall\t%8u %8u %8u %8u %8u %6u\r\n", stats.current, stats.peak, stats.pooled, stats.allocs, stats.frees,
+              stats.failed);
+    APP_PRINT("\t%u of %u table slots used, %u allocations untracked, %u frees of unknown blocks\r\n", g_slots_used,
+              HEAP_TRACE_SLOTS_MAX, g_untracked, g_unknown_frees);
+    APP_PRINT("\tTrace on RTT channel %u %s: %u records, %u dropped\r\n", RTT_STREAM_METRICS,
+              g_streaming ? "on" : "off", g_records, g_dropped);
+#else
+    APP_PRINT("\r\nHeap accounting disabled (HEAP_TRACE_ENABLE)\r\n");
+#endif
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Subsystem of an allocation in progress: the tag of a wrapper, else the IP task is TCP and any other task
+ *             the application.
+ **********************************************************************************************************************/
+static heap_trace_tag_t heap_trace_caller_tag(void)
+{
+    TaskHandle_t ip_task = FreeRTOS_GetIPTaskHandle ();
+
+    if (HEAP_TRACE_TAG_COUNT != g_pending_tag)
+    {
+        return g_pending_tag;
+    }
+    if ((NULL != ip_task) && (xTaskGetCurrentTaskHandle () == ip_task))
+    {
+        return HEAP_TRACE_TAG_TCP;
+    }
+    return HEAP_TRACE_TAG_APP;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Home slot of a block address, Fibonacci hashing of the 8 byte aligned address.
+ **********************************************************************************************************************/
+static uint32_t heap_trace_hash(uint32_t address)
+{
+    return ((address >> 3) * 2654435761UL) & HEAP_TRACE_SLOT_MASK;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Remembers a live block, linear probing from its home slot.
+ * @retval     false when the table is full.
+ **********************************************************************************************************************/
+static bool heap_trace_insert(uint32_t address, uint32_t size, heap_trace_tag_t tag)
+{
+    uint32_t i = heap_trace_hash (address);
+
+    if (g_slots_used >= HEAP_TRACE_SLOTS_MAX)
+    {
+        return false;
+    }
+    while (0U != g_slots[i].address)
+    {
+        i = (i + 1U) & HEAP_TRACE_SLOT_MASK;
+    }
+    g_slots[i].address  = address;
+    g_slots[i].size_tag = (size & HEAP_TRACE_SIZE_MASK) | ((uint32_t) tag << HEAP_TRACE_TAG_SHIFT);
+    g_slots_used++;
+    return true;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Forgets a block. The blocks probed past its slot are shifted back, so lookups never need tombstones.
+ * @retval     false when the block is not in the table.
+ **********************************************************************************************************************/
+static bool heap_trace_remove(uint32_t address, uint32_t * p_size, heap_trace_tag_t * p_tag)
+{
+    uint32_t i = heap_trace_hash (address);
+    uint32_t j = RESET_VALUE;
+
+    while (address != g_slots[i].address)
+    {
+        if (0U == g_slots[i].address)
+        {
+            return false;
+        }
+        i = (i + 1U) & HEAP_TRACE_SLOT_MASK;
+    }
+    *p_size = g_slots[i].size_tag & HEAP_TRACE_SIZE_MASK;
+    *p_tag  = (heap_trace_tag_t) (g_slots[i].size_tag >> HEAP_TRACE_TAG_SHIFT);
+
+    j = i;
+    for (;;)
+    {
+        j = (j + 1U) & HEAP_TRACE_SLOT_MASK;
+        if (0U == g_slots[j].address)
+        {
+            break;
+        }
+
+        /* The block in j may fill the hole in i unless its home slot lies after i */
+        if (((j - heap_trace_hash (g_slots[j].address)) & HEAP_TRACE_SLOT_MASK) >= ((j - i) & HEAP_TRACE_SLOT_MASK))
+        {
+            g_slots[i] = g_slots[j];
+            i          = j;
+        }
+    }
+    g_slots[i].address = 0U;
+    g_slots_used--;
+    return true;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Charges an allocation to a subsystem.
+ **********************************************************************************************************************/
+static void heap_trace_charge(heap_trace_tag_t tag, uint32_t size)
+{
+    heap_trace_stats_t * p_stats = &g_stats[tag];
+
+    p_stats->allocs++;
+    p_stats->current += size;
+    p_stats->peak     = (p_stats->current > p_stats->peak) ? p_stats->current : p_stats->peak;
+    g_total.allocs++;
+    g_total.current += size;
+    g_total.peak     = (g_total.current > g_total.peak) ? g_total.current : g_total.peak;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Writes one trace record to the metrics channel, whole or not at all.
+ **********************************************************************************************************************/
+static void heap_trace_emit(heap_trace_op_t op, heap_trace_tag_t tag, uint32_t address, uint32_t size)
+{
+#if (HEAP_TRACE_RTT == ENABLE)
+    heap_trace_record_t record;
+
+    if (!g_streaming)
+    {
+        return;
+    }
+    record.cycles  = app_timing_cycles ();
+    record.address = address;
+    record.info    = (size & HEAP_TRACE_SIZE_MASK) | ((uint32_t) tag << HEAP_TRACE_TAG_SHIFT) |
+                     ((uint32_t) op << HEAP_TRACE_OP_SHIFT);
+    if (0U != rtt_stream_metric (RTT_METRIC_HEAP_TRACE, &record, sizeof(record)))
+    {
+        g_records++;
+    }
+    else
+    {
+        g_dropped++;
+    }
+#else
+    FSP_PARAMETER_NOT_USED(op);
+    FSP_PARAMETER_NOT_USED(tag);
+    FSP_PARAMETER_NOT_USED(address);
+    FSP_PARAMETER_NOT_USED(size);
+#endif
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
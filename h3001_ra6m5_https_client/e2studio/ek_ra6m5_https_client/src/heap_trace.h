@@ -0,0 +1,74 @@
+/***********************************************************************************************************************
+ * File Name    : heap_trace.h
+ * Description  : Contains macros, data structures and functions used by the per subsystem heap accounting and the
+ *                allocation trace
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef HEAP_TRACE_H_
+#define HEAP_TRACE_H_
+
+#include "hal_data.h"
+
+/*
+ * Live heap blocks remembered with their subsystem and size, so that a free is charged to the subsystem that made the
+ * allocation. Power of two. Blocks beyond HEAP_TRACE_SLOTS_MAX are counted as untracked: raise the slots when the
+ * "mem" command shows any.
+ */
+#define HEAP_TRACE_SLOTS                (256U)
+#define HEAP_TRACE_SLOTS_MAX            ((HEAP_TRACE_SLOTS * 7U) / 8U)
+
+/*
+ * Allocation trace, RTT_METRIC_HEAP_TRACE records of the RTT metrics channel started with "mem trace on". Payload of
+ * 3 little endian words: DWT cycles, block address, then size (bits 0-23), subsystem (bits 24-27) and operation (bits
+ * 28-31). The first record of a trace is HEAP_TRACE_OP_START with the core clock in the address word. A record that
+ * does not fit the channel buffer is dropped and counted. Decode with tools/heap_trace.py.
+ */
+
+typedef enum e_heap_trace_tag
+{
+    HEAP_TRACE_TAG_APP = 0,             /* Application tasks, kernel objects and everything not tagged otherwise */
+    HEAP_TRACE_TAG_TLS,                 /* mbedTLS */
+    HEAP_TRACE_TAG_PKCS11,              /* PKCS#11 module */
+    HEAP_TRACE_TAG_TCP,                 /* Allocations of the FreeRTOS+TCP IP task */
+    HEAP_TRACE_TAG_COUNT
+} heap_trace_tag_t;
+
+typedef enum e_heap_trace_op
+{
+    HEAP_TRACE_OP_MALLOC = 0,
+    HEAP_TRACE_OP_FREE,
+    HEAP_TRACE_OP_FAILED,               /* Heap exhausted, the size is the one requested */
+    HEAP_TRACE_OP_POOL_TAKE,            /* Fixed block pool of mem_pool.c, the size is the block size */
+    HEAP_TRACE_OP_POOL_GIVE,
+    HEAP_TRACE_OP_POOL_REQUEST,         /* Size a pool allocation asked for, at the block it got from pool or heap */
+    HEAP_TRACE_OP_SESSION,              /* TLS session of mem_pool.c begins (size 1) or ends (size 0) */
+    HEAP_TRACE_OP_START = 15
+} heap_trace_op_t;
+
+typedef struct st_heap_trace_stats
+{
+    uint32_t current;                   /* Bytes held, heap blocks including their header plus pool blocks */
+    uint32_t peak;                      /* Highest current since boot or heap_trace_reset_peaks() */
+    uint32_t pooled;                    /* Part of current held in pool blocks */
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t failed;
+} heap_trace_stats_t;
+
+void heap_trace_init(void);
+void * heap_trace_malloc(heap_trace_tag_t tag, size_t size);
+void heap_trace_free(void * p_block);
+void heap_trace_pool_event(heap_trace_tag_t tag, heap_trace_op_t op, void * p_block, uint32_t size);
+void heap_trace_get_stats(heap_trace_tag_t tag, heap_trace_stats_t * p_stats);
+void heap_trace_get_total(heap_trace_stats_t * p_stats);
+void heap_trace_reset_peaks(void);
+size_t heap_trace_heap_low(void);
+fsp_err_t heap_trace_stream(bool on);
+void heap_trace_print_stats(void);
+
+#endif /* HEAP_TRACE_H_ */
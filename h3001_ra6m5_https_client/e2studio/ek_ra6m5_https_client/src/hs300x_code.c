@@ -5,11 +5,27 @@
  *      Author: ikanari
  */
 #include "hs300x_code.h"
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+/*Last i2c event, set by the callback*/
+static volatile i2c_master_event_t i2c_event = 0;
+
+/*Given by the callback, the calling task sleeps on it instead of polling i2c_event*/
+static SemaphoreHandle_t i2c_done = NULL;
+static StaticSemaphore_t i2c_done_mem;
+
+static fsp_err_t i2c_waitEvent(i2c_master_event_t expected);
 
 /*Function to init I2C and set slave address*/
 fsp_err_t i2c_masterInit(uint8_t slaveAddress)
 {
     fsp_err_t initErr = FSP_SUCCESS;
+    if (i2c_done == NULL)
+    {
+        i2c_done = xSemaphoreCreateBinaryStatic (&i2c_done_mem);
+    }
+
     //Open I2C Module
     initErr = R_IIC_MASTER_Open (&g_i2c_master1_ctrl, &g_i2c_master1_cfg);
     if(initErr != FSP_SUCCESS)
@@ -43,27 +59,14 @@ fsp_err_t i2c_masterWrite(uint8_t len, uint8_t txdata[len])
 {
     fsp_err_t writeErr = FSP_SUCCESS;
     i2c_event = 0;
+    (void) xSemaphoreTake (i2c_done, 0);
 
     writeErr =  R_IIC_MASTER_Write(&g_i2c_master1_ctrl, txdata, len, false);
     if (writeErr != FSP_SUCCESS) {
         i2_masterDeinit();
         return writeErr;
     }
-    uint32_t timeout = 1000;
-    while ((i2c_event == 0) && timeout--) {
-        R_BSP_SoftwareDelay(1, BSP_DELAY_UNITS_MILLISECONDS);
-    }
-
-    if (i2c_event == 0) {
-        i2_masterDeinit();
-        return FSP_ERR_TIMEOUT;
-    }
-
-    if (i2c_event != I2C_MASTER_EVENT_TX_COMPLETE) {
-        i2_masterDeinit();
-        return FSP_ERR_ABORTED;
-    }
-    return writeErr;
+    return i2c_waitEvent (I2C_MASTER_EVENT_TX_COMPLETE);
 }
 
 /*I2C master read function*/
@@ -72,28 +75,29 @@ fsp_err_t i2c_masterRead(uint8_t len, uint8_t rxdata[len])
     fsp_err_t readErr = FSP_SUCCESS;
 
     i2c_event = 0;
+    (void) xSemaphoreTake (i2c_done, 0);
     readErr = R_IIC_MASTER_Read(&g_i2c_master1_ctrl, rxdata,len, false);
     if (readErr != FSP_SUCCESS) {
         i2_masterDeinit();
         return readErr;
     }
 
-    uint32_t timeout = 1000;
-    while ((i2c_event == 0) && timeout--) {
-        R_BSP_SoftwareDelay(1, BSP_DELAY_UNITS_MILLISECONDS);
-    }
+    return i2c_waitEvent (I2C_MASTER_EVENT_RX_COMPLETE);
+}
 
-    if (i2c_event == 0) {
+/*Sleep until the callback reports the end of the transfer, the bus is closed on timeout or abort*/
+static fsp_err_t i2c_waitEvent(i2c_master_event_t expected)
+{
+    if (xSemaphoreTake (i2c_done, pdMS_TO_TICKS(HS3001_I2C_TIMEOUT_MS)) != pdTRUE) {
         i2_masterDeinit();
         return FSP_ERR_TIMEOUT;
     }
 
-    if (i2c_event != I2C_MASTER_EVENT_RX_COMPLETE) {
+    if (i2c_event != expected) {
         i2_masterDeinit();
         return FSP_ERR_ABORTED;
     }
-
-    return readErr;
+    return FSP_SUCCESS;
 }
 
 
@@ -149,8 +153,14 @@ void calculateData ( struct sensor_data * hs3001_data, struct hs3001_raw_data *
 /* Callback function */
 void g_i2c_master1_cb(i2c_master_callback_args_t *p_args)
 {
-    /* TODO: add your own code here */
+    BaseType_t woken = pdFALSE;
+
     i2c_event = p_args->event;
+    if (i2c_done != NULL)
+    {
+        (void) xSemaphoreGiveFromISR (i2c_done, &woken);
+    }
+    portYIELD_FROM_ISR(woken);
 }
 
 
@@ -11,9 +11,11 @@
 /*Command to start measurement*/
 #define HS3001_START_MEASUREMENT_CMD  0x00
 
+/*Conversion time of a measurement, the task sleeps meanwhile*/
+#define HS3001_MEASUREMENT_MS         (40U)
 
-/*Check i2c event*/
-static i2c_master_event_t i2c_event = 0;
+/*Time allowed for an I2C transfer, the task sleeps until the callback*/
+#define HS3001_I2C_TIMEOUT_MS         (1000U)
 
 struct hs3001_raw_data{
     uint8_t humidity[2];
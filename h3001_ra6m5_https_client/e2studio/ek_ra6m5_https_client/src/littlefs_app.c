@@ -8,16 +8,43 @@
 * SPDX-License-Identifier: BSD-3-Clause
 ***********************************************************************************************************************/
 
+#define APP_LOG_MODULE                  (APP_LOG_MOD_FS)
+
 #include "common_utils.h"
+#include "app_timing.h"
 #include "littlefs_app.h"
+#include "littlefs_maint.h"
 
 /*******************************************************************************************************************//**
  * @addtogroup aws_https_client_ep
  * @{
  **********************************************************************************************************************/
 
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+static littlefs_app_sb_t g_app_sb;
+static uint32_t g_boot_count = RESET_VALUE;
+
+/* Block erases issued by LittleFS since boot, counted by wrapping the erase callback of the port */
+static int (* gp_port_erase)(const struct lfs_config * c, lfs_block_t block) = NULL;
+static uint32_t g_erase_count = RESET_VALUE;
+
+/* Free blocks erased ahead of time by hal_littlefs_pre_erase(), LittleFS then skips their erase on allocation */
+static uint32_t g_pre_erased[(LITTLEFS_APP_MAX_BLOCKS + 31U) / 32U];
+static uint32_t g_in_use[(LITTLEFS_APP_MAX_BLOCKS + 31U) / 32U];
+static uint32_t g_erase_skipped = RESET_VALUE;
+
+static int littlefs_counting_erase(const struct lfs_config * c, lfs_block_t block);
+static int littlefs_mark_in_use(void * p_data, lfs_block_t block);
+
+static fsp_err_t littlefs_format_and_mount(void);
+static fsp_err_t littlefs_app_sb_check(void);
+static void littlefs_app_boot_count(void);
+
 /*******************************************************************************************************************//**
- * @brief      Initializes the Littlefs module by opening, formating and mounting
+ * @brief      Initializes the Littlefs module by opening and mounting, formatting only when no valid file system or
+ *             application superblock is found
  *
  * @param[in]  None
  * @retval     FSP_SUCCESS                  Upon successful LittlefS Initialization.
@@ -32,6 +59,12 @@ fsp_err_t hal_littlefs_init(void)
         APP_ERR_PRINT("** Failed in RM_LITTLEFS_FLASH_Open API ** \r\n");
         return err;
     }
+    if (NULL == gp_port_erase)
+    {
+        gp_port_erase                 = g_rm_littlefs0_lfs_cfg.erase;
+        g_rm_littlefs0_lfs_cfg.erase = littlefs_counting_erase;
+    }
+
     /* configure littlfs flash */
     err = configure_littlefs_flash();
     if (FSP_SUCCESS != err)
@@ -41,29 +74,295 @@ fsp_err_t hal_littlefs_init(void)
         return err;
     }
 
-    APP_PRINT("\r\nLittleFS flash module initialization successful");
+    APP_INFO_PRINT("\r\nLittleFS flash module initialization successful");
     return err;
 }
 
+/*******************************************************************************************************************//**
+ * @brief      Mounts the existing file system so that data persists across resets. Formatting is the recovery path for
+ *             a blank or corrupted data flash and for an application superblock of another magic or layout version,
+ *             never for a write error: a full or failing volume is kept with its data.
+ *
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  Upon successful mount.
+ * @retval     Any other Error Code         Upon unsuccessful mount and recovery.
+ **********************************************************************************************************************/
 fsp_err_t configure_littlefs_flash(void)
 {
+    int lfs_err = LFS_ERR_OK;
+    uint32_t start = RESET_VALUE;
     fsp_err_t err = FSP_SUCCESS;
-    err = lfs_format (&g_rm_littlefs0_lfs, &g_rm_littlefs0_lfs_cfg);
+
+    app_timing_init ();
+    start   = app_timing_cycles ();
+    lfs_err = lfs_mount (&g_rm_littlefs0_lfs, &g_rm_littlefs0_lfs_cfg);
+    if (LFS_ERR_OK != lfs_err)
+    {
+        APP_WARN_PRINT("\r\nNo valid LittleFS found (%d), formatting data flash\r\n", lfs_err);
+        return littlefs_format_and_mount ();
+    }
+
+    err = littlefs_app_sb_check ();
+    if (FSP_ERR_INVALID_DATA == err)
+    {
+        APP_WARN_PRINT("\r\nApplication data layout changed, formatting data flash\r\n");
+        (void) lfs_unmount (&g_rm_littlefs0_lfs);
+        return littlefs_format_and_mount ();
+    }
     if (FSP_SUCCESS != err)
+    {
+        /* Checked again on the next boot, the files stay as they are */
+        APP_ERR_PRINT("** Application superblock not readable or not written (%d), data flash kept ** \r\n", err);
+    }
+    littlefs_app_boot_count ();
+
+    APP_INFO_PRINT("\r\nLittleFS mounted in %d us, boot %d\r\n", APP_TIMING_CYCLES_TO_US(app_timing_cycles () - start),
+                   g_boot_count);
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns the number of boots since the last format, 0 when this boot could not be recorded: its samples
+ *             then stay undated rather than share the number of another boot.
+ **********************************************************************************************************************/
+uint32_t hal_littlefs_boot_count(void)
+{
+    return g_boot_count;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns the number of data flash block erases issued by LittleFS since boot.
+ **********************************************************************************************************************/
+uint32_t hal_littlefs_erase_count(void)
+{
+    return g_erase_count;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns the number of erases LittleFS asked for on blocks that were already erased by
+ *             hal_littlefs_pre_erase().
+ **********************************************************************************************************************/
+uint32_t hal_littlefs_erase_skipped(void)
+{
+    return g_erase_skipped;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Erases up to max_blocks free blocks so that later allocations do not wait for the flash. The free blocks
+ *             are found by a traversal without the lock held; the erases only happen when LittleFS did not allocate a
+ *             block in the meantime, since every allocation goes through the erase callback. Needs LittleFS built
+ *             with Thread Safe, the lock is held for the erases.
+ * @param[in]  max_blocks                   Erases per call, bounds the time other tasks wait for the lock.
+ * @retval     Number of blocks erased.
+ **********************************************************************************************************************/
+uint32_t hal_littlefs_pre_erase(uint32_t max_blocks)
+{
+    uint32_t erased = RESET_VALUE;
+#ifdef LFS_THREADSAFE
+    uint32_t calls = g_erase_count + g_erase_skipped;
+    lfs_block_t block_count = g_rm_littlefs0_lfs_cfg.block_count;
+
+    block_count = (block_count < LITTLEFS_APP_MAX_BLOCKS) ? block_count : LITTLEFS_APP_MAX_BLOCKS;
+    memset (g_in_use, RESET_VALUE, sizeof(g_in_use));
+    if (LFS_ERR_OK != lfs_fs_traverse (&g_rm_littlefs0_lfs, littlefs_mark_in_use, NULL))
+    {
+        return RESET_VALUE;
+    }
+
+    (void) g_rm_littlefs0_lfs_cfg.lock (&g_rm_littlefs0_lfs_cfg);
+    if (calls == (g_erase_count + g_erase_skipped))
+    {
+        for (lfs_block_t block = 0; (block < block_count) && (erased < max_blocks); block++)
+        {
+            uint32_t bit = 1UL << (block % 32U);
+
+            if ((0U != (g_in_use[block / 32U] & bit)) || (0U != (g_pre_erased[block / 32U] & bit)))
+            {
+                continue;
+            }
+            if (LFS_ERR_OK == gp_port_erase (&g_rm_littlefs0_lfs_cfg, block))
+            {
+                g_pre_erased[block / 32U] |= bit;
+                erased++;
+            }
+        }
+    }
+    (void) g_rm_littlefs0_lfs_cfg.unlock (&g_rm_littlefs0_lfs_cfg);
+#else
+    FSP_PARAMETER_NOT_USED(max_blocks);
+#endif
+    return erased;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Forgets the pre-erased blocks, LittleFS erases them again on allocation. Used for baseline measurements.
+ **********************************************************************************************************************/
+void hal_littlefs_pre_erase_reset(void)
+{
+#ifdef LFS_THREADSAFE
+    (void) g_rm_littlefs0_lfs_cfg.lock (&g_rm_littlefs0_lfs_cfg);
+#endif
+    memset (g_pre_erased, RESET_VALUE, sizeof(g_pre_erased));
+#ifdef LFS_THREADSAFE
+    (void) g_rm_littlefs0_lfs_cfg.unlock (&g_rm_littlefs0_lfs_cfg);
+#endif
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Erase callback installed in g_rm_littlefs0_lfs_cfg, counts the erase and calls the port. A block erased
+ *             by hal_littlefs_pre_erase() and not used since is still blank and is handed out without waiting.
+ **********************************************************************************************************************/
+static int littlefs_counting_erase(const struct lfs_config * c, lfs_block_t block)
+{
+    /* One block less erased ahead, or a writer waited for an erase: either way a pass is due */
+    littlefs_maint_kick ();
+    if ((block < LITTLEFS_APP_MAX_BLOCKS) && (0U != (g_pre_erased[block / 32U] & (1UL << (block % 32U)))))
+    {
+        g_pre_erased[block / 32U] &= ~(1UL << (block % 32U));
+        g_erase_skipped++;
+        return LFS_ERR_OK;
+    }
+    g_erase_count++;
+    return gp_port_erase (c, block);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      lfs_fs_traverse() callback, marks a block that belongs to the file system.
+ **********************************************************************************************************************/
+static int littlefs_mark_in_use(void * p_data, lfs_block_t block)
+{
+    FSP_PARAMETER_NOT_USED(p_data);
+    if (block < LITTLEFS_APP_MAX_BLOCKS)
+    {
+        g_in_use[block / 32U] |= 1UL << (block % 32U);
+    }
+    return LFS_ERR_OK;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Recovery path: formats the data flash, mounts it and writes a fresh application superblock.
+ **********************************************************************************************************************/
+static fsp_err_t littlefs_format_and_mount(void)
+{
+    int lfs_err = LFS_ERR_OK;
+    uint32_t start = app_timing_cycles ();
+
+    lfs_err = lfs_format (&g_rm_littlefs0_lfs, &g_rm_littlefs0_lfs_cfg);
+    if (LFS_ERR_OK != lfs_err)
     {
         APP_ERR_PRINT("** Failed in lfs_format API ** \r\n");
-        hal_littlefs_deinit();
-        return err;
+        return FSP_ERR_WRITE_FAILED;
     }
 
-    err = lfs_mount (&g_rm_littlefs0_lfs, &g_rm_littlefs0_lfs_cfg);
-    if (FSP_SUCCESS != err)
+    lfs_err = lfs_mount (&g_rm_littlefs0_lfs, &g_rm_littlefs0_lfs_cfg);
+    if (LFS_ERR_OK != lfs_err)
     {
         APP_ERR_PRINT("** Failed in lfs_mount API ** \r\n");
-        hal_littlefs_deinit();
-        return err;
+        return FSP_ERR_NOT_OPEN;
+    }
+
+    if (FSP_SUCCESS != littlefs_app_sb_check ())
+    {
+        (void) lfs_unmount (&g_rm_littlefs0_lfs);
+        return FSP_ERR_WRITE_FAILED;
+    }
+    littlefs_app_boot_count ();
+
+    APP_INFO_PRINT("\r\nLittleFS formatted and mounted in %d us\r\n",
+                   APP_TIMING_CYCLES_TO_US(app_timing_cycles () - start));
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Reads the application superblock, which is only written when missing: on the first boot after a format
+ *             or the first boot of a volume from before the superblock.
+ * @retval     FSP_SUCCESS when the superblock is of this layout, FSP_ERR_INVALID_DATA for another magic or layout
+ *             version, FSP_ERR_NOT_OPEN, FSP_ERR_READ_FAILED or FSP_ERR_WRITE_FAILED when LittleFS failed.
+ **********************************************************************************************************************/
+static fsp_err_t littlefs_app_sb_check(void)
+{
+    lfs_file_t file;
+    lfs_ssize_t len = RESET_VALUE;
+    int lfs_err = LFS_ERR_OK;
+
+    lfs_err = lfs_file_open (&g_rm_littlefs0_lfs, &file, LITTLEFS_APP_SB_FILE_NAME, LFS_O_RDONLY);
+    if (LFS_ERR_OK == lfs_err)
+    {
+        len = lfs_file_read (&g_rm_littlefs0_lfs, &file, &g_app_sb, sizeof(g_app_sb));
+        (void) lfs_file_close (&g_rm_littlefs0_lfs, &file);
+        if (len < 0)
+        {
+            return FSP_ERR_READ_FAILED;
+        }
+        if (0 != len)
+        {
+            return (((lfs_ssize_t) sizeof(g_app_sb) == len) && (LITTLEFS_APP_SB_MAGIC == g_app_sb.magic)
+                    && (LITTLEFS_APP_LAYOUT_VERSION == g_app_sb.layout_version)) ? FSP_SUCCESS : FSP_ERR_INVALID_DATA;
+        }
+    }
+    else if (LFS_ERR_NOENT != lfs_err)
+    {
+        APP_ERR_PRINT("** Failed to open %s: %d ** \r\n", LITTLEFS_APP_SB_FILE_NAME, lfs_err);
+        return FSP_ERR_NOT_OPEN;
+    }
+    else
+    {
+        /* No superblock yet */
+    }
+
+    g_app_sb.magic           = LITTLEFS_APP_SB_MAGIC;
+    g_app_sb.layout_version  = LITTLEFS_APP_LAYOUT_VERSION;
+    g_app_sb.boot_count_base = RESET_VALUE;
+    lfs_err = lfs_file_open (&g_rm_littlefs0_lfs, &file, LITTLEFS_APP_SB_FILE_NAME,
+                             LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+    if (LFS_ERR_OK != lfs_err)
+    {
+        return FSP_ERR_WRITE_FAILED;
+    }
+    len     = lfs_file_write (&g_rm_littlefs0_lfs, &file, &g_app_sb, sizeof(g_app_sb));
+    lfs_err = lfs_file_close (&g_rm_littlefs0_lfs, &file);
+
+    return (((lfs_ssize_t) sizeof(g_app_sb) == len) && (LFS_ERR_OK == lfs_err)) ? FSP_SUCCESS : FSP_ERR_WRITE_FAILED;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Counts this boot in its own file. Without the file the count goes on from the superblock, where the
+ *             application before this file counted. A boot that cannot be recorded is boot 0, so the next boot still
+ *             gets a number no earlier boot had.
+ **********************************************************************************************************************/
+static void littlefs_app_boot_count(void)
+{
+    lfs_file_t file;
+    uint32_t count = g_app_sb.boot_count_base;
+    lfs_ssize_t len = RESET_VALUE;
+    int lfs_err = LFS_ERR_OK;
+
+    g_boot_count = RESET_VALUE;
+    lfs_err      = lfs_file_open (&g_rm_littlefs0_lfs, &file, LITTLEFS_APP_BOOT_FILE_NAME, LFS_O_RDWR | LFS_O_CREAT);
+    if (LFS_ERR_OK != lfs_err)
+    {
+        APP_ERR_PRINT("** Failed to open %s: %d, boot not counted ** \r\n", LITTLEFS_APP_BOOT_FILE_NAME, lfs_err);
+        return;
+    }
+
+    len = lfs_file_read (&g_rm_littlefs0_lfs, &file, &count, sizeof(count));
+    if ((0 == len) || ((lfs_ssize_t) sizeof(count) == len))
+    {
+        count++;
+        (void) lfs_file_rewind (&g_rm_littlefs0_lfs, &file);
+        len = lfs_file_write (&g_rm_littlefs0_lfs, &file, &count, sizeof(count));
+    }
+    lfs_err = lfs_file_close (&g_rm_littlefs0_lfs, &file);
+
+    if (((lfs_ssize_t) sizeof(count) == len) && (LFS_ERR_OK == lfs_err))
+    {
+        g_boot_count = count;
+    }
+    else
+    {
+        APP_ERR_PRINT("** Boot count not written (%d), samples of this boot stay undated ** \r\n",
+                      (len < 0) ? (int) len : lfs_err);
     }
-    return err;
 }
 
 void hal_littlefs_deinit(void)
@@ -13,8 +13,32 @@
 
 #include "hal_data.h"
 
+/* Application superblock, versions the layout of the files the application keeps in LittleFS. Written once after a
+ * format and only read afterwards, a new layout version goes with a format */
+#define LITTLEFS_APP_SB_FILE_NAME       "/app_sb"
+#define LITTLEFS_APP_SB_MAGIC           (0x53505041UL)      /* "APPS" */
+#define LITTLEFS_APP_LAYOUT_VERSION     (1U)
+
+/* Boot counter, a file of its own rewritten on every boot */
+#define LITTLEFS_APP_BOOT_FILE_NAME     "/boot"
+
+/* Blocks tracked for pre-erasing, the data flash at the configured block size of 128 bytes */
+#define LITTLEFS_APP_MAX_BLOCKS         (BSP_DATA_FLASH_SIZE_BYTES / 128U)
+
+typedef struct st_littlefs_app_sb
+{
+    uint32_t magic;
+    uint32_t layout_version;
+    uint32_t boot_count_base;           /* Boots counted here before LITTLEFS_APP_BOOT_FILE_NAME, read once, 0 since */
+} littlefs_app_sb_t;
+
 fsp_err_t hal_littlefs_init(void);
 fsp_err_t configure_littlefs_flash(void);
 void hal_littlefs_deinit(void);
+uint32_t hal_littlefs_boot_count(void);
+uint32_t hal_littlefs_erase_count(void);
+uint32_t hal_littlefs_erase_skipped(void);
+uint32_t hal_littlefs_pre_erase(uint32_t max_blocks);
+void hal_littlefs_pre_erase_reset(void);
 
 #endif /* LITTLEFS_APP_H_ */
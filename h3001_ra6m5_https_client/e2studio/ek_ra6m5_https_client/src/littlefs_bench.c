@@ -0,0 +1,566 @@
+/***********************************************************************************************************************
+ * File Name    : littlefs_bench.c
+ * Description  : This file benchmarks LittleFS on a RAM block device with the size of the data flash. Reads and
+ *                programs are plain copies and a timing model accounts the time the data flash would have spent, so
+ *                file system CPU time and flash time are reported apart. The same workloads run for a sweep of
+ *                block, cache and lookahead sizes, including a power-loss sweep that tears a program or erase and
+ *                checks the remount.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_FS)
+
+#include "common_utils.h"
+#include "app_timing.h"
+#include "littlefs_bench.h"
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+static const littlefs_bench_geometry_t g_bench_geometries[] = LITTLEFS_BENCH_GEOMETRIES;
+
+static uint8_t g_bench_ram[LITTLEFS_BENCH_DEVICE_SIZE];
+static uint16_t g_bench_wear[LITTLEFS_BENCH_DEVICE_SIZE / 128U];
+static littlefs_bench_counters_t g_bench_counters;
+static uint32_t g_bench_cut_after = RESET_VALUE;   /* Programs and erases left until the power cut, 0 for none */
+static bool g_bench_dead = false;                   /* Power is off after the cut */
+
+static lfs_t g_bench_lfs;
+static struct lfs_config g_bench_cfg;
+static uint8_t g_bench_read_buf[LITTLEFS_BENCH_MAX_CACHE];
+static uint8_t g_bench_prog_buf[LITTLEFS_BENCH_MAX_CACHE];
+static uint8_t g_bench_file_buf[LITTLEFS_BENCH_MAX_CACHE];
+static uint32_t g_bench_lookahead_buf[LITTLEFS_BENCH_MAX_LOOKAHEAD / sizeof(uint32_t)];
+static struct lfs_file_config g_bench_file_cfg = {.buffer = g_bench_file_buf};
+
+static int littlefs_bench_read(const struct lfs_config * c, lfs_block_t block, lfs_off_t off, void * buffer,
+                               lfs_size_t size);
+static int littlefs_bench_prog(const struct lfs_config * c, lfs_block_t block, lfs_off_t off, const void * buffer,
+                               lfs_size_t size);
+static int littlefs_bench_erase(const struct lfs_config * c, lfs_block_t block);
+static int littlefs_bench_sync(const struct lfs_config * c);
+#ifdef LFS_THREADSAFE
+static int littlefs_bench_lock(const struct lfs_config * c);
+static int littlefs_bench_unlock(const struct lfs_config * c);
+#endif
+static bool littlefs_bench_power_cut(void);
+static void littlefs_bench_report(const littlefs_bench_geometry_t * p_geometry, const char * p_name, uint32_t ops,
+                                  uint32_t cycles, const littlefs_bench_counters_t * p_before);
+static int littlefs_bench_append(const char * p_path, uint32_t value, uint32_t size);
+static fsp_err_t littlefs_bench_geometry(const littlefs_bench_geometry_t * p_geometry);
+static uint32_t littlefs_bench_cut_workload(void);
+static bool littlefs_bench_cut_verify(uint32_t committed);
+static fsp_err_t littlefs_bench_power_loss(const littlefs_bench_geometry_t * p_geometry);
+
+/*******************************************************************************************************************//**
+ * @brief      Runs the workloads for every geometry of LITTLEFS_BENCH_GEOMETRIES and prints one line per workload.
+ *             The data flash file system is not touched.
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  All runs completed and every power cut recovered.
+ * @retval     FSP_ERR_WRITE_FAILED         A workload failed on an intact device.
+ * @retval     FSP_ERR_INVALID_DATA         A remount after a power cut failed or lost committed data.
+ **********************************************************************************************************************/
+fsp_err_t littlefs_bench_run(void)
+{
+    fsp_err_t err = FSP_SUCCESS;
+    fsp_err_t geometry_err = FSP_SUCCESS;
+
+    APP_PRINT("\r\n%s,block,cache,lookahead,bench,ops,cpu_us,flash_us,reads,progs,erases,max_wear\r\n",
+              LITTLEFS_BENCH_TAG);
+    for (uint32_t i = 0; i < (sizeof(g_bench_geometries) / sizeof(g_bench_geometries[0])); i++)
+    {
+        geometry_err = littlefs_bench_geometry (&g_bench_geometries[i]);
+        if (FSP_SUCCESS == geometry_err)
+        {
+            geometry_err = littlefs_bench_power_loss (&g_bench_geometries[i]);
+        }
+        if (FSP_SUCCESS != geometry_err)
+        {
+            APP_ERR_PRINT("** Storage benchmark failed for block %d cache %d lookahead %d ** \r\n",
+                          g_bench_geometries[i].block_size, g_bench_geometries[i].cache_size,
+                          g_bench_geometries[i].lookahead_size);
+            err = geometry_err;
+        }
+    }
+    APP_PRINT("%s,end\r\n", LITTLEFS_BENCH_TAG);
+
+    return err;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prepares the configuration for a geometry and an erased device with no wear.
+ * @param[in]  p_geometry                   Block, cache and lookahead size.
+ * @retval     Configuration of the device, the caller owns the lfs_t.
+ **********************************************************************************************************************/
+const struct lfs_config * littlefs_bench_device_init(const littlefs_bench_geometry_t * p_geometry)
+{
+    memset (&g_bench_cfg, 0, sizeof(g_bench_cfg));
+    g_bench_cfg.read             = littlefs_bench_read;
+    g_bench_cfg.prog             = littlefs_bench_prog;
+    g_bench_cfg.erase            = littlefs_bench_erase;
+    g_bench_cfg.sync             = littlefs_bench_sync;
+#ifdef LFS_THREADSAFE
+    g_bench_cfg.lock             = littlefs_bench_lock;
+    g_bench_cfg.unlock           = littlefs_bench_unlock;
+#endif
+    g_bench_cfg.read_size        = LITTLEFS_BENCH_READ_SIZE;
+    g_bench_cfg.prog_size        = LITTLEFS_BENCH_PROG_SIZE;
+    g_bench_cfg.block_size       = p_geometry->block_size;
+    g_bench_cfg.block_count      = LITTLEFS_BENCH_DEVICE_SIZE / p_geometry->block_size;
+    g_bench_cfg.block_cycles     = LITTLEFS_BENCH_BLOCK_CYCLES;
+    g_bench_cfg.cache_size       = p_geometry->cache_size;
+    g_bench_cfg.lookahead_size   = p_geometry->lookahead_size;
+    g_bench_cfg.read_buffer      = g_bench_read_buf;
+    g_bench_cfg.prog_buffer      = g_bench_prog_buf;
+    g_bench_cfg.lookahead_buffer = g_bench_lookahead_buf;
+
+    memset (g_bench_ram, 0xFF, sizeof(g_bench_ram));
+    memset (g_bench_wear, 0, sizeof(g_bench_wear));
+    memset (&g_bench_counters, 0, sizeof(g_bench_counters));
+    g_bench_cut_after = RESET_VALUE;
+    g_bench_dead      = false;
+
+    return &g_bench_cfg;
+}
+
+
+/*******************************************************************************************************************//**
+ * @brief      Arms a power cut and powers the device on. The program or erase that brings the count to zero is torn
+ *             and every access after it fails until the next call.
+ * @param[in]  after                        Programs and erases until the cut, 0 for none.
+ * @retval     None
+ **********************************************************************************************************************/
+void littlefs_bench_device_cut(uint32_t after)
+{
+    g_bench_cut_after = after;
+    g_bench_dead      = false;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Tells whether the armed power cut has happened.
+ * @param[in]  None
+ * @retval     true                         Power is off.
+ **********************************************************************************************************************/
+bool littlefs_bench_device_dead(void)
+{
+    return g_bench_dead;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Copies the device counters since littlefs_bench_device_init().
+ * @param[out] p_counters                   Reads, programs, erases and modelled flash time.
+ * @retval     None
+ **********************************************************************************************************************/
+void littlefs_bench_device_counters(littlefs_bench_counters_t * p_counters)
+{
+    *p_counters = g_bench_counters;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns the content of the device, LITTLEFS_BENCH_DEVICE_SIZE bytes, for tests that damage it.
+ * @param[in]  None
+ * @retval     Start of the device.
+ **********************************************************************************************************************/
+uint8_t * littlefs_bench_device_ram(void)
+{
+    return g_bench_ram;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Block device read: a copy, the data flash reads at bus speed so no flash time is modelled.
+ **********************************************************************************************************************/
+static int littlefs_bench_read(const struct lfs_config * c, lfs_block_t block, lfs_off_t off, void * buffer,
+                               lfs_size_t size)
+{
+    if (g_bench_dead)
+    {
+        return LFS_ERR_IO;
+    }
+    memcpy (buffer, &g_bench_ram[(block * c->block_size) + off], size);
+    g_bench_counters.reads++;
+
+    return LFS_ERR_OK;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Block device program. A power cut during the program leaves the first half of the data written.
+ **********************************************************************************************************************/
+static int littlefs_bench_prog(const struct lfs_config * c, lfs_block_t block, lfs_off_t off, const void * buffer,
+                               lfs_size_t size)
+{
+    uint8_t * p_dest = &g_bench_ram[(block * c->block_size) + off];
+
+    if (g_bench_dead)
+    {
+        return LFS_ERR_IO;
+    }
+    if (littlefs_bench_power_cut ())
+    {
+        memcpy (p_dest, buffer, size / 2U);
+        return LFS_ERR_IO;
+    }
+    memcpy (p_dest, buffer, size);
+    g_bench_counters.progs++;
+    g_bench_counters.flash_us += ((size + LITTLEFS_BENCH_PROG_SIZE - 1U) / LITTLEFS_BENCH_PROG_SIZE) *
+                                 LITTLEFS_BENCH_PROG_US_PER_4B;
+
+    return LFS_ERR_OK;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Block device erase, in units of the 64 byte data flash erase block. A power cut during the erase leaves
+ *             the second half of the block with its old content.
+ **********************************************************************************************************************/
+static int littlefs_bench_erase(const struct lfs_config * c, lfs_block_t block)
+{
+    uint8_t * p_dest = &g_bench_ram[block * c->block_size];
+
+    if (g_bench_dead)
+    {
+        return LFS_ERR_IO;
+    }
+    if (littlefs_bench_power_cut ())
+    {
+        memset (p_dest, 0xFF, c->block_size / 2U);
+        return LFS_ERR_IO;
+    }
+    memset (p_dest, 0xFF, c->block_size);
+    g_bench_counters.erases++;
+    g_bench_counters.flash_us += (c->block_size / LITTLEFS_BENCH_ERASE_UNIT) * LITTLEFS_BENCH_ERASE_US_PER_64B;
+    g_bench_wear[block]++;
+
+    return LFS_ERR_OK;
+}
+
+static int littlefs_bench_sync(const struct lfs_config * c)
+{
+    FSP_PARAMETER_NOT_USED(c);
+
+    return LFS_ERR_OK;
+}
+
+#ifdef LFS_THREADSAFE
+
+/*******************************************************************************************************************//**
+ * @brief      The benchmark file system is private to the calling task, locking is not needed.
+ **********************************************************************************************************************/
+static int littlefs_bench_lock(const struct lfs_config * c)
+{
+    FSP_PARAMETER_NOT_USED(c);
+
+    return LFS_ERR_OK;
+}
+
+static int littlefs_bench_unlock(const struct lfs_config * c)
+{
+    FSP_PARAMETER_NOT_USED(c);
+
+    return LFS_ERR_OK;
+}
+
+#endif
+
+/*******************************************************************************************************************//**
+ * @brief      Counts a program or erase towards the armed power cut.
+ * @retval     true                         Power is cut during this operation.
+ **********************************************************************************************************************/
+static bool littlefs_bench_power_cut(void)
+{
+    if (RESET_VALUE != g_bench_cut_after)
+    {
+        g_bench_cut_after--;
+        g_bench_dead = (RESET_VALUE == g_bench_cut_after);
+    }
+
+    return g_bench_dead;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints one result line with the device counters accumulated since p_before.
+ **********************************************************************************************************************/
+static void littlefs_bench_report(const littlefs_bench_geometry_t * p_geometry, const char * p_name, uint32_t ops,
+                                  uint32_t cycles, const littlefs_bench_counters_t * p_before)
+{
+    uint32_t max_wear = RESET_VALUE;
+
+    for (uint32_t i = 0; i < g_bench_cfg.block_count; i++)
+    {
+        max_wear = (g_bench_wear[i] > max_wear) ? g_bench_wear[i] : max_wear;
+    }
+    APP_PRINT("%s,%d,%d,%d,%s,%d,%d,%d,%d,%d,%d,%d\r\n", LITTLEFS_BENCH_TAG, p_geometry->block_size,
+              p_geometry->cache_size, p_geometry->lookahead_size, p_name, ops, APP_TIMING_CYCLES_TO_US(cycles),
+              (uint32_t) (g_bench_counters.flash_us - p_before->flash_us), g_bench_counters.reads - p_before->reads,
+              g_bench_counters.progs - p_before->progs, g_bench_counters.erases - p_before->erases, max_wear);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Appends one record filled with value to a file, open to close like the journal does.
+ **********************************************************************************************************************/
+static int littlefs_bench_append(const char * p_path, uint32_t value, uint32_t size)
+{
+    lfs_file_t file;
+    uint8_t record[LITTLEFS_BENCH_SEGMENT];
+    lfs_ssize_t written = RESET_VALUE;
+    int lfs_err = LFS_ERR_OK;
+
+    memset (record, (int) value, size);
+    lfs_err = lfs_file_opencfg (&g_bench_lfs, &file, p_path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND,
+                                &g_bench_file_cfg);
+    if (LFS_ERR_OK != lfs_err)
+    {
+        return lfs_err;
+    }
+    written = lfs_file_write (&g_bench_lfs, &file, record, size);
+    lfs_err = lfs_file_close (&g_bench_lfs, &file);
+    if ((LFS_ERR_OK == lfs_err) && ((lfs_ssize_t) size != written))
+    {
+        lfs_err = (written < 0) ? (int) written : LFS_ERR_IO;
+    }
+
+    return lfs_err;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Format, mount, small appends, read-back, segment rotation and a remount of the used file system.
+ **********************************************************************************************************************/
+static fsp_err_t littlefs_bench_geometry(const littlefs_bench_geometry_t * p_geometry)
+{
+    littlefs_bench_counters_t before;
+    lfs_file_t file;
+    uint8_t record[LITTLEFS_BENCH_RECORD];
+    char path[8];
+    uint32_t start = RESET_VALUE;
+    uint32_t ops = RESET_VALUE;
+    int lfs_err = LFS_ERR_OK;
+
+    (void) littlefs_bench_device_init (p_geometry);
+
+    before = g_bench_counters;
+    start  = app_timing_cycles ();
+    lfs_err = lfs_format (&g_bench_lfs, &g_bench_cfg);
+    littlefs_bench_report (p_geometry, "format", 1U, app_timing_cycles () - start, &before);
+    if (LFS_ERR_OK != lfs_err)
+    {
+        return FSP_ERR_WRITE_FAILED;
+    }
+
+    before = g_bench_counters;
+    start  = app_timing_cycles ();
+    lfs_err = lfs_mount (&g_bench_lfs, &g_bench_cfg);
+    littlefs_bench_report (p_geometry, "mount", 1U, app_timing_cycles () - start, &before);
+    if (LFS_ERR_OK != lfs_err)
+    {
+        return FSP_ERR_WRITE_FAILED;
+    }
+
+    before = g_bench_counters;
+    start  = app_timing_cycles ();
+    for (ops = 0; (ops < LITTLEFS_BENCH_APPENDS) && (LFS_ERR_OK == lfs_err); ops++)
+    {
+        lfs_err = littlefs_bench_append ("/app", ops, LITTLEFS_BENCH_RECORD);
+    }
+    littlefs_bench_report (p_geometry, "append", ops, app_timing_cycles () - start, &before);
+
+    if (LFS_ERR_OK == lfs_err)
+    {
+        before = g_bench_counters;
+        start  = app_timing_cycles ();
+        lfs_err = lfs_file_opencfg (&g_bench_lfs, &file, "/app", LFS_O_RDONLY, &g_bench_file_cfg);
+        for (ops = 0; (ops < LITTLEFS_BENCH_APPENDS) && (LFS_ERR_OK == lfs_err); ops++)
+        {
+            if ((lfs_ssize_t) sizeof(record) != lfs_file_read (&g_bench_lfs, &file, record, sizeof(record)))
+            {
+                lfs_err = LFS_ERR_CORRUPT;
+            }
+        }
+        if (LFS_ERR_OK == lfs_err)
+        {
+            lfs_err = lfs_file_close (&g_bench_lfs, &file);
+        }
+        littlefs_bench_report (p_geometry, "readback", ops, app_timing_cycles () - start, &before);
+    }
+
+    /* Rotation: fill a segment, drop the oldest once LITTLEFS_BENCH_LIVE_SEGMENTS are kept */
+    if (LFS_ERR_OK == lfs_err)
+    {
+        (void) lfs_remove (&g_bench_lfs, "/app");
+        before = g_bench_counters;
+        start  = app_timing_cycles ();
+        for (ops = 0; (ops < LITTLEFS_BENCH_ROTATIONS) && (LFS_ERR_OK == lfs_err); ops++)
+        {
+            snprintf (path, sizeof(path), "/s%02d", (int) (ops % 100U));
+            lfs_err = littlefs_bench_append (path, ops, LITTLEFS_BENCH_SEGMENT);
+            if ((LFS_ERR_OK == lfs_err) && (ops >= LITTLEFS_BENCH_LIVE_SEGMENTS))
+            {
+                snprintf (path, sizeof(path), "/s%02d", (int) ((ops - LITTLEFS_BENCH_LIVE_SEGMENTS) % 100U));
+                lfs_err = lfs_remove (&g_bench_lfs, path);
+            }
+        }
+        littlefs_bench_report (p_geometry, "rotate", ops, app_timing_cycles () - start, &before);
+    }
+
+    (void) lfs_unmount (&g_bench_lfs);
+    if (LFS_ERR_OK != lfs_err)
+    {
+        return FSP_ERR_WRITE_FAILED;
+    }
+
+    /* Mount of a used file system, as at every boot */
+    before = g_bench_counters;
+    start  = app_timing_cycles ();
+    lfs_err = lfs_mount (&g_bench_lfs, &g_bench_cfg);
+    littlefs_bench_report (p_geometry, "remount", 1U, app_timing_cycles () - start, &before);
+    (void) lfs_unmount (&g_bench_lfs);
+
+    return (LFS_ERR_OK == lfs_err) ? FSP_SUCCESS : FSP_ERR_WRITE_FAILED;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Workload of the power-loss sweep: LITTLEFS_BENCH_CUT_RECORDS records appended to one file.
+ * @retval     Number of appends that completed, stops at the first failure.
+ **********************************************************************************************************************/
+static uint32_t littlefs_bench_cut_workload(void)
+{
+    uint32_t committed = RESET_VALUE;
+
+    while ((committed < LITTLEFS_BENCH_CUT_RECORDS) &&
+           (LFS_ERR_OK == littlefs_bench_append ("/pl", committed + 1U, LITTLEFS_BENCH_RECORD)))
+    {
+        committed++;
+    }
+
+    return committed;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Checks the file after a remount: every completed append is there, the torn one is either complete or
+ *             absent, and nothing else is.
+ **********************************************************************************************************************/
+static bool littlefs_bench_cut_verify(uint32_t committed)
+{
+    lfs_file_t file;
+    uint8_t record[LITTLEFS_BENCH_RECORD];
+    lfs_soff_t size = RESET_VALUE;
+    uint32_t records = RESET_VALUE;
+    bool valid = true;
+    int lfs_err = LFS_ERR_OK;
+
+    lfs_err = lfs_file_opencfg (&g_bench_lfs, &file, "/pl", LFS_O_RDONLY, &g_bench_file_cfg);
+    if (LFS_ERR_NOENT == lfs_err)
+    {
+        return (RESET_VALUE == committed);
+    }
+    if (LFS_ERR_OK != lfs_err)
+    {
+        return false;
+    }
+
+    size    = lfs_file_size (&g_bench_lfs, &file);
+    records = (uint32_t) size / LITTLEFS_BENCH_RECORD;
+    valid   = (size >= 0) && (0U == ((uint32_t) size % LITTLEFS_BENCH_RECORD)) && (records >= committed) &&
+              (records <= (committed + 1U));
+    for (uint32_t i = 0; valid && (i < records); i++)
+    {
+        valid = ((lfs_ssize_t) sizeof(record) == lfs_file_read (&g_bench_lfs, &file, record, sizeof(record)));
+        for (uint32_t j = 0; valid && (j < sizeof(record)); j++)
+        {
+            valid = ((uint8_t) (i + 1U) == record[j]);
+        }
+    }
+    (void) lfs_file_close (&g_bench_lfs, &file);
+
+    return valid;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Power-loss sweep. A clean run counts the programs and erases of the workload, then power is cut at
+ *             LITTLEFS_BENCH_CUT_POINTS points spread over them and the file system is mounted and checked again.
+ *             The line reports the number of cuts, the slowest recovery mount and the cuts that did not recover.
+ **********************************************************************************************************************/
+static fsp_err_t littlefs_bench_power_loss(const littlefs_bench_geometry_t * p_geometry)
+{
+    littlefs_bench_counters_t before;
+    uint32_t total = RESET_VALUE;
+    uint32_t step = RESET_VALUE;
+    uint32_t cuts = RESET_VALUE;
+    uint32_t failed = RESET_VALUE;
+    uint32_t committed = RESET_VALUE;
+    uint32_t start = RESET_VALUE;
+    uint32_t mount_cycles = RESET_VALUE;
+    uint32_t mount_us_max = RESET_VALUE;
+    uint32_t mount_flash_us_max = RESET_VALUE;
+    uint32_t max_wear = RESET_VALUE;
+    int lfs_err = LFS_ERR_OK;
+
+    (void) littlefs_bench_device_init (p_geometry);
+    if ((LFS_ERR_OK != lfs_format (&g_bench_lfs, &g_bench_cfg)) ||
+        (LFS_ERR_OK != lfs_mount (&g_bench_lfs, &g_bench_cfg)))
+    {
+        return FSP_ERR_WRITE_FAILED;
+    }
+    before = g_bench_counters;
+    committed = littlefs_bench_cut_workload ();
+    total = (g_bench_counters.progs - before.progs) + (g_bench_counters.erases - before.erases);
+    (void) lfs_unmount (&g_bench_lfs);
+    if (LITTLEFS_BENCH_CUT_RECORDS != committed)
+    {
+        return FSP_ERR_WRITE_FAILED;
+    }
+    step = (total > LITTLEFS_BENCH_CUT_POINTS) ? (total / LITTLEFS_BENCH_CUT_POINTS) : 1U;
+
+    for (uint32_t cut = 1U; cut <= total; cut += step)
+    {
+        (void) littlefs_bench_device_init (p_geometry);
+        if ((LFS_ERR_OK != lfs_format (&g_bench_lfs, &g_bench_cfg)) ||
+            (LFS_ERR_OK != lfs_mount (&g_bench_lfs, &g_bench_cfg)))
+        {
+            return FSP_ERR_WRITE_FAILED;
+        }
+        littlefs_bench_device_cut (cut);
+        committed = littlefs_bench_cut_workload ();
+
+        /* Power back on. The lfs_t of the dead mount is abandoned, as after a reset */
+        littlefs_bench_device_cut (RESET_VALUE);
+        before = g_bench_counters;
+        start  = app_timing_cycles ();
+        lfs_err = lfs_mount (&g_bench_lfs, &g_bench_cfg);
+        mount_cycles = app_timing_cycles () - start;
+        if ((LFS_ERR_OK != lfs_err) || !littlefs_bench_cut_verify (committed))
+        {
+            APP_ERR_PRINT("** Power cut at write %d of %d not recovered: %d ** \r\n", cut, total, lfs_err);
+            failed++;
+        }
+        if (LFS_ERR_OK == lfs_err)
+        {
+            (void) lfs_unmount (&g_bench_lfs);
+        }
+        cuts++;
+
+        mount_us_max       = (APP_TIMING_CYCLES_TO_US(mount_cycles) > mount_us_max) ?
+                             APP_TIMING_CYCLES_TO_US(mount_cycles) : mount_us_max;
+        mount_flash_us_max = ((uint32_t) (g_bench_counters.flash_us - before.flash_us) > mount_flash_us_max) ?
+                             (uint32_t) (g_bench_counters.flash_us - before.flash_us) : mount_flash_us_max;
+        for (uint32_t i = 0; i < g_bench_cfg.block_count; i++)
+        {
+            max_wear = (g_bench_wear[i] > max_wear) ? g_bench_wear[i] : max_wear;
+        }
+    }
+
+    APP_PRINT("%s,%d,%d,%d,powerloss,%d,%d,%d,%d,0,0,%d\r\n", LITTLEFS_BENCH_TAG, p_geometry->block_size,
+              p_geometry->cache_size, p_geometry->lookahead_size, cuts, mount_us_max, mount_flash_us_max, failed,
+              max_wear);
+
+    return (RESET_VALUE == failed) ? FSP_SUCCESS : FSP_ERR_INVALID_DATA;
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
@@ -0,0 +1,73 @@
+/***********************************************************************************************************************
+ * File Name    : littlefs_bench.h
+ * Description  : Contains macros, data structures and functions used by the LittleFS storage benchmark on RAM
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef LITTLEFS_BENCH_H_
+#define LITTLEFS_BENCH_H_
+
+#include "hal_data.h"
+
+/* The RAM device has the size of the data flash. The configuration in use is the first geometry of the sweep.
+ * LittleFS needs blocks of at least 128 bytes for its CTZ skip lists, so the 64 byte erase unit is not an option */
+#define LITTLEFS_BENCH_DEVICE_SIZE      (BSP_DATA_FLASH_SIZE_BYTES)
+#define LITTLEFS_BENCH_GEOMETRIES       { {128U, 64U, 16U}, {128U, 128U, 16U}, {128U, 32U, 16U}, {256U, 64U, 16U}, \
+                                          {256U, 128U, 16U}, {128U, 64U, 8U}, {128U, 64U, 32U} }
+#define LITTLEFS_BENCH_MAX_CACHE        (128U)
+#define LITTLEFS_BENCH_MAX_LOOKAHEAD    (32U)
+#define LITTLEFS_BENCH_READ_SIZE        (1U)
+#define LITTLEFS_BENCH_PROG_SIZE        (4U)
+#define LITTLEFS_BENCH_BLOCK_CYCLES     (1024)
+
+/* Data flash timing model, typical values of the RA6M5 data flash. Check them against the electrical characteristics
+ * of the part before comparing the modelled time with the real device */
+#define LITTLEFS_BENCH_PROG_US_PER_4B   (36U)
+#define LITTLEFS_BENCH_ERASE_US_PER_64B (300U)
+#define LITTLEFS_BENCH_ERASE_UNIT       (64U)
+
+/* Workloads: small records as the journal writes them, segment files rotated as the journal rotates them */
+#define LITTLEFS_BENCH_RECORD           (16U)
+#define LITTLEFS_BENCH_APPENDS          (64U)
+#define LITTLEFS_BENCH_SEGMENT          (128U)
+#define LITTLEFS_BENCH_ROTATIONS        (24U)
+#define LITTLEFS_BENCH_LIVE_SEGMENTS    (6U)
+#define LITTLEFS_BENCH_CUT_RECORDS      (32U)
+#define LITTLEFS_BENCH_CUT_POINTS       (24U)
+
+/*
+ * Every result is printed as one comma separated line:
+ *   #LFSRAM,<block>,<cache>,<lookahead>,<bench>,<ops>,<cpu us>,<flash us>,<reads>,<progs>,<erases>,<max block wear>
+ * For the power-loss bench <ops> is the number of cuts and <reads> the cuts that did not recover.
+ */
+#define LITTLEFS_BENCH_TAG              "#LFSRAM"
+
+typedef struct st_littlefs_bench_geometry
+{
+    uint32_t block_size;
+    uint32_t cache_size;
+    uint32_t lookahead_size;
+} littlefs_bench_geometry_t;
+
+typedef struct st_littlefs_bench_counters
+{
+    uint32_t reads;
+    uint32_t progs;
+    uint32_t erases;
+    uint64_t flash_us;                  /* Modelled data flash time */
+} littlefs_bench_counters_t;
+
+fsp_err_t littlefs_bench_run(void);
+
+/* The RAM device on its own, the block device of the host tests in test/host */
+const struct lfs_config * littlefs_bench_device_init(const littlefs_bench_geometry_t * p_geometry);
+void littlefs_bench_device_cut(uint32_t after);
+bool littlefs_bench_device_dead(void);
+void littlefs_bench_device_counters(littlefs_bench_counters_t * p_counters);
+uint8_t * littlefs_bench_device_ram(void);
+
+#endif /* LITTLEFS_BENCH_H_ */
@@ -0,0 +1,269 @@
+/***********************************************************************************************************************
+ * File Name    : littlefs_maint.c
+ * Description  : This file runs LittleFS housekeeping in a task just above idle priority: lfs_fs_gc() compacts
+ *                metadata pairs past LITTLEFS_MAINT_COMPACT_THRESH and refills the block allocator lookahead, then a
+ *                few free blocks are erased ahead of time. Writers in other tasks then rarely wait for a compaction,
+ *                a lookahead scan or an erase.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_FS)
+
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "core_http_client.h"
+#include "transport_mbedtls_pkcs11.h"
+#include "user_app.h"
+#include "app_timing.h"
+#include "littlefs_app.h"
+#include "littlefs_maint.h"
+
+#if (LITTLEFS_MAINT_ENABLE == ENABLE) && !defined(LFS_THREADSAFE)
+ #error "The LittleFS maintenance task shares the file system, enable Thread Safe in the LittleFS module"
+#endif
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+static littlefs_maint_stats_t g_maint_stats;
+static TaskHandle_t g_maint_task = NULL;
+static SemaphoreHandle_t g_maint_mutex = NULL;      /* Held for a pass, or by the benchmark to keep passes out */
+static StaticSemaphore_t g_maint_mutex_mem;
+static uint32_t g_bench_us[LITTLEFS_MAINT_BENCH_APPENDS];
+
+static void littlefs_maint_task(void * pvParameters);
+static void littlefs_maint_pass(void);
+static fsp_err_t littlefs_maint_bench_run(bool with_maint);
+
+/*******************************************************************************************************************//**
+ * @brief      Starts the maintenance task. Called once LittleFS is mounted and startup is done.
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  Task started or maintenance disabled.
+ * @retval     FSP_ERR_OUT_OF_MEMORY        Task could not be created.
+ **********************************************************************************************************************/
+fsp_err_t littlefs_maint_start(void)
+{
+#if (LITTLEFS_MAINT_ENABLE == ENABLE)
+    if (NULL != g_maint_task)
+    {
+        return FSP_SUCCESS;
+    }
+
+ #if (LFS_VERSION >= 0x00020009)
+    /* Only lfs_fs_gc() looks at the threshold, writers still compact a metadata pair when it is full */
+    g_rm_littlefs0_lfs_cfg.compact_thresh = LITTLEFS_MAINT_COMPACT_THRESH;
+ #endif
+    g_maint_mutex = xSemaphoreCreateMutexStatic (&g_maint_mutex_mem);
+    if (pdPASS != xTaskCreate (littlefs_maint_task, LITTLEFS_MAINT_TASK_NAME, LITTLEFS_MAINT_TASK_STACK, NULL,
+                               LITTLEFS_MAINT_TASK_PRIORITY, &g_maint_task))
+    {
+        return FSP_ERR_OUT_OF_MEMORY;
+    }
+
+    /* First pass after startup, which wrote the file system last */
+    xTaskNotifyGive (g_maint_task);
+#endif
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Tells the maintenance task that LittleFS took a block, a pass follows LITTLEFS_MAINT_DELAY_MS later.
+ *             Called from the erase callback of littlefs_app.c, the blocks taken by a pass do not start another.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void littlefs_maint_kick(void)
+{
+    if ((NULL != g_maint_task) && (xTaskGetCurrentTaskHandle () != g_maint_task))
+    {
+        xTaskNotifyGive (g_maint_task);
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints the maintenance counters and how many foreground erases were avoided.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void littlefs_maint_print_stats(void)
+{
+    littlefs_maint_stats_t stats = g_maint_stats;
+
+    APP_PRINT("\r\nLittleFS maintenance: %s, %d passes, gc failures %d\r\n",
+              (NULL != g_maint_task) ? "running" : "off", stats.passes, stats.gc_failed);
+    if (0U != stats.passes)
+    {
+        APP_PRINT("\tgc: avg %d us, max %d us\r\n", (uint32_t) (stats.gc_us_total / stats.passes), stats.gc_us_max);
+    }
+    APP_PRINT("\tpre-erased %d blocks (max %d us per pass), erases by LittleFS %d, skipped %d\r\n", stats.pre_erased,
+              stats.pre_erase_us_max, hal_littlefs_erase_count (), hal_littlefs_erase_skipped ());
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Appends LITTLEFS_MAINT_BENCH_APPENDS records to a scratch file, once without maintenance and once with a
+ *             maintenance pass in the gap after every append, as between two samples. Prints the append latency
+ *             percentiles as comma separated lines:
+ *               #LFSBENCH,<mode>,<appends>,<p50 us>,<p99 us>,<max us>,<erases in appends>,<erases skipped>
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  Both runs completed.
+ * @retval     FSP_ERR_IN_USE               Maintenance pass did not finish in time.
+ * @retval     FSP_ERR_WRITE_FAILED         Scratch file could not be written.
+ **********************************************************************************************************************/
+fsp_err_t littlefs_maint_bench(void)
+{
+    fsp_err_t err = FSP_SUCCESS;
+
+    if ((NULL != g_maint_mutex) && (pdTRUE != xSemaphoreTake (g_maint_mutex, pdMS_TO_TICKS(LITTLEFS_MAINT_DELAY_MS))))
+    {
+        return FSP_ERR_IN_USE;
+    }
+
+    APP_PRINT("\r\n%s,mode,appends,p50_us,p99_us,max_us,erases,skipped\r\n", LITTLEFS_MAINT_BENCH_TAG);
+    err = littlefs_maint_bench_run (false);
+    if (FSP_SUCCESS == err)
+    {
+        err = littlefs_maint_bench_run (true);
+    }
+    APP_PRINT("%s,end\r\n", LITTLEFS_MAINT_BENCH_TAG);
+
+    if (NULL != g_maint_mutex)
+    {
+        (void) xSemaphoreGive (g_maint_mutex);
+    }
+    return err;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Runs a pass LITTLEFS_MAINT_DELAY_MS after LittleFS took a block, the blocks taken meanwhile are covered
+ *             by the same pass. Without writes the task has no timeout and adds no wakeups. At this priority the pass
+ *             only starts when every other task is blocked.
+ **********************************************************************************************************************/
+static void littlefs_maint_task(void * pvParameters)
+{
+    FSP_PARAMETER_NOT_USED(pvParameters);
+
+    while (true)
+    {
+        (void) ulTaskNotifyTake (pdTRUE, portMAX_DELAY);
+        vTaskDelay (pdMS_TO_TICKS(LITTLEFS_MAINT_DELAY_MS));
+        (void) ulTaskNotifyTake (pdTRUE, 0);
+        if (pdTRUE == xSemaphoreTake (g_maint_mutex, 0))
+        {
+            littlefs_maint_pass ();
+            (void) xSemaphoreGive (g_maint_mutex);
+        }
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      One maintenance pass: garbage collection, then pre-erasing. Each LittleFS call holds the file system
+ *             lock for its duration only.
+ **********************************************************************************************************************/
+static void littlefs_maint_pass(void)
+{
+    uint32_t start = app_timing_cycles ();
+    uint32_t elapsed_us = RESET_VALUE;
+    int lfs_err = LFS_ERR_OK;
+
+#if (LFS_VERSION >= 0x00020008)
+    lfs_err = lfs_fs_gc (&g_rm_littlefs0_lfs);
+#endif
+    elapsed_us = APP_TIMING_CYCLES_TO_US(app_timing_cycles () - start);
+    g_maint_stats.passes++;
+    g_maint_stats.gc_failed  += (LFS_ERR_OK != lfs_err) ? 1U : 0U;
+    g_maint_stats.gc_us_total += elapsed_us;
+    g_maint_stats.gc_us_max   = (elapsed_us > g_maint_stats.gc_us_max) ? elapsed_us : g_maint_stats.gc_us_max;
+
+    start = app_timing_cycles ();
+    g_maint_stats.pre_erased += hal_littlefs_pre_erase (LITTLEFS_MAINT_PRE_ERASE_BLOCKS);
+    elapsed_us = APP_TIMING_CYCLES_TO_US(app_timing_cycles () - start);
+    g_maint_stats.pre_erase_us_max = (elapsed_us > g_maint_stats.pre_erase_us_max) ? elapsed_us :
+                                     g_maint_stats.pre_erase_us_max;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      One benchmark run on a fresh scratch file. The baseline first forgets earlier pre-erases, so every
+ *             allocation in it pays for its erase.
+ **********************************************************************************************************************/
+static fsp_err_t littlefs_maint_bench_run(bool with_maint)
+{
+    lfs_file_t file;
+    uint8_t record[LITTLEFS_MAINT_BENCH_RECORD];
+    uint32_t erases = RESET_VALUE;
+    uint32_t skipped = hal_littlefs_erase_skipped ();
+    uint32_t before = RESET_VALUE;
+    uint32_t start = RESET_VALUE;
+    lfs_ssize_t written = RESET_VALUE;
+    int lfs_err = LFS_ERR_OK;
+
+    (void) lfs_remove (&g_rm_littlefs0_lfs, LITTLEFS_MAINT_BENCH_FILE);
+    if (with_maint)
+    {
+        littlefs_maint_pass ();
+    }
+    else
+    {
+        hal_littlefs_pre_erase_reset ();
+    }
+
+    for (uint32_t i = 0; i < LITTLEFS_MAINT_BENCH_APPENDS; i++)
+    {
+        memset (record, (int) i, sizeof(record));
+        before = hal_littlefs_erase_count ();
+        start  = app_timing_cycles ();
+        lfs_err = lfs_file_open (&g_rm_littlefs0_lfs, &file, LITTLEFS_MAINT_BENCH_FILE,
+                                 LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND);
+        if (LFS_ERR_OK == lfs_err)
+        {
+            written = lfs_file_write (&g_rm_littlefs0_lfs, &file, record, sizeof(record));
+            lfs_err = lfs_file_close (&g_rm_littlefs0_lfs, &file);
+        }
+        g_bench_us[i] = APP_TIMING_CYCLES_TO_US(app_timing_cycles () - start);
+        erases       += hal_littlefs_erase_count () - before;
+        if ((LFS_ERR_OK != lfs_err) || ((lfs_ssize_t) sizeof(record) != written))
+        {
+            APP_ERR_PRINT("** Benchmark append %d failed: %d ** \r\n", i, lfs_err);
+            (void) lfs_remove (&g_rm_littlefs0_lfs, LITTLEFS_MAINT_BENCH_FILE);
+            return FSP_ERR_WRITE_FAILED;
+        }
+
+        if (with_maint)
+        {
+            littlefs_maint_pass ();
+        }
+    }
+    (void) lfs_remove (&g_rm_littlefs0_lfs, LITTLEFS_MAINT_BENCH_FILE);
+
+    /* Insertion sort, the run is short */
+    for (uint32_t i = 1; i < LITTLEFS_MAINT_BENCH_APPENDS; i++)
+    {
+        uint32_t value = g_bench_us[i];
+        uint32_t j = i;
+
+        for (; (j > 0U) && (g_bench_us[j - 1U] > value); j--)
+        {
+            g_bench_us[j] = g_bench_us[j - 1U];
+        }
+        g_bench_us[j] = value;
+    }
+
+    APP_PRINT("%s,%s,%d,%d,%d,%d,%d,%d\r\n", LITTLEFS_MAINT_BENCH_TAG, with_maint ? "maint" : "inline",
+              LITTLEFS_MAINT_BENCH_APPENDS,
+              g_bench_us[LITTLEFS_MAINT_BENCH_APPENDS / 2U], g_bench_us[(LITTLEFS_MAINT_BENCH_APPENDS * 99U) / 100U],
+              g_bench_us[LITTLEFS_MAINT_BENCH_APPENDS - 1U], erases, hal_littlefs_erase_skipped () - skipped);
+    return FSP_SUCCESS;
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
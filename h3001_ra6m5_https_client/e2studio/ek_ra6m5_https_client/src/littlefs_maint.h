@@ -0,0 +1,42 @@
+/***********************************************************************************************************************
+ * File Name    : littlefs_maint.h
+ * Description  : Contains macros, data structures and functions used by the LittleFS maintenance task
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef LITTLEFS_MAINT_H_
+#define LITTLEFS_MAINT_H_
+
+#include "hal_data.h"
+
+/* Runs just above the idle task, so maintenance only uses time no other task wants */
+#define LITTLEFS_MAINT_TASK_NAME        "LfsMaint"
+#define LITTLEFS_MAINT_TASK_STACK       (512U)      /* Words */
+#define LITTLEFS_MAINT_TASK_PRIORITY    (1U)
+
+/* Append benchmark: a small record appended to a scratch file, like the journal writes a sample */
+#define LITTLEFS_MAINT_BENCH_FILE       "/lfs_bench"
+#define LITTLEFS_MAINT_BENCH_APPENDS    (64U)
+#define LITTLEFS_MAINT_BENCH_RECORD     (16U)
+#define LITTLEFS_MAINT_BENCH_TAG        "#LFSBENCH"
+
+typedef struct st_littlefs_maint_stats
+{
+    uint32_t passes;
+    uint32_t gc_failed;
+    uint32_t gc_us_max;                 /* lfs_fs_gc(): compaction and lookahead scan */
+    uint64_t gc_us_total;
+    uint32_t pre_erased;                /* Free blocks erased ahead of their allocation */
+    uint32_t pre_erase_us_max;
+} littlefs_maint_stats_t;
+
+fsp_err_t littlefs_maint_start(void);
+void littlefs_maint_kick(void);
+void littlefs_maint_print_stats(void);
+fsp_err_t littlefs_maint_bench(void);
+
+#endif /* LITTLEFS_MAINT_H_ */
@@ -0,0 +1,168 @@
+/***********************************************************************************************************************
+ * File Name    : log_token.c
+ * Description  : This file sends the records of the tokenized log to their RTT channel and benchmarks a log call
+ *                formatted on the target with SEGGER_RTT_printf() against the same call tokenized.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_SYS)
+
+#include "common_utils.h"
+#include "app_timing.h"
+#include "log_token.h"
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+/* Benchmark: one log call to the scratch channel, timed and then taken back from it */
+#define LOG_TOKEN_BENCH_MESSAGES        (4U)
+#define LOG_TOKEN_BENCH_CHANNEL         (RTT_STREAM_BENCH)
+#define LOG_TOKEN_BENCH_RUN(p_result, call)                                                                           \
+    do {                                                                                                              \
+        uint32_t bench_start_ = app_timing_cycles ();                                                                 \
+        (p_result)->bytes   = (uint32_t) (call);                                                                      \
+        (p_result)->cycles += app_timing_cycles () - bench_start_;                                                    \
+        p_up->WrOff         = p_up->RdOff;                                                                            \
+    } while (0)
+
+typedef struct st_log_token_bench
+{
+    uint32_t cycles;                    /* Sum over the iterations */
+    uint32_t bytes;                     /* Written by one call */
+} log_token_bench_t;
+
+static void log_token_put_bytes(log_token_record_t * p_record, const char * p_str);
+static void log_token_bench_line(const char * p_name, uint32_t args, const log_token_bench_t * p_text,
+                                 const log_token_bench_t * p_token);
+
+/*******************************************************************************************************************//**
+ * @brief      Appends a string argument, cut to what the record has left.
+ * @param[in]  p_record                     Record.
+ * @param[in]  p_str                        String, NULL is sent as "(NULL)" like SEGGER_RTT_printf() prints it.
+ * @retval     None
+ **********************************************************************************************************************/
+void log_token_put_str(log_token_record_t * p_record, const char * p_str)
+{
+    log_token_put_bytes (p_record, (NULL != p_str) ? p_str : "(NULL)");
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Appends a string argument given as unsigned characters, such as an HTTP response body.
+ * @param[in]  p_record                     Record.
+ * @param[in]  p_str                        String.
+ * @retval     None
+ **********************************************************************************************************************/
+void log_token_put_ustr(log_token_record_t * p_record, const unsigned char * p_str)
+{
+    log_token_put_bytes (p_record, (NULL != p_str) ? (const char *) p_str : "(NULL)");
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Completes a record with its length and writes it to the channel, whole or not at all.
+ * @param[in]  p_record                     Record.
+ * @param[in]  channel                      RTT up channel.
+ * @retval     Bytes written, 0 when the record was dropped.
+ **********************************************************************************************************************/
+uint32_t log_token_end(log_token_record_t * p_record, uint32_t channel)
+{
+    uint32_t payload = p_record->length - LOG_TOKEN_HEADER_LEN;
+
+    p_record->data[2] = (uint8_t) payload;
+    p_record->data[3] = (uint8_t) (payload >> 8);
+    return rtt_stream_write ((rtt_stream_t) channel, p_record->data, p_record->length);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Times messages typical of the application, formatted with SEGGER_RTT_printf() and tokenized. Both go
+ *             through SEGGER_RTT_Write() as on the log channels, but to the scratch channel RTT_STREAM_BENCH, which no
+ *             host reads: every write is taken back right away so that it never fills, and the live channels and
+ *             their counters are left alone.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void log_token_bench(void)
+{
+    SEGGER_RTT_BUFFER_UP * p_up = &_SEGGER_RTT.aUp[LOG_TOKEN_BENCH_CHANNEL];
+    log_token_bench_t text[LOG_TOKEN_BENCH_MESSAGES] = {{RESET_VALUE}};
+    log_token_bench_t token[LOG_TOKEN_BENCH_MESSAGES] = {{RESET_VALUE}};
+
+    if (0U == p_up->SizeOfBuffer)
+    {
+        APP_ERR_PRINT("** RTT channel %d is not set up ** \r\n", LOG_TOKEN_BENCH_CHANNEL);
+        return;
+    }
+    app_timing_init ();
+    p_up->WrOff = p_up->RdOff;
+
+    for (uint32_t i = 0; i < LOG_TOKEN_BENCH_ITERATIONS; i++)
+    {
+        LOG_TOKEN_BENCH_RUN(&text[0], SEGGER_RTT_printf (LOG_TOKEN_BENCH_CHANNEL, "\r\nProcessing POST Request\r\n"));
+        LOG_TOKEN_BENCH_RUN(&token[0], LOG_TOKEN_PRINT_TO(LOG_TOKEN_BENCH_CHANNEL, "\r\nProcessing POST Request\r\n"));
+
+        LOG_TOKEN_BENCH_RUN(&text[1], SEGGER_RTT_printf (LOG_TOKEN_BENCH_CHANNEL,
+                                                         "\r\nSample %d journaled, %d pending\r\n", i + 1000U, i));
+        LOG_TOKEN_BENCH_RUN(&token[1], LOG_TOKEN_PRINT_TO(LOG_TOKEN_BENCH_CHANNEL,
+                                                          "\r\nSample %d journaled, %d pending\r\n", i + 1000U, i));
+
+        LOG_TOKEN_BENCH_RUN(&text[2], SEGGER_RTT_printf (LOG_TOKEN_BENCH_CHANNEL, "[ERR] In Function: %s(), %s",
+                                                         __FUNCTION__, "** PKCS#11 pool exhausted ** \r\n"));
+        LOG_TOKEN_BENCH_RUN(&token[2], LOG_TOKEN_PRINT_TO(LOG_TOKEN_BENCH_CHANNEL,
+                                                          "[ERR] In Function: %s(), ** PKCS#11 pool exhausted ** \r\n",
+                                                          __FUNCTION__));
+
+        LOG_TOKEN_BENCH_RUN(&text[3], SEGGER_RTT_printf (LOG_TOKEN_BENCH_CHANNEL, "%s,%d,%d,%d,%d,%d,%d,%d,%d\r\n",
+                                                         "#BENCH", 4096U, i, 65536U, 123456U, 98765U, 2U, 77U, 3U));
+        LOG_TOKEN_BENCH_RUN(&token[3], LOG_TOKEN_PRINT_TO(LOG_TOKEN_BENCH_CHANNEL, "%s,%d,%d,%d,%d,%d,%d,%d,%d\r\n",
+                                                          "#BENCH", 4096U, i, 65536U, 123456U, 98765U, 2U, 77U, 3U));
+    }
+
+    APP_PRINT("\r\n%s,message,args,text_cycles,token_cycles,text_bytes,token_bytes\r\n", LOG_TOKEN_BENCH_TAG);
+    log_token_bench_line ("plain", 0U, &text[0], &token[0]);
+    log_token_bench_line ("two ints", 2U, &text[1], &token[1]);
+    log_token_bench_line ("error", 1U, &text[2], &token[2]);
+    log_token_bench_line ("csv", 9U, &text[3], &token[3]);
+    APP_PRINT("%s,end\r\n", LOG_TOKEN_BENCH_TAG);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Appends the length and the characters of a string.
+ **********************************************************************************************************************/
+static void log_token_put_bytes(log_token_record_t * p_record, const char * p_str)
+{
+    size_t len = strlen (p_str);
+    uint32_t room = LOG_TOKEN_RECORD_MAX - p_record->length;
+
+    if (0U == room)
+    {
+        return;
+    }
+    room--;
+    len = (len > LOG_TOKEN_STRING_MAX) ? LOG_TOKEN_STRING_MAX : len;
+    len = (len > room) ? room : len;
+    p_record->data[p_record->length] = (uint8_t) len;
+    memcpy (&p_record->data[p_record->length + 1U], p_str, len);
+    p_record->length += (uint32_t) len + 1U;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints the averages of one benchmark message.
+ **********************************************************************************************************************/
+static void log_token_bench_line(const char * p_name, uint32_t args, const log_token_bench_t * p_text,
+                                 const log_token_bench_t * p_token)
+{
+    APP_PRINT("%s,%s,%d,%d,%d,%d,%d\r\n", LOG_TOKEN_BENCH_TAG, p_name, args,
+              p_text->cycles / LOG_TOKEN_BENCH_ITERATIONS, p_token->cycles / LOG_TOKEN_BENCH_ITERATIONS, p_text->bytes,
+              p_token->bytes);
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
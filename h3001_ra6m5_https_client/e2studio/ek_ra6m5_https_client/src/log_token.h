@@ -0,0 +1,119 @@
+/***********************************************************************************************************************
+ * File Name    : log_token.h
+ * Description  : Contains macros, data structures and functions used by the tokenized log
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef LOG_TOKEN_H_
+#define LOG_TOKEN_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "rtt_streams.h"
+
+/*
+ * Tokenized log: the format string of a call goes to the .log_fmt section, which the linker keeps in the ELF without
+ * loading it (see script/fsp.ld). The target sends a record of the string's offset in the section and the raw
+ * arguments, tools/log_decode.py formats it on the host from the ELF. A record is:
+ *   <id: 16 bit offset of the format><length: 16 bit bytes that follow><arguments>
+ * little endian, every argument a 32 bit word except strings: an 8 bit length and the characters, cut to fit
+ * LOG_TOKEN_RECORD_MAX. Records that do not fit the channel buffer are dropped whole and counted, see rtt_streams.h.
+ */
+#define LOG_TOKEN_RTT_CHANNEL           (RTT_STREAM_LOG_TOKENS)
+#define LOG_TOKEN_RECORD_MAX            (128U)
+#define LOG_TOKEN_HEADER_LEN            (4U)
+#define LOG_TOKEN_STRING_MAX            (255U)
+
+/*
+ * Benchmark of a log call, text against tokenized, one line per message after the header:
+ *   #LOGBENCH,message,args,text_cycles,token_cycles,text_bytes,token_bytes
+ */
+#define LOG_TOKEN_BENCH_TAG             "#LOGBENCH"
+#define LOG_TOKEN_BENCH_ITERATIONS      (100U)
+
+typedef struct st_log_token_record
+{
+    uint32_t length;                    /* Bytes used in data, header included */
+    uint8_t data[LOG_TOKEN_RECORD_MAX];
+} log_token_record_t;
+
+/* Argument count of a call, up to 16 */
+#define LOG_TOKEN_COUNT(...)            LOG_TOKEN_COUNT_(0, ##__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, \
+                                                         4, 3, 2, 1, 0)
+#define LOG_TOKEN_COUNT_(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, n, ...) n
+#define LOG_TOKEN_CAT(a, b)             LOG_TOKEN_CAT_(a, b)
+#define LOG_TOKEN_CAT_(a, b)            a ## b
+
+/* Strings are copied, anything else is sent as a 32 bit word */
+#define LOG_TOKEN_PUT(p_rec, arg)       _Generic((arg),                                                               \
+                                                 char *: log_token_put_str,                                           \
+                                                 const char *: log_token_put_str,                                     \
+                                                 unsigned char *: log_token_put_ustr,                                 \
+                                                 const unsigned char *: log_token_put_ustr,                           \
+                                                 default: log_token_put_u32)((p_rec), (arg));
+#define LOG_TOKEN_PUT_0(p_rec)
+#define LOG_TOKEN_PUT_1(p_rec, a)       LOG_TOKEN_PUT(p_rec, a)
+#define LOG_TOKEN_PUT_2(p_rec, a, ...)  LOG_TOKEN_PUT(p_rec, a) LOG_TOKEN_PUT_1(p_rec, __VA_ARGS__)
+#define LOG_TOKEN_PUT_3(p_rec, a, ...)  LOG_TOKEN_PUT(p_rec, a) LOG_TOKEN_PUT_2(p_rec, __VA_ARGS__)
+#define LOG_TOKEN_PUT_4(p_rec, a, ...)  LOG_TOKEN_PUT(p_rec, a) LOG_TOKEN_PUT_3(p_rec, __VA_ARGS__)
+#define LOG_TOKEN_PUT_5(p_rec, a, ...)  LOG_TOKEN_PUT(p_rec, a) LOG_TOKEN_PUT_4(p_rec, __VA_ARGS__)
+#define LOG_TOKEN_PUT_6(p_rec, a, ...)  LOG_TOKEN_PUT(p_rec, a) LOG_TOKEN_PUT_5(p_rec, __VA_ARGS__)
+#define LOG_TOKEN_PUT_7(p_rec, a, ...)  LOG_TOKEN_PUT(p_rec, a) LOG_TOKEN_PUT_6(p_rec, __VA_ARGS__)
+#define LOG_TOKEN_PUT_8(p_rec, a, ...)  LOG_TOKEN_PUT(p_rec, a) LOG_TOKEN_PUT_7(p_rec, __VA_ARGS__)
+#define LOG_TOKEN_PUT_9(p_rec, a, ...)  LOG_TOKEN_PUT(p_rec, a) LOG_TOKEN_PUT_8(p_rec, __VA_ARGS__)
+#define LOG_TOKEN_PUT_10(p_rec, a, ...) LOG_TOKEN_PUT(p_rec, a) LOG_TOKEN_PUT_9(p_rec, __VA_ARGS__)
+#define LOG_TOKEN_PUT_11(p_rec, a, ...) LOG_TOKEN_PUT(p_rec, a) LOG_TOKEN_PUT_10(p_rec, __VA_ARGS__)
+#define LOG_TOKEN_PUT_12(p_rec, a, ...) LOG_TOKEN_PUT(p_rec, a) LOG_TOKEN_PUT_11(p_rec, __VA_ARGS__)
+#define LOG_TOKEN_PUT_13(p_rec, a, ...) LOG_TOKEN_PUT(p_rec, a) LOG_TOKEN_PUT_12(p_rec, __VA_ARGS__)
+#define LOG_TOKEN_PUT_14(p_rec, a, ...) LOG_TOKEN_PUT(p_rec, a) LOG_TOKEN_PUT_13(p_rec, __VA_ARGS__)
+#define LOG_TOKEN_PUT_15(p_rec, a, ...) LOG_TOKEN_PUT(p_rec, a) LOG_TOKEN_PUT_14(p_rec, __VA_ARGS__)
+#define LOG_TOKEN_PUT_16(p_rec, a, ...) LOG_TOKEN_PUT(p_rec, a) LOG_TOKEN_PUT_15(p_rec, __VA_ARGS__)
+
+/*
+ * Sends one record to an RTT channel, the value is the record length or 0 when it was dropped. The format must be a
+ * string literal.
+ */
+#define LOG_TOKEN_PRINT_TO(channel, fmt_, ...)                                                                        \
+    ({                                                                                                                \
+        static const char log_token_fmt_[] __attribute__((section(".log_fmt"), used)) = fmt_;                        \
+        log_token_record_t log_token_rec_;                                                                            \
+        log_token_begin (&log_token_rec_, log_token_fmt_);                                                            \
+        LOG_TOKEN_CAT(LOG_TOKEN_PUT_, LOG_TOKEN_COUNT(__VA_ARGS__))(&log_token_rec_, ##__VA_ARGS__)                   \
+        log_token_end (&log_token_rec_, (channel));                                                                   \
+    })
+#define LOG_TOKEN_PRINT(fmt_, ...)      LOG_TOKEN_PRINT_TO(LOG_TOKEN_RTT_CHANNEL, fmt_, ##__VA_ARGS__)
+
+/*******************************************************************************************************************//**
+ * @brief      Starts a record with the id of its format.
+ **********************************************************************************************************************/
+static inline void log_token_begin(log_token_record_t * p_record, const char * p_fmt)
+{
+    uint32_t id = (uint32_t) (uintptr_t) p_fmt;
+
+    p_record->data[0] = (uint8_t) id;
+    p_record->data[1] = (uint8_t) (id >> 8);
+    p_record->length  = LOG_TOKEN_HEADER_LEN;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Appends a 32 bit argument, dropped when the record is full.
+ **********************************************************************************************************************/
+static inline void log_token_put_u32(log_token_record_t * p_record, uint32_t value)
+{
+    if ((p_record->length + sizeof(value)) <= LOG_TOKEN_RECORD_MAX)
+    {
+        memcpy (&p_record->data[p_record->length], &value, sizeof(value));
+        p_record->length += sizeof(value);
+    }
+}
+
+void log_token_put_str(log_token_record_t * p_record, const char * p_str);
+void log_token_put_ustr(log_token_record_t * p_record, const unsigned char * p_str);
+uint32_t log_token_end(log_token_record_t * p_record, uint32_t channel);
+void log_token_bench(void);
+
+#endif /* LOG_TOKEN_H_ */
@@ -0,0 +1,481 @@
+/***********************************************************************************************************************
+ * File Name    : mem_pool.c
+ * Description  : This file serves the allocations of mbedTLS and PKCS#11 from fixed block pools in static arenas
+ *                instead of the FreeRTOS heap. Blocks of a size class are interchangeable, so freeing in any order
+ *                leaves no holes. The mbedTLS allocations of the task running a TLS session go to the TLS pool for the
+ *                life of the session, and the pool is laid out afresh when the session is torn down.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_SYS)
+
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mbedtls/platform.h"
+#include "user_app.h"
+#include "mem_pool.h"
+#include "heap_trace.h"
+
+#if (MEM_POOL_ENABLE == ENABLE) && !defined(MBEDTLS_PLATFORM_MEMORY)
+ #error "The mbedTLS pool is installed with mbedtls_platform_set_calloc_free(), enable MBEDTLS_PLATFORM_MEMORY"
+#endif
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+typedef struct st_mem_pool_class_state
+{
+    uint8_t * p_start;
+    uint8_t * p_end;
+    void * p_free;                      /* Free list, linked through the first word of the free blocks */
+    uint32_t in_use;
+    uint32_t peak;
+} mem_pool_class_state_t;
+
+typedef struct st_mem_pool
+{
+    const char * p_name;
+    heap_trace_tag_t tag;               /* Subsystem charged for the blocks and the heap fallbacks */
+    const mem_pool_class_t * p_classes;
+    mem_pool_class_state_t * p_state;
+    uint32_t class_count;
+    uint8_t * p_arena;
+    uint32_t arena_size;
+    mem_pool_stats_t stats;
+} mem_pool_t;
+
+static const mem_pool_class_t g_tls_classes[] = MEM_POOL_TLS_CLASSES;
+static const mem_pool_class_t g_pkcs11_classes[] = MEM_POOL_PKCS11_CLASSES;
+static mem_pool_class_state_t g_tls_state[sizeof(g_tls_classes) / sizeof(g_tls_classes[0])];
+static mem_pool_class_state_t g_pkcs11_state[sizeof(g_pkcs11_classes) / sizeof(g_pkcs11_classes[0])];
+
+#if (MEM_POOL_ENABLE == ENABLE)
+static uint64_t g_tls_arena[MEM_POOL_TLS_ARENA_SIZE / sizeof(uint64_t)];
+static uint64_t g_pkcs11_arena[MEM_POOL_PKCS11_ARENA_SIZE / sizeof(uint64_t)];
+#endif
+
+static mem_pool_t g_pools[MEM_POOL_COUNT] =
+{
+    [MEM_POOL_TLS] =
+    {
+        .p_name      = "TLS",
+        .tag         = HEAP_TRACE_TAG_TLS,
+        .p_classes   = g_tls_classes,
+        .p_state     = g_tls_state,
+        .class_count = sizeof(g_tls_classes) / sizeof(g_tls_classes[0]),
+    },
+    [MEM_POOL_PKCS11] =
+    {
+        .p_name      = "PKCS#11",
+        .tag         = HEAP_TRACE_TAG_PKCS11,
+        .p_classes   = g_pkcs11_classes,
+        .p_state     = g_pkcs11_state,
+        .class_count = sizeof(g_pkcs11_classes) / sizeof(g_pkcs11_classes[0]),
+    },
+};
+
+/* TLS session in progress, only the allocations of its task are taken from the TLS pool */
+static bool g_session_open = false;
+static TaskHandle_t g_session_task = NULL;
+
+/* Reconnect stress trace: the allocations and frees of one TLS session by slot, see mem_pool_trace.h */
+static const uint32_t g_stress_trace[] = MEM_POOL_TLS_TRACE;
+
+static bool mem_pool_layout(mem_pool_t * p_pool);
+static void * mem_pool_take(mem_pool_t * p_pool, size_t size);
+static bool mem_pool_give(mem_pool_t * p_pool, void * p_block);
+static void * mem_pool_alloc(mem_pool_t * p_pool, size_t size);
+static uint32_t mem_pool_in_use(const mem_pool_t * p_pool);
+
+/*******************************************************************************************************************//**
+ * @brief      Lays out the pools and installs the TLS pool as the mbedTLS allocator. Call after
+ *             mbedtls_platform_setup(), which installs the FreeRTOS heap.
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  Pools in use, or disabled.
+ * @retval     FSP_ERR_OUT_OF_MEMORY        Size classes do not fit their arena, the heap stays in use.
+ **********************************************************************************************************************/
+fsp_err_t mem_pool_init(void)
+{
+#if (MEM_POOL_ENABLE == ENABLE)
+    g_pools[MEM_POOL_TLS].p_arena       = (uint8_t *) g_tls_arena;
+    g_pools[MEM_POOL_TLS].arena_size    = sizeof(g_tls_arena);
+    g_pools[MEM_POOL_PKCS11].p_arena    = (uint8_t *) g_pkcs11_arena;
+    g_pools[MEM_POOL_PKCS11].arena_size = sizeof(g_pkcs11_arena);
+
+    for (uint32_t i = 0; i < MEM_POOL_COUNT; i++)
+    {
+        if (!mem_pool_layout (&g_pools[i]))
+        {
+            APP_ERR_PRINT("** %s pool classes exceed the %d byte arena ** \r\n", g_pools[i].p_name,
+                          g_pools[i].arena_size);
+            g_pools[i].arena_size = 0U;
+            return FSP_ERR_OUT_OF_MEMORY;
+        }
+    }
+    (void) mbedtls_platform_set_calloc_free (mem_pool_tls_calloc, mem_pool_tls_free);
+#endif
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Starts a TLS session: from here the mbedTLS allocations of the calling task are taken from the TLS pool.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void mem_pool_session_begin(void)
+{
+    if (!g_session_open)
+    {
+        g_session_task = xTaskGetCurrentTaskHandle ();
+        g_session_open = true;
+        heap_trace_pool_event (HEAP_TRACE_TAG_TLS, HEAP_TRACE_OP_SESSION, NULL, 1U);
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Ends the TLS session once mbedTLS freed its context. The TLS pool is laid out again, which releases
+ *             the whole session at once. A block still taken would be overwritten, so a pool that is not empty is
+ *             kept as it is and the session is counted as leaked.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void mem_pool_session_end(void)
+{
+    mem_pool_t * p_pool = &g_pools[MEM_POOL_TLS];
+    uint32_t in_use = RESET_VALUE;
+
+    if (!g_session_open)
+    {
+        return;
+    }
+    g_session_open = false;
+    p_pool->stats.sessions++;
+    heap_trace_pool_event (HEAP_TRACE_TAG_TLS, HEAP_TRACE_OP_SESSION, NULL, 0U);
+
+    in_use = mem_pool_in_use (p_pool);
+    if (0U == in_use)
+    {
+        (void) mem_pool_layout (p_pool);
+    }
+    else
+    {
+        p_pool->stats.leaked++;
+        APP_ERR_PRINT("** TLS session left %d pool blocks allocated ** \r\n", in_use);
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      mbedTLS calloc. Allocations of the session task during a TLS session come from the TLS pool, all others
+ *             from the FreeRTOS heap as before: the credentials cached across sessions never enter the pool.
+ * @param[in]  count                        Number of elements.
+ * @param[in]  size                         Element size.
+ * @retval     Zeroed block, NULL when out of memory.
+ **********************************************************************************************************************/
+void * mem_pool_tls_calloc(size_t count, size_t size)
+{
+    size_t bytes = count * size;
+    void * p_block = NULL;
+
+    if ((0U != size) && ((bytes / size) != count))
+    {
+        return NULL;
+    }
+
+    if (g_session_open && (xTaskGetCurrentTaskHandle () == g_session_task))
+    {
+        p_block = mem_pool_alloc (&g_pools[MEM_POOL_TLS], bytes);
+    }
+    else
+    {
+        p_block = heap_trace_malloc (HEAP_TRACE_TAG_TLS, bytes);
+    }
+    if (NULL != p_block)
+    {
+        memset (p_block, 0, bytes);
+    }
+    return p_block;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      mbedTLS free, for pool blocks and heap blocks alike.
+ * @param[in]  p_block                      Block to free, may be NULL.
+ * @retval     None
+ **********************************************************************************************************************/
+void mem_pool_tls_free(void * p_block)
+{
+    if ((NULL != p_block) && !mem_pool_give (&g_pools[MEM_POOL_TLS], p_block))
+    {
+        vPortFree (p_block);
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      PKCS11 Malloc of the PKCS#11 module configuration.
+ * @param[in]  size                         Bytes.
+ * @retval     Block, NULL when out of memory.
+ **********************************************************************************************************************/
+void * mem_pool_pkcs11_malloc(size_t size)
+{
+    return mem_pool_alloc (&g_pools[MEM_POOL_PKCS11], size);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      PKCS11 Free of the PKCS#11 module configuration.
+ * @param[in]  p_block                      Block to free, may be NULL.
+ * @retval     None
+ **********************************************************************************************************************/
+void mem_pool_pkcs11_free(void * p_block)
+{
+    if ((NULL != p_block) && !mem_pool_give (&g_pools[MEM_POOL_PKCS11], p_block))
+    {
+        vPortFree (p_block);
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints the counters of the pools and the use of every size class.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void mem_pool_print_stats(void)
+{
+    for (uint32_t i = 0; i < MEM_POOL_COUNT; i++)
+    {
+        const mem_pool_t * p_pool = &g_pools[i];
+
+        APP_PRINT("\r\n%s pool: %d bytes, %d allocations, %d fallbacks to the heap (largest %d bytes), %d failed\r\n",
+                  p_pool->p_name, p_pool->arena_size, p_pool->stats.allocs, p_pool->stats.fallbacks,
+                  p_pool->stats.fallback_max, p_pool->stats.failed);
+        if (MEM_POOL_TLS == i)
+        {
+            APP_PRINT("\t%d sessions, %d left blocks allocated\r\n", p_pool->stats.sessions, p_pool->stats.leaked);
+        }
+        for (uint32_t c = 0; c < p_pool->class_count; c++)
+        {
+            APP_PRINT("\t%5d bytes: %d blocks, %d in use, peak %d\r\n", p_pool->p_classes[c].block_size,
+                      p_pool->p_classes[c].blocks, p_pool->p_state[c].in_use, p_pool->p_state[c].peak);
+        }
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Replays the allocations and frees of the TLS session of mem_pool_trace.h reconnects times through the
+ *             TLS pool, each replay ending like a teardown, and compares the FreeRTOS heap before and after. Must run
+ *             in the task that owns the TLS sessions, with no session open. Other tasks using the heap meanwhile show
+ *             in the heap figures.
+ * @param[in]  reconnects                   Sessions to replay.
+ * @retval     FSP_SUCCESS                  Every replay left the pool empty and the heap is not more fragmented.
+ * @retval     FSP_ERR_IN_USE               A TLS session is open.
+ * @retval     FSP_ERR_INVALID_STATE        Blocks leaked or the heap fragmented.
+ **********************************************************************************************************************/
+fsp_err_t mem_pool_stress(uint32_t reconnects)
+{
+    mem_pool_t * p_pool = &g_pools[MEM_POOL_TLS];
+    void * p_live[MEM_POOL_STRESS_LIVE_MAX] = {NULL};
+    uint32_t slot = RESET_VALUE;
+    uint32_t allocs = p_pool->stats.allocs;
+    uint32_t fallbacks = p_pool->stats.fallbacks;
+    uint32_t leaked = p_pool->stats.leaked;
+    HeapStats_t before;
+    HeapStats_t after;
+    bool pass = false;
+
+    if (g_session_open)
+    {
+        return FSP_ERR_IN_USE;
+    }
+#if (MEM_POOL_TLS_TRACE_CAPTURED == 0)
+    APP_PRINT("\r\nReplaying the estimated TLS session of mem_pool_trace.h, capture one with tools/heap_trace.py\r\n");
+#endif
+
+    vPortGetHeapStats (&before);
+    for (uint32_t r = 0; r < reconnects; r++)
+    {
+        mem_pool_session_begin ();
+        for (uint32_t i = 0; i < (sizeof(g_stress_trace) / sizeof(g_stress_trace[0])); i++)
+        {
+            slot = MEM_POOL_TRACE_SLOT(g_stress_trace[i]) % MEM_POOL_STRESS_LIVE_MAX;
+            mem_pool_tls_free (p_live[slot]);
+            p_live[slot] = NULL;
+            if (0U != MEM_POOL_TRACE_SIZE(g_stress_trace[i]))
+            {
+                p_live[slot] = mem_pool_tls_calloc (1U, MEM_POOL_TRACE_SIZE(g_stress_trace[i]));
+            }
+        }
+
+        /* Teardown frees what the session still holds */
+        for (slot = 0; slot < MEM_POOL_STRESS_LIVE_MAX; slot++)
+        {
+            mem_pool_tls_free (p_live[slot]);
+            p_live[slot] = NULL;
+        }
+        mem_pool_session_end ();
+    }
+    vPortGetHeapStats (&after);
+
+    pass = (leaked == p_pool->stats.leaked) &&
+           (after.xNumberOfFreeBlocks <= before.xNumberOfFreeBlocks) &&
+           (after.xSizeOfLargestFreeBlockInBytes >= before.xSizeOfLargestFreeBlockInBytes);
+
+    APP_PRINT("\r\n%s,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%s\r\n", MEM_POOL_STRESS_TAG, reconnects,
+              p_pool->stats.allocs - allocs, p_pool->stats.fallbacks - fallbacks, p_pool->stats.leaked - leaked,
+              (uint32_t) before.xAvailableHeapSpaceInBytes, (uint32_t) after.xAvailableHeapSpaceInBytes,
+              (uint32_t) before.xSizeOfLargestFreeBlockInBytes, (uint32_t) after.xSizeOfLargestFreeBlockInBytes,
+              (uint32_t) before.xNumberOfFreeBlocks, (uint32_t) after.xNumberOfFreeBlocks, pass ? "pass" : "FAIL");
+    return pass ? FSP_SUCCESS : FSP_ERR_INVALID_STATE;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Cuts the arena into the blocks of the size classes and chains every block into its free list.
+ * @retval     false when the classes need more than the arena.
+ **********************************************************************************************************************/
+static bool mem_pool_layout(mem_pool_t * p_pool)
+{
+    uint8_t * p_next = p_pool->p_arena;
+    uint8_t * p_arena_end = p_pool->p_arena + p_pool->arena_size;
+
+    taskENTER_CRITICAL();
+    for (uint32_t c = 0; c < p_pool->class_count; c++)
+    {
+        const mem_pool_class_t * p_class = &p_pool->p_classes[c];
+        mem_pool_class_state_t * p_state = &p_pool->p_state[c];
+
+        if (((uint32_t) (p_arena_end - p_next) / p_class->block_size) < p_class->blocks)
+        {
+            taskEXIT_CRITICAL();
+            return false;
+        }
+        p_state->p_start = p_next;
+        p_state->p_end   = p_next + (p_class->block_size * p_class->blocks);
+        p_state->p_free  = NULL;
+        p_state->in_use  = RESET_VALUE;
+        for (uint32_t i = p_class->blocks; i > 0U; i--)
+        {
+            uint8_t * p_block = p_state->p_start + ((i - 1U) * p_class->block_size);
+
+            *(void **) p_block = p_state->p_free;
+            p_state->p_free    = p_block;
+        }
+        p_next = p_state->p_end;
+    }
+    taskEXIT_CRITICAL();
+    return true;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Takes a block of the smallest class that fits and has one free.
+ * @retval     Block, NULL when no class can take the size.
+ **********************************************************************************************************************/
+static void * mem_pool_take(mem_pool_t * p_pool, size_t size)
+{
+    void * p_block = NULL;
+    uint32_t block_size = RESET_VALUE;
+
+    if (0U == p_pool->arena_size)
+    {
+        return NULL;
+    }
+
+    taskENTER_CRITICAL();
+    for (uint32_t c = 0; c < p_pool->class_count; c++)
+    {
+        mem_pool_class_state_t * p_state = &p_pool->p_state[c];
+
+        if ((size <= p_pool->p_classes[c].block_size) && (NULL != p_state->p_free))
+        {
+            p_block         = p_state->p_free;
+            p_state->p_free = *(void **) p_block;
+            p_state->in_use++;
+            p_state->peak = (p_state->in_use > p_state->peak) ? p_state->in_use : p_state->peak;
+            block_size    = p_pool->p_classes[c].block_size;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+    if (NULL != p_block)
+    {
+        heap_trace_pool_event (p_pool->tag, HEAP_TRACE_OP_POOL_TAKE, p_block, block_size);
+    }
+    return p_block;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns a block to the free list of its class.
+ * @retval     false when the block is not from this pool.
+ **********************************************************************************************************************/
+static bool mem_pool_give(mem_pool_t * p_pool, void * p_block)
+{
+    uint8_t * p_byte = (uint8_t *) p_block;
+    uint32_t block_size = RESET_VALUE;
+
+    if ((p_byte < p_pool->p_arena) || (p_byte >= (p_pool->p_arena + p_pool->arena_size)))
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    for (uint32_t c = 0; c < p_pool->class_count; c++)
+    {
+        mem_pool_class_state_t * p_state = &p_pool->p_state[c];
+
+        if ((p_byte >= p_state->p_start) && (p_byte < p_state->p_end))
+        {
+            *(void **) p_block = p_state->p_free;
+            p_state->p_free    = p_block;
+            p_state->in_use--;
+            block_size         = p_pool->p_classes[c].block_size;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+    heap_trace_pool_event (p_pool->tag, HEAP_TRACE_OP_POOL_GIVE, p_block, block_size);
+    return true;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Takes a pool block, or falls back to the FreeRTOS heap and counts it.
+ **********************************************************************************************************************/
+static void * mem_pool_alloc(mem_pool_t * p_pool, size_t size)
+{
+    void * p_block = mem_pool_take (p_pool, size);
+
+    p_pool->stats.allocs++;
+    if (NULL == p_block)
+    {
+        p_block = heap_trace_malloc (p_pool->tag, size);
+        p_pool->stats.fallbacks++;
+        p_pool->stats.fallback_max = (size > p_pool->stats.fallback_max) ? (uint32_t) size :
+                                     p_pool->stats.fallback_max;
+        p_pool->stats.failed += (NULL == p_block) ? 1U : 0U;
+    }
+    heap_trace_pool_event (p_pool->tag, HEAP_TRACE_OP_POOL_REQUEST, p_block, (uint32_t) size);
+    return p_block;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Blocks taken over all classes.
+ **********************************************************************************************************************/
+static uint32_t mem_pool_in_use(const mem_pool_t * p_pool)
+{
+    uint32_t in_use = RESET_VALUE;
+
+    for (uint32_t c = 0; c < p_pool->class_count; c++)
+    {
+        in_use += p_pool->p_state[c].in_use;
+    }
+    return in_use;
+}
+
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
@@ -0,0 +1,87 @@
+/***********************************************************************************************************************
+ * File Name    : mem_pool.h
+ * Description  : Contains macros, data structures and functions used by the fixed block pools of mbedTLS and PKCS#11
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef MEM_POOL_H_
+#define MEM_POOL_H_
+
+#include "hal_data.h"
+#include "mbedtls/build_info.h"
+#include "app_pkcs11_config.h"
+
+/* A record buffer holds the content plus header, IV, MAC and padding. The content lengths follow the record profile of
+ * app_mbedtls_config.h, so the record class shrinks with the small profile */
+#define MEM_POOL_TLS_RECORD_OVERHEAD    (512U)
+#define MEM_POOL_TLS_RECORD_SIZE        ((((MBEDTLS_SSL_IN_CONTENT_LEN > MBEDTLS_SSL_OUT_CONTENT_LEN) ?               \
+                                           MBEDTLS_SSL_IN_CONTENT_LEN : MBEDTLS_SSL_OUT_CONTENT_LEN) +                \
+                                          MEM_POOL_TLS_RECORD_OVERHEAD + 7U) & ~7U)
+
+/*
+ * Entries of MEM_POOL_TLS_TRACE, one allocation or free of a TLS session in the order mbedTLS made them. The slot
+ * numbers the blocks live at the same time, a slot is reused once its block is freed.
+ */
+#define MEM_POOL_TRACE_ALLOC(slot, size)    (((uint32_t) (slot) << 24) | (uint32_t) (size))
+#define MEM_POOL_TRACE_FREE(slot)           ((uint32_t) (slot) << 24)
+#define MEM_POOL_TRACE_SLOT(entry)          ((entry) >> 24)
+#define MEM_POOL_TRACE_SIZE(entry)          ((entry) & 0xFFFFFFU)
+
+/*
+ * Size classes as {block size, blocks}, ascending. An allocation takes a block of the smallest class that fits and has
+ * one free, the next larger classes otherwise. What no class can take is served by the FreeRTOS heap and counted as
+ * fallback.
+ * TLS: the allocations of one session, from the SSL context to the parsed peer chain and the bignums of the key
+ * exchange. The classes, the arena and the session trace the reconnect stress replays are written to mem_pool_trace.h
+ * by tools/heap_trace.py --emit-c from an allocation trace of the target, see there.
+ * PKCS#11: sessions and object buffers of the PKCS#11 module.
+ */
+#include "mem_pool_trace.h"
+#define MEM_POOL_PKCS11_CLASSES         { {64U, 16U}, {256U, 8U}, {1024U, 4U}, {2048U, 2U} }
+#define MEM_POOL_PKCS11_ARENA_SIZE      (11264U)
+
+/*
+ * Reconnect stress check, one line when done:
+ *   #MEMSTRESS,<reconnects>,<allocations>,<fallbacks>,<leaked sessions>,<heap free before>,<after>,
+ *   <largest free block before>,<after>,<free blocks before>,<after>,<result>
+ */
+#define MEM_POOL_STRESS_TAG             "#MEMSTRESS"
+#define MEM_POOL_STRESS_RECONNECTS      (10000U)
+#define MEM_POOL_STRESS_LIVE_MAX        (64U)          /* Slots of MEM_POOL_TLS_TRACE */
+
+typedef enum e_mem_pool_id
+{
+    MEM_POOL_TLS = 0,
+    MEM_POOL_PKCS11,
+    MEM_POOL_COUNT
+} mem_pool_id_t;
+
+typedef struct st_mem_pool_class
+{
+    uint32_t block_size;                /* Multiple of 8 */
+    uint32_t blocks;
+} mem_pool_class_t;
+
+typedef struct st_mem_pool_stats
+{
+    uint32_t allocs;
+    uint32_t fallbacks;                 /* Served by the FreeRTOS heap */
+    uint32_t fallback_max;              /* Largest of them */
+    uint32_t failed;                    /* Heap exhausted as well */
+    uint32_t sessions;                  /* TLS sessions that ended */
+    uint32_t leaked;                    /* Sessions that ended with blocks still taken, the pool was not reset */
+} mem_pool_stats_t;
+
+fsp_err_t mem_pool_init(void);
+void mem_pool_session_begin(void);
+void mem_pool_session_end(void);
+void * mem_pool_tls_calloc(size_t count, size_t size);
+void mem_pool_tls_free(void * p_block);
+void mem_pool_print_stats(void);
+fsp_err_t mem_pool_stress(uint32_t reconnects);
+
+#endif /* MEM_POOL_H_ */
@@ -0,0 +1,54 @@
+/***********************************************************************************************************************
+ * File Name    : mem_pool_trace.h
+ * Description  : TLS pool size classes and the TLS session the reconnect stress replays, written by
+ *                tools/heap_trace.py --emit-c from an allocation trace of the target. Do not edit,
+ *                capture again after changing the mbedTLS configuration, the credentials or the server
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef MEM_POOL_TRACE_H_
+#define MEM_POOL_TRACE_H_
+
+/*
+ * No capture yet: the trace is an estimate of one client session in the order mbedTLS allocates, record buffers,
+ * handshake parameters, transform and session, the parsed peer chain, then the bignums and temporaries of the key
+ * exchange, all held to the teardown. The classes are sized from it as --emit-c sizes them, mem_pool_stress() says
+ * that it replays an estimate. Replace this file: enable MEM_POOL_ENABLE and HEAP_TRACE_RTT, run tools/rtt_capture.py,
+ * enter "mem trace on" and reconnect a few times, then run tools/heap_trace.py <capture> --emit-c src/mem_pool_trace.h.
+ */
+#define MEM_POOL_TLS_TRACE_CAPTURED     (0)
+
+#define MEM_POOL_TLS_CLASSES            { {32U, 9U}, {64U, 16U}, {128U, 7U}, {256U, 5U}, {512U, 9U}, {1024U, 11U}, \
+                                          {2048U, 6U}, {4096U, 3U}, {MEM_POOL_TLS_RECORD_SIZE, 2U} }
+#define MEM_POOL_TLS_ARENA_SIZE         (43936U + (2U * MEM_POOL_TLS_RECORD_SIZE))
+
+#define MEM_POOL_TLS_TRACE              \
+{ \
+    MEM_POOL_TRACE_ALLOC(0, MEM_POOL_TLS_RECORD_SIZE), MEM_POOL_TRACE_ALLOC(1, MEM_POOL_TLS_RECORD_SIZE), \
+    MEM_POOL_TRACE_ALLOC(2, 1720U), MEM_POOL_TRACE_ALLOC(3, 612U), MEM_POOL_TRACE_ALLOC(4, 296U), \
+    MEM_POOL_TRACE_ALLOC(5, 24U), MEM_POOL_TRACE_ALLOC(6, 1460U), MEM_POOL_TRACE_ALLOC(7, 560U), \
+    MEM_POOL_TRACE_ALLOC(8, 48U), MEM_POOL_TRACE_ALLOC(9, 40U), MEM_POOL_TRACE_ALLOC(10, 56U), \
+    MEM_POOL_TRACE_ALLOC(11, 32U), MEM_POOL_TRACE_ALLOC(12, 40U), MEM_POOL_TRACE_ALLOC(13, 48U), \
+    MEM_POOL_TRACE_ALLOC(14, 24U), MEM_POOL_TRACE_ALLOC(15, 280U), MEM_POOL_TRACE_ALLOC(16, 1290U), \
+    MEM_POOL_TRACE_ALLOC(17, 560U), MEM_POOL_TRACE_ALLOC(18, 48U), MEM_POOL_TRACE_ALLOC(19, 40U), \
+    MEM_POOL_TRACE_ALLOC(20, 56U), MEM_POOL_TRACE_ALLOC(21, 40U), MEM_POOL_TRACE_ALLOC(22, 32U), \
+    MEM_POOL_TRACE_ALLOC(23, 280U), MEM_POOL_TRACE_ALLOC(24, 912U), MEM_POOL_TRACE_ALLOC(25, 560U), \
+    MEM_POOL_TRACE_ALLOC(26, 48U), MEM_POOL_TRACE_ALLOC(27, 40U), MEM_POOL_TRACE_ALLOC(28, 56U), \
+    MEM_POOL_TRACE_ALLOC(29, 280U), MEM_POOL_TRACE_ALLOC(30, 264U), MEM_POOL_TRACE_ALLOC(31, 264U), \
+    MEM_POOL_TRACE_ALLOC(32, 520U), MEM_POOL_TRACE_ALLOC(33, 520U), MEM_POOL_TRACE_ALLOC(34, 136U), \
+    MEM_POOL_TRACE_ALLOC(35, 136U), MEM_POOL_TRACE_ALLOC(36, 72U), MEM_POOL_TRACE_ALLOC(37, 72U), \
+    MEM_POOL_TRACE_ALLOC(38, 264U), MEM_POOL_TRACE_ALLOC(39, 520U), MEM_POOL_TRACE_ALLOC(40, 520U), \
+    MEM_POOL_TRACE_ALLOC(41, 1032U), MEM_POOL_TRACE_ALLOC(42, 136U), MEM_POOL_TRACE_ALLOC(43, 72U), \
+    MEM_POOL_TRACE_ALLOC(44, 40U), MEM_POOL_TRACE_ALLOC(45, 3100U), MEM_POOL_TRACE_ALLOC(46, 24U), \
+    MEM_POOL_TRACE_ALLOC(47, 64U), MEM_POOL_TRACE_ALLOC(48, 128U), MEM_POOL_TRACE_ALLOC(49, 200U), \
+    MEM_POOL_TRACE_ALLOC(50, 96U), MEM_POOL_TRACE_ALLOC(51, 16U), MEM_POOL_TRACE_ALLOC(52, 16U), \
+    MEM_POOL_TRACE_ALLOC(53, 32U), MEM_POOL_TRACE_ALLOC(54, 112U), MEM_POOL_TRACE_ALLOC(55, 264U), \
+    MEM_POOL_TRACE_ALLOC(56, 520U), MEM_POOL_TRACE_ALLOC(57, 1032U), MEM_POOL_TRACE_ALLOC(58, 2056U), \
+    MEM_POOL_TRACE_ALLOC(59, 48U) \
+}
+
+#endif /* MEM_POOL_TRACE_H_ */
@@ -0,0 +1,433 @@
+/***********************************************************************************************************************
+ * File Name    : net_cache.c
+ * Description  : This file keeps the last DHCP lease and the last DNS answer for the server in LittleFS. On a warm
+ *                boot DHCP asks for the stored address again while its lease runs, and the stored answer replaces a
+ *                DNS lookup while its TTL runs. The time from link up to TCP connect is reported.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_NET)
+
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "FreeRTOS_DNS.h"
+#include "core_http_client.h"
+#include "transport_mbedtls_pkcs11.h"
+#include "user_app.h"
+#include "littlefs_app.h"
+#include "boot_profile.h"
+#include "net_cache.h"
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+static net_cache_record_t g_net_cache;
+
+/* Set by the startup task once g_net_cache is read, the DHCP hook in the IP task only looks at it afterwards */
+static volatile bool g_net_cache_loaded = false;
+
+/* Uptime of earlier boots counted up to their last write of the record, see net_cache_now_s() */
+static uint32_t g_clock_base_s = RESET_VALUE;
+
+static uint32_t g_lease_requested = RESET_VALUE;
+static TickType_t g_link_up_tick = RESET_VALUE;
+static bool g_link_up_seen = false;
+static bool g_connect_reported = false;
+static bool g_dns_from_cache = false;
+static uint32_t g_dns_lookup_ms = RESET_VALUE;
+
+static uint32_t net_cache_now_s(void);
+static uint32_t net_cache_dns_query(const char * p_host_name, uint32_t * p_ttl_s);
+static size_t net_cache_dns_skip_name(const uint8_t * p_msg, size_t msg_len, size_t offset);
+static fsp_err_t net_cache_store(void);
+
+/*******************************************************************************************************************//**
+ * @brief      Reads the cache record from LittleFS. Called once LittleFS is mounted. A missing or foreign record
+ *             leaves both entries invalid.
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  Record read.
+ * @retval     FSP_ERR_NOT_FOUND            No usable record, the next lease and lookup are done in full.
+ **********************************************************************************************************************/
+fsp_err_t net_cache_load(void)
+{
+    lfs_file_t file;
+    lfs_ssize_t read_len = RESET_VALUE;
+    fsp_err_t err = FSP_ERR_NOT_FOUND;
+
+    memset (&g_net_cache, RESET_VALUE, sizeof(g_net_cache));
+    if (LFS_ERR_OK == lfs_file_open (&g_rm_littlefs0_lfs, &file, NET_CACHE_FILE_NAME, LFS_O_RDONLY))
+    {
+        read_len = lfs_file_read (&g_rm_littlefs0_lfs, &file, &g_net_cache, sizeof(g_net_cache));
+        (void) lfs_file_close (&g_rm_littlefs0_lfs, &file);
+
+        if (((lfs_ssize_t) sizeof(g_net_cache) == read_len) && (NET_CACHE_MAGIC == g_net_cache.magic)
+            && (NET_CACHE_VERSION == g_net_cache.version))
+        {
+            g_clock_base_s = g_net_cache.clock_s;
+            err = FSP_SUCCESS;
+        }
+        else
+        {
+            memset (&g_net_cache, RESET_VALUE, sizeof(g_net_cache));
+        }
+    }
+    g_net_cache_loaded = true;
+
+    return err;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Called from the DHCP hook before a DISCOVER goes out, marks the link as up. Returns the cached address
+ *             while its lease has not run out, for the DISCOVER to ask for it again in the requested IP address
+ *             option (50). DHCP itself still runs: the server may NAK or offer another address, and the stack renews
+ *             the lease. A DHCP restart later in the same boot asks for no address.
+ * @param[in]  None
+ * @retval     Address to request in network byte order, 0 for none.
+ **********************************************************************************************************************/
+uint32_t net_cache_lease_request(void)
+{
+    if (g_link_up_seen)
+    {
+        return 0U;
+    }
+    g_link_up_seen = true;
+    g_link_up_tick = xTaskGetTickCount ();
+
+#if (NET_CACHE_ENABLE == ENABLE)
+    /* LittleFS is mounted by the startup task, a cache that is not read by now is skipped */
+    if (g_net_cache_loaded && (0U != g_net_cache.lease_valid)
+        && ((net_cache_now_s () - g_net_cache.lease_at_s) < g_net_cache.lease_s))
+    {
+        g_lease_requested = g_net_cache.ip_address;
+    }
+#endif
+    return g_lease_requested;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Stores the lease granted by DHCP in this boot. Must not run while another task uses LittleFS.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void net_cache_lease_store(void)
+{
+    NetworkEndPoint_t * p_end_point = FreeRTOS_FirstEndPoint (NULL);
+
+    if ((NULL == p_end_point) || (0U == p_end_point->ipv4_settings.ulIPAddress))
+    {
+        return;
+    }
+
+    g_net_cache.ip_address         = p_end_point->ipv4_settings.ulIPAddress;
+    g_net_cache.net_mask           = p_end_point->ipv4_settings.ulNetMask;
+    g_net_cache.gateway_address    = p_end_point->ipv4_settings.ulGatewayAddress;
+    g_net_cache.dns_server_address = p_end_point->ipv4_settings.ulDNSServerAddresses[0];
+
+    /* FreeRTOS+TCP keeps half of the granted lease, in ticks, as its renewal time. The grant is dated to now: the
+     * ACK came in this boot, and a later expiry check errs towards plain DISCOVER */
+    g_net_cache.lease_s     = (p_end_point->xDHCPData.ulLeaseTime / configTICK_RATE_HZ) * 2U;
+    g_net_cache.lease_at_s  = net_cache_now_s ();
+    g_net_cache.lease_valid = 1U;
+
+    if (FSP_SUCCESS == net_cache_store ())
+    {
+        APP_DBG_PRINT("\r\nDHCP lease stored, %d s\r\n", g_net_cache.lease_s);
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Resolves a host name, from the cache while the stored answer is within its TTL, otherwise with a DNS
+ *             query whose answer and TTL are stored. Falls back to FreeRTOS_gethostbyname(), whose answer is not
+ *             stored as it carries no TTL.
+ * @param[in]  p_host_name                  Host to resolve.
+ * @param[out] p_cached                     true when the address came from the cache.
+ * @retval     Address in network byte order, 0 when the lookup failed.
+ **********************************************************************************************************************/
+uint32_t net_cache_resolve(const char * p_host_name, bool * p_cached)
+{
+    uint32_t address = RESET_VALUE;
+    uint32_t ttl_s = RESET_VALUE;
+    TickType_t start_tick = RESET_VALUE;
+
+    *p_cached = false;
+
+#if (NET_CACHE_ENABLE == ENABLE)
+    if ((0U != g_net_cache.dns_valid) && ((net_cache_now_s () - g_net_cache.dns_at_s) < g_net_cache.dns_ttl_s)
+        && (0 == strncmp (g_net_cache.host_name, p_host_name, NET_CACHE_HOST_LEN)))
+    {
+        *p_cached        = true;
+        g_dns_from_cache = true;
+        return g_net_cache.host_address;
+    }
+#endif
+
+    start_tick = xTaskGetTickCount ();
+#if (NET_CACHE_ENABLE == ENABLE)
+    address = net_cache_dns_query (p_host_name, &ttl_s);
+#endif
+    if (0U == address)
+    {
+        address = FreeRTOS_gethostbyname (p_host_name);
+    }
+    g_dns_lookup_ms  = (xTaskGetTickCount () - start_tick) * portTICK_PERIOD_MS;
+    g_dns_from_cache = false;
+    if (0U == address)
+    {
+        return address;
+    }
+    boot_profile_mark ("DNS resolved");
+
+    if (0U == ttl_s)
+    {
+        return address;
+    }
+    g_net_cache.dns_valid    = 1U;
+    g_net_cache.host_address = address;
+    g_net_cache.dns_ttl_s    = ttl_s;
+    g_net_cache.dns_at_s     = net_cache_now_s ();
+    strncpy (g_net_cache.host_name, p_host_name, NET_CACHE_HOST_LEN - 1U);
+    g_net_cache.host_name[NET_CACHE_HOST_LEN - 1U] = '\0';
+    (void) net_cache_store ();
+
+    return address;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Drops the cached DNS answer after a failed connect to it, the next resolve does a lookup.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void net_cache_dns_invalidate(void)
+{
+    if (0U == g_net_cache.dns_valid)
+    {
+        return;
+    }
+    APP_INFO_PRINT("\r\nCached address of %s dropped\r\n", g_net_cache.host_name);
+    g_net_cache.dns_valid = RESET_VALUE;
+    (void) net_cache_store ();
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Called once the TCP connection is up. Prints the time since link up for the first connect of a boot.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void net_cache_connected(void)
+{
+    uint32_t connect_ms = RESET_VALUE;
+    NetworkEndPoint_t * p_end_point = FreeRTOS_FirstEndPoint (NULL);
+    const char * p_lease = "new";
+
+    if (g_connect_reported || !g_link_up_seen)
+    {
+        return;
+    }
+    g_connect_reported = true;
+    boot_profile_mark ("TCP connected");
+
+    if (0U != g_lease_requested)
+    {
+        p_lease = ((NULL != p_end_point) && (g_lease_requested == p_end_point->ipv4_settings.ulIPAddress)) ?
+                  "cached address granted" : "cached address refused";
+    }
+    connect_ms = (xTaskGetTickCount () - g_link_up_tick) * portTICK_PERIOD_MS;
+    if (g_dns_from_cache)
+    {
+        APP_INFO_PRINT("\r\nLink up to TCP connect: %d ms (lease %s, DNS cached)\r\n", connect_ms, p_lease);
+    }
+    else
+    {
+        APP_INFO_PRINT("\r\nLink up to TCP connect: %d ms (lease %s, DNS lookup %d ms)\r\n", connect_ms, p_lease,
+                       g_dns_lookup_ms);
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Seconds on a clock that only runs while the board is powered: the uptime of earlier boots up to their
+ *             last write of the record plus the uptime of this boot. Without a real time clock the time spent
+ *             powered off is unknown, so this is a lower bound of the real time since an entry was stored. An expired
+ *             lease is always detected late rather than early; the DHCP server has the final word on the address and
+ *             a cached DNS answer that no longer connects is dropped by net_cache_dns_invalidate().
+ **********************************************************************************************************************/
+static uint32_t net_cache_now_s(void)
+{
+    return g_clock_base_s + (xTaskGetTickCount () / configTICK_RATE_HZ);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Sends one A query for the host to the DNS server of the lease and reads the address and TTL from the
+ *             answer. Over a CNAME chain the lowest TTL of the chain applies. Returns 0 on any failure.
+ **********************************************************************************************************************/
+static uint32_t net_cache_dns_query(const char * p_host_name, uint32_t * p_ttl_s)
+{
+    uint8_t msg[NET_CACHE_DNS_MSG_LEN];
+    NetworkEndPoint_t * p_end_point = FreeRTOS_FirstEndPoint (NULL);
+    Socket_t dns_socket = FREERTOS_INVALID_SOCKET;
+    struct freertos_sockaddr server;
+    uint32_t server_len = sizeof(server);
+    TickType_t timeout = pdMS_TO_TICKS(NET_CACHE_DNS_TIMEOUT_MS);
+    uint32_t id = RESET_VALUE;
+    size_t name_len = strlen (p_host_name);
+    size_t offset = NET_CACHE_DNS_HEADER_LEN;
+    size_t label = offset;
+    int32_t msg_len = RESET_VALUE;
+    uint32_t answers = RESET_VALUE;
+    uint32_t rr_type = RESET_VALUE;
+    uint32_t rr_class = RESET_VALUE;
+    uint32_t rr_ttl = RESET_VALUE;
+    uint32_t rr_len = RESET_VALUE;
+    uint32_t ttl_s = UINT32_MAX;
+    uint32_t address = RESET_VALUE;
+
+    if ((NULL == p_end_point) || (0U == p_end_point->ipv4_settings.ulDNSServerAddresses[0])
+        || ((NET_CACHE_DNS_HEADER_LEN + name_len + 6U) > sizeof(msg)))
+    {
+        return 0U;
+    }
+
+    /* Header: ID, recursion desired, one question */
+    (void) xApplicationGetRandomNumber (&id);
+    memset (msg, RESET_VALUE, sizeof(msg));
+    msg[0] = (uint8_t) (id >> 8);
+    msg[1] = (uint8_t) id;
+    msg[2] = 0x01U;
+    msg[5] = 0x01U;
+
+    /* Question: the name as labels, type A, class IN */
+    for (size_t i = 0U; i <= name_len; i++)
+    {
+        if ((i == name_len) || ('.' == p_host_name[i]))
+        {
+            msg[label] = (uint8_t) (offset - label);
+            label      = ++offset;
+        }
+        else
+        {
+            msg[++offset] = (uint8_t) p_host_name[i];
+        }
+    }
+    msg[offset++] = 0U;
+    msg[offset++] = 0U;
+    msg[offset++] = 1U;
+    msg[offset++] = 0U;
+    msg[offset++] = 1U;
+
+    dns_socket = FreeRTOS_socket (FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP);
+    if (FREERTOS_INVALID_SOCKET == dns_socket)
+    {
+        return 0U;
+    }
+    (void) FreeRTOS_setsockopt (dns_socket, 0, FREERTOS_SO_RCVTIMEO, &timeout, sizeof(timeout));
+    memset (&server, RESET_VALUE, sizeof(server));
+    server.sin_family            = FREERTOS_AF_INET;
+    server.sin_port              = FreeRTOS_htons (NET_CACHE_DNS_PORT);
+    server.sin_address.ulIP_IPv4 = p_end_point->ipv4_settings.ulDNSServerAddresses[0];
+
+    if (FreeRTOS_sendto (dns_socket, msg, offset, 0, &server, sizeof(server)) > 0)
+    {
+        msg_len = FreeRTOS_recvfrom (dns_socket, msg, sizeof(msg), 0, &server, &server_len);
+    }
+    (void) FreeRTOS_closesocket (dns_socket);
+
+    /* Same ID, a response, no error code, at least one answer */
+    if ((msg_len < (int32_t) offset) || (msg[0] != (uint8_t) (id >> 8)) || (msg[1] != (uint8_t) id)
+        || (0U == (msg[2] & 0x80U)) || (0U != (msg[3] & 0x0FU)))
+    {
+        return 0U;
+    }
+    answers = ((uint32_t) msg[6] << 8) | msg[7];
+
+    /* The question is echoed first, the answers follow it */
+    for (; (0U != answers) && (0U == address); answers--)
+    {
+        offset = net_cache_dns_skip_name (msg, (size_t) msg_len, offset);
+        if ((0U == offset) || ((offset + 10U) > (size_t) msg_len))
+        {
+            return 0U;
+        }
+        rr_type  = ((uint32_t) msg[offset] << 8) | msg[offset + 1U];
+        rr_class = ((uint32_t) msg[offset + 2U] << 8) | msg[offset + 3U];
+        rr_ttl   = ((uint32_t) msg[offset + 4U] << 24) | ((uint32_t) msg[offset + 5U] << 16) |
+                   ((uint32_t) msg[offset + 6U] << 8) | msg[offset + 7U];
+        rr_len   = ((uint32_t) msg[offset + 8U] << 8) | msg[offset + 9U];
+        offset += 10U;
+        if ((offset + rr_len) > (size_t) msg_len)
+        {
+            return 0U;
+        }
+
+        ttl_s = (rr_ttl < ttl_s) ? rr_ttl : ttl_s;
+        if ((1U == rr_type) && (1U == rr_class) && (4U == rr_len))
+        {
+            memcpy (&address, &msg[offset], sizeof(address));
+        }
+        offset += rr_len;
+    }
+
+    *p_ttl_s = (0U != address) ? ttl_s : 0U;
+    return address;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns the offset behind a name in a DNS message, a compressed name ends at its pointer. 0 when the
+ *             name runs past the message.
+ **********************************************************************************************************************/
+static size_t net_cache_dns_skip_name(const uint8_t * p_msg, size_t msg_len, size_t offset)
+{
+    while (offset < msg_len)
+    {
+        if (0U == p_msg[offset])
+        {
+            return offset + 1U;
+        }
+        if (0xC0U == (p_msg[offset] & 0xC0U))
+        {
+            return ((offset + 2U) <= msg_len) ? (offset + 2U) : 0U;
+        }
+        offset += p_msg[offset] + 1U;
+    }
+    return 0U;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Writes the cache record, LittleFS commits the new file contents atomically on close. The clock of
+ *             net_cache_now_s() is saved with it.
+ **********************************************************************************************************************/
+static fsp_err_t net_cache_store(void)
+{
+    lfs_file_t file;
+    lfs_ssize_t written = RESET_VALUE;
+    int lfs_err = LFS_ERR_OK;
+
+    g_net_cache.magic   = NET_CACHE_MAGIC;
+    g_net_cache.version = NET_CACHE_VERSION;
+    g_net_cache.clock_s = net_cache_now_s ();
+
+    lfs_err = lfs_file_open (&g_rm_littlefs0_lfs, &file, NET_CACHE_FILE_NAME, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+    if (LFS_ERR_OK != lfs_err)
+    {
+        APP_ERR_PRINT("** Failed to open %s: %d ** \r\n", NET_CACHE_FILE_NAME, lfs_err);
+        return FSP_ERR_WRITE_FAILED;
+    }
+    written = lfs_file_write (&g_rm_littlefs0_lfs, &file, &g_net_cache, sizeof(g_net_cache));
+    lfs_err = lfs_file_close (&g_rm_littlefs0_lfs, &file);
+
+    return (((lfs_ssize_t) sizeof(g_net_cache) == written) && (LFS_ERR_OK == lfs_err)) ? FSP_SUCCESS :
+           FSP_ERR_WRITE_FAILED;
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
@@ -0,0 +1,60 @@
+/***********************************************************************************************************************
+ * File Name    : net_cache.h
+ * Description  : Contains macros, data structures and functions used by the DHCP lease and DNS answer cache
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef NET_CACHE_H_
+#define NET_CACHE_H_
+
+#include "hal_data.h"
+#include "FreeRTOS.h"
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Routing.h"
+
+/* LittleFS file holding the last DHCP lease and the last answer for HTTPS_HOST_ADDRESS */
+#define NET_CACHE_FILE_NAME             "/net_cache"
+#define NET_CACHE_MAGIC                 (0x4554454EUL)      /* "NETE" */
+#define NET_CACHE_VERSION               (2U)
+#define NET_CACHE_HOST_LEN              (64U)
+
+/* DNS query of net_cache_resolve(), a UDP message without EDNS is at most 512 bytes */
+#define NET_CACHE_DNS_PORT              (53U)
+#define NET_CACHE_DNS_HEADER_LEN        (12U)
+#define NET_CACHE_DNS_MSG_LEN           (512U)
+
+typedef struct st_net_cache_record
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t clock_s;                   /* Powered time counted over all boots when the record was written */
+
+    /* DHCP lease, addresses in network byte order as used by FreeRTOS+TCP */
+    uint32_t lease_valid;
+    uint32_t ip_address;
+    uint32_t net_mask;
+    uint32_t gateway_address;
+    uint32_t dns_server_address;
+    uint32_t lease_s;                   /* Lease time granted by the server */
+    uint32_t lease_at_s;                /* clock_s when the lease was granted */
+
+    /* DNS answer */
+    uint32_t dns_valid;
+    uint32_t host_address;
+    uint32_t dns_ttl_s;                 /* TTL of the answer */
+    uint32_t dns_at_s;                  /* clock_s when the answer came in */
+    char     host_name[NET_CACHE_HOST_LEN];
+} net_cache_record_t;
+
+fsp_err_t net_cache_load(void);
+uint32_t net_cache_lease_request(void);
+void net_cache_lease_store(void);
+uint32_t net_cache_resolve(const char * p_host_name, bool * p_cached);
+void net_cache_dns_invalidate(void);
+void net_cache_connected(void);
+
+#endif /* NET_CACHE_H_ */
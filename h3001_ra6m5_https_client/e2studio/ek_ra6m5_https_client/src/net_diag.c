@@ -0,0 +1,302 @@
+/***********************************************************************************************************************
+ * File Name    : net_diag.c
+ * Description  : This file runs the ICMP reachability check in a low priority task. Each echo is timed from the
+ *                request to vApplicationPingReplyHook() and sorted into an RTT histogram. The check stops after the
+ *                requested count or at its deadline, whichever comes first.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_NET)
+
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "core_http_client.h"
+#include "transport_mbedtls_pkcs11.h"
+#include "user_app.h"
+#include "app_timing.h"
+#include "boot_profile.h"
+#include "net_diag.h"
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/* Echo request waiting for its reply */
+typedef struct st_net_diag_slot
+{
+    bool       in_use;
+    uint16_t   identifier;                      /* Sequence number returned by FreeRTOS_SendPingRequest() */
+    uint32_t   sent_cycles;
+    TickType_t sent_tick;
+} net_diag_slot_t;
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+static net_diag_stats_t g_ping_stats;
+static net_diag_slot_t g_ping_slots[NET_DIAG_MAX_OUTSTANDING];
+static const uint32_t g_hist_bounds_ms[NET_DIAG_HIST_BUCKETS - 1U] = NET_DIAG_HIST_BOUNDS_MS;
+static TaskHandle_t g_ping_task = NULL;
+static const char * g_ping_address = NULL;
+static uint32_t g_ping_count = RESET_VALUE;
+static uint32_t g_ping_deadline_ms = RESET_VALUE;
+static volatile bool g_ping_running = false;
+
+static void net_diag_ping_task(void * pvParameters);
+static uint32_t net_diag_expire(bool all);
+static void net_diag_record_rtt(uint32_t rtt_us);
+
+/*******************************************************************************************************************//**
+ * @brief      Starts the reachability check in the background and returns immediately. Results are printed by the
+ *             task when it finishes and can be printed again with net_diag_ping_print().
+ * @param[in]  p_ip_address                 Target in dotted decimal notation, must stay valid until the check ends.
+ * @param[in]  count                        Number of echo requests.
+ * @param[in]  deadline_ms                  Time after which the check stops, outstanding echoes count as timed out.
+ * @retval     FSP_SUCCESS                  Task started.
+ * @retval     FSP_ERR_IN_USE               A check is still running.
+ * @retval     FSP_ERR_INVALID_ARGUMENT     Address could not be parsed or count is zero.
+ * @retval     FSP_ERR_OUT_OF_MEMORY        Task could not be created.
+ **********************************************************************************************************************/
+fsp_err_t net_diag_ping_start(const char * p_ip_address, uint32_t count, uint32_t deadline_ms)
+{
+    BaseType_t status = pdFAIL;
+
+    if (g_ping_running)
+    {
+        return FSP_ERR_IN_USE;
+    }
+    if ((NULL == p_ip_address) || (0U == FreeRTOS_inet_addr (p_ip_address)) || (0U == count))
+    {
+        return FSP_ERR_INVALID_ARGUMENT;
+    }
+
+    memset (&g_ping_stats, RESET_VALUE, sizeof(g_ping_stats));
+    memset (g_ping_slots, RESET_VALUE, sizeof(g_ping_slots));
+    g_ping_stats.rtt_min_us = UINT32_MAX;
+    g_ping_address          = p_ip_address;
+    g_ping_count            = count;
+    g_ping_deadline_ms      = deadline_ms;
+    g_ping_running          = true;
+
+    status = xTaskCreate (net_diag_ping_task, NET_DIAG_TASK_NAME, NET_DIAG_TASK_STACK, NULL, NET_DIAG_TASK_PRIORITY,
+                          &g_ping_task);
+    if (pdPASS != status)
+    {
+        g_ping_running = false;
+        return FSP_ERR_OUT_OF_MEMORY;
+    }
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Tells whether a check is in progress.
+ * @param[in]  None
+ * @retval     true while the ping task runs.
+ **********************************************************************************************************************/
+bool net_diag_ping_running(void)
+{
+    return g_ping_running;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Matches a reply to its request. Called from vApplicationPingReplyHook() in the IP task.
+ * @param[in]  status                       Reply status reported by the IP stack.
+ * @param[in]  identifier                   Sequence number of the answered request.
+ * @retval     None
+ **********************************************************************************************************************/
+void net_diag_ping_reply(ePingReplyStatus_t status, uint16_t identifier)
+{
+    uint32_t     cycles = app_timing_cycles ();
+    TaskHandle_t task   = NULL;
+
+    taskENTER_CRITICAL();
+    for (uint32_t i = 0; i < NET_DIAG_MAX_OUTSTANDING; i++)
+    {
+        if (g_ping_slots[i].in_use && (g_ping_slots[i].identifier == identifier))
+        {
+            g_ping_slots[i].in_use = false;
+            if (eSuccess == status)
+            {
+                g_ping_stats.received++;
+                net_diag_record_rtt (APP_TIMING_CYCLES_TO_US(cycles - g_ping_slots[i].sent_cycles));
+            }
+            else
+            {
+                g_ping_stats.invalid++;
+            }
+            task = g_ping_task;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    /* Replies to an expired or unknown request are ignored */
+    if (NULL != task)
+    {
+        xTaskNotifyGive (task);
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints the counters, RTT min/avg/max and the RTT histogram of the last check.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void net_diag_ping_print(void)
+{
+    net_diag_stats_t stats;
+
+    taskENTER_CRITICAL();
+    stats = g_ping_stats;
+    taskEXIT_CRITICAL();
+
+    APP_PRINT("\r\nPing Statistics for %s %s:\r\n", (NULL != g_ping_address) ? g_ping_address : "-",
+              g_ping_running ? "(running)" : "");
+    APP_PRINT("\r\nPackets: Sent  = %02d, Received = %02d, Lost = %02d (invalid %d, timeout %d, no buffer %d)\r\n",
+              stats.sent, stats.received, stats.invalid + stats.timeout + stats.send_failed, stats.invalid,
+              stats.timeout, stats.send_failed);
+    if (0U == stats.received)
+    {
+        return;
+    }
+
+    APP_PRINT("RTT [us]: min %d, avg %d, max %d\r\n", stats.rtt_min_us, (uint32_t) (stats.rtt_sum_us / stats.received),
+              stats.rtt_max_us);
+    for (uint32_t i = 0; i < NET_DIAG_HIST_BUCKETS; i++)
+    {
+        if (i < (NET_DIAG_HIST_BUCKETS - 1U))
+        {
+            APP_PRINT("\t<= %d ms\t: %d\r\n", g_hist_bounds_ms[i], stats.hist[i]);
+        }
+        else
+        {
+            APP_PRINT("\t>  %d ms\t: %d\r\n", g_hist_bounds_ms[i - 1U], stats.hist[i]);
+        }
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Sends one echo every PING_DELAY ticks while a slot is free, until the count is reached and every echo
+ *             is answered or expired, or until the deadline.
+ **********************************************************************************************************************/
+static void net_diag_ping_task(void * pvParameters)
+{
+    TickType_t start_tick = xTaskGetTickCount ();
+    TickType_t deadline   = pdMS_TO_TICKS(g_ping_deadline_ms);
+    uint32_t outstanding  = RESET_VALUE;
+    uint32_t requested    = RESET_VALUE;
+
+    FSP_PARAMETER_NOT_USED(pvParameters);
+    boot_profile_mark ("Ping start");
+
+    while ((xTaskGetTickCount () - start_tick) < deadline)
+    {
+        outstanding = net_diag_expire (false);
+        if ((requested >= g_ping_count) && (0U == outstanding))
+        {
+            break;
+        }
+
+        if ((requested < g_ping_count) && (outstanding < NET_DIAG_MAX_OUTSTANDING))
+        {
+            uint32_t   sent_cycles = app_timing_cycles ();
+            TickType_t sent_tick   = xTaskGetTickCount ();
+            BaseType_t sequence    = vSendPing (g_ping_address);
+
+            requested++;
+            taskENTER_CRITICAL();
+            if (pdFAIL == sequence)
+            {
+                g_ping_stats.send_failed++;
+            }
+            else
+            {
+                for (uint32_t i = 0; i < NET_DIAG_MAX_OUTSTANDING; i++)
+                {
+                    if (!g_ping_slots[i].in_use)
+                    {
+                        g_ping_slots[i].in_use      = true;
+                        g_ping_slots[i].identifier  = (uint16_t) sequence;
+                        g_ping_slots[i].sent_cycles = sent_cycles;
+                        g_ping_slots[i].sent_tick   = sent_tick;
+                        break;
+                    }
+                }
+                g_ping_stats.sent++;
+            }
+            taskEXIT_CRITICAL();
+        }
+
+        /* A reply wakes the task early, otherwise keep the request spacing */
+        (void) ulTaskNotifyTake (pdTRUE, PING_DELAY);
+    }
+    (void) net_diag_expire (true);
+
+    boot_profile_mark ("Ping done");
+    net_diag_ping_print ();
+
+    g_ping_task    = NULL;
+    g_ping_running = false;
+    vTaskDelete (NULL);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Counts echoes older than PING_ECHO_TIMEOUT_MS, or all outstanding ones, as timed out.
+ * @retval     Number of echoes still waiting for a reply.
+ **********************************************************************************************************************/
+static uint32_t net_diag_expire(bool all)
+{
+    TickType_t now       = xTaskGetTickCount ();
+    uint32_t outstanding = RESET_VALUE;
+
+    taskENTER_CRITICAL();
+    for (uint32_t i = 0; i < NET_DIAG_MAX_OUTSTANDING; i++)
+    {
+        if (!g_ping_slots[i].in_use)
+        {
+            continue;
+        }
+        if (all || ((now - g_ping_slots[i].sent_tick) >= pdMS_TO_TICKS(PING_ECHO_TIMEOUT_MS)))
+        {
+            g_ping_slots[i].in_use = false;
+            g_ping_stats.timeout++;
+        }
+        else
+        {
+            outstanding++;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return outstanding;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Adds one RTT to min/max/sum and its histogram bucket. Called with interrupts masked.
+ **********************************************************************************************************************/
+static void net_diag_record_rtt(uint32_t rtt_us)
+{
+    uint32_t bucket = NET_DIAG_HIST_BUCKETS - 1U;
+
+    for (uint32_t i = 0; i < (NET_DIAG_HIST_BUCKETS - 1U); i++)
+    {
+        if (rtt_us <= (g_hist_bounds_ms[i] * 1000U))
+        {
+            bucket = i;
+            break;
+        }
+    }
+    g_ping_stats.hist[bucket]++;
+    g_ping_stats.rtt_sum_us += rtt_us;
+    g_ping_stats.rtt_min_us = (rtt_us < g_ping_stats.rtt_min_us) ? rtt_us : g_ping_stats.rtt_min_us;
+    g_ping_stats.rtt_max_us = (rtt_us > g_ping_stats.rtt_max_us) ? rtt_us : g_ping_stats.rtt_max_us;
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
@@ -0,0 +1,48 @@
+/***********************************************************************************************************************
+ * File Name    : net_diag.h
+ * Description  : Contains macros, data structures and functions used by the background ping diagnostics
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef NET_DIAG_H_
+#define NET_DIAG_H_
+
+#include "hal_data.h"
+#include "FreeRTOS.h"
+#include "FreeRTOS_IP.h"
+
+/* Task sending the echo requests, below the user thread so it never delays an upload */
+#define NET_DIAG_TASK_NAME              "Ping"
+#define NET_DIAG_TASK_STACK             (512U)      /* Words */
+#define NET_DIAG_TASK_PRIORITY          (1U)
+
+/* Echo requests waiting for a reply at the same time */
+#define NET_DIAG_MAX_OUTSTANDING        (8U)
+
+/* Upper bounds of the RTT histogram buckets in ms, the last bucket takes everything above */
+#define NET_DIAG_HIST_BOUNDS_MS         {1U, 2U, 5U, 10U, 20U, 50U, 100U, 200U, 500U}
+#define NET_DIAG_HIST_BUCKETS           (10U)
+
+typedef struct st_net_diag_stats
+{
+    uint32_t sent;                              /* Echo requests handed to the IP task */
+    uint32_t received;                          /* Valid replies */
+    uint32_t invalid;                           /* Replies with bad data */
+    uint32_t timeout;                           /* No reply within the echo timeout or before the deadline */
+    uint32_t send_failed;                       /* No network buffer for the request */
+    uint32_t rtt_min_us;
+    uint32_t rtt_max_us;
+    uint64_t rtt_sum_us;
+    uint32_t hist[NET_DIAG_HIST_BUCKETS];
+} net_diag_stats_t;
+
+fsp_err_t net_diag_ping_start(const char * p_ip_address, uint32_t count, uint32_t deadline_ms);
+bool net_diag_ping_running(void);
+void net_diag_ping_reply(ePingReplyStatus_t status, uint16_t identifier);
+void net_diag_ping_print(void);
+
+#endif /* NET_DIAG_H_ */
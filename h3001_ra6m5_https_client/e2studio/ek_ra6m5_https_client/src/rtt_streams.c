@@ -0,0 +1,222 @@
+/***********************************************************************************************************************
+ * File Name    : rtt_streams.c
+ * Description  : This file sets up the RTT up channels with their buffer and overflow mode and counts what each of them
+ *                wrote and dropped. The counters go to the metrics channel, so the host sees the losses of the
+ *                channels it captures.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_SYS)
+
+#include "common_utils.h"
+#include "rtt_streams.h"
+
+#if (SEGGER_RTT_MAX_NUM_UP_BUFFERS < RTT_STREAM_COUNT)
+ #error "SEGGER_RTT_MAX_NUM_UP_BUFFERS in SEGGER_RTT_Conf.h must cover every RTT stream"
+#endif
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+typedef struct st_rtt_stream_cfg
+{
+    const char * p_name;
+    uint8_t * p_buffer;                 /* NULL for the terminal, set up by SEGGER RTT */
+    uint32_t size;
+    uint32_t mode;
+} rtt_stream_cfg_t;
+
+static uint8_t g_metrics_buffer[RTT_STREAM_METRICS_BUFFER_SIZE];
+static uint8_t g_tokens_buffer[RTT_STREAM_TOKENS_BUFFER_SIZE];
+static uint8_t g_samples_buffer[RTT_STREAM_SAMPLES_BUFFER_SIZE];
+static uint8_t g_bench_buffer[RTT_STREAM_BENCH_BUFFER_SIZE];
+
+static const rtt_stream_cfg_t g_stream_cfg[RTT_STREAM_COUNT] =
+{
+    {"Terminal",  NULL,             BUFFER_SIZE_UP,                 RTT_STREAM_TERMINAL_MODE},
+    {"Metrics",   g_metrics_buffer, RTT_STREAM_METRICS_BUFFER_SIZE, RTT_STREAM_METRICS_MODE},
+    {"LogTokens", g_tokens_buffer,  RTT_STREAM_TOKENS_BUFFER_SIZE,  RTT_STREAM_TOKENS_MODE},
+    {"Samples",   g_samples_buffer, RTT_STREAM_SAMPLES_BUFFER_SIZE, RTT_STREAM_SAMPLES_MODE},
+    {"Bench",     g_bench_buffer,   RTT_STREAM_BENCH_BUFFER_SIZE,   RTT_STREAM_BENCH_MODE},
+};
+
+static const char * const g_mode_names[] = {"skip", "trim", "block"};
+
+static rtt_stream_stats_t g_stream_stats[RTT_STREAM_COUNT];
+static volatile bool g_streams_ready = false;
+
+static void rtt_stream_count(rtt_stream_t stream, uint32_t len, uint32_t written);
+
+/*******************************************************************************************************************//**
+ * @brief      Sets up the buffer and the mode of every channel. Binary channels drop what is written before.
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  Channels ready.
+ * @retval     FSP_ERR_NOT_ENABLED          SEGGER RTT refused a channel.
+ **********************************************************************************************************************/
+fsp_err_t rtt_streams_init(void)
+{
+    const rtt_stream_cfg_t * p_cfg = NULL;
+
+    if (0 > SEGGER_RTT_SetFlagsUpBuffer (RTT_STREAM_TERMINAL, RTT_STREAM_TERMINAL_MODE))
+    {
+        return FSP_ERR_NOT_ENABLED;
+    }
+    for (uint32_t i = RTT_STREAM_METRICS; i < RTT_STREAM_COUNT; i++)
+    {
+        p_cfg = &g_stream_cfg[i];
+        if (0 > SEGGER_RTT_ConfigUpBuffer (i, p_cfg->p_name, p_cfg->p_buffer, p_cfg->size, p_cfg->mode))
+        {
+            APP_ERR_PRINT("** RTT channel %d (%s) is not available ** \r\n", i, p_cfg->p_name);
+            return FSP_ERR_NOT_ENABLED;
+        }
+    }
+    g_streams_ready = true;
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Writes to a binary channel, a record that does not fit is dropped whole and counted. Safe from any task
+ *             and with the scheduler suspended; never blocks.
+ * @param[in]  stream                       Channel.
+ * @param[in]  p_data                       Record.
+ * @param[in]  len                          Bytes.
+ * @retval     Bytes written, 0 when the record was dropped.
+ **********************************************************************************************************************/
+uint32_t rtt_stream_write(rtt_stream_t stream, const void * p_data, uint32_t len)
+{
+    uint32_t written = 0U;
+
+    if (g_streams_ready)
+    {
+        written = SEGGER_RTT_Write (stream, p_data, len);
+    }
+    rtt_stream_count (stream, len, written);
+    return written;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Writes a record to the metrics channel.
+ * @param[in]  type                         Record type.
+ * @param[in]  p_payload                    Payload.
+ * @param[in]  len                          Payload bytes, at most RTT_METRIC_PAYLOAD_MAX.
+ * @retval     Bytes written, 0 when the record was dropped or too long.
+ **********************************************************************************************************************/
+uint32_t rtt_stream_metric(rtt_metric_t type, const void * p_payload, uint32_t len)
+{
+    uint8_t record[RTT_METRIC_HEADER_LEN + RTT_METRIC_PAYLOAD_MAX];
+
+    if (len > RTT_METRIC_PAYLOAD_MAX)
+    {
+        return 0U;
+    }
+    record[0] = (uint8_t) type;
+    record[1] = (uint8_t) len;
+    memcpy (&record[RTT_METRIC_HEADER_LEN], p_payload, len);
+    return rtt_stream_write (RTT_STREAM_METRICS, record, RTT_METRIC_HEADER_LEN + len);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Counts a message of the terminal by the result of SEGGER_RTT_printf(), negative when the message was
+ *             cut or dropped.
+ * @param[in]  result                       Result of SEGGER_RTT_printf().
+ * @retval     The result.
+ **********************************************************************************************************************/
+int rtt_stream_text(int result)
+{
+    if (result >= 0)
+    {
+        rtt_stream_count (RTT_STREAM_TERMINAL, (uint32_t) result, (uint32_t) result);
+    }
+    else
+    {
+        /* SEGGER_RTT_printf() does not tell how much was lost */
+        SEGGER_RTT_LOCK();
+        g_stream_stats[RTT_STREAM_TERMINAL].dropped++;
+        SEGGER_RTT_UNLOCK();
+    }
+    return result;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns the counters of a channel since boot.
+ * @param[in]  stream                       Channel.
+ * @param[out] p_stats                      Counters.
+ * @retval     None
+ **********************************************************************************************************************/
+void rtt_stream_get_stats(rtt_stream_t stream, rtt_stream_stats_t * p_stats)
+{
+    SEGGER_RTT_LOCK();
+    *p_stats = g_stream_stats[stream];
+    SEGGER_RTT_UNLOCK();
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Writes the counters of every channel to the metrics channel, RTT_METRIC_STREAM_STATS records.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void rtt_streams_emit_stats(void)
+{
+    rtt_stream_metric_t metric;
+
+    for (uint32_t i = 0; i < RTT_STREAM_COUNT; i++)
+    {
+        metric.channel = i;
+        rtt_stream_get_stats ((rtt_stream_t) i, &metric.stats);
+        (void) rtt_stream_metric (RTT_METRIC_STREAM_STATS, &metric, sizeof(metric));
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints the buffer, the mode and the counters of every channel.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void rtt_streams_print_stats(void)
+{
+    rtt_stream_stats_t stats;
+
+    APP_PRINT("\r\nRTT up channels:\r\n");
+    APP_PRINT("\tch name\t\t buffer mode    records      bytes  dropped dropped bytes\r\n");
+    for (uint32_t i = 0; i < RTT_STREAM_COUNT; i++)
+    {
+        rtt_stream_get_stats ((rtt_stream_t) i, &stats);
+        APP_PRINT("\t%2u %s\t%7u %s\t%10u %10u %8u %10u\r\n", i, g_stream_cfg[i].p_name, g_stream_cfg[i].size,
+                  g_mode_names[g_stream_cfg[i].mode & SEGGER_RTT_MODE_MASK], stats.records, stats.bytes, stats.dropped,
+                  stats.dropped_bytes);
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Adds a write to the counters of its channel.
+ **********************************************************************************************************************/
+static void rtt_stream_count(rtt_stream_t stream, uint32_t len, uint32_t written)
+{
+    rtt_stream_stats_t * p_stats = &g_stream_stats[stream];
+
+    SEGGER_RTT_LOCK();
+    if (written == len)
+    {
+        p_stats->records++;
+        p_stats->bytes += written;
+    }
+    else
+    {
+        p_stats->dropped++;
+        p_stats->bytes         += written;
+        p_stats->dropped_bytes += len - written;
+    }
+    SEGGER_RTT_UNLOCK();
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
@@ -0,0 +1,93 @@
+/***********************************************************************************************************************
+ * File Name    : rtt_streams.h
+ * Description  : Contains macros, data structures and functions used by the RTT up channels: terminal, metrics,
+ *                tokenized log and sensor samples
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef RTT_STREAMS_H_
+#define RTT_STREAMS_H_
+
+#include "hal_data.h"
+
+/*
+ * Up channels, each with its own buffer so that a burst on one does not push out the others. The terminal buffer is
+ * BUFFER_SIZE_UP of SEGGER_RTT_Conf.h. Binary channels write a record whole or drop it; the terminal keeps the part
+ * of a message that fits. Every write that does not fit is counted as a drop of its channel. Capture all channels at
+ * once with tools/rtt_capture.py. The bench channel is the scratch channel of the log benchmark, no host reads it.
+ */
+#define RTT_STREAM_METRICS_BUFFER_SIZE  (2048U)
+#define RTT_STREAM_TOKENS_BUFFER_SIZE   (2048U)
+#define RTT_STREAM_SAMPLES_BUFFER_SIZE  (1024U)
+#define RTT_STREAM_BENCH_BUFFER_SIZE    (256U)
+
+#define RTT_STREAM_TERMINAL_MODE        (SEGGER_RTT_MODE_NO_BLOCK_TRIM)
+#define RTT_STREAM_METRICS_MODE         (SEGGER_RTT_MODE_NO_BLOCK_SKIP)
+#define RTT_STREAM_TOKENS_MODE          (SEGGER_RTT_MODE_NO_BLOCK_SKIP)
+#define RTT_STREAM_SAMPLES_MODE         (SEGGER_RTT_MODE_NO_BLOCK_SKIP)
+#define RTT_STREAM_BENCH_MODE           (SEGGER_RTT_MODE_NO_BLOCK_SKIP)
+
+/* Metrics record: <type: 8 bit><length: 8 bit bytes that follow><payload>, payload little endian */
+#define RTT_METRIC_HEADER_LEN           (2U)
+#define RTT_METRIC_PAYLOAD_MAX          (62U)
+
+/* Fastest rate of the sample stream of "rtt samples <ms>" */
+#define RTT_STREAM_SAMPLE_PERIOD_MIN_MS (50U)
+
+typedef enum e_rtt_stream
+{
+    RTT_STREAM_TERMINAL = 0,            /* Console and text log, SEGGER_INDEX */
+    RTT_STREAM_METRICS,                 /* Binary metrics records */
+    RTT_STREAM_LOG_TOKENS,              /* Tokenized log, see log_token.h */
+    RTT_STREAM_SAMPLES,                 /* Raw sensor samples, rtt_stream_sample_t */
+    RTT_STREAM_BENCH,                   /* Written and taken back by log_token_bench() */
+    RTT_STREAM_COUNT
+} rtt_stream_t;
+
+typedef enum e_rtt_metric
+{
+    RTT_METRIC_HEAP_TRACE = 1,          /* Allocation trace record, see heap_trace.h */
+    RTT_METRIC_SYS_STATS,               /* sys_stats_metric_t */
+    RTT_METRIC_TASK,                    /* sys_stats_task_metric_t, one per task after RTT_METRIC_SYS_STATS */
+    RTT_METRIC_STREAM_STATS,            /* rtt_stream_metric_t, one per channel */
+} rtt_metric_t;
+
+typedef struct st_rtt_stream_stats
+{
+    uint32_t records;                   /* Writes that fit */
+    uint32_t bytes;
+    uint32_t dropped;                   /* Writes dropped or cut */
+    uint32_t dropped_bytes;
+} rtt_stream_stats_t;
+
+/* RTT_METRIC_STREAM_STATS payload */
+typedef struct st_rtt_stream_metric
+{
+    uint32_t channel;
+    rtt_stream_stats_t stats;
+} rtt_stream_metric_t;
+
+/* Sample channel record: one HS3001 measurement, the raw words as read from the sensor, status bits included */
+typedef struct st_rtt_stream_sample
+{
+    uint32_t time_ms;                   /* Time since boot at sampling */
+    uint32_t count;                     /* Measurements since boot, a gap is a dropped record */
+    uint16_t raw_humidity;
+    uint16_t raw_temperature;
+    int16_t  temp_cdeg;
+    uint16_t rh_cprh;
+} rtt_stream_sample_t;
+
+fsp_err_t rtt_streams_init(void);
+uint32_t rtt_stream_write(rtt_stream_t stream, const void * p_data, uint32_t len);
+uint32_t rtt_stream_metric(rtt_metric_t type, const void * p_payload, uint32_t len);
+int rtt_stream_text(int result);
+void rtt_stream_get_stats(rtt_stream_t stream, rtt_stream_stats_t * p_stats);
+void rtt_streams_emit_stats(void);
+void rtt_streams_print_stats(void);
+
+#endif /* RTT_STREAMS_H_ */
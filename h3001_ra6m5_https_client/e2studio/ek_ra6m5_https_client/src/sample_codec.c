@@ -0,0 +1,360 @@
+/***********************************************************************************************************************
+ * File Name    : sample_codec.c
+ * Description  : This file encodes sensor samples into compact blocks: an absolute anchor per block followed by
+ *                delta-of-delta timestamps and zig-zag varint value deltas. A regular series takes about 3 bytes per
+ *                sample instead of the 16 bytes of the in-memory record.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_FS)
+
+#include "common_utils.h"
+#include "app_timing.h"
+#include "sample_codec.h"
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+static sample_codec_sample_t g_bench_trace[SAMPLE_CODEC_BENCH_SAMPLES];
+static uint8_t g_bench_blocks[SAMPLE_CODEC_BENCH_BLOCKS][SAMPLE_CODEC_BLOCK_SIZE];
+static uint32_t g_bench_block_len[SAMPLE_CODEC_BENCH_BLOCKS];
+
+static uint32_t sample_codec_put_varint(uint8_t * p_out, uint32_t value);
+static uint32_t sample_codec_get_varint(const uint8_t * p_in, uint32_t len, uint32_t * p_value);
+static void sample_codec_put_u32(uint8_t * p_out, uint32_t value);
+static uint32_t sample_codec_get_u32(const uint8_t * p_in);
+static void sample_codec_bench_trace(void);
+
+/* Zig-zag mapping keeps small negative deltas small: 0, -1, 1, -2, ... become 0, 1, 2, 3, ... */
+static inline uint32_t sample_codec_zigzag(int32_t value)
+{
+    return ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+}
+
+static inline int32_t sample_codec_unzigzag(uint32_t value)
+{
+    return (int32_t) (value >> 1) ^ -(int32_t) (value & 1U);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Starts a new block.
+ * @param[out] p_state                      Encoder or decoder position.
+ * @retval     None
+ **********************************************************************************************************************/
+void sample_codec_reset(sample_codec_state_t * p_state)
+{
+    memset (p_state, RESET_VALUE, sizeof(sample_codec_state_t));
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Encodes one sample as continuation of the block described by p_state. The state is only updated when
+ *             the sample fits.
+ * @param[in,out] p_state                   Encoder position.
+ * @param[in]  p_sample                     Sample to encode.
+ * @param[out] p_out                        At least SAMPLE_CODEC_MAX_ENCODED bytes, receives the encoded sample.
+ * @param[out] p_len                        Number of bytes written to p_out.
+ * @retval     FSP_SUCCESS                  Sample encoded, append p_out to the block.
+ * @retval     FSP_ERR_OVERFLOW             Block full or sample does not continue it, start a new block.
+ **********************************************************************************************************************/
+fsp_err_t sample_codec_encode(sample_codec_state_t * p_state, const sample_codec_sample_t * p_sample,
+                              uint8_t * p_out, uint32_t * p_len)
+{
+    uint32_t len = RESET_VALUE;
+    int32_t delta_ms = RESET_VALUE;
+
+    if (0U == p_state->count)
+    {
+        p_out[0] = SAMPLE_CODEC_MAGIC;
+        p_out[1] = SAMPLE_CODEC_VERSION;
+        sample_codec_put_u32 (&p_out[2], p_sample->seq);
+        sample_codec_put_u32 (&p_out[6], p_sample->boot);
+        sample_codec_put_u32 (&p_out[10], p_sample->time_ms);
+        p_out[14] = (uint8_t) ((uint16_t) p_sample->temp_cdeg);
+        p_out[15] = (uint8_t) ((uint16_t) p_sample->temp_cdeg >> 8);
+        p_out[16] = (uint8_t) p_sample->rh_cprh;
+        p_out[17] = (uint8_t) (p_sample->rh_cprh >> 8);
+        p_out[18] = 0U;                 /* Reserved */
+        p_out[19] = 0U;
+        len = SAMPLE_CODEC_HEADER_SIZE;
+    }
+    else
+    {
+        if ((p_sample->boot != p_state->last.boot) || (p_sample->seq != (p_state->last.seq + 1U)))
+        {
+            return FSP_ERR_OVERFLOW;
+        }
+        delta_ms = (int32_t) (p_sample->time_ms - p_state->last.time_ms);
+        len  = sample_codec_put_varint (&p_out[len],
+                                        sample_codec_zigzag ((int32_t) ((uint32_t) delta_ms -
+                                                                        (uint32_t) p_state->last_delta_ms)));
+        len += sample_codec_put_varint (&p_out[len],
+                                        sample_codec_zigzag ((int32_t) p_sample->temp_cdeg -
+                                                             (int32_t) p_state->last.temp_cdeg));
+        len += sample_codec_put_varint (&p_out[len],
+                                        sample_codec_zigzag ((int32_t) p_sample->rh_cprh -
+                                                             (int32_t) p_state->last.rh_cprh));
+    }
+
+    if ((p_state->used + len) > SAMPLE_CODEC_BLOCK_SIZE)
+    {
+        return FSP_ERR_OVERFLOW;
+    }
+
+    p_state->last_delta_ms = (0U == p_state->count) ? 0 : delta_ms;
+    p_state->last          = *p_sample;
+    p_state->used         += len;
+    p_state->count++;
+    *p_len = len;
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Decodes the sample at p_state->used.
+ * @param[in,out] p_state                   Decoder position, reset for the first sample of a block.
+ * @param[in]  p_block                      Encoded block.
+ * @param[in]  block_len                    Valid bytes in p_block.
+ * @param[out] p_sample                     Decoded sample.
+ * @retval     FSP_SUCCESS                  Sample decoded.
+ * @retval     FSP_ERR_NOT_FOUND            End of the block.
+ * @retval     FSP_ERR_INVALID_DATA         Not a block of this format or truncated sample.
+ **********************************************************************************************************************/
+fsp_err_t sample_codec_decode(sample_codec_state_t * p_state, const uint8_t * p_block, uint32_t block_len,
+                              sample_codec_sample_t * p_sample)
+{
+    const uint8_t * p_in = &p_block[p_state->used];
+    uint32_t left = RESET_VALUE;
+    uint32_t len = RESET_VALUE;
+    uint32_t step = RESET_VALUE;
+    uint32_t value[3] = {RESET_VALUE};
+    sample_codec_sample_t sample;
+
+    if (p_state->used >= block_len)
+    {
+        return FSP_ERR_NOT_FOUND;
+    }
+    left = block_len - p_state->used;
+
+    if (0U == p_state->count)
+    {
+        if ((left < SAMPLE_CODEC_HEADER_SIZE) || (SAMPLE_CODEC_MAGIC != p_in[0]) || (SAMPLE_CODEC_VERSION != p_in[1]))
+        {
+            return FSP_ERR_INVALID_DATA;
+        }
+        sample.seq       = sample_codec_get_u32 (&p_in[2]);
+        sample.boot      = sample_codec_get_u32 (&p_in[6]);
+        sample.time_ms   = sample_codec_get_u32 (&p_in[10]);
+        sample.temp_cdeg = (int16_t) ((uint16_t) p_in[14] | ((uint16_t) p_in[15] << 8));
+        sample.rh_cprh   = (uint16_t) ((uint16_t) p_in[16] | ((uint16_t) p_in[17] << 8));
+        p_state->last_delta_ms = 0;
+        len = SAMPLE_CODEC_HEADER_SIZE;
+    }
+    else
+    {
+        for (uint32_t i = 0; i < 3U; i++)
+        {
+            step = sample_codec_get_varint (&p_in[len], left - len, &value[i]);
+            if (0U == step)
+            {
+                return FSP_ERR_INVALID_DATA;
+            }
+            len += step;
+        }
+        p_state->last_delta_ms = (int32_t) ((uint32_t) p_state->last_delta_ms +
+                                            (uint32_t) sample_codec_unzigzag (value[0]));
+        sample.seq       = p_state->last.seq + 1U;
+        sample.boot      = p_state->last.boot;
+        sample.time_ms   = p_state->last.time_ms + (uint32_t) p_state->last_delta_ms;
+        sample.temp_cdeg = (int16_t) ((int32_t) p_state->last.temp_cdeg + sample_codec_unzigzag (value[1]));
+        sample.rh_cprh   = (uint16_t) ((int32_t) p_state->last.rh_cprh + sample_codec_unzigzag (value[2]));
+    }
+
+    p_state->last  = sample;
+    p_state->used += len;
+    p_state->count++;
+    *p_sample = sample;
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Encodes and decodes a synthetic trace, checks the round trip and prints bytes per sample and the
+ *             encode and decode cost as comma separated lines:
+ *               #CODEC,<format>,<samples>,<bytes>,<bytes per 100 samples>,<total us>,<cycles per sample>
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  Round trip exact.
+ * @retval     FSP_ERR_OUT_OF_MEMORY        Trace does not fit SAMPLE_CODEC_BENCH_BLOCKS.
+ * @retval     FSP_ERR_INVALID_DATA         Decoded trace differs from the input.
+ **********************************************************************************************************************/
+fsp_err_t sample_codec_bench(void)
+{
+    sample_codec_state_t state;
+    sample_codec_sample_t sample;
+    uint8_t encoded[SAMPLE_CODEC_MAX_ENCODED];
+    uint32_t blocks = RESET_VALUE;
+    uint32_t bytes = RESET_VALUE;
+    uint32_t len = RESET_VALUE;
+    uint32_t decoded = RESET_VALUE;
+    uint32_t encode_cycles = RESET_VALUE;
+    uint32_t decode_cycles = RESET_VALUE;
+    uint32_t start = RESET_VALUE;
+    fsp_err_t err = FSP_SUCCESS;
+
+    app_timing_init ();
+    sample_codec_bench_trace ();
+    memset (g_bench_block_len, RESET_VALUE, sizeof(g_bench_block_len));
+
+    start = app_timing_cycles ();
+    sample_codec_reset (&state);
+    for (uint32_t i = 0; i < SAMPLE_CODEC_BENCH_SAMPLES; i++)
+    {
+        /* The encoder writes the whole sample before it checks the fit, so encode aside as the journal does */
+        err = sample_codec_encode (&state, &g_bench_trace[i], encoded, &len);
+        if (FSP_ERR_OVERFLOW == err)
+        {
+            g_bench_block_len[blocks++] = state.used;
+            if (blocks >= SAMPLE_CODEC_BENCH_BLOCKS)
+            {
+                return FSP_ERR_OUT_OF_MEMORY;
+            }
+            sample_codec_reset (&state);
+            err = sample_codec_encode (&state, &g_bench_trace[i], encoded, &len);
+        }
+        if (FSP_SUCCESS != err)
+        {
+            return err;
+        }
+        memcpy (&g_bench_blocks[blocks][state.used - len], encoded, len);
+    }
+    g_bench_block_len[blocks++] = state.used;
+    encode_cycles = app_timing_cycles () - start;
+
+    start = app_timing_cycles ();
+    for (uint32_t b = 0; b < blocks; b++)
+    {
+        sample_codec_reset (&state);
+        while (FSP_SUCCESS == sample_codec_decode (&state, g_bench_blocks[b], g_bench_block_len[b], &sample))
+        {
+            if ((decoded >= SAMPLE_CODEC_BENCH_SAMPLES)
+                || (0 != memcmp (&sample, &g_bench_trace[decoded], sizeof(sample))))
+            {
+                APP_ERR_PRINT("** Codec round trip differs at sample %d ** \r\n", decoded);
+                return FSP_ERR_INVALID_DATA;
+            }
+            decoded++;
+        }
+        bytes += g_bench_block_len[b];
+    }
+    decode_cycles = app_timing_cycles () - start;
+    if (SAMPLE_CODEC_BENCH_SAMPLES != decoded)
+    {
+        APP_ERR_PRINT("** Codec decoded %d of %d samples ** \r\n", decoded, SAMPLE_CODEC_BENCH_SAMPLES);
+        return FSP_ERR_INVALID_DATA;
+    }
+
+    APP_PRINT("\r\n%s,format,samples,bytes,bytes_per_100,total_us,cycles_per_sample\r\n", SAMPLE_CODEC_BENCH_TAG);
+    APP_PRINT("%s,raw,%d,%d,%d,0,0\r\n", SAMPLE_CODEC_BENCH_TAG, SAMPLE_CODEC_BENCH_SAMPLES,
+              (uint32_t) (SAMPLE_CODEC_BENCH_SAMPLES * sizeof(sample_codec_sample_t)),
+              (uint32_t) (100U * sizeof(sample_codec_sample_t)));
+    APP_PRINT("%s,encode,%d,%d,%d,%d,%d\r\n", SAMPLE_CODEC_BENCH_TAG, SAMPLE_CODEC_BENCH_SAMPLES, bytes,
+              (100U * bytes) / SAMPLE_CODEC_BENCH_SAMPLES, APP_TIMING_CYCLES_TO_US(encode_cycles),
+              encode_cycles / SAMPLE_CODEC_BENCH_SAMPLES);
+    APP_PRINT("%s,decode,%d,%d,%d,%d,%d\r\n", SAMPLE_CODEC_BENCH_TAG, SAMPLE_CODEC_BENCH_SAMPLES, bytes,
+              (100U * bytes) / SAMPLE_CODEC_BENCH_SAMPLES, APP_TIMING_CYCLES_TO_US(decode_cycles),
+              decode_cycles / SAMPLE_CODEC_BENCH_SAMPLES);
+    APP_PRINT("%s,end (%d blocks of %d bytes)\r\n", SAMPLE_CODEC_BENCH_TAG, blocks, SAMPLE_CODEC_BLOCK_SIZE);
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Writes value as LEB128 varint, 7 bits per byte, least significant group first.
+ * @retval     Number of bytes written, at most SAMPLE_CODEC_VARINT_MAX.
+ **********************************************************************************************************************/
+static uint32_t sample_codec_put_varint(uint8_t * p_out, uint32_t value)
+{
+    uint32_t len = RESET_VALUE;
+
+    while (value >= 0x80U)
+    {
+        p_out[len++] = (uint8_t) (value | 0x80U);
+        value      >>= 7;
+    }
+    p_out[len++] = (uint8_t) value;
+    return len;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Reads a LEB128 varint.
+ * @retval     Number of bytes read, 0 when the varint is truncated or too long.
+ **********************************************************************************************************************/
+static uint32_t sample_codec_get_varint(const uint8_t * p_in, uint32_t len, uint32_t * p_value)
+{
+    uint32_t value = RESET_VALUE;
+
+    for (uint32_t i = 0; (i < len) && (i < SAMPLE_CODEC_VARINT_MAX); i++)
+    {
+        value |= (uint32_t) (p_in[i] & 0x7FU) << (7U * i);
+        if (0U == (p_in[i] & 0x80U))
+        {
+            *p_value = value;
+            return i + 1U;
+        }
+    }
+    return 0U;
+}
+
+static void sample_codec_put_u32(uint8_t * p_out, uint32_t value)
+{
+    p_out[0] = (uint8_t) value;
+    p_out[1] = (uint8_t) (value >> 8);
+    p_out[2] = (uint8_t) (value >> 16);
+    p_out[3] = (uint8_t) (value >> 24);
+}
+
+static uint32_t sample_codec_get_u32(const uint8_t * p_in)
+{
+    return (uint32_t) p_in[0] | ((uint32_t) p_in[1] << 8) | ((uint32_t) p_in[2] << 16) | ((uint32_t) p_in[3] << 24);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Fills g_bench_trace like the main loop would: a sample every APP_SAMPLE_PERIOD_MS with up to one loop
+ *             pass (100 ms) of jitter, temperature drifting by a few 0.01 degC and humidity noise of +-0.1 %RH.
+ *             A reboot in the middle of the trace forces a new anchor.
+ **********************************************************************************************************************/
+static void sample_codec_bench_trace(void)
+{
+    uint32_t lcg = 0x2545F491U;
+    uint32_t time_ms = 12000U;
+    int32_t temp_cdeg = 2350;
+    int32_t rh_cprh = 4500;
+    uint32_t boot = 7U;
+
+    for (uint32_t i = 0; i < SAMPLE_CODEC_BENCH_SAMPLES; i++)
+    {
+        lcg = (lcg * 1664525U) + 1013904223U;
+        if ((SAMPLE_CODEC_BENCH_SAMPLES / 2U) == i)
+        {
+            boot++;
+            time_ms = 9000U;
+        }
+        time_ms   += 60000U + ((lcg >> 8) % 100U);
+        temp_cdeg += (int32_t) ((lcg >> 16) % 7U) - 3;
+        rh_cprh   += (int32_t) ((lcg >> 24) % 21U) - 10;
+
+        g_bench_trace[i].seq       = 1000U + i;
+        g_bench_trace[i].boot      = boot;
+        g_bench_trace[i].time_ms   = time_ms;
+        g_bench_trace[i].temp_cdeg = (int16_t) temp_cdeg;
+        g_bench_trace[i].rh_cprh   = (uint16_t) rh_cprh;
+    }
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
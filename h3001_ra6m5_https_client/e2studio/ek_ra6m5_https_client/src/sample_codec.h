@@ -0,0 +1,63 @@
+/***********************************************************************************************************************
+ * File Name    : sample_codec.h
+ * Description  : Contains macros, data structures and functions used by the compact binary sample format
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef SAMPLE_CODEC_H_
+#define SAMPLE_CODEC_H_
+
+#include "hal_data.h"
+
+/*
+ * A block starts with a header holding the first sample as absolute anchor:
+ *   magic u8, version u8, seq u32, boot u32, time_ms u32, temp_cdeg i16, rh_cprh u16 (little endian, 20 bytes)
+ * Every further sample is three zig-zag varints:
+ *   delta of the time delta [ms], temperature delta [0.01 degC], humidity delta [0.01 %RH]
+ * Sequence numbers within a block are consecutive and the boot count is the same, a sample that does not continue
+ * the block starts a new one. At a regular sampling period a sample takes 3 bytes.
+ */
+#define SAMPLE_CODEC_MAGIC              (0xD5U)
+#define SAMPLE_CODEC_VERSION            (1U)
+#define SAMPLE_CODEC_HEADER_SIZE        (20U)
+#define SAMPLE_CODEC_VARINT_MAX         (5U)
+#define SAMPLE_CODEC_MAX_ENCODED        (SAMPLE_CODEC_HEADER_SIZE)
+
+/* One LittleFS block of the data flash, a block file then occupies exactly one erase unit */
+#define SAMPLE_CODEC_BLOCK_SIZE         (128U)
+
+/* Synthetic trace used by sample_codec_bench(): one sample per minute, tick jitter, slow drift and sensor noise */
+#define SAMPLE_CODEC_BENCH_SAMPLES      (256U)
+#define SAMPLE_CODEC_BENCH_BLOCKS       (16U)
+#define SAMPLE_CODEC_BENCH_TAG          "#CODEC"
+
+typedef struct st_sample_codec_sample
+{
+    uint32_t seq;                       /* Sample number, continuous across boots */
+    uint32_t boot;                      /* hal_littlefs_boot_count() at sampling */
+    uint32_t time_ms;                   /* Time since boot at sampling */
+    int16_t  temp_cdeg;                 /* Temperature in 0.01 degree Celsius */
+    uint16_t rh_cprh;                   /* Relative humidity in 0.01 % */
+} sample_codec_sample_t;
+
+/* Position in a block, shared by encoder and decoder: after decoding a whole block it continues the encoding */
+typedef struct st_sample_codec_state
+{
+    uint32_t              count;        /* Samples in the block so far */
+    uint32_t              used;         /* Bytes in the block so far */
+    int32_t               last_delta_ms;
+    sample_codec_sample_t last;
+} sample_codec_state_t;
+
+void sample_codec_reset(sample_codec_state_t * p_state);
+fsp_err_t sample_codec_encode(sample_codec_state_t * p_state, const sample_codec_sample_t * p_sample,
+                              uint8_t * p_out, uint32_t * p_len);
+fsp_err_t sample_codec_decode(sample_codec_state_t * p_state, const uint8_t * p_block, uint32_t block_len,
+                              sample_codec_sample_t * p_sample);
+fsp_err_t sample_codec_bench(void);
+
+#endif /* SAMPLE_CODEC_H_ */
@@ -0,0 +1,914 @@
+/***********************************************************************************************************************
+ * File Name    : sample_journal.c
+ * Description  : This file implements an append-only journal of sensor samples in LittleFS. Samples taken while the
+ *                uplink is down are encoded with sample_codec and appended to segment files, one codec block per
+ *                segment, and drained oldest first once the uplink is back. The head block is staged in RAM and
+ *                written when it is full, after SAMPLE_JOURNAL_FLUSH_MS or on sample_journal_flush(), so one flash
+ *                write covers many samples. A small index file holds the read cursor and the sample count of every
+ *                sealed segment. It is committed after every drained batch and before the first write of a new
+ *                segment, so a reset neither loses nor resends acknowledged samples and the journal resumes from the
+ *                index and the head segment alone, whatever the backlog. All functions run in the user thread.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_FS)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "core_http_client.h"
+#include "transport_mbedtls_pkcs11.h"
+#include "user_app.h"
+#include "app_timing.h"
+#include "littlefs_app.h"
+#include "sample_journal.h"
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/* Samples in a live segment, segments from the cursor to the head never share a slot */
+#define SAMPLE_JOURNAL_RECORDS(segment) (g_segment_records[(segment) % SAMPLE_JOURNAL_MAX_SEGMENTS])
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+/* Read cursor of the journal before the index */
+typedef struct st_sample_journal_legacy_cursor
+{
+    uint32_t magic;
+    sample_journal_cursor_t cursor;
+} sample_journal_legacy_cursor_t;
+
+static sample_journal_cursor_t g_cursor;
+static sample_journal_index_t g_index;              /* As last committed */
+static uint32_t g_first_segment = RESET_VALUE;      /* Oldest segment file that may still exist */
+static uint32_t g_head_segment = RESET_VALUE;       /* Segment being appended to */
+static uint32_t g_head_seq = RESET_VALUE;           /* Sequence number of the first sample of the head segment */
+static sample_codec_state_t g_head_state;           /* Encoder position in the head segment */
+static uint8_t g_head_block[SAMPLE_CODEC_BLOCK_SIZE];   /* Head segment, bytes from g_head_flushed on are RAM only */
+static uint32_t g_head_flushed = RESET_VALUE;
+static uint32_t g_head_staged = RESET_VALUE;        /* Samples not yet written */
+static TickType_t g_staged_tick = RESET_VALUE;      /* Time the oldest staged sample was appended */
+static uint8_t g_segment_records[SAMPLE_JOURNAL_MAX_SEGMENTS];
+static uint8_t g_block[SAMPLE_CODEC_BLOCK_SIZE];
+static uint32_t g_next_seq = RESET_VALUE;
+static bool g_journal_ready = false;
+static sample_journal_stats_t g_journal_stats;
+
+static void sample_journal_path(char * p_path, uint32_t segment);
+static fsp_err_t sample_journal_resume(void);
+static fsp_err_t sample_journal_rebuild(void);
+static void sample_journal_restore_head(fsp_err_t load_err, const sample_codec_state_t * p_state);
+static uint32_t sample_journal_first_seq(uint32_t segment);
+static fsp_err_t sample_journal_scan(uint32_t * p_min_segment, uint32_t * p_max_segment);
+static fsp_err_t sample_journal_load(uint32_t segment, sample_codec_state_t * p_state, uint32_t index,
+                                     sample_codec_sample_t * p_records, uint32_t max_records, uint32_t * p_count);
+static fsp_err_t sample_journal_write_head(void);
+static void sample_journal_drop_oldest(void);
+static fsp_err_t sample_journal_commit(void);
+static fsp_err_t sample_journal_advance(uint32_t count);
+static void sample_journal_remove(uint32_t first_segment, uint32_t end_segment);
+static void sample_journal_cut_point(void);
+
+/*******************************************************************************************************************//**
+ * @brief      Opens the journal after LittleFS is mounted. The index gives the read cursor and the sealed segments,
+ *             only the head segment is read. Without an index, on the first boot or after an update from the journal
+ *             before the index, every segment is scanned once and the index is written.
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  Journal ready.
+ * @retval     Any other Error Code         Journal directory not usable.
+ **********************************************************************************************************************/
+fsp_err_t sample_journal_init(void)
+{
+    uint32_t start = app_timing_cycles ();
+    int lfs_err = lfs_mkdir (&g_rm_littlefs0_lfs, SAMPLE_JOURNAL_DIR);
+    fsp_err_t err = FSP_SUCCESS;
+
+    if ((LFS_ERR_OK != lfs_err) && (LFS_ERR_EXIST != lfs_err))
+    {
+        APP_ERR_PRINT("** Failed to create %s: %d ** \r\n", SAMPLE_JOURNAL_DIR, lfs_err);
+        return FSP_ERR_NOT_OPEN;
+    }
+
+    g_journal_ready = false;
+    memset (&g_cursor, RESET_VALUE, sizeof(g_cursor));
+    memset (&g_index, RESET_VALUE, sizeof(g_index));
+    memset (g_segment_records, RESET_VALUE, sizeof(g_segment_records));
+    memset (&g_journal_stats, RESET_VALUE, sizeof(g_journal_stats));
+    sample_codec_reset (&g_head_state);
+    g_first_segment = RESET_VALUE;
+    g_head_segment  = RESET_VALUE;
+    g_head_seq      = RESET_VALUE;
+    g_head_flushed  = RESET_VALUE;
+    g_head_staged   = RESET_VALUE;
+    g_next_seq      = RESET_VALUE;
+
+    err = sample_journal_resume ();
+    g_journal_stats.resumed = (FSP_SUCCESS == err);
+    if (FSP_SUCCESS != err)
+    {
+        err = sample_journal_rebuild ();
+        if (FSP_SUCCESS != err)
+        {
+            return err;
+        }
+        if (FSP_SUCCESS == sample_journal_commit ())
+        {
+            (void) lfs_remove (&g_rm_littlefs0_lfs, SAMPLE_JOURNAL_CURSOR_FILE);
+        }
+    }
+
+    g_journal_ready = true;
+    g_journal_stats.resume_us = APP_TIMING_CYCLES_TO_US(app_timing_cycles () - start);
+    APP_INFO_PRINT("\r\nSample journal: %d samples pending, next sample %d, opened from the %s in %d us\r\n",
+                   sample_journal_pending (), g_next_seq, g_journal_stats.resumed ? "index" : "segments",
+                   g_journal_stats.resume_us);
+#if (SAMPLE_JOURNAL_CUT_TEST == ENABLE)
+    (void) sample_journal_check ();
+#endif
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Appends one sample to the head block in RAM. The sample is durable after the next flush: when the block
+ *             is full, SAMPLE_JOURNAL_FLUSH_MS after the oldest staged sample or on sample_journal_flush(). A sample
+ *             that does not continue the head block starts the next segment, when the journal is full the oldest
+ *             segment is dropped.
+ * @param[in,out] p_sample                  Sample to store, its sequence number and boot count are assigned here.
+ * @retval     FSP_SUCCESS                  Sample stored.
+ * @retval     FSP_ERR_NOT_OPEN             Journal not initialized.
+ * @retval     FSP_ERR_WRITE_FAILED         The full head block could not be written, the sample is not stored.
+ **********************************************************************************************************************/
+fsp_err_t sample_journal_append(sample_codec_sample_t * p_sample)
+{
+    uint8_t encoded[SAMPLE_CODEC_MAX_ENCODED];
+    sample_codec_state_t state = g_head_state;
+    uint32_t len = RESET_VALUE;
+    uint32_t start = app_timing_cycles ();
+    uint32_t elapsed_us = RESET_VALUE;
+    fsp_err_t err = FSP_SUCCESS;
+
+    if (!g_journal_ready)
+    {
+        return FSP_ERR_NOT_OPEN;
+    }
+
+    p_sample->seq  = g_next_seq;
+    p_sample->boot = hal_littlefs_boot_count ();
+    if (FSP_SUCCESS != sample_codec_encode (&state, p_sample, encoded, &len))
+    {
+        /* Head block full or a new boot: write it out and start the next segment with a fresh anchor */
+        err = sample_journal_write_head ();
+        if (FSP_SUCCESS != err)
+        {
+            return err;
+        }
+        g_head_segment++;
+        g_head_seq = g_next_seq;
+        if ((g_head_segment - g_cursor.segment) >= SAMPLE_JOURNAL_MAX_SEGMENTS)
+        {
+            sample_journal_drop_oldest ();
+        }
+        SAMPLE_JOURNAL_RECORDS(g_head_segment) = RESET_VALUE;
+        sample_codec_reset (&g_head_state);
+        g_head_flushed = RESET_VALUE;
+        state = g_head_state;
+        (void) sample_codec_encode (&state, p_sample, encoded, &len);
+    }
+
+    memcpy (&g_head_block[g_head_state.used], encoded, len);
+    g_head_state = state;
+    SAMPLE_JOURNAL_RECORDS(g_head_segment)++;
+    g_next_seq++;
+    if (0U == g_head_staged)
+    {
+        g_staged_tick = xTaskGetTickCount ();
+    }
+    g_head_staged++;
+
+#if (SAMPLE_JOURNAL_WRITE_BACK == DISABLE)
+    /* Write-through for comparison, every sample costs a flash write */
+    (void) sample_journal_write_head ();
+#endif
+
+    elapsed_us = APP_TIMING_CYCLES_TO_US(app_timing_cycles () - start);
+    g_journal_stats.appended++;
+    g_journal_stats.bytes_appended  += len;
+    g_journal_stats.append_us_total += elapsed_us;
+    g_journal_stats.append_us_max    = (elapsed_us > g_journal_stats.append_us_max) ? elapsed_us :
+                                       g_journal_stats.append_us_max;
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Writes the staged samples when the oldest of them waited SAMPLE_JOURNAL_FLUSH_MS. Called from the main
+ *             loop, off the sampling path.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void sample_journal_service(void)
+{
+    if (g_journal_ready && (0U == sample_journal_service_due ()))
+    {
+        if (FSP_SUCCESS != sample_journal_write_head ())
+        {
+            /* Retried a flush period later rather than on every pass of the main loop */
+            g_staged_tick = xTaskGetTickCount ();
+        }
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns the time until sample_journal_service() has work, for the main loop to sleep that long.
+ * @param[in]  None
+ * @retval     Ticks until the staged samples are due, 0 when they are due now, portMAX_DELAY when none are staged.
+ **********************************************************************************************************************/
+TickType_t sample_journal_service_due(void)
+{
+    TickType_t elapsed = xTaskGetTickCount () - g_staged_tick;
+    TickType_t period = pdMS_TO_TICKS(SAMPLE_JOURNAL_FLUSH_MS);
+
+    if (0U == g_head_staged)
+    {
+        return portMAX_DELAY;
+    }
+    return (elapsed >= period) ? 0U : (period - elapsed);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Writes the staged samples now. Call before a planned reset or power down, or on a power-fail warning.
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  Every appended sample is in flash.
+ * @retval     FSP_ERR_WRITE_FAILED         LittleFS write failed, the samples stay staged.
+ **********************************************************************************************************************/
+fsp_err_t sample_journal_flush(void)
+{
+    if (!g_journal_ready)
+    {
+        return FSP_SUCCESS;
+    }
+    return sample_journal_write_head ();
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns the number of samples not yet drained.
+ * @param[in]  None
+ * @retval     Pending samples.
+ **********************************************************************************************************************/
+uint32_t sample_journal_pending(void)
+{
+    uint32_t pending = RESET_VALUE;
+
+    for (uint32_t segment = g_cursor.segment; segment <= g_head_segment; segment++)
+    {
+        pending += SAMPLE_JOURNAL_RECORDS(segment);
+    }
+    return pending - g_cursor.index;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Reads the oldest pending samples without consuming them. A segment that decodes to fewer samples than
+ *             the index lists ends the batch after its last decodable sample, so a consume of the batch never moves
+ *             the cursor over samples that were not read. Once the cursor reaches the undecodable rest of such a
+ *             segment, the rest is dropped, committed and counted as unreadable, and the batch goes on with the next
+ *             segment: a bad segment file never stalls the drain.
+ * @param[out] p_records                    Buffer for up to max_records samples.
+ * @param[in]  max_records                  Batch size.
+ * @param[out] p_count                      Samples read, 0 when the journal is empty.
+ * @retval     FSP_SUCCESS                  Upon successful read.
+ * @retval     FSP_ERR_WRITE_FAILED         The index could not be written after dropping an unreadable segment.
+ **********************************************************************************************************************/
+fsp_err_t sample_journal_peek(sample_codec_sample_t * p_records, uint32_t max_records, uint32_t * p_count)
+{
+    sample_codec_state_t state;
+    uint32_t segment = g_cursor.segment;
+    uint32_t index = g_cursor.index;
+    uint32_t count = RESET_VALUE;
+    uint32_t chunk = RESET_VALUE;
+    uint32_t lost = RESET_VALUE;
+    uint32_t start = app_timing_cycles ();
+    fsp_err_t err = FSP_SUCCESS;
+    bool short_segment = false;
+
+    *p_count = RESET_VALUE;
+    if (!g_journal_ready)
+    {
+        return FSP_ERR_NOT_OPEN;
+    }
+
+    while ((count < max_records) && (segment <= g_head_segment))
+    {
+        if (index < SAMPLE_JOURNAL_RECORDS(segment))
+        {
+            err           = sample_journal_load (segment, &state, index, &p_records[count], max_records - count,
+                                                 &chunk);
+            count        += chunk;
+            short_segment = (FSP_SUCCESS != err) || (state.count < SAMPLE_JOURNAL_RECORDS(segment));
+            if (short_segment && (0U != count))
+            {
+                /* The batch ends at the last decodable sample, the rest is dropped on the next peek */
+                break;
+            }
+            if (short_segment)
+            {
+                /* The cursor is at the undecodable rest, only empty segments can be in front of it */
+                lost = SAMPLE_JOURNAL_RECORDS(segment) - index;
+                APP_ERR_PRINT("** Journal segment %d: %d samples do not decode (%d), dropped ** \r\n", segment, lost,
+                              err);
+                err = sample_journal_advance (lost);
+                if (FSP_SUCCESS != err)
+                {
+                    return FSP_ERR_WRITE_FAILED;
+                }
+                g_journal_stats.unreadable += lost;
+            }
+        }
+        segment++;
+        index = RESET_VALUE;
+    }
+
+    g_journal_stats.read_us_total += APP_TIMING_CYCLES_TO_US(app_timing_cycles () - start);
+    *p_count = count;
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Marks the oldest samples as delivered. The cursor is committed before drained segments are removed.
+ * @param[in]  count                        Samples acknowledged by the server, at most sample_journal_pending().
+ * @retval     FSP_SUCCESS                  Cursor committed.
+ * @retval     FSP_ERR_INVALID_ARGUMENT     More samples than pending.
+ * @retval     FSP_ERR_WRITE_FAILED         Cursor could not be written, the samples will be sent again.
+ **********************************************************************************************************************/
+fsp_err_t sample_journal_consume(uint32_t count)
+{
+    uint32_t start = app_timing_cycles ();
+    fsp_err_t err = FSP_SUCCESS;
+
+    if (count > sample_journal_pending ())
+    {
+        return FSP_ERR_INVALID_ARGUMENT;
+    }
+
+    err = sample_journal_advance (count);
+    if (FSP_SUCCESS != err)
+    {
+        return err;
+    }
+
+    g_journal_stats.consumed        += count;
+    g_journal_stats.commit_us_total += APP_TIMING_CYCLES_TO_US(app_timing_cycles () - start);
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints the journal fill level, the encoded size per sample and the append, read and cursor commit cost.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void sample_journal_print_stats(void)
+{
+    sample_journal_stats_t * p_stats = &g_journal_stats;
+
+    APP_PRINT("\r\nSample journal: %d pending from sample %d (segments %d..%d), next sample %d\r\n",
+              sample_journal_pending (), sample_journal_first_seq (g_cursor.segment) + g_cursor.index,
+              g_cursor.segment, g_head_segment, g_next_seq);
+    APP_PRINT("\tappended %d, drained %d, dropped %d, unreadable %d, index commits %d, staged in RAM %d\r\n",
+              p_stats->appended, p_stats->consumed, p_stats->dropped, p_stats->unreadable, p_stats->index_commits,
+              g_head_staged);
+    APP_PRINT("\topened from the %s in %d us, index generation %d\r\n", p_stats->resumed ? "index" : "segments",
+              p_stats->resume_us, g_index.generation);
+    if (0U != p_stats->flushes)
+    {
+        /* Estimate only: every coalesced sample taken as a write of its own at the erases per write seen here. A
+         * write-through build (SAMPLE_JOURNAL_WRITE_BACK) over the same outage gives the measured figure */
+        APP_PRINT("\tflash writes: %d for %d samples, %d erases, est. %d erases saved vs write-through, "
+                  "write max %d us\r\n", p_stats->flushes, p_stats->flushed, p_stats->erases,
+                  ((p_stats->flushed - p_stats->flushes) * p_stats->erases) / p_stats->flushes,
+                  p_stats->flush_us_max);
+    }
+    if (0U != p_stats->appended)
+    {
+        APP_PRINT("\tencoded: %d bytes, %d.%02d bytes/sample (raw record %d bytes)\r\n", p_stats->bytes_appended,
+                  p_stats->bytes_appended / p_stats->appended,
+                  ((100U * p_stats->bytes_appended) / p_stats->appended) % 100U, (uint32_t) sizeof(sample_codec_sample_t));
+        APP_PRINT("\tappend (sampler stall): avg %d us, max %d us, %d samples/s\r\n",
+                  (uint32_t) (p_stats->append_us_total / p_stats->appended), p_stats->append_us_max,
+                  (uint32_t) ((1000000ULL * p_stats->appended) / (p_stats->append_us_total + 1U)));
+    }
+    if (0U != p_stats->consumed)
+    {
+        APP_PRINT("\tdrain (read + index commit): %d samples/s\r\n",
+                  (uint32_t) ((1000000ULL * p_stats->consumed) /
+                              (p_stats->read_us_total + p_stats->commit_us_total + 1U)));
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Checks the journal as opened from the index against a scan of every segment file: no segment outside
+ *             the index, the sample count of every sealed segment and sequence numbers running on across segments.
+ *             Prints the open time next to the scan time as comma separated lines:
+ *               #JRNLCHK,<index generation>,<opened from>,<open us>,<scan us>,<pending>,<result>
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  Index and segments agree.
+ * @retval     FSP_ERR_NOT_OPEN             Journal not initialized.
+ * @retval     FSP_ERR_INVALID_DATA         Index and segments disagree.
+ **********************************************************************************************************************/
+fsp_err_t sample_journal_check(void)
+{
+    sample_codec_state_t state;
+    uint32_t min_segment = RESET_VALUE;
+    uint32_t max_segment = RESET_VALUE;
+    uint32_t count = RESET_VALUE;
+    uint32_t seq = sample_journal_first_seq (g_cursor.segment);
+    uint32_t start = app_timing_cycles ();
+    uint32_t scan_us = RESET_VALUE;
+    fsp_err_t err = FSP_SUCCESS;
+    bool valid = true;
+
+    if (!g_journal_ready)
+    {
+        return FSP_ERR_NOT_OPEN;
+    }
+
+    err   = sample_journal_scan (&min_segment, &max_segment);
+    valid = (FSP_ERR_NOT_FOUND == err) ||
+            ((FSP_SUCCESS == err) && (min_segment >= g_first_segment) && (max_segment <= g_head_segment));
+    for (uint32_t segment = g_cursor.segment; valid && (segment < g_head_segment); segment++)
+    {
+        err   = sample_journal_load (segment, &state, 0U, NULL, 0U, &count);
+        valid = (FSP_SUCCESS == err) && (state.count == SAMPLE_JOURNAL_RECORDS(segment)) &&
+                ((0U == state.count) || ((state.last.seq + 1U - state.count) == seq));
+        seq  += state.count;
+    }
+    valid   = valid && (seq == g_head_seq);
+    scan_us = APP_TIMING_CYCLES_TO_US(app_timing_cycles () - start);
+
+    APP_PRINT("\r\n%s,generation,opened_from,open_us,scan_us,pending,result\r\n", SAMPLE_JOURNAL_CHECK_TAG);
+    APP_PRINT("%s,%d,%s,%d,%d,%d,%s\r\n", SAMPLE_JOURNAL_CHECK_TAG, g_index.generation,
+              g_journal_stats.resumed ? "index" : "segments", g_journal_stats.resume_us, scan_us,
+              sample_journal_pending (), valid ? "ok" : "mismatch");
+    return valid ? FSP_SUCCESS : FSP_ERR_INVALID_DATA;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Restores the journal from the index. Segments drained before a reset whose removal was cut short are
+ *             removed, then the head segment is decoded: it is the only one written since the last commit.
+ * @retval     FSP_SUCCESS when the index is usable, FSP_ERR_NOT_FOUND or FSP_ERR_INVALID_DATA otherwise.
+ **********************************************************************************************************************/
+static fsp_err_t sample_journal_resume(void)
+{
+    lfs_file_t file;
+    sample_journal_index_t index;
+    sample_codec_state_t state;
+    uint32_t count = RESET_VALUE;
+    lfs_ssize_t read_len = RESET_VALUE;
+    fsp_err_t err = FSP_SUCCESS;
+
+    if (LFS_ERR_OK != lfs_file_open (&g_rm_littlefs0_lfs, &file, SAMPLE_JOURNAL_INDEX_FILE, LFS_O_RDONLY))
+    {
+        return FSP_ERR_NOT_FOUND;
+    }
+    read_len = lfs_file_read (&g_rm_littlefs0_lfs, &file, &index, sizeof(index));
+    (void) lfs_file_close (&g_rm_littlefs0_lfs, &file);
+    if (((lfs_ssize_t) sizeof(index) != read_len) || (SAMPLE_JOURNAL_INDEX_MAGIC != index.magic)
+        || (index.cursor.segment < index.first_segment) || (index.cursor.segment > index.head_segment)
+        || ((index.head_segment - index.cursor.segment) >= SAMPLE_JOURNAL_MAX_SEGMENTS))
+    {
+        return FSP_ERR_INVALID_DATA;
+    }
+
+    g_index         = index;
+    g_cursor        = index.cursor;
+    g_first_segment = index.first_segment;
+    g_head_segment  = index.head_segment;
+    g_head_seq      = index.head_seq;
+    memcpy (g_segment_records, index.records, sizeof(g_segment_records));
+
+    sample_journal_remove (g_first_segment, g_cursor.segment);
+    g_first_segment = g_cursor.segment;
+
+    err = sample_journal_load (g_head_segment, &state, 0U, NULL, 0U, &count);
+    sample_journal_restore_head (err, &state);
+    if (g_cursor.index > SAMPLE_JOURNAL_RECORDS(g_cursor.segment))
+    {
+        g_cursor.index = SAMPLE_JOURNAL_RECORDS(g_cursor.segment);
+    }
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Restores the journal by scanning the directory and decoding every live segment. The read position comes
+ *             from the cursor file of the journal before the index, when there is one.
+ * @retval     FSP_SUCCESS when the journal is restored, an error when the directory cannot be read.
+ **********************************************************************************************************************/
+static fsp_err_t sample_journal_rebuild(void)
+{
+    lfs_file_t file;
+    sample_journal_legacy_cursor_t legacy;
+    lfs_ssize_t read_len = RESET_VALUE;
+    uint32_t min_segment = RESET_VALUE;
+    uint32_t max_segment = RESET_VALUE;
+    uint32_t count = RESET_VALUE;
+    sample_codec_state_t state;
+    fsp_err_t err = FSP_SUCCESS;
+
+    /* A temporary cursor without its rename is from an interrupted commit, the old cursor is still valid */
+    (void) lfs_remove (&g_rm_littlefs0_lfs, SAMPLE_JOURNAL_CURSOR_TMP_FILE);
+
+    memset (&legacy, RESET_VALUE, sizeof(legacy));
+    if (LFS_ERR_OK == lfs_file_open (&g_rm_littlefs0_lfs, &file, SAMPLE_JOURNAL_CURSOR_FILE, LFS_O_RDONLY))
+    {
+        read_len = lfs_file_read (&g_rm_littlefs0_lfs, &file, &legacy, sizeof(legacy));
+        (void) lfs_file_close (&g_rm_littlefs0_lfs, &file);
+    }
+    if (((lfs_ssize_t) sizeof(legacy) == read_len) && (SAMPLE_JOURNAL_CURSOR_MAGIC == legacy.magic))
+    {
+        g_cursor = legacy.cursor;
+    }
+
+    err = sample_journal_scan (&min_segment, &max_segment);
+    if (FSP_ERR_NOT_FOUND == err)
+    {
+        /* Empty journal, continue the segment numbering of the cursor */
+        g_head_segment  = g_cursor.segment;
+        g_first_segment = g_cursor.segment;
+        g_cursor.index  = RESET_VALUE;
+        return FSP_SUCCESS;
+    }
+    if (FSP_SUCCESS != err)
+    {
+        return err;
+    }
+
+    g_head_segment = max_segment;
+    if ((g_cursor.segment < min_segment) || (g_cursor.segment > g_head_segment))
+    {
+        g_cursor.segment = min_segment;
+        g_cursor.index   = RESET_VALUE;
+    }
+    if ((g_head_segment - g_cursor.segment) >= SAMPLE_JOURNAL_MAX_SEGMENTS)
+    {
+        g_cursor.segment = g_head_segment - (SAMPLE_JOURNAL_MAX_SEGMENTS - 1U);
+        g_cursor.index   = RESET_VALUE;
+    }
+
+    /* Segments in front of the cursor were drained, their removal was cut short by a reset */
+    sample_journal_remove (min_segment, g_cursor.segment);
+    g_first_segment = g_cursor.segment;
+
+    for (uint32_t segment = g_cursor.segment; segment < g_head_segment; segment++)
+    {
+        (void) sample_journal_load (segment, &state, 0U, NULL, 0U, &count);
+        SAMPLE_JOURNAL_RECORDS(segment) = (uint8_t) state.count;
+        if (0U != state.count)
+        {
+            g_next_seq = state.last.seq + 1U;
+        }
+    }
+    g_head_seq = g_next_seq;
+
+    err = sample_journal_load (g_head_segment, &state, 0U, NULL, 0U, &count);
+    sample_journal_restore_head (err, &state);
+    if (g_cursor.index > SAMPLE_JOURNAL_RECORDS(g_cursor.segment))
+    {
+        g_cursor.index = SAMPLE_JOURNAL_RECORDS(g_cursor.segment);
+    }
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Takes over the decoded head segment: its sample count, the next sequence number and the encoder
+ *             position, g_block still holds the segment. A missing head file is an empty head.
+ **********************************************************************************************************************/
+static void sample_journal_restore_head(fsp_err_t load_err, const sample_codec_state_t * p_state)
+{
+    SAMPLE_JOURNAL_RECORDS(g_head_segment) = (uint8_t) p_state->count;
+    if (0U != p_state->count)
+    {
+        g_next_seq = p_state->last.seq + 1U;
+        g_head_seq = g_next_seq - p_state->count;
+    }
+    else
+    {
+        g_next_seq = g_head_seq;
+    }
+
+    if ((FSP_SUCCESS == load_err) || (FSP_ERR_NOT_FOUND == load_err))
+    {
+        g_head_state   = *p_state;
+        g_head_flushed = p_state->used;
+        memcpy (g_head_block, g_block, p_state->used);
+    }
+    else
+    {
+        /* Unreadable or older format head, never append behind data that does not decode */
+        g_head_segment++;
+        g_head_seq = g_next_seq;
+        if ((g_head_segment - g_cursor.segment) >= SAMPLE_JOURNAL_MAX_SEGMENTS)
+        {
+            sample_journal_drop_oldest ();
+        }
+        SAMPLE_JOURNAL_RECORDS(g_head_segment) = RESET_VALUE;
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns the sequence number of the first sample of a live segment.
+ **********************************************************************************************************************/
+static uint32_t sample_journal_first_seq(uint32_t segment)
+{
+    uint32_t seq = g_head_seq;
+
+    for (uint32_t older = segment; older < g_head_segment; older++)
+    {
+        seq -= SAMPLE_JOURNAL_RECORDS(older);
+    }
+    return seq;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Builds the file name of a segment.
+ **********************************************************************************************************************/
+static void sample_journal_path(char * p_path, uint32_t segment)
+{
+    (void) snprintf (p_path, SAMPLE_JOURNAL_PATH_LEN, SAMPLE_JOURNAL_SEGMENT_FMT, (unsigned long) segment);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Finds the oldest and the newest segment file.
+ * @retval     FSP_SUCCESS when at least one segment exists, FSP_ERR_NOT_FOUND for an empty journal.
+ **********************************************************************************************************************/
+static fsp_err_t sample_journal_scan(uint32_t * p_min_segment, uint32_t * p_max_segment)
+{
+    lfs_dir_t dir;
+    struct lfs_info info;
+    bool found = false;
+    int lfs_err = lfs_dir_open (&g_rm_littlefs0_lfs, &dir, SAMPLE_JOURNAL_DIR);
+
+    if (LFS_ERR_OK != lfs_err)
+    {
+        return FSP_ERR_NOT_OPEN;
+    }
+    while (lfs_dir_read (&g_rm_littlefs0_lfs, &dir, &info) > 0)
+    {
+        char * p_end = NULL;
+        uint32_t segment = RESET_VALUE;
+
+        if ((LFS_TYPE_REG != info.type) || ('s' != info.name[0]))
+        {
+            continue;
+        }
+        segment = (uint32_t) strtoul (&info.name[1], &p_end, 16);
+        if ((NULL == p_end) || ('\0' != *p_end))
+        {
+            continue;
+        }
+        if (!found || (segment < *p_min_segment))
+        {
+            *p_min_segment = segment;
+        }
+        if (!found || (segment > *p_max_segment))
+        {
+            *p_max_segment = segment;
+        }
+        found = true;
+    }
+    (void) lfs_dir_close (&g_rm_littlefs0_lfs, &dir);
+
+    return found ? FSP_SUCCESS : FSP_ERR_NOT_FOUND;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Reads one segment and decodes it, copying up to max_records samples from index on. p_state ends behind
+ *             the last sample that decoded.
+ * @retval     FSP_SUCCESS when the whole segment decoded, FSP_ERR_INVALID_DATA when decoding stopped early.
+ **********************************************************************************************************************/
+static fsp_err_t sample_journal_load(uint32_t segment, sample_codec_state_t * p_state, uint32_t index,
+                                     sample_codec_sample_t * p_records, uint32_t max_records, uint32_t * p_count)
+{
+    lfs_file_t file;
+    char path[SAMPLE_JOURNAL_PATH_LEN];
+    sample_codec_sample_t sample;
+    const uint8_t * p_block = g_block;
+    lfs_ssize_t read_len = RESET_VALUE;
+    fsp_err_t err = FSP_SUCCESS;
+
+    *p_count = RESET_VALUE;
+    sample_codec_reset (p_state);
+    if (g_journal_ready && (segment == g_head_segment))
+    {
+        /* The head is complete only in RAM */
+        p_block  = g_head_block;
+        read_len = (lfs_ssize_t) g_head_state.used;
+    }
+    else
+    {
+        sample_journal_path (path, segment);
+        if (LFS_ERR_OK != lfs_file_open (&g_rm_littlefs0_lfs, &file, path, LFS_O_RDONLY))
+        {
+            return FSP_ERR_NOT_FOUND;
+        }
+        read_len = lfs_file_read (&g_rm_littlefs0_lfs, &file, g_block, sizeof(g_block));
+        (void) lfs_file_close (&g_rm_littlefs0_lfs, &file);
+        if (read_len < 0)
+        {
+            return FSP_ERR_READ_FAILED;
+        }
+    }
+
+    while (FSP_SUCCESS == (err = sample_codec_decode (p_state, p_block, (uint32_t) read_len, &sample)))
+    {
+        if ((p_state->count > index) && (*p_count < max_records))
+        {
+            p_records[(*p_count)++] = sample;
+        }
+    }
+    return (FSP_ERR_NOT_FOUND == err) ? FSP_SUCCESS : err;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Moves the cursor over count pending samples, commits it and removes the segments it left behind.
+ **********************************************************************************************************************/
+static fsp_err_t sample_journal_advance(uint32_t count)
+{
+    uint32_t first_segment = g_cursor.segment;
+    fsp_err_t err = FSP_SUCCESS;
+
+    /* Passed samples must be in flash, after a reset their sequence numbers would be given out again */
+    if ((count + g_head_staged) > sample_journal_pending ())
+    {
+        err = sample_journal_write_head ();
+        if (FSP_SUCCESS != err)
+        {
+            return err;
+        }
+    }
+
+    g_cursor.index += count;
+    while ((g_cursor.segment < g_head_segment) && (g_cursor.index >= SAMPLE_JOURNAL_RECORDS(g_cursor.segment)))
+    {
+        g_cursor.index -= SAMPLE_JOURNAL_RECORDS(g_cursor.segment);
+        g_cursor.segment++;
+    }
+
+    err = sample_journal_commit ();
+    if (FSP_SUCCESS != err)
+    {
+        return err;
+    }
+    sample_journal_cut_point ();
+    sample_journal_remove (first_segment, g_cursor.segment);
+    g_first_segment = g_cursor.segment;
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Appends the staged part of the head block to its segment file and counts the erases LittleFS needed.
+ **********************************************************************************************************************/
+static fsp_err_t sample_journal_write_head(void)
+{
+    lfs_file_t file;
+    char path[SAMPLE_JOURNAL_PATH_LEN];
+    uint32_t len = g_head_state.used - g_head_flushed;
+    uint32_t erases = hal_littlefs_erase_count ();
+    uint32_t start = app_timing_cycles ();
+    uint32_t elapsed_us = RESET_VALUE;
+    lfs_ssize_t written = RESET_VALUE;
+    int lfs_err = LFS_ERR_OK;
+
+    if (0U == len)
+    {
+        return FSP_SUCCESS;
+    }
+
+    /* The index lists a new head before its file exists, a resume never misses a segment */
+    if ((g_index.head_segment != g_head_segment) && (FSP_SUCCESS != sample_journal_commit ()))
+    {
+        return FSP_ERR_WRITE_FAILED;
+    }
+
+    sample_journal_path (path, g_head_segment);
+    lfs_err = lfs_file_open (&g_rm_littlefs0_lfs, &file, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND);
+    if (LFS_ERR_OK != lfs_err)
+    {
+        APP_ERR_PRINT("** Failed to open %s: %d ** \r\n", path, lfs_err);
+        return FSP_ERR_WRITE_FAILED;
+    }
+    written = lfs_file_write (&g_rm_littlefs0_lfs, &file, &g_head_block[g_head_flushed], len);
+    sample_journal_cut_point ();
+    lfs_err = lfs_file_close (&g_rm_littlefs0_lfs, &file);
+    sample_journal_cut_point ();
+    if (((lfs_ssize_t) len != written) || (LFS_ERR_OK != lfs_err))
+    {
+        APP_ERR_PRINT("** Failed to append to %s: %d ** \r\n", path, lfs_err);
+        return FSP_ERR_WRITE_FAILED;
+    }
+
+    elapsed_us = APP_TIMING_CYCLES_TO_US(app_timing_cycles () - start);
+    g_journal_stats.flushes++;
+    g_journal_stats.flushed     += g_head_staged;
+    g_journal_stats.erases      += hal_littlefs_erase_count () - erases;
+    g_journal_stats.flush_us_max = (elapsed_us > g_journal_stats.flush_us_max) ? elapsed_us :
+                                   g_journal_stats.flush_us_max;
+    g_head_flushed = g_head_state.used;
+    g_head_staged  = RESET_VALUE;
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Gives up the oldest unsent segment to make room for a new head.
+ **********************************************************************************************************************/
+static void sample_journal_drop_oldest(void)
+{
+    uint32_t dropped_segment = g_cursor.segment;
+
+    g_journal_stats.dropped += SAMPLE_JOURNAL_RECORDS(g_cursor.segment) - g_cursor.index;
+    g_cursor.segment++;
+    g_cursor.index = RESET_VALUE;
+    (void) sample_journal_commit ();
+    sample_journal_remove (dropped_segment, g_cursor.segment);
+    g_first_segment = g_cursor.segment;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Rewrites the index. LittleFS writes the new content copy-on-write and switches to it at close, after a
+ *             power loss either the old or the new index is found.
+ **********************************************************************************************************************/
+static fsp_err_t sample_journal_commit(void)
+{
+    lfs_file_t file;
+    sample_journal_index_t index = g_index;
+    lfs_ssize_t written = RESET_VALUE;
+    int lfs_err = LFS_ERR_OK;
+
+    index.magic         = SAMPLE_JOURNAL_INDEX_MAGIC;
+    index.generation++;
+    index.cursor        = g_cursor;
+    index.first_segment = g_first_segment;
+    index.head_segment  = g_head_segment;
+    index.head_seq      = g_head_seq;
+    memcpy (index.records, g_segment_records, sizeof(index.records));
+
+    lfs_err = lfs_file_open (&g_rm_littlefs0_lfs, &file, SAMPLE_JOURNAL_INDEX_FILE,
+                             LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+    if (LFS_ERR_OK != lfs_err)
+    {
+        APP_ERR_PRINT("** Failed to open %s: %d ** \r\n", SAMPLE_JOURNAL_INDEX_FILE, lfs_err);
+        return FSP_ERR_WRITE_FAILED;
+    }
+    written = lfs_file_write (&g_rm_littlefs0_lfs, &file, &index, sizeof(index));
+    sample_journal_cut_point ();
+    lfs_err = lfs_file_close (&g_rm_littlefs0_lfs, &file);
+    if ((lfs_ssize_t) sizeof(index) != written)
+    {
+        lfs_err = LFS_ERR_IO;
+    }
+    if (LFS_ERR_OK != lfs_err)
+    {
+        APP_ERR_PRINT("** Failed to commit the journal index: %d ** \r\n", lfs_err);
+        return FSP_ERR_WRITE_FAILED;
+    }
+
+    g_index = index;
+    g_journal_stats.index_commits++;
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Removes the segment files first_segment .. end_segment - 1.
+ **********************************************************************************************************************/
+static void sample_journal_remove(uint32_t first_segment, uint32_t end_segment)
+{
+    char path[SAMPLE_JOURNAL_PATH_LEN];
+
+    for (uint32_t segment = first_segment; segment < end_segment; segment++)
+    {
+        sample_journal_path (path, segment);
+        (void) lfs_remove (&g_rm_littlefs0_lfs, path);
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Power-cut test: resets the MCU here about once in SAMPLE_JOURNAL_CUT_TEST_ODDS calls. The points sit
+ *             between the LittleFS calls of a flush, an index commit and a segment removal.
+ **********************************************************************************************************************/
+static void sample_journal_cut_point(void)
+{
+#if (SAMPLE_JOURNAL_CUT_TEST == ENABLE)
+    if (0U == (app_timing_cycles () % SAMPLE_JOURNAL_CUT_TEST_ODDS))
+    {
+        NVIC_SystemReset ();
+    }
+#endif
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
@@ -0,0 +1,88 @@
+/***********************************************************************************************************************
+ * File Name    : sample_journal.h
+ * Description  : Contains macros, data structures and functions used by the store-and-forward sample journal
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef SAMPLE_JOURNAL_H_
+#define SAMPLE_JOURNAL_H_
+
+#include "hal_data.h"
+#include "FreeRTOS.h"
+#include "sample_codec.h"
+
+/* Journal layout in LittleFS: append-only segment files and the index */
+#define SAMPLE_JOURNAL_DIR              "/jrnl"
+#define SAMPLE_JOURNAL_SEGMENT_FMT      "/jrnl/s%08lx"
+#define SAMPLE_JOURNAL_INDEX_FILE       "/jrnl/index"
+#define SAMPLE_JOURNAL_PATH_LEN         (24U)
+#define SAMPLE_JOURNAL_INDEX_MAGIC      (0x5849524AUL)      /* "JRIX" */
+
+/* Read cursor of the journal before the index, only read to carry the read position over */
+#define SAMPLE_JOURNAL_CURSOR_FILE      "/jrnl/cursor"
+#define SAMPLE_JOURNAL_CURSOR_TMP_FILE  "/jrnl/cursor.tmp"
+#define SAMPLE_JOURNAL_CURSOR_MAGIC     (0x5243524AUL)      /* "JRCR" */
+
+/* The data flash holds 8 KB shared with the PKCS#11 objects. A segment is one codec block of SAMPLE_CODEC_BLOCK_SIZE
+ * bytes (about 36 samples at a regular period), the oldest segment is dropped when the journal is full */
+#define SAMPLE_JOURNAL_MAX_SEGMENTS     (12U)
+#define SAMPLE_JOURNAL_CHECK_TAG        "#JRNLCHK"
+
+/* Read position */
+typedef struct st_sample_journal_cursor
+{
+    uint32_t segment;                   /* Segment holding the oldest unsent record */
+    uint32_t index;                     /* Record index within that segment */
+} sample_journal_cursor_t;
+
+/* Journal state committed to flash, small enough to be inlined in its LittleFS metadata pair. The file is rewritten
+ * in place: LittleFS makes a file update visible at close only, so after a power loss either the old or the new
+ * index is found. Segments are numbered consecutively and sample sequence numbers run on across segments, so the
+ * first and last sequence number of every segment follows from head_seq and the sample counts */
+typedef struct st_sample_journal_index
+{
+    uint32_t magic;
+    uint32_t generation;                /* Commits since the index was created */
+    sample_journal_cursor_t cursor;
+    uint32_t first_segment;             /* Oldest segment file that may still exist */
+    uint32_t head_segment;              /* Segment being appended to, its samples are counted by decoding it */
+    uint32_t head_seq;                  /* Sequence number of the first sample of the head segment */
+    uint8_t records[SAMPLE_JOURNAL_MAX_SEGMENTS];   /* Samples of each sealed segment, slot segment % MAX */
+} sample_journal_index_t;
+
+typedef struct st_sample_journal_stats
+{
+    uint32_t appended;
+    uint32_t consumed;
+    uint32_t dropped;                   /* Lost to the size bound */
+    uint32_t unreadable;                /* Lost in segments that no longer decode, dropped unsent */
+    uint32_t index_commits;
+    uint32_t bytes_appended;            /* Encoded size including the block anchors */
+    uint32_t flushes;                   /* Writes of staged samples to flash */
+    uint32_t flushed;                   /* Samples covered by these writes */
+    uint32_t erases;                    /* Block erases LittleFS issued for them */
+    uint32_t flush_us_max;
+    uint32_t append_us_max;
+    uint64_t append_us_total;
+    uint64_t read_us_total;
+    uint64_t commit_us_total;
+    uint32_t resume_us;                 /* Journal open at boot */
+    bool resumed;                       /* Opened from the index, false when segments had to be scanned */
+} sample_journal_stats_t;
+
+fsp_err_t sample_journal_init(void);
+fsp_err_t sample_journal_append(sample_codec_sample_t * p_sample);
+void sample_journal_service(void);
+TickType_t sample_journal_service_due(void);
+fsp_err_t sample_journal_flush(void);
+uint32_t sample_journal_pending(void);
+fsp_err_t sample_journal_peek(sample_codec_sample_t * p_records, uint32_t max_records, uint32_t * p_count);
+fsp_err_t sample_journal_consume(uint32_t count);
+void sample_journal_print_stats(void);
+fsp_err_t sample_journal_check(void);
+
+#endif /* SAMPLE_JOURNAL_H_ */
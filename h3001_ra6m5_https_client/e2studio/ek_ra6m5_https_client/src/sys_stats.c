@@ -0,0 +1,290 @@
+/***********************************************************************************************************************
+ * File Name    : sys_stats.c
+ * Description  : This file reports the stack margin and the CPU share of every task. The kernel's run time stats count
+ *                core clock cycles derived from the tick count and the SysTick down counter: the DWT cycle counter
+ *                stops in Sleep mode and would hide the idle time spent in tickless sleep. The user thread samples the
+ *                counters every SYS_STATS_PERIOD_MS for the RTT metrics channel and on the "stats" command.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_SYS)
+
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "user_app.h"
+#include "rtt_streams.h"
+#include "sys_stats.h"
+
+#if (configGENERATE_RUN_TIME_STATS != 1) || (configUSE_TRACE_FACILITY != 1)
+ #error "Enable Generate Run Time Stats and Use Trace Facility in the FreeRTOS module for the task report"
+#endif
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+/* Run time counter, read at every context switch */
+static uint32_t g_cycles_per_tick = RESET_VALUE;
+static TickType_t g_last_ticks = RESET_VALUE;
+static uint32_t g_tick_wraps = RESET_VALUE;
+static uint64_t g_switched_in = RESET_VALUE;        /* Run time when the running task was switched in */
+
+/* Counters at the start of the report window, by task number */
+static TaskStatus_t g_task_status[SYS_STATS_TASKS_MAX];
+static UBaseType_t g_window_numbers[SYS_STATS_TASKS_MAX];
+static uint64_t g_window_run_time[SYS_STATS_TASKS_MAX];
+static uint32_t g_window_tasks = RESET_VALUE;
+static uint64_t g_window_total = RESET_VALUE;
+static TickType_t g_window_tick = RESET_VALUE;
+
+static sys_stats_report_t g_report;
+
+static uint64_t sys_stats_window_start(UBaseType_t number);
+
+/*******************************************************************************************************************//**
+ * @brief      portCONFIGURE_TIMER_FOR_RUN_TIME_STATS(), called by vTaskStartScheduler() before the port starts SysTick.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void sys_stats_run_time_start(void)
+{
+    g_cycles_per_tick = SystemCoreClock / configTICK_RATE_HZ;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      portGET_RUN_TIME_COUNTER_VALUE(): core clock cycles since the scheduler started. Ticks times the cycles
+ *             of a tick plus the part of the current tick SysTick counted down. A SysTick wrap whose interrupt is
+ *             still pending counts as the tick it is about to add.
+ * @param[in]  None
+ * @retval     Cycles.
+ **********************************************************************************************************************/
+uint64_t sys_stats_run_time(void)
+{
+    uint32_t primask = __get_PRIMASK ();
+    TickType_t ticks = RESET_VALUE;
+    uint32_t down = RESET_VALUE;
+    uint32_t in_tick = RESET_VALUE;
+    uint32_t wraps = RESET_VALUE;
+
+    __disable_irq ();
+    ticks = xTaskGetTickCount ();
+    down  = SysTick->VAL;
+    if (0U != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk))
+    {
+        ticks++;
+        down = SysTick->VAL;
+    }
+
+    /* Ticks counted while the scheduler is suspended are added on resume and may read a little behind */
+    wraps = g_tick_wraps;
+    if ((TickType_t) (ticks - g_last_ticks) < (portMAX_DELAY / 2U))
+    {
+        wraps        += (ticks < g_last_ticks) ? 1U : 0U;
+        g_tick_wraps  = wraps;
+        g_last_ticks  = ticks;
+    }
+    else if (ticks > g_last_ticks)
+    {
+        wraps--;
+    }
+    else
+    {
+        /* Behind within the same wrap */
+    }
+    __set_PRIMASK (primask);
+
+    in_tick = (down < g_cycles_per_tick) ? (g_cycles_per_tick - 1U - down) : 0U;
+    return (((((uint64_t) wraps) << 32) | ticks) * g_cycles_per_tick) + in_tick;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      traceTASK_SWITCHED_IN(), called by the kernel in the context switch right after it charged the run time
+ *             of the task switched out.
+ * @param[in]  None
+ * @retval     None
+ **********************************************************************************************************************/
+void sys_stats_task_switched_in(void)
+{
+    g_switched_in = sys_stats_run_time ();
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Run time of the calling task up to now, core clock cycles. The kernel charges a task at its switch out,
+ *             so its counter is added the slice running since the switch in: no yield is needed to bring it up to
+ *             date, and two reads around a step count the step alone.
+ * @param[in]  None
+ * @retval     Cycles.
+ **********************************************************************************************************************/
+uint64_t sys_stats_task_run_time(void)
+{
+    uint32_t primask = __get_PRIMASK ();
+    uint64_t run_time = RESET_VALUE;
+
+    __disable_irq ();
+    run_time = ulTaskGetRunTimeCounter (NULL) + (sys_stats_run_time () - g_switched_in);
+    __set_PRIMASK (primask);
+    return run_time;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Takes the stack margins and the CPU shares of the window since the previous sample, which starts the
+ *             next window. Call from one task only.
+ * @param[in]  None
+ * @retval     Report, valid until the next call.
+ **********************************************************************************************************************/
+const sys_stats_report_t * sys_stats_sample(void)
+{
+    configRUN_TIME_COUNTER_TYPE total = RESET_VALUE;
+    uint64_t window = RESET_VALUE;
+    uint64_t idle = RESET_VALUE;
+    uint64_t run = RESET_VALUE;
+    UBaseType_t count = RESET_VALUE;
+    TickType_t now = xTaskGetTickCount ();
+
+    count  = uxTaskGetSystemState (g_task_status, SYS_STATS_TASKS_MAX, &total);
+    window = total - g_window_total;
+
+    g_report.window_ms     = (now - g_window_tick) * portTICK_PERIOD_MS;
+    g_report.tasks         = (uint32_t) count;
+    g_report.heap_free     = xPortGetFreeHeapSize ();
+    g_report.heap_min_free = xPortGetMinimumEverFreeHeapSize ();
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        const TaskStatus_t * p_status = &g_task_status[i];
+        sys_stats_task_t * p_task = &g_report.task[i];
+
+        run = p_status->ulRunTimeCounter - sys_stats_window_start (p_status->xTaskNumber);
+        strncpy (p_task->name, p_status->pcTaskName, sizeof(p_task->name) - 1U);
+        p_task->priority     = (uint32_t) p_status->uxCurrentPriority;
+        p_task->stack_margin = (uint32_t) p_status->usStackHighWaterMark * sizeof(StackType_t);
+        p_task->cpu_x100     = (0U != window) ? (uint32_t) ((run * 10000U) / window) : 0U;
+        if (0 == strcmp (p_status->pcTaskName, configIDLE_TASK_NAME))
+        {
+            idle = run;
+        }
+    }
+    g_report.load_x100 = (0U != window) ? (uint32_t) (10000U - ((idle * 10000U) / window)) : 0U;
+
+    /* Next window */
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        g_window_numbers[i]  = g_task_status[i].xTaskNumber;
+        g_window_run_time[i] = g_task_status[i].ulRunTimeCounter;
+    }
+    g_window_tasks = (uint32_t) count;
+    g_window_total = total;
+    g_window_tick  = now;
+    return &g_report;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Ticks until the next periodic report is due, 0 when it is.
+ * @param[in]  None
+ * @retval     Ticks.
+ **********************************************************************************************************************/
+TickType_t sys_stats_service_due(void)
+{
+    TickType_t elapsed = xTaskGetTickCount () - g_window_tick;
+
+    return (elapsed >= pdMS_TO_TICKS(SYS_STATS_PERIOD_MS)) ? 0U : (pdMS_TO_TICKS(SYS_STATS_PERIOD_MS) - elapsed);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Prints a report.
+ * @param[in]  p_report                     Report of sys_stats_sample().
+ * @retval     None
+ **********************************************************************************************************************/
+void sys_stats_print(const sys_stats_report_t * p_report)
+{
+    APP_PRINT("\r\n%s,%d,%d,%d.%02d,%d,%d\r\n", SYS_STATS_TAG, p_report->window_ms, p_report->tasks,
+              p_report->load_x100 / 100U, p_report->load_x100 % 100U, p_report->heap_free, p_report->heap_min_free);
+    for (uint32_t i = 0; i < p_report->tasks; i++)
+    {
+        const sys_stats_task_t * p_task = &p_report->task[i];
+
+        APP_PRINT("%s,task,%s,%d,%d,%d.%02d\r\n", SYS_STATS_TAG, p_task->name, p_task->priority,
+                  p_task->stack_margin, p_task->cpu_x100 / 100U, p_task->cpu_x100 % 100U);
+    }
+    APP_PRINT("%s,end\r\n", SYS_STATS_TAG);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Writes a report to the RTT metrics channel.
+ * @param[in]  p_report                     Report of sys_stats_sample().
+ * @retval     None
+ **********************************************************************************************************************/
+void sys_stats_emit(const sys_stats_report_t * p_report)
+{
+    sys_stats_metric_t metric;
+    sys_stats_task_metric_t task;
+
+    metric.time_ms       = xTaskGetTickCount () * portTICK_PERIOD_MS;
+    metric.window_ms     = p_report->window_ms;
+    metric.tasks         = p_report->tasks;
+    metric.load_x100     = p_report->load_x100;
+    metric.heap_free     = p_report->heap_free;
+    metric.heap_min_free = p_report->heap_min_free;
+    (void) rtt_stream_metric (RTT_METRIC_SYS_STATS, &metric, sizeof(metric));
+
+    for (uint32_t i = 0; i < p_report->tasks; i++)
+    {
+        strncpy (task.name, p_report->task[i].name, sizeof(task.name));
+        task.priority     = p_report->task[i].priority;
+        task.stack_margin = p_report->task[i].stack_margin;
+        task.cpu_x100     = p_report->task[i].cpu_x100;
+        (void) rtt_stream_metric (RTT_METRIC_TASK, &task, sizeof(task));
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Formats a report as the JSON body of a data point of the health feed: the load, the heap and the stack
+ *             margin of every task in one value.
+ * @param[in]  p_report                     Report of sys_stats_sample().
+ * @param[out] p_buffer                     Body.
+ * @param[in]  size                         Size of the buffer.
+ * @retval     Length of the body, negative or not less than size when it does not fit.
+ **********************************************************************************************************************/
+int sys_stats_format_feed(const sys_stats_report_t * p_report, char * p_buffer, size_t size)
+{
+    int len = snprintf (p_buffer, size, "{\"datum\":{\"value\":\"load=%u.%02u,heap=%u,heap_min=%u",
+                        (unsigned) (p_report->load_x100 / 100U), (unsigned) (p_report->load_x100 % 100U),
+                        (unsigned) p_report->heap_free, (unsigned) p_report->heap_min_free);
+
+    for (uint32_t i = 0; (i < p_report->tasks) && (len > 0) && ((size_t) len < size); i++)
+    {
+        len += snprintf (&p_buffer[len], size - (size_t) len, ",%s=%u", p_report->task[i].name,
+                         (unsigned) p_report->task[i].stack_margin);
+    }
+    if ((len > 0) && ((size_t) len < size))
+    {
+        len += snprintf (&p_buffer[len], size - (size_t) len, "\"}}");
+    }
+    return len;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Run time of a task at the start of the window, 0 for a task started in the window.
+ **********************************************************************************************************************/
+static uint64_t sys_stats_window_start(UBaseType_t number)
+{
+    for (uint32_t i = 0; i < g_window_tasks; i++)
+    {
+        if (g_window_numbers[i] == number)
+        {
+            return g_window_run_time[i];
+        }
+    }
+    return 0U;
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
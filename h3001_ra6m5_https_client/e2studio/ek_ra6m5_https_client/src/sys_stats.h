@@ -0,0 +1,79 @@
+/***********************************************************************************************************************
+ * File Name    : sys_stats.h
+ * Description  : Contains macros, data structures and functions used by the stack and CPU load report of the tasks
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef SYS_STATS_H_
+#define SYS_STATS_H_
+
+#include "hal_data.h"
+#include "FreeRTOS.h"
+
+/* Tasks covered by a report, the others are counted in the total only */
+#define SYS_STATS_TASKS_MAX             (16U)
+
+/*
+ * Report of the "stats" command, one line per task after the header:
+ *   #SYSSTATS,<window ms>,<tasks>,<load %>,<heap free>,<lowest heap free>
+ *   #SYSSTATS,task,<name>,<priority>,<stack margin bytes>,<cpu %>
+ * The margin is the stack the task never touched since it started, the CPU share is of the report window. The
+ * periodic report goes to the RTT metrics channel instead: a RTT_METRIC_SYS_STATS record, then a RTT_METRIC_TASK
+ * record per task.
+ */
+#define SYS_STATS_TAG                   "#SYSSTATS"
+#define SYS_STATS_METRIC_NAME_LEN       (16U)
+
+typedef struct st_sys_stats_task
+{
+    char name[configMAX_TASK_NAME_LEN];
+    uint32_t priority;
+    uint32_t stack_margin;              /* Bytes */
+    uint32_t cpu_x100;                  /* Percent of the window times 100 */
+} sys_stats_task_t;
+
+typedef struct st_sys_stats_report
+{
+    uint32_t window_ms;
+    uint32_t tasks;
+    uint32_t load_x100;                 /* Percent of the window not spent in the idle task, times 100 */
+    uint32_t heap_free;
+    uint32_t heap_min_free;
+    sys_stats_task_t task[SYS_STATS_TASKS_MAX];
+} sys_stats_report_t;
+
+/* RTT_METRIC_SYS_STATS payload */
+typedef struct st_sys_stats_metric
+{
+    uint32_t time_ms;                   /* Time since boot at the end of the window */
+    uint32_t window_ms;
+    uint32_t tasks;
+    uint32_t load_x100;
+    uint32_t heap_free;
+    uint32_t heap_min_free;
+} sys_stats_metric_t;
+
+/* RTT_METRIC_TASK payload */
+typedef struct st_sys_stats_task_metric
+{
+    char name[SYS_STATS_METRIC_NAME_LEN];   /* Zero padded, not terminated at full length */
+    uint32_t priority;
+    uint32_t stack_margin;
+    uint32_t cpu_x100;
+} sys_stats_task_metric_t;
+
+void sys_stats_run_time_start(void);
+uint64_t sys_stats_run_time(void);
+void sys_stats_task_switched_in(void);
+uint64_t sys_stats_task_run_time(void);
+const sys_stats_report_t * sys_stats_sample(void);
+TickType_t sys_stats_service_due(void);
+void sys_stats_print(const sys_stats_report_t * p_report);
+void sys_stats_emit(const sys_stats_report_t * p_report);
+int sys_stats_format_feed(const sys_stats_report_t * p_report, char * p_buffer, size_t size);
+
+#endif /* SYS_STATS_H_ */
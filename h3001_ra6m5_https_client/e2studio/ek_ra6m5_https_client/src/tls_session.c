@@ -0,0 +1,439 @@
+/***********************************************************************************************************************
+ * File Name    : tls_session.c
+ * Description  : This file opens and closes TLS sessions on top of the TCP sockets wrapper using the credentials
+ *                held by the credential cache.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_TLS)
+
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "tcp_sockets_wrapper.h"
+#include "mbedtls_bio_tcp_sockets_wrapper.h"
+#include "mbedtls/ssl.h"
+#include "credential_cache.h"
+#include "cert_pin.h"
+#include "core_http_client.h"
+#include "user_app.h"
+#include "app_timing.h"
+#include "net_cache.h"
+#include "mem_pool.h"
+#include "heap_trace.h"
+#include "tls_session.h"
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+/*
+ * Record buffer profile, selected with TLS_SMALL_RECORDS in app_mbedtls_config.h, which also sets
+ * MBEDTLS_SSL_IN_CONTENT_LEN and MBEDTLS_SSL_OUT_CONTENT_LEN for the library and the TLS pool. The full profile keeps
+ * both at 16384 (about 32 KB per session) and requests nothing. The small profile sets IN to 4096 and OUT to 2048; the
+ * server is then asked for 4096 byte records with max_fragment_length and the session is refused if the server does
+ * not acknowledge it. max_fragment_length is a TLS 1.2 extension in this mbedTLS configuration, so the small profile
+ * caps the session to TLS 1.2.
+ */
+#if TLS_RECORD_PROFILE_SMALL
+#define TLS_RECORD_MFL_CODE         (MBEDTLS_SSL_MAX_FRAG_LEN_4096)
+#else
+#define TLS_RECORD_MFL_CODE         (MBEDTLS_SSL_MAX_FRAG_LEN_NONE)
+#endif
+
+#if TLS_SMALL_RECORDS && !TLS_RECORD_PROFILE_SMALL
+#warning "TLS_SMALL_RECORDS: server Certificate message not measured or above 4096 bytes, full records are used"
+#endif
+#if TLS_RECORD_PROFILE_SMALL && (MBEDTLS_SSL_IN_CONTENT_LEN != 4096)
+#error "The small record profile requests 4096 byte records, MBEDTLS_SSL_IN_CONTENT_LEN must match"
+#endif
+#if TLS_RECORD_PROFILE_SMALL && !defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+#error "Record buffers below 16384 bytes need MBEDTLS_SSL_MAX_FRAGMENT_LENGTH"
+#endif
+
+/* Reason for reconnecting straight away after a failed handshake */
+typedef enum e_tls_session_retry
+{
+    TLS_SESSION_RETRY_NONE = 0,
+    TLS_SESSION_RETRY_FULL_VALIDATION,      /* Pinned leaf rejected */
+    TLS_SESSION_RETRY_TLS1_2,               /* TLS 1.3 handshake failed, server or key not usable with 1.3 */
+    TLS_SESSION_RETRY_DNS                   /* Cached server address did not accept the connection */
+} tls_session_retry_t;
+
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3) && !TLS_RECORD_PROFILE_SMALL
+#define TLS_SESSION_OFFER_TLS1_3    (1)
+#else
+#define TLS_SESSION_OFFER_TLS1_3    (0)
+#endif
+
+#if TLS_SESSION_OFFER_TLS1_3
+/* Sessions left that offer TLS 1.2 only after a TLS 1.3 handshake failed at protocol level */
+static uint32_t g_tls1_2_sessions = RESET_VALUE;
+#endif
+
+#if (TLS_HANDSHAKE_INJECT_RTT_MS > 0)
+static bool g_flight_sent = false;
+static int tls_session_bio_send(void * ctx, const unsigned char * buf, size_t len);
+static int tls_session_bio_recv(void * ctx, unsigned char * buf, size_t len);
+#endif
+
+static bool tls_session_record_limit_ok(const mbedtls_ssl_context * p_ssl);
+static mbedtls_ssl_protocol_version tls_session_max_version(bool retry_tls1_2);
+#if TLS_SESSION_OFFER_TLS1_3
+static bool tls_session_tls1_3_refused(int mbedtls_err);
+#endif
+static TlsTransportStatus_t tls_session_open(NetworkContext_t * pNetworkContext,
+                                             const char * pHostName,
+                                             uint16_t port,
+                                             uint32_t receiveTimeoutMs,
+                                             uint32_t sendTimeoutMs,
+                                             tls_session_retry_t * p_retry);
+
+/*******************************************************************************************************************//**
+ * @brief      Connects the TCP socket and performs the TLS handshake. Only the per connection SSL context and
+ *             configuration are created here, the root CA, client certificate, private key and DRBG are shared.
+ *             TLS 1.3 is offered with TLS 1.2 as minimum. A pinned handshake that is rejected is retried with full
+ *             chain validation, a TLS 1.3 handshake refused at protocol level is retried with TLS 1.2 only (and the
+ *             next TLS_TLS1_2_FALLBACK_SESSIONS sessions offer 1.2 only) and a cached server address that refuses
+ *             the connection is retried after a fresh DNS lookup.
+ *
+ * @param[in]  pNetworkContext              Network context whose pParams points at the transport parameters.
+ * @param[in]  pHostName                    Server host name, also used for SNI and certificate name checks.
+ * @param[in]  port                         Server port.
+ * @param[in]  receiveTimeoutMs             Socket receive timeout.
+ * @param[in]  sendTimeoutMs                Socket send timeout.
+ * @retval     TLS_TRANSPORT_SUCCESS        Upon successful handshake.
+ * @retval     Any other status             Upon unsuccessful connection or handshake.
+ **********************************************************************************************************************/
+TlsTransportStatus_t tls_session_connect(NetworkContext_t * pNetworkContext,
+                                         const char * pHostName,
+                                         uint16_t port,
+                                         uint32_t receiveTimeoutMs,
+                                         uint32_t sendTimeoutMs)
+{
+    TlsTransportStatus_t status = TLS_TRANSPORT_SUCCESS;
+    tls_session_retry_t retry = TLS_SESSION_RETRY_NONE;
+    uint32_t attempts = RESET_VALUE;
+
+    if ((NULL == pNetworkContext) || (NULL == pNetworkContext->pParams) || (NULL == pHostName))
+    {
+        return TLS_TRANSPORT_INVALID_PARAMETER;
+    }
+
+    /* The POST cycle whose peak heap post_json() reports starts here */
+    heap_trace_reset_peaks ();
+
+    /* At most one retry for each reason */
+    do
+    {
+        status = tls_session_open (pNetworkContext, pHostName, port, receiveTimeoutMs, sendTimeoutMs, &retry);
+        attempts++;
+    } while ((TLS_TRANSPORT_SUCCESS != status) && (TLS_SESSION_RETRY_NONE != retry) && (attempts < 4U));
+
+    return status;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Sends close notify, closes the socket and frees the per connection state. Cached credentials stay alive.
+ * @param[in]  pNetworkContext              Network context of the session to close.
+ * @retval     None
+ **********************************************************************************************************************/
+void tls_session_disconnect(NetworkContext_t * pNetworkContext)
+{
+    TlsTransportParams_t * pParams = NULL;
+    int mbedtls_err = RESET_VALUE;
+
+    if ((NULL == pNetworkContext) || (NULL == pNetworkContext->pParams))
+    {
+        return;
+    }
+    pParams = pNetworkContext->pParams;
+
+    if (NULL != pParams->tcpSocket)
+    {
+        do
+        {
+            mbedtls_err = mbedtls_ssl_close_notify (&pParams->sslContext.context);
+        } while (MBEDTLS_ERR_SSL_WANT_WRITE == mbedtls_err);
+
+        (void) TCP_Sockets_Disconnect (pParams->tcpSocket);
+        pParams->tcpSocket = NULL;
+    }
+
+    mbedtls_ssl_free (&pParams->sslContext.context);
+    mbedtls_ssl_config_free (&pParams->sslContext.config);
+
+    /* Everything mbedTLS allocated for the session is free now, the pool is released in one go */
+    mem_pool_session_end ();
+}
+/*******************************************************************************************************************//**
+ * @brief      One connection attempt: TCP connect, SSL setup and handshake. Prints the connect latency, the handshake
+ *             time and the negotiated protocol version.
+ **********************************************************************************************************************/
+static TlsTransportStatus_t tls_session_open(NetworkContext_t * pNetworkContext,
+                                             const char * pHostName,
+                                             uint16_t port,
+                                             uint32_t receiveTimeoutMs,
+                                             uint32_t sendTimeoutMs,
+                                             tls_session_retry_t * p_retry)
+{
+    TlsTransportParams_t * pParams = pNetworkContext->pParams;
+    SSLContext_t * pSsl = &pParams->sslContext;
+    BaseType_t socket_status = TCP_SOCKETS_ERRNO_NONE;
+    cert_pin_mode_t pin_mode = CERT_PIN_MODE_FULL;
+    mbedtls_ssl_protocol_version max_version = tls_session_max_version (TLS_SESSION_RETRY_TLS1_2 == *p_retry);
+    TickType_t start_tick = xTaskGetTickCount ();
+    size_t heap_free = xPortGetFreeHeapSize ();
+    uint32_t start = RESET_VALUE;
+    uint32_t cycles = RESET_VALUE;
+    int mbedtls_err = RESET_VALUE;
+    uint32_t host_address = RESET_VALUE;
+    bool address_cached = false;
+    char host_address_str[16] = {RESET_VALUE};
+
+    *p_retry = TLS_SESSION_RETRY_NONE;
+
+    /* The allocations of the session come from the TLS pool until tls_session_disconnect() */
+    mem_pool_session_begin ();
+    mbedtls_ssl_config_init (&pSsl->config);
+    mbedtls_ssl_init (&pSsl->context);
+
+    /* The host name is still used for SNI and the certificate name check, only the address may come from the cache */
+    host_address = net_cache_resolve (pHostName, &address_cached);
+    if (0U == host_address)
+    {
+        APP_ERR_PRINT("** DNS lookup of %s failed ** \r\n", pHostName);
+        socket_status = TCP_SOCKETS_ERRNO_ERROR;
+    }
+    else
+    {
+        FreeRTOS_inet_ntoa (host_address, host_address_str);
+        socket_status = TCP_Sockets_Connect (&pParams->tcpSocket, host_address_str, port, receiveTimeoutMs,
+                                             sendTimeoutMs);
+    }
+    if (TCP_SOCKETS_ERRNO_NONE != socket_status)
+    {
+        APP_ERR_PRINT("** TCP_Sockets_Connect failed: %d ** \r\n", socket_status);
+        if (address_cached)
+        {
+            net_cache_dns_invalidate ();
+            *p_retry = TLS_SESSION_RETRY_DNS;
+        }
+        mbedtls_ssl_free (&pSsl->context);
+        mbedtls_ssl_config_free (&pSsl->config);
+        mem_pool_session_end ();
+        return TLS_TRANSPORT_CONNECT_FAILURE;
+    }
+    net_cache_connected ();
+#if (TLS_HANDSHAKE_INJECT_RTT_MS > 0)
+    /* SYN / SYN-ACK round trip */
+    vTaskDelay (pdMS_TO_TICKS(TLS_HANDSHAKE_INJECT_RTT_MS));
+    g_flight_sent = false;
+#endif
+
+    mbedtls_err = mbedtls_ssl_config_defaults (&pSsl->config, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                               MBEDTLS_SSL_PRESET_DEFAULT);
+    if (0 == mbedtls_err)
+    {
+        mbedtls_ssl_conf_authmode (&pSsl->config, MBEDTLS_SSL_VERIFY_REQUIRED);
+        mbedtls_ssl_conf_min_tls_version (&pSsl->config, MBEDTLS_SSL_VERSION_TLS1_2);
+        mbedtls_ssl_conf_max_tls_version (&pSsl->config, max_version);
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+        mbedtls_err = mbedtls_ssl_conf_max_frag_len (&pSsl->config, TLS_RECORD_MFL_CODE);
+#endif
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3) && defined(MBEDTLS_SSL_SESSION_TICKETS)
+        /* Post handshake NewSessionTicket messages are consumed inside mbedtls_ssl_read() */
+        mbedtls_ssl_conf_tls13_enable_signal_new_session_tickets (&pSsl->config,
+                                                                  MBEDTLS_SSL_TLS1_3_SIGNAL_NEW_SESSION_TICKETS_DISABLED);
+#endif
+        mbedtls_ssl_conf_rng (&pSsl->config, mbedtls_ctr_drbg_random, credential_cache_rng ());
+#if (HTTPS_CERT_PINNING == ENABLE)
+        pin_mode = cert_pin_configure (&pSsl->config, credential_cache_root_ca ());
+#else
+        mbedtls_ssl_conf_ca_chain (&pSsl->config, credential_cache_root_ca (), NULL);
+#endif
+    }
+    if (0 == mbedtls_err)
+    {
+        mbedtls_err = mbedtls_ssl_conf_own_cert (&pSsl->config, credential_cache_client_cert (),
+                                                 credential_cache_private_key ());
+    }
+    if (0 == mbedtls_err)
+    {
+        mbedtls_err = mbedtls_ssl_setup (&pSsl->context, &pSsl->config);
+    }
+    if (0 == mbedtls_err)
+    {
+        mbedtls_err = mbedtls_ssl_set_hostname (&pSsl->context, pHostName);
+    }
+    if (0 != mbedtls_err)
+    {
+        APP_ERR_PRINT("** TLS session setup failed: -0x%x ** \r\n", -mbedtls_err);
+        tls_session_disconnect (pNetworkContext);
+        return TLS_TRANSPORT_INTERNAL_ERROR;
+    }
+
+#if (TLS_HANDSHAKE_INJECT_RTT_MS > 0)
+    mbedtls_ssl_set_bio (&pSsl->context, (void *) pParams->tcpSocket, tls_session_bio_send, tls_session_bio_recv, NULL);
+#else
+    mbedtls_ssl_set_bio (&pSsl->context, (void *) pParams->tcpSocket, xMbedTLSBioTCPSocketsWrapperSend,
+                         xMbedTLSBioTCPSocketsWrapperRecv, NULL);
+#endif
+
+    app_timing_init ();
+    start = app_timing_cycles ();
+    do
+    {
+        mbedtls_err = mbedtls_ssl_handshake (&pSsl->context);
+    } while ((MBEDTLS_ERR_SSL_WANT_READ == mbedtls_err) || (MBEDTLS_ERR_SSL_WANT_WRITE == mbedtls_err));
+    cycles = app_timing_cycles () - start;
+
+#if (HTTPS_CERT_PINNING == ENABLE)
+    cert_pin_handshake_done (pin_mode, mbedtls_err);
+    if ((CERT_PIN_MODE_PINNED == pin_mode) && (MBEDTLS_ERR_X509_CERT_VERIFY_FAILED == mbedtls_err))
+    {
+        *p_retry = TLS_SESSION_RETRY_FULL_VALIDATION;
+    }
+#endif
+#if TLS_SESSION_OFFER_TLS1_3
+    /* Only a refusal of the protocol falls back, a reset, EOF or allocation failure is retried as it was */
+    if ((TLS_SESSION_RETRY_NONE == *p_retry) && (MBEDTLS_SSL_VERSION_TLS1_3 == max_version)
+        && tls_session_tls1_3_refused (mbedtls_err))
+    {
+        APP_WARN_PRINT("\r\nTLS 1.3 handshake refused (-0x%x), TLS 1.2 for this and the next %d sessions\r\n",
+                       -mbedtls_err, TLS_TLS1_2_FALLBACK_SESSIONS);
+        g_tls1_2_sessions = TLS_TLS1_2_FALLBACK_SESSIONS;
+        *p_retry          = TLS_SESSION_RETRY_TLS1_2;
+    }
+#endif
+
+    if (0 != mbedtls_err)
+    {
+#if TLS_RECORD_PROFILE_SMALL
+        if ((MBEDTLS_ERR_SSL_INVALID_RECORD == mbedtls_err) || (MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL == mbedtls_err) ||
+            (MBEDTLS_ERR_SSL_FEATURE_UNAVAILABLE == mbedtls_err))
+        {
+            /* A handshake message split over records is not reassembled, e.g. a certificate chain grown past 4 KB */
+            APP_ERR_PRINT("** Server message larger than the %d byte TLS buffer, measure the chain again with "
+                          "tools/tls_chain_size.py or set TLS_SMALL_RECORDS to 0 ** \r\n", MBEDTLS_SSL_IN_CONTENT_LEN);
+        }
+#endif
+        APP_ERR_PRINT("** TLS handshake failed: -0x%x ** \r\n", -mbedtls_err);
+        tls_session_disconnect (pNetworkContext);
+        return TLS_TRANSPORT_HANDSHAKE_FAILED;
+    }
+
+    if (!tls_session_record_limit_ok (&pSsl->context))
+    {
+        APP_ERR_PRINT("** Server ignored max_fragment_length, %d byte TLS input buffer is too small ** \r\n",
+                      MBEDTLS_SSL_IN_CONTENT_LEN);
+        tls_session_disconnect (pNetworkContext);
+        return TLS_TRANSPORT_HANDSHAKE_FAILED;
+    }
+
+    APP_INFO_PRINT("\r\nTLS handshake: %d ms, %d us CPU clock, %s (%s)\r\n",
+                   (xTaskGetTickCount () - start_tick) * portTICK_PERIOD_MS, APP_TIMING_CYCLES_TO_US(cycles),
+                   mbedtls_ssl_get_version (&pSsl->context),
+                   (CERT_PIN_MODE_PINNED == pin_mode) ? "pinned" : "full validation");
+    APP_DBG_PRINT("TLS session heap outside the pool: %d bytes (record buffers IN %d / OUT %d), "
+                  "lowest free heap %d\r\n", heap_free - xPortGetFreeHeapSize (), MBEDTLS_SSL_IN_CONTENT_LEN,
+                  MBEDTLS_SSL_OUT_CONTENT_LEN, xPortGetMinimumEverFreeHeapSize ());
+    return TLS_TRANSPORT_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Checks that the peer will not send records larger than the input buffer of this build. With the default
+ *             16384 byte buffers any record fits, with the small profile the server must have acknowledged the
+ *             requested max_fragment_length.
+ **********************************************************************************************************************/
+static bool tls_session_record_limit_ok(const mbedtls_ssl_context * p_ssl)
+{
+#if TLS_RECORD_PROFILE_SMALL
+    const mbedtls_ssl_session * p_session = mbedtls_ssl_get_session_pointer (p_ssl);
+
+    return (NULL != p_session) && (TLS_RECORD_MFL_CODE == p_session->MBEDTLS_PRIVATE(mfl_code));
+#else
+    FSP_PARAMETER_NOT_USED(p_ssl);
+    return true;
+#endif
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Highest protocol version to offer. TLS 1.2 on the retry after a refused TLS 1.3 handshake and for the
+ *             sessions that follow it, TLS 1.3 again after that.
+ **********************************************************************************************************************/
+static mbedtls_ssl_protocol_version tls_session_max_version(bool retry_tls1_2)
+{
+#if TLS_SESSION_OFFER_TLS1_3
+    if (retry_tls1_2)
+    {
+        return MBEDTLS_SSL_VERSION_TLS1_2;
+    }
+    if (0U != g_tls1_2_sessions)
+    {
+        g_tls1_2_sessions--;
+        return MBEDTLS_SSL_VERSION_TLS1_2;
+    }
+    return MBEDTLS_SSL_VERSION_TLS1_3;
+#else
+    FSP_PARAMETER_NOT_USED(retry_tls1_2);
+    return MBEDTLS_SSL_VERSION_TLS1_2;
+#endif
+}
+
+#if TLS_SESSION_OFFER_TLS1_3
+/*******************************************************************************************************************//**
+ * @brief      Tells a TLS 1.3 handshake the peer or this end refused at protocol level (e.g. a certificate request the
+ *             RSA-ALT (PKCS#11) key cannot answer with RSA-PSS, or a fatal alert) from a transport or resource error.
+ **********************************************************************************************************************/
+static bool tls_session_tls1_3_refused(int mbedtls_err)
+{
+    switch (mbedtls_err)
+    {
+        case MBEDTLS_ERR_SSL_HANDSHAKE_FAILURE:
+        case MBEDTLS_ERR_SSL_BAD_PROTOCOL_VERSION:
+        case MBEDTLS_ERR_SSL_FEATURE_UNAVAILABLE:
+        case MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE:
+            return true;
+
+        default:
+            return false;
+    }
+}
+#endif
+
+#if (TLS_HANDSHAKE_INJECT_RTT_MS > 0)
+/*******************************************************************************************************************//**
+ * @brief      BIO send wrapper that marks a flight as in flight for the injected round trip.
+ **********************************************************************************************************************/
+static int tls_session_bio_send(void * ctx, const unsigned char * buf, size_t len)
+{
+    g_flight_sent = true;
+    return xMbedTLSBioTCPSocketsWrapperSend (ctx, buf, len);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      BIO receive wrapper that delays the first read after each sent flight by TLS_HANDSHAKE_INJECT_RTT_MS.
+ **********************************************************************************************************************/
+static int tls_session_bio_recv(void * ctx, unsigned char * buf, size_t len)
+{
+    if (g_flight_sent)
+    {
+        g_flight_sent = false;
+        vTaskDelay (pdMS_TO_TICKS(TLS_HANDSHAKE_INJECT_RTT_MS));
+    }
+    return xMbedTLSBioTCPSocketsWrapperRecv (ctx, buf, len);
+}
+#endif
+
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
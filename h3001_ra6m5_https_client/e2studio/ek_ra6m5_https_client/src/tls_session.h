@@ -0,0 +1,34 @@
+/***********************************************************************************************************************
+ * File Name    : tls_session.h
+ * Description  : Contains macros, data structures and functions used to open TLS sessions with cached credentials
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef TLS_SESSION_H_
+#define TLS_SESSION_H_
+
+#include "transport_mbedtls_pkcs11.h"
+
+/* The transport interface leaves the network context to the application */
+struct NetworkContext
+{
+    TlsTransportParams_t * pParams;
+};
+
+/*
+ * Sessions opened by tls_session_connect() share the TlsTransportParams_t layout of the FSP transport, so
+ * TLS_FreeRTOS_send() and TLS_FreeRTOS_recv() are used unchanged for the HTTP traffic. The credentials are borrowed
+ * from the credential cache and must be released with tls_session_disconnect(), not TLS_FreeRTOS_Disconnect().
+ */
+TlsTransportStatus_t tls_session_connect(NetworkContext_t * pNetworkContext,
+                                         const char * pHostName,
+                                         uint16_t port,
+                                         uint32_t receiveTimeoutMs,
+                                         uint32_t sendTimeoutMs);
+void tls_session_disconnect(NetworkContext_t * pNetworkContext);
+
+#endif /* TLS_SESSION_H_ */
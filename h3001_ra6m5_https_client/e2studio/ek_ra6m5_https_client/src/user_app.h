@@ -12,6 +12,8 @@
 #define USER_APP_H_
 
 #include "FreeRTOS_DHCP.h"
+#include "core_http_client.h"
+#include "transport_mbedtls_pkcs11.h"
 
 
 /******************************************************************************
@@ -50,6 +52,21 @@
  **/
 #define HTTPS_PUT_POST_API    "/api/v2/user1995/feeds/temperature/data/"
 
+/** @brief Creates several data points in one POST request, used to drain the sample journal. **/
+#define HTTPS_BATCH_API       HTTPS_PUT_POST_API "batch"
+
+/** @brief Journaled samples that cannot be dated, from a boot that never reached the server, go to this feed
+ *  instead of being stamped with their time of arrival, so that the time line of the temperature feed stays right.
+ *  Create the feed with key {feed_key}-undated next to the temperature feed (Feeds > New Feed, name
+ *  "temperature-undated") and update {username} here as in the other URLs. Only the transport result of a request is
+ *  checked, so samples the server refuses for a missing feed are dropped from the journal all the same.
+ *  API from POST url: /api/v2/{username}/feeds/{feed_key}-undated/data/batch **/
+#define HTTPS_UNDATED_BATCH_API "/api/v2/user1995/feeds/temperature-undated/data/batch"
+
+/** @brief Feed of the periodic device health report (load, heap, stack margins), used with SYS_STATS_FEED. Create
+ *  the feed "device-health" like the undated feed before enabling it. **/
+#define HTTPS_HEALTH_API      "/api/v2/user1995/feeds/device-health/data/"
+
 /** @brief User has to update their generated active key from the io.adafruit.com server. */
 #define ACTIVE_KEY                             "aio_gMnp73O9HoPsBbUaArGYjivhBABq"
 
@@ -58,12 +75,14 @@
 /* TLS port for HTTPS. */
 #define HTTPS_PORT    ( ( uint16_t ) 443U )
 
+/* Accept the server leaf on a pinned SPKI hash after one fully validated handshake (ENABLE/DISABLE) */
+#define HTTPS_CERT_PINNING                      (DISABLE)
 
-/* Number of times to retry the HTTPS connection. A connection is only attempted again if
- * TLS_TRANSPORT_SUCCESS is not returned from TLS_FreeRTOS_Connect(). This indicates an error in the network
- * layer.
+
+/* Wait before the first new connection attempt after the HTTPS connection failed or was lost. The main loop makes one
+ * attempt per pass and doubles the wait after every failed attempt, up to APP_UPLINK_RETRY_MS.
  */
-#define HTTPS_CONNECTION_NUM_RETRY              ( ( uint32_t ) 5 )
+#define HTTPS_CONNECTION_RETRY_MS               ( ( uint32_t ) 3000 )
 
 #define SOCKET_SEND_RECV_TIME_OUT_MS            ( ( uint32_t ) 10000 )
 
@@ -183,6 +202,90 @@
 /* Set up macro for debugging */
 #define DEBUG_HTTPS (0)
 
+/* Print the PEM/PKCS#11 versus cached credential cost and reconnect cost once the network is up, before the first
+ * connect */
+#define CREDENTIAL_CACHE_BENCHMARK  (0)
+
+/* Round trip time (e.g. 100) added to every TLS handshake flight to benchmark handshake latency against a LAN test
+ * server, 0 = off. tools/tls_test_server.py runs that server (TLS 1.3, 1.2 or both) with test certificates and prints
+ * the HTTPS_HOST_ADDRESS, HTTPS_PORT and HTTPS_TRUSTED_ROOT_CA to build with, see the notes "Benchmarking the TLS
+ * Handshake" */
+#define TLS_HANDSHAKE_INJECT_RTT_MS (0)
+
+/* The TLS record buffer profile (TLS_SMALL_RECORDS) is set in app_mbedtls_config.h, which the mbedTLS sources read */
+
+/* After a TLS 1.3 handshake refused at protocol level, this many later sessions offer TLS 1.2 only before 1.3 is
+ * offered again */
+#define TLS_TLS1_2_FALLBACK_SESSIONS (8U)
+
+/* SHA-256 of the provisioned CLIENT_KEY_PEM and CLIENT_CERTIFICATE_PEM, kept next to the PKCS#11 objects */
+#define PROVISION_DIGEST_FILE_NAME  "/prov_sha"
+#define PROVISION_DIGEST_LEN        (32U)
+
+/* Overlap DHCP, LittleFS + provisioning and the sensor bring-up at startup, DISABLE for the original sequential order */
+#define APP_STARTUP_PARALLEL        (ENABLE)
+
+/* Temperature samples held until the HTTPS connection is up */
+#define APP_SAMPLE_QUEUE_LEN        (8U)
+
+/* Background ping check of HTTPS_TEST_PING_IP: USR_PING_COUNT echoes, one every PING_DELAY ticks, stopped at the
+ * deadline. An echo without reply after PING_ECHO_TIMEOUT_MS counts as lost */
+#define PING_DEADLINE_MS            (5000U)
+#define PING_ECHO_TIMEOUT_MS        (1000U)
+
+/* Reuse the last DHCP lease and DNS answer stored in LittleFS on a warm boot, DISABLE to measure without them.
+ * DHCP asks for the cached address while its lease runs, a DNS answer is reused while its TTL runs. Both are timed
+ * in powered time, see net_cache_now_s(). A DNS query without answer after NET_CACHE_DNS_TIMEOUT_MS falls back to
+ * the lookup of the stack */
+#define NET_CACHE_ENABLE            (ENABLE)
+#define NET_CACHE_DNS_TIMEOUT_MS    (2000U)
+
+/* Periodic temperature sample, uploaded directly while the uplink is up and journaled in LittleFS otherwise. Between
+ * samples, reconnect attempts and journal flushes the main loop sleeps until whichever is due first. Reconnect
+ * attempts back off from HTTPS_CONNECTION_RETRY_MS to APP_UPLINK_RETRY_MS */
+#define APP_SAMPLE_PERIOD_MS        (60000U)
+#define APP_UPLINK_RETRY_MS         (30000U)
+
+/* Journaled samples sent per request while draining, the body must fit APP_JOURNAL_BATCH_BODY_LEN */
+#define APP_JOURNAL_BATCH           (8U)
+#define APP_JOURNAL_BATCH_BODY_LEN  (512U)
+
+/* Journaled samples are staged in RAM and written when the block is full, SAMPLE_JOURNAL_FLUSH_MS after the oldest
+ * staged sample or on sample_journal_flush(). A power cut loses the staged samples, at most
+ * SAMPLE_JOURNAL_FLUSH_MS / APP_SAMPLE_PERIOD_MS + 1 of them: 3 at two sample periods, one write per 2 to 3 samples.
+ * DISABLE writes every sample through to compare erases and sampler stall, see the journal test in test/host */
+#define SAMPLE_JOURNAL_WRITE_BACK   (ENABLE)
+#define SAMPLE_JOURNAL_FLUSH_MS     (120000U)
+
+/* Power-cut soak test of the journal: ENABLE resets the MCU at random points between the LittleFS calls of a flush or
+ * an index commit, about once in SAMPLE_JOURNAL_CUT_TEST_ODDS, and checks the journal against its segments at boot */
+#define SAMPLE_JOURNAL_CUT_TEST         (DISABLE)
+#define SAMPLE_JOURNAL_CUT_TEST_ODDS    (8U)
+
+/* LittleFS garbage collection and pre-erasing in an idle priority task, LITTLEFS_MAINT_DELAY_MS after a write took a
+ * block. A pass holds the file system lock for at most LITTLEFS_MAINT_PRE_ERASE_BLOCKS erases. Metadata pairs filled
+ * past LITTLEFS_MAINT_COMPACT_THRESH bytes are compacted in the pass instead of in a writer */
+#define LITTLEFS_MAINT_ENABLE           (ENABLE)
+#define LITTLEFS_MAINT_DELAY_MS         (5000U)
+#define LITTLEFS_MAINT_PRE_ERASE_BLOCKS (4U)
+#define LITTLEFS_MAINT_COMPACT_THRESH   (64U)
+
+/* mbedTLS allocations of a TLS session and the PKCS#11 allocations from fixed block pools, size classes in mem_pool.h.
+ * DISABLE leaves both on the FreeRTOS heap */
+#define MEM_POOL_ENABLE                 (ENABLE)
+
+/* Heap and pool bytes per subsystem (app, TLS, PKCS#11, TCP) from the malloc and free hooks of the kernel, printed by
+ * the "mem" command. HEAP_TRACE_RTT enables the allocation trace on the RTT metrics channel, see heap_trace.h */
+#define HEAP_TRACE_ENABLE               (ENABLE)
+#define HEAP_TRACE_RTT                  (ENABLE)
+
+/* Stack margin and CPU share of every task, sent to the RTT metrics channel every SYS_STATS_PERIOD_MS together with
+ * the counters of the RTT channels, and printed by the "stats" command.
+ * SYS_STATS_FEED also posts each periodic report to HTTPS_HEALTH_API while the uplink is up */
+#define SYS_STATS_PERIOD_MS             (600000U)
+#define SYS_STATS_FEED                  (DISABLE)
+#define SYS_STATS_FEED_BODY_LEN         (384U)
+
 /* ENABLE, DIABLE MACROs */
 #define ENABLE      (1)
 #define DISABLE     (0)
@@ -198,25 +301,6 @@
 		                        "\r\nreadings are sent and shown to server dashboard. User can select through the"\
 		                        "\r\nmenu in RTT viewer to perform either POST or GET  requests.\r\n"
 
-#define PRINT_MENU              "\r\nSelect from the below menu options "\
-                                "\r\n 1. POST Request"\
-                                "\r\n 2. GET Request\r\n"
-
-
-
-typedef struct st_ping_data
-{
-    uint32_t sent;     // Ping Request
-    uint32_t received; // Ping Response
-    uint32_t lost;     // Ping failure
-} ping_data_t;
-
-typedef enum Userinput
-{
-    POST = 1,
-    GET = 2
-}user_input_t;
-
 #if( ipconfigDHCP_REGISTER_HOSTNAME == 1 )
     /* DHCP has an option for clients to register their hostname.  It doesn't
     have much use, except that a device can be found in a router along with its
@@ -17,8 +17,30 @@
 #include "littlefs_app.h"
 #include "core_http_client.h"
 #include "transport_mbedtls_pkcs11.h"
+#include "core_pkcs11_config.h"
+#include "core_pkcs11.h"
+#include "mbedtls/sha256.h"
 #include "user_app.h"
 #include "hs300x_code.h"
+#include "credential_cache.h"
+#include "tls_session.h"
+#include "crypto_bench.h"
+#include "app_startup.h"
+#include "boot_profile.h"
+#include "net_diag.h"
+#include "net_cache.h"
+#include "sample_journal.h"
+#include "littlefs_maint.h"
+#include "littlefs_bench.h"
+#include "console.h"
+#include "app_power.h"
+#include "mem_pool.h"
+#include "heap_trace.h"
+#include "sys_stats.h"
+#include "log_token.h"
+#include "app_log.h"
+#include "rtt_streams.h"
+#include "wall_clock.h"
 
 #define CKR_ACTION_PROHIBITED  0x0000001BUL
 #define CKR_DEVICE_MEMORY  0x00000031UL
@@ -40,14 +62,12 @@ extern TaskHandle_t user_app_thread;
 /******************************************************************************
  Exported global variables
  ******************************************************************************/
-ping_data_t ping_data = { RESET_VALUE, RESET_VALUE, RESET_VALUE };
 IPV4Parameters_t xNd = {RESET_VALUE, RESET_VALUE, RESET_VALUE, {RESET_VALUE, RESET_VALUE}, RESET_VALUE, RESET_VALUE};
 uint32_t dhcp_in_use = RESET_VALUE;
 
 /* Variables to store H3001 readings */
 struct hs3001_raw_data rawData;
 struct sensor_data hs300x_data;
-float temp  = RESET_VALUE;
 
 /* Domain for the DNS Host lookup is used in this Example Project.
  * The project can be built with different *domain_name to validate the DNS client
@@ -78,9 +98,89 @@ char id[SIZE_32] = { RESET_VALUE };
 /* Flag bit for PUT request. if User calls directly without processed GET request */
 bool is_get_called = false;
 bool ID_alive=false;
-struct NetworkContext
+/* Transport parameters of the HTTPS session, must outlive connect_aws_https_client() */
+static TlsTransportParams_t xTlsTransportParams;
+
+/* Temperature samples taken before the HTTPS connection is up */
+static QueueHandle_t g_sample_queue = NULL;
+static StaticQueue_t g_sample_queue_mem;
+static uint8_t g_sample_queue_storage[APP_SAMPLE_QUEUE_LEN * sizeof(sample_codec_sample_t)];
+
+/* Uplink state, samples go to the journal while it is down */
+static bool g_uplink_up = false;
+static TickType_t g_uplink_retry_tick = RESET_VALUE;
+static uint32_t g_uplink_retry_ms = HTTPS_CONNECTION_RETRY_MS;
+static TickType_t g_last_sample_tick = RESET_VALUE;
+static TickType_t g_drain_start_tick = RESET_VALUE;
+static uint32_t g_drained = RESET_VALUE;
+
+/* Set once the session asked the server for the time, see uplink_service() */
+static bool g_clock_requested = false;
+
+/* Sample stream of the RTT samples channel, every measurement goes there and "rtt samples <ms>" adds more */
+static uint32_t g_sensor_reads = RESET_VALUE;
+static uint32_t g_stream_period_ms = RESET_VALUE;
+static TickType_t g_last_stream_tick = RESET_VALUE;
+
+/* What the console commands work on, owned by the user thread */
+typedef struct st_app_command_context
 {
-    TlsTransportParams_t * pParams;
+    NetworkContext_t * p_network_context;
+    TransportInterface_t * p_transport;
+} app_command_context_t;
+
+#if (APP_STARTUP_PARALLEL == ENABLE)
+static void startup_staged(void);
+#else
+static void startup_sequential(void);
+#endif
+static void startup_sensor(void);
+static fsp_err_t sample_sensor(sample_codec_sample_t * p_sample);
+static HTTPStatus_t https_request(TransportInterface_t * p_transport, const char * p_method, const char * p_path,
+                                  const char * p_body, HTTPResponse_t * p_response);
+static HTTPStatus_t post_json(TransportInterface_t * p_transport, const char * p_path, const char * p_body);
+static HTTPStatus_t post_temperature(TransportInterface_t * p_transport, float value);
+static HTTPStatus_t post_journal_batch(TransportInterface_t * p_transport, const sample_codec_sample_t * p_records,
+                                       uint32_t count, uint32_t * p_sent);
+#if (SYS_STATS_FEED == ENABLE)
+static HTTPStatus_t post_health(TransportInterface_t * p_transport, const sys_stats_report_t * p_report);
+#endif
+static bool uplink_sample(NetworkContext_t * p_context, TransportInterface_t * p_transport,
+                          const sample_codec_sample_t * p_sample);
+static void uplink_down(NetworkContext_t * p_context);
+static void uplink_service(NetworkContext_t * p_context, TransportInterface_t * p_transport);
+static TickType_t uplink_next_wait(void);
+static fsp_err_t command_post(uint32_t argc, char * p_argv[], void * p_context);
+static fsp_err_t command_get(uint32_t argc, char * p_argv[], void * p_context);
+static fsp_err_t command_crypto_bench(uint32_t argc, char * p_argv[], void * p_context);
+static fsp_err_t command_boot_timeline(uint32_t argc, char * p_argv[], void * p_context);
+static fsp_err_t command_journal(uint32_t argc, char * p_argv[], void * p_context);
+static fsp_err_t command_littlefs_maint(uint32_t argc, char * p_argv[], void * p_context);
+static fsp_err_t command_storage_bench(uint32_t argc, char * p_argv[], void * p_context);
+static fsp_err_t command_power(uint32_t argc, char * p_argv[], void * p_context);
+static fsp_err_t command_memory(uint32_t argc, char * p_argv[], void * p_context);
+static fsp_err_t command_sys_stats(uint32_t argc, char * p_argv[], void * p_context);
+static fsp_err_t command_log(uint32_t argc, char * p_argv[], void * p_context);
+static fsp_err_t command_rtt(uint32_t argc, char * p_argv[], void * p_context);
+static void provisioning_digest(const ProvisioningParams_t * p_params, uint8_t digest[PROVISION_DIGEST_LEN]);
+static bool provisioning_is_current(const uint8_t digest[PROVISION_DIGEST_LEN]);
+static void provisioning_store_digest(const uint8_t digest[PROVISION_DIGEST_LEN]);
+
+/* Menu commands, a new command only needs an entry here */
+static const console_command_t g_app_commands[] =
+{
+    {"post",    "1", "POST Request",                                            command_post},
+    {"get",     "2", "GET Request",                                             command_get},
+    {"crypto",  "3", "Crypto benchmark",                                        command_crypto_bench},
+    {"boot",    "4", "Boot timeline (current and previous boot)",               command_boot_timeline},
+    {"journal", "5", "Sample journal status, index check and codec benchmark",  command_journal},
+    {"lfs",     "6", "LittleFS maintenance status and append benchmark",        command_littlefs_maint},
+    {"storage", "7", "Storage benchmark (LittleFS on RAM)",                     command_storage_bench},
+    {"power",   "8", "Idle residency and wakeups per hour",                     command_power},
+    {"mem",     "9", "Heap by subsystem and pools, \"mem stress|trace on|off|peak\"", command_memory},
+    {"stats",   "10", "Stack margin and CPU load per task",                     command_sys_stats},
+    {"log",     "11", "Log levels, \"log <module>|all <level>|bench\"",          command_log},
+    {"rtt",     "12", "RTT channels and drops, \"rtt samples <ms>|off\"",          command_rtt},
 };
 
 /*Res and Recv buffers for header of HTTP request*/
@@ -95,287 +195,117 @@ uint8_t reqUserBuffer[USER_BUFF]={RESET_VALUE};
 void user_app_thread_entry(void *pvParameters)
 {
     fsp_err_t err = FSP_SUCCESS;
-    BaseType_t status = pdFALSE;
     HTTPStatus_t httpsClientStatus = HTTPSuccess;
     NetworkContext_t xNetworkContext={RESET_VALUE};
     TransportInterface_t xTransportInterface={RESET_VALUE};
-    unsigned char rByte[BUFFER_SIZE_DOWN] =  { RESET_VALUE };
-    user_input_t user_input = RESET_VALUE;
-
-    /* #HTTPClient_InitializeRequestHeaders. */
-    HTTPRequestInfo_t xRequestInfo={RESET_VALUE};
-    /* Represents a response returned from an HTTP server. */
-    HTTPResponse_t xResponse={RESET_VALUE};
-    /* Represents header data that will be sent in an HTTP request. */
-    HTTPRequestHeaders_t xRequestHeaders={RESET_VALUE};
-
+    app_command_context_t command_context = {&xNetworkContext, &xTransportInterface};
+    char line[CONSOLE_LINE_LEN] = {RESET_VALUE};
+    TickType_t wait = RESET_VALUE;
+    sample_codec_sample_t sample = {RESET_VALUE};
 
     FSP_PARAMETER_NOT_USED(pvParameters);
+    boot_profile_mark ("User thread start");
+    (void) rtt_streams_init ();
+    heap_trace_init ();
 
     /*Print Project info*/
     APP_PRINT(PROJECT_INFO);
 
-    /*Initialize littlefs port*/
-    err = hal_littlefs_init ();
-    if (err != FSP_SUCCESS)
+    err = app_startup_init ();
+    g_sample_queue = xQueueCreateStatic (APP_SAMPLE_QUEUE_LEN, sizeof(sample_codec_sample_t), g_sample_queue_storage,
+                                         &g_sample_queue_mem);
+    if ((FSP_SUCCESS != err) || (NULL == g_sample_queue))
     {
-        APP_PRINT("** Failed in hal_littlefs_init () function ** \r\n");
+        APP_PRINT("** Failed to create the startup event group or sample queue ** \r\n");
         __BKPT(0);
     }
 
-    /*Initialize HS3001 sensor*/
-    err = i2c_masterInit(0x44);
-    if(err != FSP_SUCCESS)
-    {
-        APP_PRINT("** Failed in i2c_master_init () function to init H3001 **\r\n");
-        hal_littlefs_deinit ();
-        __BKPT(0);
-    }
+#if (APP_STARTUP_PARALLEL == ENABLE)
+    startup_staged ();
+#else
+    startup_sequential ();
+#endif
 
-    /*Start Measurement Process-Wake up sensor by sending one byte 0x00*/
-    err = start_measurement();
-    if(err != FSP_SUCCESS)
-    {
-        APP_PRINT("** Failed in start_measurement() function to prepare HS3001 **\r\n");
-        hal_littlefs_deinit ();
-        __BKPT(0);
-    }
+    net_cache_lease_store ();
 
-    /* Initialize the crypto hardware acceleration. */
-    /* Initialize mbedtls. */
-    err = mbedtls_platform_setup (NULL);
-    if (FSP_SUCCESS != err)
+#if CREDENTIAL_CACHE_BENCHMARK
+    /* Reconnects to the server with and without the cache, before the uplink session is opened */
+    credential_cache_benchmark ();
+#endif
+
+    xTransportInterface.pNetworkContext = &xNetworkContext;
+    xTransportInterface.send = TLS_FreeRTOS_send;
+    xTransportInterface.recv = TLS_FreeRTOS_recv;
+
+    /* Initialize HTTPS client with presigned URL */
+    httpsClientStatus = connect_aws_https_client (&xNetworkContext);
+    /* Handle_error */
+    if (HTTPSuccess != httpsClientStatus)
     {
-        APP_PRINT("** Failed in mbedtls_platform_setup() function ** \r\n");
-        hal_littlefs_deinit ();
-        i2_masterDeinit();
-        __BKPT(0);
+        /* Samples are journaled and the connection is retried from the main loop */
+        APP_PRINT("\r\nFailed in server connection establishment");
+        uplink_down (&xNetworkContext);
+        httpsClientStatus = HTTPSuccess;
     }
     else
     {
-        APP_PRINT("\r\nmbedtls_platform setup successful\r\n");
+        g_uplink_up = true;
+        app_startup_done (STARTUP_EVT_CONNECTED);
     }
 
-    /*Connect board to network*/
-    status = getIP(ucIPAddress,ucNetMask,ucGatewayAddress,ucDNSServerAddress,ucMACAddress);
-    if (status != pdTRUE)
+    /* Upload the samples taken while the connection was coming up, oldest first */
+    while (pdTRUE == xQueueReceive (g_sample_queue, &sample, 0))
     {
-        APP_PRINT("Failed to connect to network \r\n");
-        __BKPT(0);
+        if (uplink_sample (&xNetworkContext, &xTransportInterface, &sample))
+        {
+            app_startup_done (STARTUP_EVT_FIRST_POST);
+        }
     }
+    g_last_sample_tick = xTaskGetTickCount ();
+    app_startup_report ();
 
-    /*Perform ping requests*/
-    pingIP((char*)remote_ip_address);
-
-    /*Perform device provisioning using specified TLS client credentials*/
-    status = provision_alt_key ();
-    if (status != pdPASS)
+    /* Startup is done with the file system, housekeeping may use the idle time from now on */
+    if (FSP_SUCCESS != littlefs_maint_start ())
     {
-        APP_PRINT("\r\nFailed in network_init() function\r\n");
-        hal_littlefs_deinit ();
-        mbedtls_platform_teardown (NULL);
-        __BKPT(0);
+        APP_ERR_PRINT("** LittleFS maintenance task not started ** \r\n");
     }
 
-    /* Initialize HTTPS client with presigned URL */
-    httpsClientStatus = connect_aws_https_client (&xNetworkContext);
-    /* Handle_error */
-    if (HTTPSuccess != httpsClientStatus)
-    {
-        APP_PRINT("\r\nFailed in server connection establishment");
-        hal_littlefs_deinit ();
-        mbedtls_platform_teardown (NULL);
-        __BKPT(0);
-    }
-    else
+#if (APP_STARTUP_PARALLEL == ENABLE)
+    /* Diagnostics only, runs in the background after the first POST */
+    pingIP((char*)remote_ip_address);
+#endif
+
+    APP_INFO_PRINT("\r\nClient successfully connected to adfruit.io server \r\n");
+    boot_profile_mark ("Client connected");
+
+    /* From here on every task blocks on an event or a timeout and the idle task sleeps with the tick stopped */
+    app_power_init ();
+
+    /* Commands are read by the console task and run here, the uplink state stays with this thread */
+    if (FSP_SUCCESS != console_start (g_app_commands, sizeof(g_app_commands) / sizeof(g_app_commands[0])))
     {
-        xTransportInterface.pNetworkContext = &xNetworkContext;
-        xTransportInterface.send = TLS_FreeRTOS_send;
-        xTransportInterface.recv = TLS_FreeRTOS_recv;
+        APP_ERR_PRINT("** Console task not started ** \r\n");
     }
 
-    APP_PRINT("\r\nClient successfully connected to adfruit.io server \r\n");
-
     /*Print Menu Options*/
-    APP_PRINT(PRINT_MENU);
+    console_print_help ();
 
     while (true)
     {
-        if (APP_CHECK_DATA)
+        /* A backlog is drained batch after batch, otherwise the loop sleeps until a command or the next due work */
+        wait = uplink_next_wait ();
+        if (console_receive (line, wait))
         {
-            APP_READ(rByte);
-            user_input = (uint8_t) atoi ((char*)rByte);
-            switch (user_input)
-            {
-                case POST:
-                {
-                    APP_PRINT("\r\nPreparing to get measurement from HS3001 \r\n");
-                    //TO DO add the temperature reading
-                    err = start_measurement();
-                    if(err != FSP_SUCCESS)
-                    {
-                        __BKPT(0);
-                    }
-                    /*Wait to stabilize the sensor*/
-                    R_BSP_SoftwareDelay(40,BSP_DELAY_UNITS_MILLISECONDS);
-
-                    /*Read raw data*/
-                    err = get_measurement(&rawData);
-                    if(err != FSP_SUCCESS)
-                    {
-                        __BKPT(0);
-                    }
-
-                    /*Calculate humidity and temperature*/
-                    calculateData (&hs300x_data,&rawData);
-                    temp = convertTemperaturetoFloat();
-
-                    APP_PRINT("\r\nProcessing POST Request\r\n");
-                    /* Initialize all HTTP Client library API structs to 0. */
-                    ( void ) memset( &xRequestInfo, 0, sizeof( xRequestInfo ) );
-                    ( void ) memset( &xResponse, 0, sizeof( xResponse ) );
-                    ( void ) memset( &xRequestHeaders, 0, sizeof( xRequestHeaders ) );
-                    /* Initialize the request object. */
-                    xRequestInfo.pPath = HTTPS_PUT_POST_API;
-                    xRequestInfo.pathLen = strlen (HTTPS_PUT_POST_API);
-                    xRequestInfo.pHost = HTTPS_HOST_ADDRESS;
-                    xRequestInfo.hostLen = strlen (HTTPS_HOST_ADDRESS);
-                    xRequestInfo.pMethod = HTTP_METHOD_POST;
-                    xRequestInfo.methodLen = strlen(HTTP_METHOD_POST);
-
-                    /* Set "Connection" HTTP header to "keep-alive" so that multiple requests
-                     * can be sent over the same established TCP connection. */
-                    xRequestInfo.reqFlags = HTTP_REQUEST_KEEP_ALIVE_FLAG;
-
-                    /* Set the buffer used for storing request headers. */
-                    xRequestHeaders.pBuffer = reqUserBuffer;
-                    xRequestHeaders.bufferLen = sizeof(reqUserBuffer);
-                    memset( xRequestHeaders.pBuffer, 0, xRequestHeaders.bufferLen );
-
-                    httpsClientStatus = HTTPClient_InitializeRequestHeaders( &xRequestHeaders,
-                                                                             &xRequestInfo );
-                    /* Add header */
-                    if( httpsClientStatus == HTTPSuccess )
-                    {
-                        httpsClientStatus = add_header(&xRequestHeaders);
-                    }
-                    else
-                    {
-                        APP_PRINT("Failed to initialize HTTP request headers: Error=%s. \r\n",
-                                  HTTPClient_strerror( httpsClientStatus ) );
-                    }
-                    char upload_str[SIZE_64];
-                    snprintf (upload_str, SIZE_64, "{\"datum\":{\"value\":\"%.02f\"}}", temp); //formating into string to send in JSON format
-                    uint32_t length_upload;
-                    length_upload = strlen ((const char*) upload_str);
-
-                    xResponse.pBuffer = resUserBuffer;
-                    xResponse.bufferLen = sizeof(resUserBuffer);
-                    memset( xResponse.pBuffer, 0, xResponse.bufferLen );
-
-                    if( httpsClientStatus == HTTPSuccess )
-                    {
-                        httpsClientStatus = HTTPClient_Send( &xTransportInterface,
-                                                             &xRequestHeaders,
-                                                             (const uint8_t *)upload_str,
-                                                             length_upload,
-                                                             &xResponse,
-                                                             0 );
-                    }
-
-
-                    if (HTTPSuccess != httpsClientStatus)
-                    {
-                        APP_ERR_PRINT("** Failed in POST Request ** \r\n");
-                    }
-                    else
-                    {
-                        APP_PRINT("Received data using POST Request = %s\n", xResponse.pBody);
-                    }
-                    break;
-                }
-
-                case GET:
-                {
-                    APP_PRINT("\r\nProcessing Get Request\r\n");
-                    /* Initialize all HTTP Client library API structs to 0. */
-                    ( void ) memset( &xRequestInfo, 0, sizeof( xRequestInfo ) );
-                    ( void ) memset( &xResponse, 0, sizeof( xResponse ) );
-                    ( void ) memset( &xRequestHeaders, 0, sizeof( xRequestHeaders ) );
-                    /* Initialize the request object. */
-                    xRequestInfo.pPath = HTTPS_GET_API;
-                    xRequestInfo.pathLen = strlen (HTTPS_GET_API);
-                    xRequestInfo.pHost = HTTPS_HOST_ADDRESS;
-                    xRequestInfo.hostLen = strlen (HTTPS_HOST_ADDRESS);
-                    xRequestInfo.pMethod = HTTP_METHOD_GET;
-                    xRequestInfo.methodLen = strlen(HTTP_METHOD_GET);
-
-                    /* Set "Connection" HTTP header to "keep-alive" so that multiple requests
-                     * can be sent over the same established TCP connection. */
-                    xRequestInfo.reqFlags = HTTP_REQUEST_KEEP_ALIVE_FLAG;
-
-                    /* Set the buffer used for storing request headers. */
-
-                    xRequestHeaders.pBuffer = reqUserBuffer;
-                    xRequestHeaders.bufferLen = sizeof(reqUserBuffer);
-                    memset( xRequestHeaders.pBuffer, 0, xRequestHeaders.bufferLen );
-
-                    httpsClientStatus = HTTPClient_InitializeRequestHeaders( &xRequestHeaders,
-                                                                             &xRequestInfo );
-                    /* Add header */
-                    if( httpsClientStatus == HTTPSuccess )
-                    {
-                        httpsClientStatus = add_header(&xRequestHeaders);
-                    }
-                    else
-                    {
-                        APP_PRINT("Failed to initialize HTTP request headers: Error=%s. \r\n",
-                                  HTTPClient_strerror( httpsClientStatus ) );
-                    }
-
-                    xResponse.pBuffer = resUserBuffer;
-                    xResponse.bufferLen = sizeof(resUserBuffer);
-                    memset( xResponse.pBuffer, 0, xResponse.bufferLen );
-
-                    if( httpsClientStatus == HTTPSuccess )
-                    {
-                        httpsClientStatus = HTTPClient_Send( &xTransportInterface,
-                                                             &xRequestHeaders,
-                                                             NULL,
-                                                             0,
-                                                             &xResponse,
-                                                             0 );
-                    }
-
-                    if(HTTPSuccess != httpsClientStatus)
-                    {
-                        APP_ERR_PRINT("** Failed in GET Request ** \r\n");
-                    }
-                    else
-                    {
-                        APP_PRINT("Received data using GET Request = %s\n", xResponse.pBody);
-                        strncpy (&id[INDEX_ZERO], (char *)&xResponse.pBody[ID_START_INDEX], ID_LEN);
-                        /* Fetch the feed id from the response body which to be update in HTTPS_PUT_POST_API */
-                        /* SynchronousrResponse body starts with the string in the format like [{\"id\":\"0ENQG7RYQA40W17G2A2SFH8E9Q\",\"...\"}]".
-                         *  So, to fetch the ID_KEY other portion of string is avoided*/
-                        is_get_called = true;   //setting the flag to avoid GET call in the PUT request
-                    }
-                    break;
-                }
-                default:
-                    APP_PRINT("Incorrect option. Choose either 1:POST request or 2: GET request \r\n");
-                    break;
-            }
-            if (httpsClientStatus != HTTPSuccess)
-            {
-                mbedtls_platform_teardown (NULL);
-                hal_littlefs_deinit ();
-                APP_ERR_TRAP(httpsClientStatus);
-            }
+            (void) console_execute (line, &command_context);
             /* Repeat the menu to display for user selection */
-            APP_PRINT(PRINT_MENU);
+            console_print_help ();
+        }
+        else if (0U != wait)
+        {
+            /* Woken anyway, let the console look for a debugger attached meanwhile */
+            console_notify ();
         }
-        vTaskDelay (100);
+        uplink_service (&xNetworkContext, &xTransportInterface);
     }
 
 }
@@ -394,6 +324,7 @@ BaseType_t getIP(const uint8_t IPAddress[NETWORK_SETTINGS_LENGTH_BYTES],
     BaseType_t bt_status = pdFALSE;
     uint32_t ip_status = 0U;
 
+    boot_profile_mark ("getIP start");
     status = FreeRTOS_IPInit (IPAddress, NetMask, GatewayAddress, DNSServerAddress, MACAddress);
     if (pdFALSE == status)
     {
@@ -403,7 +334,7 @@ BaseType_t getIP(const uint8_t IPAddress[NETWORK_SETTINGS_LENGTH_BYTES],
         return status;
     }
 
-    APP_PRINT("\r\nWaiting for network link up... \r\n");
+    APP_INFO_PRINT("\r\nWaiting for network link up... \r\n");
     bt_status = xTaskNotifyWait(pdFALSE, pdFALSE, &ip_status, portMAX_DELAY);
     if (pdTRUE != bt_status)
     {
@@ -412,7 +343,8 @@ BaseType_t getIP(const uint8_t IPAddress[NETWORK_SETTINGS_LENGTH_BYTES],
         mbedtls_platform_teardown (NULL);
         return bt_status;
     }
-    APP_PRINT("\r\nObtained successfully IP and connected to network... \r\n");
+    APP_INFO_PRINT("\r\nObtained successfully IP and connected to network... \r\n");
+    boot_profile_mark ("getIP link up");
     print_ipconfig();
     return status;
 }
@@ -467,6 +399,7 @@ void print_ipconfig(void)
 eDHCPCallbackAnswer_t xApplicationDHCPHook(eDHCPCallbackPhase_t eDHCPPhase, uint32_t lulIPAddress)
 {
     eDHCPCallbackAnswer_t eReturn = eDHCPContinue;
+    NetworkEndPoint_t * p_end_point = NULL;
     /*
      * This hook is called in a couple of places during the DHCP process, as identified by the eDHCPPhase parameter.
      */
@@ -480,6 +413,12 @@ eDHCPCallbackAnswer_t xApplicationDHCPHook(eDHCPCallbackPhase_t eDHCPPhase, uint
              *  If eDHCPStopNoChanges had been returned instead then the DHCP process would be stopped and whatever the
              *  current network configuration was would continue to be used.
              */
+            p_end_point = FreeRTOS_FirstEndPoint (NULL);
+            if (NULL != p_end_point)
+            {
+                /* Warm boot, the DISCOVER asks for the address of the lease stored in LittleFS (option 50) */
+                p_end_point->xDHCPData.ulPreferredIPAddress = net_cache_lease_request ();
+            }
             break;
 
         case eDHCPPhasePreRequest:
@@ -533,31 +472,16 @@ const char* pcApplicationHostnameHook(void)
 }
 #endif
 
-/*Function to perform ping requests*/
+/*Function to start the ping requests, the check runs in the background and prints its own result*/
 void pingIP(const char *ip_address)
 {
-    uint32_t usrPingCount = 0U;
-    BaseType_t status =pdFALSE;
-    while (usrPingCount < USR_PING_COUNT)
+    fsp_err_t err = net_diag_ping_start (ip_address, USR_PING_COUNT, PING_DEADLINE_MS);
+    if (FSP_SUCCESS != err)
     {
-        status = vSendPing (ip_address);
-        if (pdFAIL != status)
-        {
-            ping_data.sent++;
-        }
-        else
-        {
-            ping_data.lost++;
-        }
-        usrPingCount++;
-        /* Add some delay between pings */
-        vTaskDelay (PING_DELAY);
+        APP_PRINT("\r\nPing check not started, error 0x%x\r\n", err);
     }
-    print_pingResult();
 }
 
-
-
 BaseType_t vSendPing(const char *pcIPAddress)
 {
     uint32_t ulIPAddress = RESET_VALUE;
@@ -579,8 +503,7 @@ BaseType_t vSendPing(const char *pcIPAddress)
 /*Print the ping results*/
 void print_pingResult(void)
 {
-    APP_PRINT("\r\nPing Statistics for %s :\r\n", (char* )remote_ip_address);
-    APP_PRINT("\r\nPackets: Sent  = %02d, Received = %02d, Lost = %02d \r\n", ping_data.sent, ping_data.received, ping_data.lost);
+    net_diag_ping_print ();
 }
 
 /*******************************************************************************************************************//**
@@ -591,20 +514,8 @@ void print_pingResult(void)
  **********************************************************************************************************************/
 void vApplicationPingReplyHook(ePingReplyStatus_t eStatus, uint16_t usIdentifier)
 {
-    (void) usIdentifier;
-
-    switch (eStatus)
-    {
-        /* A valid ping reply has been received */
-        case eSuccess:
-            ping_data.received++;
-            break;
-            /* A reply was received but it was not valid. */
-        case eInvalidData:
-        default:
-            ping_data.lost++;
-            break;
-    }
+    /* Match the reply to its request and record the round trip time */
+    net_diag_ping_reply (eStatus, usIdentifier);
 }
 
 /*******************************************************************************************************************//**
@@ -645,12 +556,16 @@ void vApplicationIPNetworkEventHook (eIPCallbackEvent_t eNetworkEvent)
 }
 #endif
 
-/* provision_alt_key function provides the device with client certificate and client key*/
+/* provision_alt_key function provides the device with client certificate and client key.
+ * The PKCS#11 objects are only rewritten when the compiled-in credentials differ from the provisioned ones */
 BaseType_t provision_alt_key(void)
 {
     BaseType_t status = pdPASS;
     ProvisioningParams_t params = {RESET_VALUE};
     CK_RV xResult = CKR_OK;
+    uint8_t digest[PROVISION_DIGEST_LEN] = {RESET_VALUE};
+    TickType_t start_tick = xTaskGetTickCount ();
+    uint32_t erase_count = hal_littlefs_erase_count ();
     /* Provision the device. */
     params.pucClientPrivateKey       = (uint8_t *) CLIENT_KEY_PEM;
     params.pucClientCertificate      = (uint8_t *) CLIENT_CERTIFICATE_PEM;
@@ -659,6 +574,14 @@ BaseType_t provision_alt_key(void)
     params.pucJITPCertificate        = NULL;
     params.ulJITPCertificateLength   = RESET_VALUE;
 
+    boot_profile_mark ("Provision start");
+    provisioning_digest (&params, digest);
+    if (provisioning_is_current (digest))
+    {
+        APP_INFO_PRINT("\r\nClient certificate and client key already provisioned, %d ms\r\n",
+                       (xTaskGetTickCount () - start_tick) * portTICK_PERIOD_MS);
+        return status;
+    }
 
     xResult = vAlternateKeyProvisioning(&params);
     if (CKR_OK != xResult)
@@ -666,54 +589,115 @@ BaseType_t provision_alt_key(void)
         APP_ERR_PRINT("\r\nFailed in vAlternateKeyProvisioning() function ");
         return (BaseType_t) xResult;
     }
+    provisioning_store_digest (digest);
 
-    APP_PRINT("\r\nSuccessfully provisioned the device with client certificate and client key ");
+    APP_INFO_PRINT("\r\nSuccessfully provisioned the device with client certificate and client key ");
+    APP_INFO_PRINT("\r\nProvisioning took %d ms, %d flash block erases\r\n",
+                   (xTaskGetTickCount () - start_tick) * portTICK_PERIOD_MS, hal_littlefs_erase_count () - erase_count);
     return status;
 }
 
-/*Connects to the server with all required connection configuration settings*/
+/*******************************************************************************************************************//**
+ * @brief      SHA-256 over the client key and certificate lengths and contents, identifies what was provisioned.
+ **********************************************************************************************************************/
+static void provisioning_digest(const ProvisioningParams_t * p_params, uint8_t digest[PROVISION_DIGEST_LEN])
+{
+    mbedtls_sha256_context sha;
+
+    mbedtls_sha256_init (&sha);
+    (void) mbedtls_sha256_starts (&sha, 0);
+    (void) mbedtls_sha256_update (&sha, (const unsigned char *) &p_params->ulClientPrivateKeyLength,
+                                  sizeof(p_params->ulClientPrivateKeyLength));
+    (void) mbedtls_sha256_update (&sha, p_params->pucClientPrivateKey, p_params->ulClientPrivateKeyLength);
+    (void) mbedtls_sha256_update (&sha, (const unsigned char *) &p_params->ulClientCertificateLength,
+                                  sizeof(p_params->ulClientCertificateLength));
+    (void) mbedtls_sha256_update (&sha, p_params->pucClientCertificate, p_params->ulClientCertificateLength);
+    (void) mbedtls_sha256_finish (&sha, digest);
+    mbedtls_sha256_free (&sha);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      True when the stored digest matches and both PKCS#11 objects are present in the store.
+ **********************************************************************************************************************/
+static bool provisioning_is_current(const uint8_t digest[PROVISION_DIGEST_LEN])
+{
+    uint8_t stored[PROVISION_DIGEST_LEN] = {RESET_VALUE};
+    lfs_file_t file;
+    lfs_ssize_t len = RESET_VALUE;
+    CK_FUNCTION_LIST_PTR p_function_list = NULL;
+    CK_SESSION_HANDLE session = CK_INVALID_HANDLE;
+    CK_OBJECT_HANDLE key = CK_INVALID_HANDLE;
+    CK_OBJECT_HANDLE cert = CK_INVALID_HANDLE;
+    CK_RV xResult = CKR_OK;
+
+    if (LFS_ERR_OK != lfs_file_open (&g_rm_littlefs0_lfs, &file, PROVISION_DIGEST_FILE_NAME, LFS_O_RDONLY))
+    {
+        return false;
+    }
+    len = lfs_file_read (&g_rm_littlefs0_lfs, &file, stored, sizeof(stored));
+    (void) lfs_file_close (&g_rm_littlefs0_lfs, &file);
+    if (((lfs_ssize_t) sizeof(stored) != len) || (0 != memcmp (stored, digest, sizeof(stored))))
+    {
+        return false;
+    }
+
+    /* The digest alone does not prove the objects survived, look them up */
+    xResult = C_GetFunctionList (&p_function_list);
+    if (CKR_OK == xResult)
+    {
+        xResult = xInitializePkcs11Session (&session);
+    }
+    if (CKR_OK == xResult)
+    {
+        xResult = xFindObjectWithLabelAndClass (session, pkcs11configLABEL_DEVICE_PRIVATE_KEY_FOR_TLS,
+                                                sizeof(pkcs11configLABEL_DEVICE_PRIVATE_KEY_FOR_TLS) - 1U,
+                                                CKO_PRIVATE_KEY, &key);
+    }
+    if (CKR_OK == xResult)
+    {
+        xResult = xFindObjectWithLabelAndClass (session, pkcs11configLABEL_DEVICE_CERTIFICATE_FOR_TLS,
+                                                sizeof(pkcs11configLABEL_DEVICE_CERTIFICATE_FOR_TLS) - 1U,
+                                                CKO_CERTIFICATE, &cert);
+    }
+    if ((NULL != p_function_list) && (CK_INVALID_HANDLE != session))
+    {
+        (void) p_function_list->C_CloseSession (session);
+    }
+
+    return (CKR_OK == xResult) && (CK_INVALID_HANDLE != key) && (CK_INVALID_HANDLE != cert);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Records the digest of the credentials just provisioned. A failed write only costs a rewrite next boot.
+ **********************************************************************************************************************/
+static void provisioning_store_digest(const uint8_t digest[PROVISION_DIGEST_LEN])
+{
+    lfs_file_t file;
+
+    if (LFS_ERR_OK != lfs_file_open (&g_rm_littlefs0_lfs, &file, PROVISION_DIGEST_FILE_NAME,
+                                     LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC))
+    {
+        return;
+    }
+    (void) lfs_file_write (&g_rm_littlefs0_lfs, &file, digest, PROVISION_DIGEST_LEN);
+    (void) lfs_file_close (&g_rm_littlefs0_lfs, &file);
+}
+
+/*Connects to the server with all required connection configuration settings. One attempt, the caller retries*/
 HTTPStatus_t connect_aws_https_client(NetworkContext_t *NetworkContext)
 {
     HTTPStatus_t httpsClientStatus = HTTPSuccess;
     TlsTransportStatus_t TCP_connect_status = TLS_TRANSPORT_SUCCESS;
-    /* The current attempt in the number of connection tries. */
-    uint32_t connAttempt = RESET_VALUE;
-    NetworkCredentials_t connConfig = { RESET_VALUE };
-    TlsTransportParams_t xPlaintextTransportParams={ RESET_VALUE };
     assert( NetworkContext != NULL );
 
-    ( void ) memset( &connConfig, 0U, sizeof( NetworkCredentials_t ) );
     ( void ) memset( NetworkContext, 0U, sizeof( NetworkContext_t ) );
-    NetworkContext->pParams=&xPlaintextTransportParams;
-
-    /* Set the connection configurations. */
-    connConfig.disableSni = pdFALSE;
-    connConfig.pRootCa = (const unsigned char *) HTTPS_TRUSTED_ROOT_CA;
-    connConfig.rootCaSize = sizeof(HTTPS_TRUSTED_ROOT_CA);
-    connConfig.pUserName = NULL;
-    connConfig.userNameSize = 0;
-    connConfig.pPassword = NULL;
-    connConfig.passwordSize = 0;
-    connConfig.pClientCertLabel = pkcs11configLABEL_DEVICE_CERTIFICATE_FOR_TLS;
-    connConfig.pPrivateKeyLabel = pkcs11configLABEL_DEVICE_PRIVATE_KEY_FOR_TLS;
-    connConfig.pAlpnProtos=NULL;
-
-    /* Connect to server. */
-    for (connAttempt = 1; connAttempt <= HTTPS_CONNECTION_NUM_RETRY; connAttempt++)
-    {
-        TCP_connect_status = TLS_FreeRTOS_Connect (NetworkContext,HTTPS_HOST_ADDRESS,HTTPS_PORT,&connConfig,SOCKET_SEND_RECV_TIME_OUT_MS,SOCKET_SEND_RECV_TIME_OUT_MS);
-
-        if ((TCP_connect_status != TLS_TRANSPORT_SUCCESS) && (connAttempt < HTTPS_CONNECTION_NUM_RETRY))
-        {
-            APP_ERR_PRINT("Failed to connect the server, retrying after 3000 ms.\r\n");
-            vTaskDelay(3000);
-            continue;
-        }
-        else
-        {
-            break;
-        }
-    }
+    ( void ) memset( &xTlsTransportParams, 0U, sizeof( TlsTransportParams_t ) );
+    NetworkContext->pParams=&xTlsTransportParams;
+    boot_profile_mark ("Connect start");
+
+    /* Connect to server. Root CA, client certificate and private key are taken from the credential cache. */
+    TCP_connect_status = tls_session_connect (NetworkContext, HTTPS_HOST_ADDRESS, HTTPS_PORT,
+                                              SOCKET_SEND_RECV_TIME_OUT_MS, SOCKET_SEND_RECV_TIME_OUT_MS);
     if ( TLS_TRANSPORT_SUCCESS != TCP_connect_status )
     {
         APP_PRINT("Unable to connect the server. Error code: %d.\r\n", TCP_connect_status);
@@ -721,7 +705,8 @@ HTTPStatus_t connect_aws_https_client(NetworkContext_t *NetworkContext)
         return httpsClientStatus;
     }
 
-    APP_PRINT("\r\nConnected to the server\r\n");
+    APP_INFO_PRINT("\r\nConnected to the server\r\n");
+    boot_profile_mark ("Connect done");
     return httpsClientStatus;
 }
 
@@ -755,6 +740,842 @@ HTTPStatus_t add_header (HTTPRequestHeaders_t * pRequestHeaders)
     return Status;
 }
 
+#if (APP_STARTUP_PARALLEL == ENABLE)
+/*******************************************************************************************************************//**
+ * @brief      Staged startup. The crypto engine comes first because the TCP/IP stack and the provisioning both use it,
+ *             then DHCP (IP task), LittleFS + provisioning + credential cache (startup task) and the sensor (this
+ *             thread) run side by side. Returns once the network is up and the credentials are ready.
+ **********************************************************************************************************************/
+static void startup_staged(void)
+{
+    fsp_err_t err = FSP_SUCCESS;
+    EventBits_t bits = RESET_VALUE;
+
+    /* Initialize the crypto hardware acceleration. */
+    /* Initialize mbedtls. */
+    err = mbedtls_platform_setup (NULL);
+    if (FSP_SUCCESS != err)
+    {
+        APP_PRINT("** Failed in mbedtls_platform_setup() function ** \r\n");
+        __BKPT(0);
+    }
+    APP_INFO_PRINT("\r\nmbedtls_platform setup successful\r\n");
+    (void) mem_pool_init ();
+    app_startup_done (STARTUP_EVT_CRYPTO_READY);
+
+    /* DHCP proceeds in the IP task from here */
+    if (pdFALSE == FreeRTOS_IPInit (ucIPAddress, ucNetMask, ucGatewayAddress, ucDNSServerAddress, ucMACAddress))
+    {
+        APP_PRINT("FreeRTOS_IPInit failed \r\n");
+        mbedtls_platform_teardown (NULL);
+        __BKPT(0);
+    }
+
+    err = app_startup_storage_start ();
+    if (FSP_SUCCESS != err)
+    {
+        APP_PRINT("** Failed to start the startup task ** \r\n");
+        mbedtls_platform_teardown (NULL);
+        __BKPT(0);
+    }
+
+    startup_sensor ();
+
+    APP_INFO_PRINT("\r\nWaiting for network link up... \r\n");
+    if (pdTRUE != xTaskNotifyWait (pdFALSE, pdFALSE, NULL, portMAX_DELAY))
+    {
+        APP_ERR_PRINT("xTaskNotifyWait Failed \r\n");
+        __BKPT(0);
+    }
+    APP_INFO_PRINT("\r\nObtained successfully IP and connected to network... \r\n");
+    print_ipconfig ();
+    app_startup_done (STARTUP_EVT_NETWORK_UP);
+
+    bits = app_startup_wait (STARTUP_EVT_CREDENTIALS_READY);
+    if (0U != (bits & STARTUP_EVT_FAILED))
+    {
+        hal_littlefs_deinit ();
+        mbedtls_platform_teardown (NULL);
+        __BKPT(0);
+    }
+}
+#else
+/*******************************************************************************************************************//**
+ * @brief      Original strictly sequential startup, kept to compare the time to the first POST.
+ **********************************************************************************************************************/
+static void startup_sequential(void)
+{
+    fsp_err_t err = FSP_SUCCESS;
+    BaseType_t status = pdFALSE;
+
+    /*Initialize littlefs port*/
+    err = app_startup_storage_mount ();
+    if (err != FSP_SUCCESS)
+    {
+        __BKPT(0);
+    }
+
+    startup_sensor ();
+
+    /* Initialize the crypto hardware acceleration. */
+    /* Initialize mbedtls. */
+    err = mbedtls_platform_setup (NULL);
+    if (FSP_SUCCESS != err)
+    {
+        APP_PRINT("** Failed in mbedtls_platform_setup() function ** \r\n");
+        hal_littlefs_deinit ();
+        i2_masterDeinit();
+        __BKPT(0);
+    }
+    else
+    {
+        APP_INFO_PRINT("\r\nmbedtls_platform setup successful\r\n");
+    }
+    (void) mem_pool_init ();
+    app_startup_done (STARTUP_EVT_CRYPTO_READY);
+
+    /*Connect board to network*/
+    status = getIP(ucIPAddress,ucNetMask,ucGatewayAddress,ucDNSServerAddress,ucMACAddress);
+    if (status != pdTRUE)
+    {
+        APP_PRINT("Failed to connect to network \r\n");
+        __BKPT(0);
+    }
+    app_startup_done (STARTUP_EVT_NETWORK_UP);
+
+    /*Start the ping requests, they run in the background*/
+    pingIP((char*)remote_ip_address);
+
+    err = app_startup_credentials_load ();
+    if (FSP_SUCCESS != err)
+    {
+        hal_littlefs_deinit ();
+        mbedtls_platform_teardown (NULL);
+        __BKPT(0);
+    }
+}
+#endif
+
+/*******************************************************************************************************************//**
+ * @brief      Brings up the HS3001 and queues the first temperature sample for upload once connected.
+ **********************************************************************************************************************/
+static void startup_sensor(void)
+{
+    fsp_err_t err = FSP_SUCCESS;
+    sample_codec_sample_t first_sample = {RESET_VALUE};
+
+    /*Initialize HS3001 sensor*/
+    err = i2c_masterInit(0x44);
+    if(err != FSP_SUCCESS)
+    {
+        APP_PRINT("** Failed in i2c_master_init () function to init H3001 **\r\n");
+        __BKPT(0);
+    }
+
+    /*Start Measurement Process-Wake up sensor by sending one byte 0x00*/
+    err = sample_sensor (&first_sample);
+    if(err != FSP_SUCCESS)
+    {
+        APP_PRINT("** Failed to take the first HS3001 measurement **\r\n");
+        i2_masterDeinit();
+        __BKPT(0);
+    }
+    (void) xQueueSend (g_sample_queue, &first_sample, 0);
+    app_startup_done (STARTUP_EVT_SENSOR_READY);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Takes one HS3001 measurement and converts temperature and humidity. The measurement also goes to the RTT
+ *             samples channel.
+ * @param[out] p_sample                     Sampling time, temperature and humidity in 0.01 units.
+ * @retval     FSP_SUCCESS                  Upon successful measurement.
+ * @retval     Any other Error Code         Upon I2C failure.
+ **********************************************************************************************************************/
+static fsp_err_t sample_sensor(sample_codec_sample_t * p_sample)
+{
+    rtt_stream_sample_t stream_sample;
+    fsp_err_t err = start_measurement();
+    if(err != FSP_SUCCESS)
+    {
+        return err;
+    }
+    /*Wait to stabilize the sensor, sleeping rather than spinning so the idle task can stop the tick*/
+    vTaskDelay (pdMS_TO_TICKS(HS3001_MEASUREMENT_MS));
+
+    /*Read raw data*/
+    err = get_measurement(&rawData);
+    if(err != FSP_SUCCESS)
+    {
+        return err;
+    }
+
+    /*Calculate humidity and temperature*/
+    calculateData (&hs300x_data,&rawData);
+    p_sample->time_ms   = xTaskGetTickCount () * portTICK_PERIOD_MS;
+    p_sample->temp_cdeg = (int16_t) ((hs300x_data.temperature_data.integer_part * 100) +
+                                     hs300x_data.temperature_data.decimal_part);
+    p_sample->rh_cprh   = (uint16_t) ((hs300x_data.humidity_data.integer_part * 100) +
+                                      hs300x_data.humidity_data.decimal_part);
+
+    stream_sample.time_ms         = p_sample->time_ms;
+    stream_sample.count           = ++g_sensor_reads;
+    stream_sample.raw_humidity    = (uint16_t) ((rawData.humidity[0] << 8) | rawData.humidity[1]);
+    stream_sample.raw_temperature = (uint16_t) ((rawData.temperature[0] << 8) | rawData.temperature[1]);
+    stream_sample.temp_cdeg       = p_sample->temp_cdeg;
+    stream_sample.rh_cprh         = p_sample->rh_cprh;
+    (void) rtt_stream_write (RTT_STREAM_SAMPLES, &stream_sample, sizeof(stream_sample));
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Sends a request with an optional JSON body. The Date header of the response sets the wall clock
+ *             reference of the samples.
+ * @param[in]  p_transport                  Transport interface of the open session.
+ * @param[in]  p_method                     HTTP_METHOD_POST or HTTP_METHOD_GET.
+ * @param[in]  p_path                       Request path.
+ * @param[in]  p_body                       JSON body, NULL for none.
+ * @param[out] p_response                   Response, its body in resUserBuffer until the next request. NULL if the
+ *                                          caller only needs the status.
+ * @retval     HTTPSuccess                  Upon successful request.
+ * @retval     Any other Error Code         Upon unsuccessful request.
+ **********************************************************************************************************************/
+static HTTPStatus_t https_request(TransportInterface_t * p_transport, const char * p_method, const char * p_path,
+                                  const char * p_body, HTTPResponse_t * p_response)
+{
+    HTTPStatus_t httpsClientStatus = HTTPSuccess;
+    HTTPRequestInfo_t xRequestInfo = {RESET_VALUE};
+    HTTPResponse_t xResponse = {RESET_VALUE};
+    HTTPRequestHeaders_t xRequestHeaders = {RESET_VALUE};
+    const char * p_date = NULL;
+    size_t date_len = RESET_VALUE;
+
+    APP_INFO_PRINT("\r\nProcessing %s Request\r\n", p_method);
+    /* Initialize the request object. */
+    xRequestInfo.pPath = p_path;
+    xRequestInfo.pathLen = strlen (p_path);
+    xRequestInfo.pHost = HTTPS_HOST_ADDRESS;
+    xRequestInfo.hostLen = strlen (HTTPS_HOST_ADDRESS);
+    xRequestInfo.pMethod = p_method;
+    xRequestInfo.methodLen = strlen (p_method);
+
+    /* Set "Connection" HTTP header to "keep-alive" so that multiple requests
+     * can be sent over the same established TCP connection. */
+    xRequestInfo.reqFlags = HTTP_REQUEST_KEEP_ALIVE_FLAG;
+
+    /* Set the buffer used for storing request headers. */
+    xRequestHeaders.pBuffer = reqUserBuffer;
+    xRequestHeaders.bufferLen = sizeof(reqUserBuffer);
+    memset( xRequestHeaders.pBuffer, 0, xRequestHeaders.bufferLen );
+
+    httpsClientStatus = HTTPClient_InitializeRequestHeaders( &xRequestHeaders,
+                                                             &xRequestInfo );
+    /* Add header */
+    if( httpsClientStatus == HTTPSuccess )
+    {
+        httpsClientStatus = add_header(&xRequestHeaders);
+    }
+    else
+    {
+        APP_PRINT("Failed to initialize HTTP request headers: Error=%s. \r\n",
+                  HTTPClient_strerror( httpsClientStatus ) );
+    }
+
+    xResponse.pBuffer = resUserBuffer;
+    xResponse.bufferLen = sizeof(resUserBuffer);
+    memset( xResponse.pBuffer, 0, xResponse.bufferLen );
+
+    if( httpsClientStatus == HTTPSuccess )
+    {
+        httpsClientStatus = HTTPClient_Send( p_transport,
+                                             &xRequestHeaders,
+                                             (const uint8_t *)p_body,
+                                             (NULL == p_body) ? 0U : strlen (p_body),
+                                             &xResponse,
+                                             0 );
+    }
+
+    if (HTTPSuccess != httpsClientStatus)
+    {
+        APP_ERR_PRINT("** Failed in %s Request ** \r\n", p_method);
+        return httpsClientStatus;
+    }
+
+    APP_DBG_PRINT("Received data using %s Request = %s\n", p_method, xResponse.pBody);
+    if (HTTPSuccess == HTTPClient_ReadHeader (&xResponse, "Date", strlen ("Date"), &p_date, &date_len))
+    {
+        wall_clock_set_http_date (p_date, date_len);
+    }
+    if (NULL != p_response)
+    {
+        *p_response = xResponse;
+    }
+    return httpsClientStatus;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Sends a JSON body with a POST request.
+ * @param[in]  p_transport                  Transport interface of the open session.
+ * @param[in]  p_path                       Request path.
+ * @param[in]  p_body                       JSON body.
+ * @retval     HTTPSuccess                  Upon successful request.
+ * @retval     Any other Error Code         Upon unsuccessful request.
+ **********************************************************************************************************************/
+static HTTPStatus_t post_json(TransportInterface_t * p_transport, const char * p_path, const char * p_body)
+{
+    heap_trace_stats_t heap;
+    HTTPStatus_t httpsClientStatus = https_request (p_transport, HTTP_METHOD_POST, p_path, p_body, NULL);
+
+    if (HTTPSuccess == httpsClientStatus)
+    {
+        /* The cycle started at tls_session_connect() or at the previous report: connect, handshake and this
+         * request, or this request alone on an open session. One figure per record buffer profile */
+        heap_trace_get_total (&heap);
+        APP_INFO_PRINT("\r\nPOST cycle peak heap (TLS records IN %d / OUT %d): %d bytes in use, %d held at peak by "
+                       "heap and pools\r\n", MBEDTLS_SSL_IN_CONTENT_LEN, MBEDTLS_SSL_OUT_CONTENT_LEN,
+                       configTOTAL_HEAP_SIZE - heap_trace_heap_low (), heap.peak);
+        heap_trace_reset_peaks ();
+    }
+    return httpsClientStatus;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Sends one temperature value to HTTPS_PUT_POST_API.
+ * @param[in]  p_transport                  Transport interface of the open session.
+ * @param[in]  value                        Temperature to upload.
+ * @retval     HTTPSuccess                  Upon successful request.
+ * @retval     Any other Error Code         Upon unsuccessful request.
+ **********************************************************************************************************************/
+static HTTPStatus_t post_temperature(TransportInterface_t * p_transport, float value)
+{
+    char upload_str[SIZE_64];
+
+    snprintf (upload_str, SIZE_64, "{\"datum\":{\"value\":\"%.02f\"}}", value); //formating into string to send in JSON format
+    return post_json (p_transport, HTTPS_PUT_POST_API, upload_str);
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Sends journaled samples, oldest first, in one request. Samples dated by wall_clock_epoch() carry their
+ *             sampling time as created_at and go to HTTPS_BATCH_API. Samples without a date, from an earlier boot
+ *             that never got the time, go to HTTPS_UNDATED_BATCH_API so that the server does not stamp them with the
+ *             time of arrival. One request takes the leading run of either kind.
+ * @param[in]  p_transport                  Transport interface of the open session.
+ * @param[in]  p_records                    Samples to upload.
+ * @param[in]  count                        Number of samples, at most APP_JOURNAL_BATCH.
+ * @param[out] p_sent                       Samples sent, the leading run of dated or undated samples.
+ * @retval     HTTPSuccess                  Upon successful request.
+ * @retval     Any other Error Code         Upon unsuccessful request.
+ **********************************************************************************************************************/
+static HTTPStatus_t post_journal_batch(TransportInterface_t * p_transport, const sample_codec_sample_t * p_records,
+                                       uint32_t count, uint32_t * p_sent)
+{
+    char body[APP_JOURNAL_BATCH_BODY_LEN];
+    char created_at[WALL_CLOCK_ISO_LEN];
+    uint32_t epoch_s = RESET_VALUE;
+    bool dated = wall_clock_epoch (p_records[0].boot, p_records[0].time_ms, &epoch_s);
+    uint32_t i = RESET_VALUE;
+    int len = snprintf (body, sizeof(body), "{\"data\":[");
+
+    for (i = 0; (i < count) && (len > 0) && ((size_t) len < sizeof(body)); i++)
+    {
+        if (dated != wall_clock_epoch (p_records[i].boot, p_records[i].time_ms, &epoch_s))
+        {
+            break;
+        }
+        len += snprintf (&body[len], sizeof(body) - (size_t) len, "%s{\"value\":\"%.02f\"", (0U == i) ? "" : ",",
+                         p_records[i].temp_cdeg / 100.0f);
+        if (dated && (len > 0) && ((size_t) len < sizeof(body)))
+        {
+            wall_clock_format_iso (epoch_s, created_at);
+            len += snprintf (&body[len], sizeof(body) - (size_t) len, ",\"created_at\":\"%s\"", created_at);
+        }
+        if ((len > 0) && ((size_t) len < sizeof(body)))
+        {
+            len += snprintf (&body[len], sizeof(body) - (size_t) len, "}");
+        }
+    }
+    if ((len > 0) && ((size_t) len < sizeof(body)))
+    {
+        len += snprintf (&body[len], sizeof(body) - (size_t) len, "]}");
+    }
+    if ((len <= 0) || ((size_t) len >= sizeof(body)))
+    {
+        APP_ERR_PRINT("** Journal batch does not fit into %d bytes ** \r\n", APP_JOURNAL_BATCH_BODY_LEN);
+        return HTTPInsufficientMemory;
+    }
+    if (!dated)
+    {
+        APP_WARN_PRINT("\r\n%d journaled samples have no date, sent to the undated feed\r\n", i);
+    }
+    *p_sent = i;
+    return post_json (p_transport, dated ? HTTPS_BATCH_API : HTTPS_UNDATED_BATCH_API, body);
+}
+
+#if (SYS_STATS_FEED == ENABLE)
+/*******************************************************************************************************************//**
+ * @brief      Sends a task report as one data point to HTTPS_HEALTH_API.
+ * @param[in]  p_transport                  Transport interface of the open session.
+ * @param[in]  p_report                     Report of sys_stats_sample().
+ * @retval     HTTPSuccess                  Upon successful request.
+ * @retval     Any other Error Code         Upon unsuccessful request.
+ **********************************************************************************************************************/
+static HTTPStatus_t post_health(TransportInterface_t * p_transport, const sys_stats_report_t * p_report)
+{
+    char body[SYS_STATS_FEED_BODY_LEN];
+    int len = sys_stats_format_feed (p_report, body, sizeof(body));
+
+    if ((len <= 0) || ((size_t) len >= sizeof(body)))
+    {
+        APP_ERR_PRINT("** Health report does not fit into %d bytes ** \r\n", SYS_STATS_FEED_BODY_LEN);
+        return HTTPInsufficientMemory;
+    }
+    return post_json (p_transport, HTTPS_HEALTH_API, body);
+}
+#endif
+
+/*******************************************************************************************************************//**
+ * @brief      Uploads a sample while the uplink is up and nothing older is waiting, journals it otherwise.
+ * @param[in]  p_context                    Network context of the session.
+ * @param[in]  p_transport                  Transport interface of the session.
+ * @param[in]  p_sample                     Measurement to upload.
+ * @retval     true                         Sample accepted by the server.
+ * @retval     false                        Sample journaled.
+ **********************************************************************************************************************/
+static bool uplink_sample(NetworkContext_t * p_context, TransportInterface_t * p_transport,
+                          const sample_codec_sample_t * p_sample)
+{
+    sample_codec_sample_t record = *p_sample;
+
+    if (g_uplink_up && (0U == sample_journal_pending ()))
+    {
+        if (HTTPSuccess == post_temperature (p_transport, p_sample->temp_cdeg / 100.0f))
+        {
+            return true;
+        }
+        uplink_down (p_context);
+    }
+
+    if (FSP_SUCCESS == sample_journal_append (&record))
+    {
+        APP_INFO_PRINT("\r\nSample %d journaled, %d pending\r\n", record.seq, sample_journal_pending ());
+    }
+    else
+    {
+        APP_ERR_PRINT("** Sample lost, journal not writable ** \r\n");
+    }
+    return false;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Closes the session after a failed request or connect. The next connect attempt is made after
+ *             g_uplink_retry_ms, HTTPS_CONNECTION_RETRY_MS after a session that was up.
+ **********************************************************************************************************************/
+static void uplink_down(NetworkContext_t * p_context)
+{
+    if (g_uplink_up)
+    {
+        APP_WARN_PRINT("\r\nUplink down, journaling samples\r\n");
+    }
+    tls_session_disconnect (p_context);
+    g_uplink_up         = false;
+    g_clock_requested   = false;
+    g_uplink_retry_tick = xTaskGetTickCount ();
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Called from the main loop: takes the periodic sample and task report, reconnects a lost uplink and drains
+ *             one batch of journaled samples per call so that the menu stays responsive.
+ **********************************************************************************************************************/
+static void uplink_service(NetworkContext_t * p_context, TransportInterface_t * p_transport)
+{
+    sample_codec_sample_t batch[APP_JOURNAL_BATCH];
+    sample_codec_sample_t measurement = {RESET_VALUE};
+    const sys_stats_report_t * p_report = NULL;
+    uint32_t count = RESET_VALUE;
+    uint32_t sent = RESET_VALUE;
+
+    if ((xTaskGetTickCount () - g_last_sample_tick) >= pdMS_TO_TICKS(APP_SAMPLE_PERIOD_MS))
+    {
+        g_last_sample_tick = xTaskGetTickCount ();
+        if (FSP_SUCCESS == sample_sensor (&measurement))
+        {
+            (void) uplink_sample (p_context, p_transport, &measurement);
+        }
+        else
+        {
+            APP_ERR_PRINT("** HS3001 measurement failed ** \r\n");
+        }
+    }
+
+    /* Extra measurements for the RTT samples channel only */
+    if ((0U != g_stream_period_ms) &&
+        ((xTaskGetTickCount () - g_last_stream_tick) >= pdMS_TO_TICKS(g_stream_period_ms)))
+    {
+        g_last_stream_tick = xTaskGetTickCount ();
+        (void) sample_sensor (&measurement);
+    }
+
+    /* Timed write of samples staged in RAM, off the sampling path */
+    sample_journal_service ();
+
+    if (0U == sys_stats_service_due ())
+    {
+        p_report = sys_stats_sample ();
+        sys_stats_emit (p_report);
+        rtt_streams_emit_stats ();
+#if (SYS_STATS_FEED == ENABLE)
+        if (g_uplink_up && (HTTPSuccess != post_health (p_transport, p_report)))
+        {
+            uplink_down (p_context);
+        }
+#endif
+    }
+
+    if (!g_uplink_up)
+    {
+        if ((xTaskGetTickCount () - g_uplink_retry_tick) < pdMS_TO_TICKS(g_uplink_retry_ms))
+        {
+            return;
+        }
+        /* One attempt per pass so that sampling and the console carry on while the server is unreachable */
+        if (HTTPSuccess != connect_aws_https_client (p_context))
+        {
+            g_uplink_retry_tick = xTaskGetTickCount ();
+            g_uplink_retry_ms   = ((2U * g_uplink_retry_ms) < APP_UPLINK_RETRY_MS) ? (2U * g_uplink_retry_ms) :
+                                  APP_UPLINK_RETRY_MS;
+            APP_WARN_PRINT("\r\nNext connect attempt in %d ms\r\n", g_uplink_retry_ms);
+            return;
+        }
+        g_uplink_up       = true;
+        g_uplink_retry_ms = HTTPS_CONNECTION_RETRY_MS;
+        app_startup_done (STARTUP_EVT_CONNECTED);
+    }
+
+    if ((FSP_SUCCESS != sample_journal_peek (batch, APP_JOURNAL_BATCH, &count)) || (0U == count))
+    {
+        return;
+    }
+    if (0U == g_drained)
+    {
+        g_drain_start_tick = xTaskGetTickCount ();
+    }
+
+    /* Samples of this boot are dated once a response of this boot carried the time, so ask for it before the
+     * first batch of a session unless a live sample already got it */
+    if (!wall_clock_synced () && !g_clock_requested)
+    {
+        g_clock_requested = true;
+        if (HTTPSuccess != https_request (p_transport, HTTP_METHOD_GET, HTTPS_GET_API, NULL, NULL))
+        {
+            uplink_down (p_context);
+            return;
+        }
+    }
+    if (HTTPSuccess != post_journal_batch (p_transport, batch, count, &sent))
+    {
+        uplink_down (p_context);
+        return;
+    }
+
+    /* Acknowledged, a reset from here on must not send these again */
+    if (FSP_SUCCESS == sample_journal_consume (sent))
+    {
+        g_drained += sent;
+        app_startup_done (STARTUP_EVT_FIRST_POST);
+    }
+    if (0U == sample_journal_pending ())
+    {
+        APP_INFO_PRINT("\r\nJournal drained: %d samples in %d ms\r\n", g_drained,
+                       (xTaskGetTickCount () - g_drain_start_tick) * portTICK_PERIOD_MS);
+        g_drained = RESET_VALUE;
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Returns how long the main loop may sleep: until the next sample, the next journal flush, the next report,
+ *             the next streamed sample or, while the uplink is down, the next connect attempt. A backlog to drain is
+ *             due now.
+ **********************************************************************************************************************/
+static TickType_t uplink_next_wait(void)
+{
+    TickType_t now = xTaskGetTickCount ();
+    TickType_t elapsed = now - g_last_sample_tick;
+    TickType_t wait = RESET_VALUE;
+    TickType_t due = RESET_VALUE;
+
+    wait = (elapsed >= pdMS_TO_TICKS(APP_SAMPLE_PERIOD_MS)) ? 0U : (pdMS_TO_TICKS(APP_SAMPLE_PERIOD_MS) - elapsed);
+    due  = sample_journal_service_due ();
+    wait = (due < wait) ? due : wait;
+    due  = sys_stats_service_due ();
+    wait = (due < wait) ? due : wait;
+    if (0U != g_stream_period_ms)
+    {
+        elapsed = now - g_last_stream_tick;
+        due     = (elapsed >= pdMS_TO_TICKS(g_stream_period_ms)) ? 0U : (pdMS_TO_TICKS(g_stream_period_ms) - elapsed);
+        wait    = (due < wait) ? due : wait;
+    }
+
+    if (!g_uplink_up)
+    {
+        elapsed = now - g_uplink_retry_tick;
+        due     = (elapsed >= pdMS_TO_TICKS(g_uplink_retry_ms)) ? 0U : (pdMS_TO_TICKS(g_uplink_retry_ms) - elapsed);
+        wait    = (due < wait) ? due : wait;
+    }
+    else if (0U != sample_journal_pending ())
+    {
+        wait = 0U;
+    }
+    return wait;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Console command: takes a measurement and uploads it, or journals it while the uplink is down.
+ **********************************************************************************************************************/
+static fsp_err_t command_post(uint32_t argc, char * p_argv[], void * p_context)
+{
+    app_command_context_t * p_command = (app_command_context_t *) p_context;
+    sample_codec_sample_t sample = {RESET_VALUE};
+    fsp_err_t err = FSP_SUCCESS;
+
+    FSP_PARAMETER_NOT_USED(argc);
+    FSP_PARAMETER_NOT_USED(p_argv);
+
+    APP_PRINT("\r\nPreparing to get measurement from HS3001 \r\n");
+    err = sample_sensor (&sample);
+    if(err != FSP_SUCCESS)
+    {
+        __BKPT(0);
+    }
+
+    (void) uplink_sample (p_command->p_network_context, p_command->p_transport, &sample);
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Console command: reads the feed and keeps its id for the PUT/POST API.
+ **********************************************************************************************************************/
+static fsp_err_t command_get(uint32_t argc, char * p_argv[], void * p_context)
+{
+    app_command_context_t * p_command = (app_command_context_t *) p_context;
+    /* Represents a response returned from an HTTP server. */
+    HTTPResponse_t xResponse = {RESET_VALUE};
+
+    FSP_PARAMETER_NOT_USED(argc);
+    FSP_PARAMETER_NOT_USED(p_argv);
+
+    if (!g_uplink_up)
+    {
+        APP_PRINT("\r\nUplink down, GET Request skipped\r\n");
+        return FSP_ERR_NOT_OPEN;
+    }
+
+    if (HTTPSuccess != https_request (p_command->p_transport, HTTP_METHOD_GET, HTTPS_GET_API, NULL, &xResponse))
+    {
+        /* The session is reopened by uplink_service(), samples are journaled meanwhile */
+        uplink_down (p_command->p_network_context);
+        return FSP_ERR_ABORTED;
+    }
+
+    APP_PRINT("Received data using GET Request = %s\n", xResponse.pBody);
+    strncpy (&id[INDEX_ZERO], (char *)&xResponse.pBody[ID_START_INDEX], ID_LEN);
+    /* Fetch the feed id from the response body which to be update in HTTPS_PUT_POST_API */
+    /* SynchronousrResponse body starts with the string in the format like [{\"id\":\"0ENQG7RYQA40W17G2A2SFH8E9Q\",\"...\"}]".
+     *  So, to fetch the ID_KEY other portion of string is avoided*/
+    is_get_called = true;   //setting the flag to avoid GET call in the PUT request
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Console command: crypto benchmark.
+ **********************************************************************************************************************/
+static fsp_err_t command_crypto_bench(uint32_t argc, char * p_argv[], void * p_context)
+{
+    fsp_err_t err = FSP_SUCCESS;
+
+    FSP_PARAMETER_NOT_USED(argc);
+    FSP_PARAMETER_NOT_USED(p_argv);
+    FSP_PARAMETER_NOT_USED(p_context);
+
+    APP_PRINT("\r\nRunning crypto benchmark\r\n");
+    err = crypto_bench_run ();
+    if (FSP_SUCCESS != err)
+    {
+        APP_ERR_PRINT("** Crypto benchmark failed ** \r\n");
+    }
+    return err;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Console command: boot timeline of this and of the previous boot.
+ **********************************************************************************************************************/
+static fsp_err_t command_boot_timeline(uint32_t argc, char * p_argv[], void * p_context)
+{
+    FSP_PARAMETER_NOT_USED(argc);
+    FSP_PARAMETER_NOT_USED(p_argv);
+    FSP_PARAMETER_NOT_USED(p_context);
+
+    boot_profile_print (false);
+    boot_profile_print (true);
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Console command: uplink and journal status, journal index check and codec benchmark.
+ **********************************************************************************************************************/
+static fsp_err_t command_journal(uint32_t argc, char * p_argv[], void * p_context)
+{
+    FSP_PARAMETER_NOT_USED(argc);
+    FSP_PARAMETER_NOT_USED(p_argv);
+    FSP_PARAMETER_NOT_USED(p_context);
+
+    APP_PRINT("\r\nUplink %s\r\n", g_uplink_up ? "up" : "down");
+    sample_journal_print_stats ();
+    (void) sample_journal_check ();
+    return sample_codec_bench ();
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Console command: LittleFS maintenance counters and append benchmark.
+ **********************************************************************************************************************/
+static fsp_err_t command_littlefs_maint(uint32_t argc, char * p_argv[], void * p_context)
+{
+    FSP_PARAMETER_NOT_USED(argc);
+    FSP_PARAMETER_NOT_USED(p_argv);
+    FSP_PARAMETER_NOT_USED(p_context);
+
+    littlefs_maint_print_stats ();
+    return littlefs_maint_bench ();
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Console command: LittleFS benchmark on a RAM block device.
+ **********************************************************************************************************************/
+static fsp_err_t command_storage_bench(uint32_t argc, char * p_argv[], void * p_context)
+{
+    FSP_PARAMETER_NOT_USED(argc);
+    FSP_PARAMETER_NOT_USED(p_argv);
+    FSP_PARAMETER_NOT_USED(p_context);
+
+    return littlefs_bench_run ();
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Console command: idle residency and wakeups per hour, with the console wakeups among them.
+ **********************************************************************************************************************/
+static fsp_err_t command_power(uint32_t argc, char * p_argv[], void * p_context)
+{
+    FSP_PARAMETER_NOT_USED(argc);
+    FSP_PARAMETER_NOT_USED(p_argv);
+    FSP_PARAMETER_NOT_USED(p_context);
+
+    app_power_print_stats ();
+    console_print_stats ();
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Console command: heap bytes per subsystem and pool use by size class. "mem stress [n]" closes the
+ *             uplink, replays n TLS sessions through the pool (MEM_POOL_STRESS_RECONNECTS by default) and reconnects
+ *             after HTTPS_CONNECTION_RETRY_MS. "mem trace on|off" streams the allocations on RTT, "mem peak" restarts
+ *             the peaks, e.g. before a "post" to see what one handshake takes.
+ **********************************************************************************************************************/
+static fsp_err_t command_memory(uint32_t argc, char * p_argv[], void * p_context)
+{
+    app_command_context_t * p_command = (app_command_context_t *) p_context;
+    uint32_t reconnects = MEM_POOL_STRESS_RECONNECTS;
+    fsp_err_t err = FSP_SUCCESS;
+
+    if ((argc > 1U) && (0 == strcmp (p_argv[1], "stress")))
+    {
+        if (argc > 2U)
+        {
+            reconnects = (uint32_t) strtoul (p_argv[2], NULL, 10);
+        }
+        uplink_down (p_command->p_network_context);
+        err = mem_pool_stress (reconnects);
+    }
+    else if ((argc > 2U) && (0 == strcmp (p_argv[1], "trace")))
+    {
+        err = heap_trace_stream (0 == strcmp (p_argv[2], "on"));
+    }
+    else if ((argc > 1U) && (0 == strcmp (p_argv[1], "peak")))
+    {
+        heap_trace_reset_peaks ();
+    }
+    else
+    {
+        /* Status only */
+    }
+    heap_trace_print_stats ();
+    mem_pool_print_stats ();
+    APP_PRINT("FreeRTOS heap: %d bytes free, lowest %d since the peaks were reset, %d since boot\r\n",
+              xPortGetFreeHeapSize (), heap_trace_heap_low (), xPortGetMinimumEverFreeHeapSize ());
+    return err;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Console command: stack margin and CPU share of every task since the previous report.
+ **********************************************************************************************************************/
+static fsp_err_t command_sys_stats(uint32_t argc, char * p_argv[], void * p_context)
+{
+    FSP_PARAMETER_NOT_USED(argc);
+    FSP_PARAMETER_NOT_USED(p_argv);
+    FSP_PARAMETER_NOT_USED(p_context);
+
+    sys_stats_print (sys_stats_sample ());
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Console command: log levels of the modules, "log <module>|all <level>" sets one, "log bench" compares the
+ *             cost of a log call formatted, tokenized and filtered.
+ **********************************************************************************************************************/
+static fsp_err_t command_log(uint32_t argc, char * p_argv[], void * p_context)
+{
+    fsp_err_t err = FSP_SUCCESS;
+
+    FSP_PARAMETER_NOT_USED(p_context);
+
+    if ((argc > 1U) && (0 == strcmp (p_argv[1], "bench")))
+    {
+        log_token_bench ();
+        app_log_bench ();
+        return FSP_SUCCESS;
+    }
+    if (argc > 2U)
+    {
+        err = app_log_set_level (p_argv[1], p_argv[2]);
+    }
+    app_log_print_levels ();
+    return err;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Console command: buffer, mode and counters of the RTT channels. "rtt samples <ms>" streams a measurement
+ *             every <ms> to the samples channel on top of the periodic ones, "rtt samples off" stops.
+ **********************************************************************************************************************/
+static fsp_err_t command_rtt(uint32_t argc, char * p_argv[], void * p_context)
+{
+    uint32_t period_ms = RESET_VALUE;
+
+    FSP_PARAMETER_NOT_USED(p_context);
+
+    if ((argc > 2U) && (0 == strcmp (p_argv[1], "samples")))
+    {
+        period_ms = (0 == strcmp (p_argv[2], "off")) ? 0U : (uint32_t) strtoul (p_argv[2], NULL, 10);
+        if ((0U != period_ms) && (period_ms < RTT_STREAM_SAMPLE_PERIOD_MIN_MS))
+        {
+            period_ms = RTT_STREAM_SAMPLE_PERIOD_MIN_MS;
+        }
+        g_stream_period_ms = period_ms;
+        g_last_stream_tick = xTaskGetTickCount ();
+    }
+    rtt_streams_print_stats ();
+    APP_PRINT("Sample stream: %s, %d measurements since boot\r\n", (0U != g_stream_period_ms) ? "on" : "off",
+              g_sensor_reads);
+    rtt_streams_emit_stats ();
+    return FSP_SUCCESS;
+}
+
 float convertTemperaturetoFloat(void)
 {
     float temperature = 0.0;
@@ -0,0 +1,219 @@
+/***********************************************************************************************************************
+ * File Name    : wall_clock.c
+ * Description  : This file dates samples. The board has no real time clock; the Date header of the server's HTTP
+ *                responses gives the wall clock time at one tick of a boot, and every sample of that boot is dated
+ *                by its time since boot relative to it. References are kept in LittleFS for the last boots.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#define APP_LOG_MODULE                  (APP_LOG_MOD_APP)
+
+#include <stdio.h>
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "littlefs_app.h"
+#include "wall_clock.h"
+
+/*******************************************************************************************************************//**
+ * @addtogroup aws_https_client_ep
+ * @{
+ **********************************************************************************************************************/
+
+/******************************************************************************
+ Private global variables and functions
+ ******************************************************************************/
+static wall_clock_record_t g_wall_clock;
+
+/* Reference of this boot, taken from the latest response; only the first one of a boot is written to LittleFS */
+static wall_clock_ref_t g_current;
+static bool g_current_stored = false;
+
+static uint32_t wall_clock_days_from_civil(uint32_t year, uint32_t month, uint32_t day);
+static fsp_err_t wall_clock_store(void);
+
+/*******************************************************************************************************************//**
+ * @brief      Reads the references of earlier boots from LittleFS. Called once LittleFS is mounted.
+ * @param[in]  None
+ * @retval     FSP_SUCCESS                  References read.
+ * @retval     FSP_ERR_NOT_FOUND            None stored, samples of earlier boots cannot be dated.
+ **********************************************************************************************************************/
+fsp_err_t wall_clock_load(void)
+{
+    lfs_file_t file;
+    lfs_ssize_t read_len = RESET_VALUE;
+
+    memset (&g_wall_clock, RESET_VALUE, sizeof(g_wall_clock));
+    if (LFS_ERR_OK != lfs_file_open (&g_rm_littlefs0_lfs, &file, WALL_CLOCK_FILE_NAME, LFS_O_RDONLY))
+    {
+        return FSP_ERR_NOT_FOUND;
+    }
+    read_len = lfs_file_read (&g_rm_littlefs0_lfs, &file, &g_wall_clock, sizeof(g_wall_clock));
+    (void) lfs_file_close (&g_rm_littlefs0_lfs, &file);
+
+    if (((lfs_ssize_t) sizeof(g_wall_clock) != read_len) || (WALL_CLOCK_MAGIC != g_wall_clock.magic))
+    {
+        memset (&g_wall_clock, RESET_VALUE, sizeof(g_wall_clock));
+        return FSP_ERR_NOT_FOUND;
+    }
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Takes the value of a Date response header, e.g. "Mon, 19 Oct 2026 08:16:34 GMT" (RFC 9110 IMF-fixdate),
+ *             as the wall clock time of now. The first reference of a boot is stored. Called in the task that owns
+ *             LittleFS, right after the response came in; the second resolution of the header and half the round
+ *             trip are the error of every date derived from it.
+ * @param[in]  p_date                       Header value, not terminated.
+ * @param[in]  date_len                     Length of the value.
+ * @retval     None
+ **********************************************************************************************************************/
+void wall_clock_set_http_date(const char * p_date, size_t date_len)
+{
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    char date[32];
+    char month[4] = {RESET_VALUE};
+    const char * p_month = NULL;
+    unsigned int day = RESET_VALUE;
+    unsigned int year = RESET_VALUE;
+    unsigned int hour = RESET_VALUE;
+    unsigned int minute = RESET_VALUE;
+    unsigned int second = RESET_VALUE;
+
+    if ((NULL == p_date) || (date_len >= sizeof(date)))
+    {
+        return;
+    }
+    memcpy (date, p_date, date_len);
+    date[date_len] = '\0';
+
+    if ((6 != sscanf (date, "%*[^,], %2u %3s %4u %2u:%2u:%2u", &day, month, &year, &hour, &minute, &second))
+        || (NULL == (p_month = strstr (months, month))) || (3U != strlen (month)) || (year < 1970U)
+        || (0U != ((size_t) (p_month - months) % 3U)))
+    {
+        APP_WARN_PRINT("\r\nDate header not understood: %s\r\n", date);
+        return;
+    }
+
+    g_current.boot    = hal_littlefs_boot_count ();
+    g_current.time_ms = xTaskGetTickCount () * portTICK_PERIOD_MS;
+    g_current.epoch_s = (wall_clock_days_from_civil (year, (uint32_t) (p_month - months) / 3U + 1U, day) * 86400U)
+                        + (hour * 3600U) + (minute * 60U) + second;
+
+    if (!g_current_stored)
+    {
+        g_current_stored = true;
+        g_wall_clock.refs[g_current.boot % WALL_CLOCK_REFS] = g_current;
+        if (FSP_SUCCESS == wall_clock_store ())
+        {
+            APP_DBG_PRINT("\r\nWall clock reference of boot %d stored\r\n", g_current.boot);
+        }
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Tells whether this boot has a reference, i.e. a response with a Date header came in.
+ * @param[in]  None
+ * @retval     true when samples of this boot can be dated.
+ **********************************************************************************************************************/
+bool wall_clock_synced(void)
+{
+    return g_current_stored;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Dates a sample from the reference of its boot. A sample of an earlier boot without a stored reference
+ *             has no date and must not be given the current time.
+ * @param[in]  boot                         hal_littlefs_boot_count() at sampling.
+ * @param[in]  time_ms                      Time since boot at sampling.
+ * @param[out] p_epoch_s                    Seconds since 1970-01-01 UTC at sampling.
+ * @retval     true                         Sample dated.
+ * @retval     false                        No reference for that boot.
+ **********************************************************************************************************************/
+bool wall_clock_epoch(uint32_t boot, uint32_t time_ms, uint32_t * p_epoch_s)
+{
+    const wall_clock_ref_t * p_ref = &g_wall_clock.refs[boot % WALL_CLOCK_REFS];
+
+    if (g_current_stored && (boot == g_current.boot))
+    {
+        p_ref = &g_current;
+    }
+    if ((0U == boot) || (boot != p_ref->boot))
+    {
+        return false;
+    }
+
+    /* The sample may lie before or after the reference */
+    *p_epoch_s = (uint32_t) ((int64_t) p_ref->epoch_s + (((int64_t) time_ms - (int64_t) p_ref->time_ms) / 1000));
+    return true;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Formats a time as ISO 8601 in UTC, e.g. "2026-10-19T08:16:34Z".
+ * @param[in]  epoch_s                      Seconds since 1970-01-01 UTC.
+ * @param[out] iso                          Formatted time.
+ * @retval     None
+ **********************************************************************************************************************/
+void wall_clock_format_iso(uint32_t epoch_s, char iso[WALL_CLOCK_ISO_LEN])
+{
+    /* Civil date from the day number, H. Hinnant's algorithm for the proleptic Gregorian calendar */
+    uint32_t days = (epoch_s / 86400U) + 719468U;
+    uint32_t era = days / 146097U;
+    uint32_t doe = days - (era * 146097U);
+    uint32_t yoe = (doe - (doe / 1460U) + (doe / 36524U) - (doe / 146096U)) / 365U;
+    uint32_t doy = doe - ((365U * yoe) + (yoe / 4U) - (yoe / 100U));
+    uint32_t mp = ((5U * doy) + 2U) / 153U;
+    uint32_t day = doy - (((153U * mp) + 2U) / 5U) + 1U;
+    uint32_t month = (mp < 10U) ? (mp + 3U) : (mp - 9U);
+    uint32_t year = yoe + (era * 400U) + ((month <= 2U) ? 1U : 0U);
+    uint32_t second = epoch_s % 86400U;
+
+    /* The modulos only tell the compiler the field widths */
+    snprintf (iso, WALL_CLOCK_ISO_LEN, "%04u-%02u-%02uT%02u:%02u:%02uZ", (unsigned int) (year % 10000U),
+              (unsigned int) (month % 100U), (unsigned int) (day % 100U), (unsigned int) (second / 3600U),
+              (unsigned int) ((second / 60U) % 60U), (unsigned int) (second % 60U));
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Days since 1970-01-01 of a date from 1970 on, the inverse of the conversion in wall_clock_format_iso().
+ **********************************************************************************************************************/
+static uint32_t wall_clock_days_from_civil(uint32_t year, uint32_t month, uint32_t day)
+{
+    uint32_t y = (month <= 2U) ? (year - 1U) : year;
+    uint32_t era = y / 400U;
+    uint32_t yoe = y - (era * 400U);
+    uint32_t doy = ((153U * ((month > 2U) ? (month - 3U) : (month + 9U))) + 2U) / 5U + day - 1U;
+    uint32_t doe = (yoe * 365U) + (yoe / 4U) - (yoe / 100U) + doy;
+
+    return (era * 146097U) + doe - 719468U;
+}
+
+/*******************************************************************************************************************//**
+ * @brief      Writes the references, LittleFS commits the new file contents atomically on close.
+ **********************************************************************************************************************/
+static fsp_err_t wall_clock_store(void)
+{
+    lfs_file_t file;
+    lfs_ssize_t written = RESET_VALUE;
+    int lfs_err = LFS_ERR_OK;
+
+    g_wall_clock.magic = WALL_CLOCK_MAGIC;
+    lfs_err = lfs_file_open (&g_rm_littlefs0_lfs, &file, WALL_CLOCK_FILE_NAME, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+    if (LFS_ERR_OK != lfs_err)
+    {
+        APP_ERR_PRINT("** Failed to open %s: %d ** \r\n", WALL_CLOCK_FILE_NAME, lfs_err);
+        return FSP_ERR_WRITE_FAILED;
+    }
+    written = lfs_file_write (&g_rm_littlefs0_lfs, &file, &g_wall_clock, sizeof(g_wall_clock));
+    lfs_err = lfs_file_close (&g_rm_littlefs0_lfs, &file);
+
+    return (((lfs_ssize_t) sizeof(g_wall_clock) == written) && (LFS_ERR_OK == lfs_err)) ? FSP_SUCCESS :
+           FSP_ERR_WRITE_FAILED;
+}
+/*******************************************************************************************************************//**
+ * @} (end defgroup aws_https_client_ep)
+ **********************************************************************************************************************/
@@ -0,0 +1,45 @@
+/***********************************************************************************************************************
+ * File Name    : wall_clock.h
+ * Description  : Contains macros, data structures and functions used by the wall clock reference of the samples
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef WALL_CLOCK_H_
+#define WALL_CLOCK_H_
+
+#include "hal_data.h"
+
+/* LittleFS file holding the references of the last boots, so that journaled samples of a boot can still be dated
+ * after a reset. A boot stores its first reference only */
+#define WALL_CLOCK_FILE_NAME            "/wall_clock"
+#define WALL_CLOCK_MAGIC                (0x4B4C4357UL)      /* "WCLK" */
+#define WALL_CLOCK_REFS                 (4U)
+
+/* "2026-10-19T08:16:34Z" and its terminator */
+#define WALL_CLOCK_ISO_LEN              (21U)
+
+/* Wall clock time at one point of a boot */
+typedef struct st_wall_clock_ref
+{
+    uint32_t boot;                      /* hal_littlefs_boot_count() of the boot, 0 for an empty slot */
+    uint32_t time_ms;                   /* Time since boot at the reference */
+    uint32_t epoch_s;                   /* Seconds since 1970-01-01 UTC at the reference */
+} wall_clock_ref_t;
+
+typedef struct st_wall_clock_record
+{
+    uint32_t magic;
+    wall_clock_ref_t refs[WALL_CLOCK_REFS];     /* Slot boot % WALL_CLOCK_REFS */
+} wall_clock_record_t;
+
+fsp_err_t wall_clock_load(void);
+void wall_clock_set_http_date(const char * p_date, size_t date_len);
+bool wall_clock_synced(void);
+bool wall_clock_epoch(uint32_t boot, uint32_t time_ms, uint32_t * p_epoch_s);
+void wall_clock_format_iso(uint32_t epoch_s, char iso[WALL_CLOCK_ISO_LEN]);
+
+#endif /* WALL_CLOCK_H_ */
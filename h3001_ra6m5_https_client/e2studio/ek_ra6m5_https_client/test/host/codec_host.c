@@ -0,0 +1,131 @@
+/***********************************************************************************************************************
+ * File Name    : codec_host.c
+ * Description  : Host test of the sample codec. Runs sample_codec_bench() on the built-in synthetic trace and, when a
+ *                samples.csv of tools/rtt_capture.py is given, round trips that capture block by block the way the
+ *                sample journal does.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#include <stdlib.h>
+#include "common_utils.h"
+#include "sample_codec.h"
+
+#define CODEC_HOST_MAX_SAMPLES          (100000U)
+
+static sample_codec_sample_t g_trace[CODEC_HOST_MAX_SAMPLES];
+
+/* Reads time_ms,count,raw_humidity,raw_temperature,temp_c,rh_pct. A time that goes backwards is a reboot */
+static uint32_t codec_host_read_capture(const char * p_path)
+{
+    FILE * p_file = fopen (p_path, "r");
+    char line[128];
+    uint32_t count = RESET_VALUE;
+    uint32_t boot = 1U;
+    unsigned long time_ms = 0;
+    unsigned long seq = 0;
+    double temp_c = 0.0;
+    double rh_pct = 0.0;
+
+    if (NULL == p_file)
+    {
+        perror (p_path);
+        exit (2);
+    }
+    while ((count < CODEC_HOST_MAX_SAMPLES) && (NULL != fgets (line, sizeof(line), p_file)))
+    {
+        if (4 != sscanf (line, "%lu,%lu,%*[^,],%*[^,],%lf,%lf", &time_ms, &seq, &temp_c, &rh_pct))
+        {
+            continue;                   /* Header */
+        }
+        if ((0U != count) && (time_ms < g_trace[count - 1U].time_ms))
+        {
+            boot++;
+        }
+        g_trace[count].seq       = (uint32_t) seq;
+        g_trace[count].boot      = boot;
+        g_trace[count].time_ms   = (uint32_t) time_ms;
+        g_trace[count].temp_cdeg = (int16_t) ((temp_c * 100.0) + ((temp_c < 0.0) ? -0.5 : 0.5));
+        g_trace[count].rh_cprh   = (uint16_t) ((rh_pct * 100.0) + 0.5);
+        count++;
+    }
+    fclose (p_file);
+    return count;
+}
+
+/* Encodes into blocks of SAMPLE_CODEC_BLOCK_SIZE through a side buffer as sample_journal_append() does, decodes each
+ * block and compares. Returns 0 when the round trip is exact */
+static int codec_host_round_trip(uint32_t samples)
+{
+    static uint8_t block[SAMPLE_CODEC_BLOCK_SIZE];
+    uint8_t encoded[SAMPLE_CODEC_MAX_ENCODED];
+    sample_codec_state_t encoder;
+    sample_codec_state_t decoder;
+    sample_codec_sample_t sample;
+    uint32_t len = RESET_VALUE;
+    uint32_t first = RESET_VALUE;
+    uint32_t blocks = RESET_VALUE;
+    uint32_t bytes = RESET_VALUE;
+
+    sample_codec_reset (&encoder);
+    for (uint32_t i = 0; i <= samples; i++)
+    {
+        fsp_err_t err = (i < samples) ? sample_codec_encode (&encoder, &g_trace[i], encoded, &len) : FSP_ERR_OVERFLOW;
+
+        if (FSP_SUCCESS == err)
+        {
+            memcpy (&block[encoder.used - len], encoded, len);
+            continue;
+        }
+
+        /* Block complete: decode it against the samples it was built from */
+        sample_codec_reset (&decoder);
+        for (uint32_t j = first; j < i; j++)
+        {
+            if ((FSP_SUCCESS != sample_codec_decode (&decoder, block, encoder.used, &sample))
+                || (0 != memcmp (&sample, &g_trace[j], sizeof(sample))))
+            {
+                printf ("round trip differs at sample %u\n", j);
+                return 1;
+            }
+        }
+        if (FSP_ERR_NOT_FOUND != sample_codec_decode (&decoder, block, encoder.used, &sample))
+        {
+            printf ("block %u has trailing data\n", blocks);
+            return 1;
+        }
+        bytes += encoder.used;
+        blocks++;
+        first = i;
+        sample_codec_reset (&encoder);
+        if ((i < samples) && (FSP_SUCCESS != sample_codec_encode (&encoder, &g_trace[i], encoded, &len)))
+        {
+            printf ("sample %u does not fit an empty block\n", i);
+            return 1;
+        }
+        memcpy (block, encoded, len);
+    }
+
+    printf ("%s,capture,%u,%u,%u,%u blocks\n", SAMPLE_CODEC_BENCH_TAG, samples, bytes,
+            (0U == samples) ? 0U : ((100U * bytes) / samples), blocks);
+    return 0;
+}
+
+int main(int argc, char * argv[])
+{
+    uint32_t samples = RESET_VALUE;
+
+    if (FSP_SUCCESS != sample_codec_bench ())
+    {
+        return 1;
+    }
+    if (argc < 2)
+    {
+        return 0;
+    }
+    samples = codec_host_read_capture (argv[1]);
+    return codec_host_round_trip (samples);
+}
@@ -0,0 +1,28 @@
+/***********************************************************************************************************************
+ * File Name    : crypto_bench_host.c
+ * Description  : Host run of crypto_bench_run() against the mbedTLS sources with their default configuration, so every
+ *                row takes the software path. Prints the same #BENCH lines as the "crypto" command of the target. The
+ *                host numbers compare the primitives with each other and catch regressions of the benchmark itself,
+ *                the rows of the target are the ones to choose cipher suites and key types on.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#include "common_utils.h"
+#include "credential_cache.h"
+#include "crypto_bench.h"
+
+int main(void)
+{
+    fsp_err_t err = credential_cache_init ();
+
+    if (FSP_SUCCESS == err)
+    {
+        err = crypto_bench_run ();
+        credential_cache_deinit ();
+    }
+    return (FSP_SUCCESS == err) ? 0 : 1;
+}
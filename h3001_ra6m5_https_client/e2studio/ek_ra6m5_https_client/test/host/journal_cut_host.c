@@ -0,0 +1,202 @@
+/***********************************************************************************************************************
+ * File Name    : journal_cut_host.c
+ * Description  : Host power-cut test of the sample journal. sample_journal.c runs on LittleFS on the RAM device
+ *                through a workload of appends, flushes and drained batches. A clean run counts its programs and
+ *                erases, then the workload is repeated with the power cut at each one of them in turn. After every
+ *                cut the device is powered on, LittleFS mounted and the journal resumed from its index, and then:
+ *                  - sample_journal_check() agrees with the segments,
+ *                  - the pending samples are consecutive, none acknowledged before the cut is pending again,
+ *                  - every sample flushed before the cut is either acknowledged or pending,
+ *                  - the next sample continues the sequence numbers.
+ *                Prints #JRNLCUT,<cuts>,<failed> at the end and the details of every failure before it.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#include "common_utils.h"
+#include "task.h"
+#include "core_http_client.h"
+#include "transport_mbedtls_pkcs11.h"
+#include "user_app.h"
+#include "littlefs_app.h"
+#include "littlefs_bench.h"
+#include "sample_journal.h"
+
+/* Workload: rounds of appends closed by a flush, draining fewer than appended so segments fill and are removed */
+#define JOURNAL_CUT_ROUNDS              (8U)
+#define JOURNAL_CUT_APPENDS             (20U)
+#define JOURNAL_CUT_DRAIN               (12U)
+#define JOURNAL_CUT_MAX_PENDING         (JOURNAL_CUT_ROUNDS * JOURNAL_CUT_APPENDS)
+#define JOURNAL_CUT_TAG                 "#JRNLCUT"
+
+/* What the application knew for certain when the power went */
+typedef struct st_journal_cut_state
+{
+    uint32_t acked;                     /* Samples below this sequence number were consumed with success */
+    uint32_t acking;                    /* A consume up to here was under way, it may or may not have been committed */
+    uint32_t durable;                   /* Samples below this were written by a flush that returned success */
+    uint32_t next;                      /* Sequence number of the next append */
+} journal_cut_state_t;
+
+static sample_codec_sample_t g_records[JOURNAL_CUT_MAX_PENDING];
+
+/* Power on, mount and open the journal as a boot does */
+static bool journal_cut_boot(uint32_t cut_after)
+{
+    rm_littlefs_host_power_on (cut_after);
+    return (FSP_SUCCESS == hal_littlefs_init ()) && (FSP_SUCCESS == sample_journal_init ());
+}
+
+/* Runs the workload until it completes or the power is cut */
+static void journal_cut_workload(journal_cut_state_t * p_state)
+{
+    sample_codec_sample_t sample;
+    uint32_t count = RESET_VALUE;
+
+    memset (p_state, 0, sizeof(*p_state));
+    for (uint32_t round = 0; round < JOURNAL_CUT_ROUNDS; round++)
+    {
+        for (uint32_t i = 0; i < JOURNAL_CUT_APPENDS; i++)
+        {
+            g_host_tick += pdMS_TO_TICKS(APP_SAMPLE_PERIOD_MS);
+            sample_journal_service ();
+            memset (&sample, 0, sizeof(sample));
+            sample.time_ms   = (uint32_t) g_host_tick;
+            sample.temp_cdeg = (int16_t) (2100 + (int32_t) (p_state->next % 17U));
+            sample.rh_cprh   = (uint16_t) (5000U - (p_state->next % 23U));
+            if (littlefs_bench_device_dead () || (FSP_SUCCESS != sample_journal_append (&sample)))
+            {
+                return;
+            }
+            p_state->next = sample.seq + 1U;
+        }
+
+        if (littlefs_bench_device_dead () || (FSP_SUCCESS != sample_journal_flush ()))
+        {
+            return;
+        }
+        p_state->durable = p_state->next;
+
+        if ((FSP_SUCCESS != sample_journal_peek (g_records, JOURNAL_CUT_DRAIN, &count)) || (0U == count))
+        {
+            return;
+        }
+        p_state->acking = g_records[count - 1U].seq + 1U;
+        if (littlefs_bench_device_dead () || (FSP_SUCCESS != sample_journal_consume (count)))
+        {
+            return;
+        }
+        p_state->acked = p_state->acking;
+    }
+}
+
+/* Checks the journal after the reboot against what was known at the cut */
+static bool journal_cut_verify(uint32_t cut, const journal_cut_state_t * p_state)
+{
+    sample_codec_sample_t sample;
+    uint32_t pending = sample_journal_pending ();
+    uint32_t count = RESET_VALUE;
+    uint32_t acked_max = (p_state->acking > p_state->acked) ? p_state->acking : p_state->acked;
+    uint32_t first = RESET_VALUE;
+    uint32_t end = RESET_VALUE;
+
+    if (FSP_SUCCESS != sample_journal_check ())
+    {
+        printf ("cut %u: index and segments disagree\n", cut);
+        return false;
+    }
+    if ((pending > JOURNAL_CUT_MAX_PENDING) ||
+        (FSP_SUCCESS != sample_journal_peek (g_records, JOURNAL_CUT_MAX_PENDING, &count)) || (count != pending))
+    {
+        printf ("cut %u: %u pending, %u read back\n", cut, pending, count);
+        return false;
+    }
+    for (uint32_t i = 1; i < count; i++)
+    {
+        if (g_records[i].seq != (g_records[i - 1U].seq + 1U))
+        {
+            printf ("cut %u: sample %u follows %u\n", cut, g_records[i].seq, g_records[i - 1U].seq);
+            return false;
+        }
+    }
+    if (0U != count)
+    {
+        first = g_records[0].seq;
+        end   = g_records[count - 1U].seq + 1U;
+        if ((first < p_state->acked) || (first > acked_max))
+        {
+            printf ("cut %u: pending from %u, acknowledged up to %u (%u under way)\n", cut, first, p_state->acked,
+                    p_state->acking);
+            return false;
+        }
+    }
+    if (((0U != count) && (end < p_state->durable)) || ((0U == count) && (acked_max < p_state->durable)))
+    {
+        printf ("cut %u: flushed up to %u, pending up to %u, acknowledged up to %u\n", cut, p_state->durable, end,
+                acked_max);
+        return false;
+    }
+
+    /* A sample number is never given out twice */
+    memset (&sample, 0, sizeof(sample));
+    if (FSP_SUCCESS != sample_journal_append (&sample))
+    {
+        printf ("cut %u: append after the reboot failed\n", cut);
+        return false;
+    }
+    if (((0U != count) && (sample.seq != end)) || (sample.seq < p_state->acked) || (sample.seq < p_state->durable))
+    {
+        printf ("cut %u: next sample %u, pending up to %u, flushed up to %u\n", cut, sample.seq, end,
+                p_state->durable);
+        return false;
+    }
+    return true;
+}
+
+int main(void)
+{
+    journal_cut_state_t state;
+    littlefs_bench_counters_t before;
+    littlefs_bench_counters_t after;
+    uint32_t total = RESET_VALUE;
+    uint32_t failed = RESET_VALUE;
+
+    /* Clean run: the writes of the workload, and a check that it completes */
+    rm_littlefs_host_attach ();
+    if (!journal_cut_boot (RESET_VALUE))
+    {
+        return 1;
+    }
+    littlefs_bench_device_counters (&before);
+    journal_cut_workload (&state);
+    littlefs_bench_device_counters (&after);
+    total = (after.progs - before.progs) + (after.erases - before.erases);
+    if ((JOURNAL_CUT_ROUNDS * JOURNAL_CUT_APPENDS) != state.next)
+    {
+        printf ("clean run stopped at sample %u\n", state.next);
+        return 1;
+    }
+
+    for (uint32_t cut = 1U; cut <= total; cut++)
+    {
+        rm_littlefs_host_attach ();
+        if (!journal_cut_boot (RESET_VALUE))
+        {
+            return 1;
+        }
+        littlefs_bench_device_cut (cut);
+        journal_cut_workload (&state);
+
+        if (!journal_cut_boot (RESET_VALUE) || !journal_cut_verify (cut, &state))
+        {
+            printf ("cut %u of %u not recovered\n", cut, total);
+            failed++;
+        }
+    }
+
+    printf ("%s,cuts,failed\n%s,%u,%u\n", JOURNAL_CUT_TAG, JOURNAL_CUT_TAG, total, failed);
+    return (RESET_VALUE == failed) ? 0 : 1;
+}
@@ -0,0 +1,208 @@
+/***********************************************************************************************************************
+ * File Name    : journal_host.c
+ * Description  : Host test of the flash writes of the sample journal. An uplink outage is played through
+ *                sample_journal.c on LittleFS and the RAM device: one sample every APP_SAMPLE_PERIOD_MS with the
+ *                journal serviced in between as the main loop does. Built once as configured and once write-through,
+ *                so the programs and erases of both runs compare the real saving with the estimate of
+ *                sample_journal_print_stats(). Then a sealed segment is cut short and drained: no batch may run over
+ *                the samples that no longer decode, and the drain must not stall on them. Prints one comma separated
+ *                line per run and one for the short segment:
+ *                  #JRNLHOST,<mode>,<samples>,<flash_us>,<progs>,<erases>,<pending>
+ *                  #JRNLHOST,short_segment,<pending>,<read back>,<dropped>,<result>
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#include <stdlib.h>
+#include "common_utils.h"
+#include "task.h"
+#include "core_http_client.h"
+#include "transport_mbedtls_pkcs11.h"
+#include "user_app.h"
+#include "littlefs_app.h"
+#include "littlefs_bench.h"
+#include "sample_journal.h"
+
+#define JOURNAL_HOST_SAMPLES            (360U)      /* Six hours of outage */
+#define JOURNAL_HOST_SHORT_SAMPLES      (120U)      /* Three segments and some, the second one is cut short */
+#define JOURNAL_HOST_DRAIN_MAX          (1000U)     /* Peeks before the drain counts as stalled */
+#define JOURNAL_HOST_TAG                "#JRNLHOST"
+
+/* Reads back every pending sample and checks the sequence numbers run on without a gap */
+static int journal_host_verify(uint32_t expected)
+{
+    sample_codec_sample_t records[APP_JOURNAL_BATCH];
+    uint32_t pending = sample_journal_pending ();
+    uint32_t next = RESET_VALUE;
+    uint32_t count = RESET_VALUE;
+    uint32_t read = RESET_VALUE;
+
+    if ((pending > expected) || (FSP_SUCCESS != sample_journal_check ()))
+    {
+        printf ("journal check failed, %u pending of %u\n", pending, expected);
+        return 1;
+    }
+    next = expected - pending;
+    while (read < pending)
+    {
+        if ((FSP_SUCCESS != sample_journal_peek (records, APP_JOURNAL_BATCH, &count)) || (0U == count))
+        {
+            printf ("read back stopped at sample %u\n", next);
+            return 1;
+        }
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (records[i].seq != next)
+            {
+                printf ("sample %u read back as %u\n", next, records[i].seq);
+                return 1;
+            }
+            next++;
+        }
+        read += count;
+        if (FSP_SUCCESS != sample_journal_consume (count))
+        {
+            printf ("consume of %u samples failed\n", count);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Appends samples one every APP_SAMPLE_PERIOD_MS with the journal serviced in between, then flushes them */
+static int journal_host_append(uint32_t samples)
+{
+    sample_codec_sample_t sample;
+
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        g_host_tick += pdMS_TO_TICKS(APP_SAMPLE_PERIOD_MS);
+        sample_journal_service ();
+
+        memset (&sample, 0, sizeof(sample));
+        sample.time_ms   = (uint32_t) g_host_tick;
+        sample.temp_cdeg = (int16_t) (2150 + (int32_t) ((i * 7U) % 41U) - 20);
+        sample.rh_cprh   = (uint16_t) (4500U + ((i * 13U) % 97U));
+        if (FSP_SUCCESS != sample_journal_append (&sample))
+        {
+            printf ("append of sample %u failed\n", i);
+            return 1;
+        }
+    }
+    return (FSP_SUCCESS == sample_journal_flush ()) ? 0 : 1;
+}
+
+/* Cuts the second oldest segment file to half its length, the index still lists all of its samples */
+static int journal_host_cut_segment(void)
+{
+    static uint8_t data[SAMPLE_CODEC_BLOCK_SIZE];
+    char path[SAMPLE_JOURNAL_PATH_LEN];
+    lfs_file_t file;
+    lfs_ssize_t len = RESET_VALUE;
+    uint32_t found = RESET_VALUE;
+
+    for (uint32_t segment = 0; segment < 4096U; segment++)
+    {
+        (void) snprintf (path, sizeof(path), SAMPLE_JOURNAL_SEGMENT_FMT, (unsigned long) segment);
+        if (LFS_ERR_OK != lfs_file_open (&g_rm_littlefs0_lfs, &file, path, LFS_O_RDONLY))
+        {
+            continue;
+        }
+        if (1U != found++)
+        {
+            (void) lfs_file_close (&g_rm_littlefs0_lfs, &file);
+            continue;
+        }
+        len = lfs_file_read (&g_rm_littlefs0_lfs, &file, data, sizeof(data));
+        (void) lfs_file_close (&g_rm_littlefs0_lfs, &file);
+        if ((len <= 0) || (LFS_ERR_OK != lfs_file_open (&g_rm_littlefs0_lfs, &file, path, LFS_O_WRONLY | LFS_O_TRUNC)))
+        {
+            return 1;
+        }
+        len = lfs_file_write (&g_rm_littlefs0_lfs, &file, data, (lfs_size_t) (len / 2));
+        return ((LFS_ERR_OK == lfs_file_close (&g_rm_littlefs0_lfs, &file)) && (len >= 0)) ? 0 : 1;
+    }
+    printf ("no second segment to cut\n");
+    return 1;
+}
+
+/* Drains a journal with a short segment: sequence numbers run on within every batch and rise across batches */
+static int journal_host_short_segment(void)
+{
+    sample_codec_sample_t records[APP_JOURNAL_BATCH];
+    uint32_t pending = RESET_VALUE;
+    uint32_t next = RESET_VALUE;
+    uint32_t count = RESET_VALUE;
+    uint32_t read = RESET_VALUE;
+    uint32_t dropped = RESET_VALUE;
+    bool pass = true;
+
+    if ((0U != journal_host_append (JOURNAL_HOST_SHORT_SAMPLES)) || (0U != journal_host_cut_segment ()))
+    {
+        return 1;
+    }
+    pending = sample_journal_pending ();
+    for (uint32_t peek = 0; pass && (peek < JOURNAL_HOST_DRAIN_MAX) && (0U != sample_journal_pending ()); peek++)
+    {
+        pass = (FSP_SUCCESS == sample_journal_peek (records, APP_JOURNAL_BATCH, &count));
+        for (uint32_t i = 0; pass && (i < count); i++)
+        {
+            if (((0U != read) || (0U != i)) && (records[i].seq < next))
+            {
+                printf ("sample %u read back again after %u\n", records[i].seq, next - 1U);
+                pass = false;
+            }
+            if ((0U != i) && (records[i].seq != next))
+            {
+                printf ("batch runs from sample %u over a gap to %u\n", next - 1U, records[i].seq);
+                pass = false;
+            }
+            next = records[i].seq + 1U;
+        }
+        read += count;
+        pass  = pass && (FSP_SUCCESS == sample_journal_consume (count));
+    }
+    dropped = pending - read - sample_journal_pending ();
+    pass    = pass && (0U == sample_journal_pending ()) && (0U != dropped);
+
+    sample_journal_print_stats ();
+    printf ("%s,short_segment,%u,%u,%u,%s\n", JOURNAL_HOST_TAG, pending, read, dropped, pass ? "pass" : "FAIL");
+    return pass ? 0 : 1;
+}
+
+int main(int argc, char * argv[])
+{
+    uint32_t samples = (argc > 1) ? (uint32_t) strtoul (argv[1], NULL, 0) : JOURNAL_HOST_SAMPLES;
+    littlefs_bench_counters_t before;
+    littlefs_bench_counters_t after;
+    uint32_t pending = RESET_VALUE;
+
+    rm_littlefs_host_attach ();
+    if ((FSP_SUCCESS != hal_littlefs_init ()) || (FSP_SUCCESS != sample_journal_init ()))
+    {
+        return 1;
+    }
+
+    littlefs_bench_device_counters (&before);
+    if (0U != journal_host_append (samples))
+    {
+        return 1;
+    }
+    littlefs_bench_device_counters (&after);
+    pending = sample_journal_pending ();
+
+    sample_journal_print_stats ();
+    printf ("%s,%s,%u,%u,%u,%u,%u\n", JOURNAL_HOST_TAG,
+            (SAMPLE_JOURNAL_WRITE_BACK == ENABLE) ? "write_back" : "write_through", samples,
+            (uint32_t) (after.flash_us - before.flash_us), after.progs - before.progs, after.erases - before.erases,
+            pending);
+
+    if (0U != journal_host_verify (samples))
+    {
+        return 1;
+    }
+    return journal_host_short_segment ();
+}
@@ -0,0 +1,19 @@
+/***********************************************************************************************************************
+ * File Name    : lfs_bench_host.c
+ * Description  : Host run of the LittleFS storage benchmark: littlefs_bench_run() on the RAM device with the data
+ *                flash timing model, built against the LittleFS sources of the FSP. cpu_us is host time, flash_us is
+ *                the modelled data flash time and holds for the target.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#include "common_utils.h"
+#include "littlefs_bench.h"
+
+int main(void)
+{
+    return (FSP_SUCCESS == littlefs_bench_run ()) ? 0 : 1;
+}
@@ -0,0 +1,51 @@
+/***********************************************************************************************************************
+ * File Name    : maint_host.c
+ * Description  : Host run of littlefs_maint_bench(): append latency p50/p99 without and with a maintenance pass
+ *                between appends, on LittleFS on the RAM device. The latencies include the data flash time of the
+ *                device model, so they are the stall a writer on the target sees. The maintenance task does not run
+ *                on the host, the benchmark calls its pass directly as it does on the target.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#include "common_utils.h"
+#include "littlefs_app.h"
+#include "littlefs_maint.h"
+
+/* Space held by other files, as the PKCS#11 objects and the journal hold it on the target */
+#define MAINT_HOST_FILL_FILE            "/maint_fill"
+#define MAINT_HOST_FILL_BYTES           (3072U)
+
+static bool maint_host_fill(void)
+{
+    static uint8_t fill[MAINT_HOST_FILL_BYTES];
+    lfs_file_t file;
+    lfs_ssize_t len = RESET_VALUE;
+
+    memset (fill, 0xA5, sizeof(fill));
+    if (LFS_ERR_OK != lfs_file_open (&g_rm_littlefs0_lfs, &file, MAINT_HOST_FILL_FILE,
+                                     LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC))
+    {
+        return false;
+    }
+    len = lfs_file_write (&g_rm_littlefs0_lfs, &file, fill, sizeof(fill));
+    return (LFS_ERR_OK == lfs_file_close (&g_rm_littlefs0_lfs, &file)) && ((lfs_ssize_t) sizeof(fill) == len);
+}
+
+int main(void)
+{
+    fsp_err_t err = FSP_SUCCESS;
+
+    rm_littlefs_host_attach ();
+    if ((FSP_SUCCESS != hal_littlefs_init ()) || !maint_host_fill () || (FSP_SUCCESS != littlefs_maint_start ()))
+    {
+        return 1;
+    }
+
+    err = littlefs_maint_bench ();
+    littlefs_maint_print_stats ();
+    return (FSP_SUCCESS == err) ? 0 : 1;
+}
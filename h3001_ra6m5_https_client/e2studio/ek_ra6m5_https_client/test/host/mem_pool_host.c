@@ -0,0 +1,161 @@
+/***********************************************************************************************************************
+ * File Name    : mem_pool_host.c
+ * Description  : Host run of the reconnect stress of mem_pool.c on the heap_4 model of stubs/heap_host.c, with
+ *                AddressSanitizer and LeakSanitizer watching the heap blocks. mem_pool_stress() replays the TLS
+ *                sessions and prints its #MEMSTRESS line, then the test checks what the stress cannot see itself:
+ *                  - the allocator installed in mbedTLS is the pool's,
+ *                  - every block of every TLS size class can be taken again, none twice and none from the heap,
+ *                  - PKCS#11 allocations beyond its pool fall back to the heap and give all of it back,
+ *                  - in the end no pool block is held and the heap is one free block again.
+ *                Prints #MEMHOST,<reconnects>,<heap blocks held>,<free blocks>,<largest free>,<result> at the end.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#include <stdlib.h>
+#include "common_utils.h"
+#include "FreeRTOS.h"
+#include "mbedtls/platform.h"
+#include "mem_pool.h"
+#include "heap_trace.h"
+
+#define MEM_POOL_HOST_TAG               "#MEMHOST"
+#define MEM_POOL_HOST_CACHED_SIZE       (1200U)     /* A parsed certificate kept across sessions, outside the pool */
+#define MEM_POOL_HOST_BLOCKS_MAX        (256U)
+
+static const mem_pool_class_t g_tls_classes[] = MEM_POOL_TLS_CLASSES;
+static const mem_pool_class_t g_pkcs11_classes[] = MEM_POOL_PKCS11_CLASSES;
+
+static void * g_blocks[MEM_POOL_HOST_BLOCKS_MAX];
+static uint32_t g_sizes[MEM_POOL_HOST_BLOCKS_MAX];
+
+static size_t mem_pool_host_heap_held(void)
+{
+    HeapStats_t heap;
+
+    vPortGetHeapStats (&heap);
+    return heap.xNumberOfSuccessfulAllocations - heap.xNumberOfSuccessfulFrees;
+}
+
+/* Sorts the blocks by address and tells whether any two of them overlap */
+static bool mem_pool_host_distinct(uint32_t count)
+{
+    for (uint32_t i = 1U; i < count; i++)
+    {
+        for (uint32_t j = i; (j > 0U) && ((uintptr_t) g_blocks[j - 1U] > (uintptr_t) g_blocks[j]); j--)
+        {
+            void * p_block = g_blocks[j];
+            uint32_t size = g_sizes[j];
+
+            g_blocks[j]      = g_blocks[j - 1U];
+            g_sizes[j]       = g_sizes[j - 1U];
+            g_blocks[j - 1U] = p_block;
+            g_sizes[j - 1U]  = size;
+        }
+    }
+    for (uint32_t i = 1U; i < count; i++)
+    {
+        if (((uintptr_t) g_blocks[i - 1U] + g_sizes[i - 1U]) > (uintptr_t) g_blocks[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Takes every block of the TLS pool in one session: the free lists survived the relayouts of the stress */
+static bool mem_pool_host_tls_blocks(void)
+{
+    size_t held = mem_pool_host_heap_held ();
+    uint32_t count = RESET_VALUE;
+    bool ok = false;
+
+    mem_pool_session_begin ();
+    for (uint32_t c = 0; c < (sizeof(g_tls_classes) / sizeof(g_tls_classes[0])); c++)
+    {
+        for (uint32_t i = 0; (i < g_tls_classes[c].blocks) && (count < MEM_POOL_HOST_BLOCKS_MAX); i++)
+        {
+            g_sizes[count]    = g_tls_classes[c].block_size;
+            g_blocks[count++] = g_host_mbedtls_calloc (1U, g_tls_classes[c].block_size);
+        }
+    }
+    ok = (held == mem_pool_host_heap_held ()) && mem_pool_host_distinct (count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        g_host_mbedtls_free (g_blocks[i]);
+    }
+    mem_pool_session_end ();
+
+    printf ("TLS pool: %u blocks taken again, %s\n", count, ok ? "distinct and none from the heap" : "FAILED");
+    return ok;
+}
+
+/* Two blocks more than every PKCS#11 class has, freed in the reverse order */
+static bool mem_pool_host_pkcs11_fallback(void)
+{
+    size_t held = mem_pool_host_heap_held ();
+    uint32_t count = RESET_VALUE;
+    bool ok = true;
+
+    for (uint32_t c = 0; c < (sizeof(g_pkcs11_classes) / sizeof(g_pkcs11_classes[0])); c++)
+    {
+        for (uint32_t i = 0; (i < (g_pkcs11_classes[c].blocks + 2U)) && (count < MEM_POOL_HOST_BLOCKS_MAX); i++)
+        {
+            g_blocks[count] = mem_pool_pkcs11_malloc (g_pkcs11_classes[c].block_size);
+            if (NULL == g_blocks[count])
+            {
+                ok = false;
+                continue;
+            }
+            memset (g_blocks[count++], 0x5A, g_pkcs11_classes[c].block_size);
+        }
+    }
+    ok = ok && (mem_pool_host_heap_held () > held);
+    while (0U != count)
+    {
+        mem_pool_pkcs11_free (g_blocks[--count]);
+    }
+    ok = ok && (mem_pool_host_heap_held () == held);
+
+    printf ("PKCS#11 pool: heap fallbacks %s\n", ok ? "given back" : "FAILED");
+    return ok;
+}
+
+int main(int argc, char * argv[])
+{
+    uint32_t reconnects = (argc > 1) ? (uint32_t) strtoul (argv[1], NULL, 0) : MEM_POOL_STRESS_RECONNECTS;
+    heap_trace_stats_t tls;
+    heap_trace_stats_t pkcs11;
+    HeapStats_t heap;
+    void * p_cached = NULL;
+    bool ok = false;
+
+    if ((FSP_SUCCESS != mem_pool_init ()) || (mem_pool_tls_calloc != g_host_mbedtls_calloc) ||
+        (mem_pool_tls_free != g_host_mbedtls_free))
+    {
+        printf ("pool not installed as the mbedTLS allocator\n");
+        return 1;
+    }
+
+    /* Allocated outside a session, so it comes from the heap and stays there across the reconnects */
+    p_cached = g_host_mbedtls_calloc (1U, MEM_POOL_HOST_CACHED_SIZE);
+    ok       = (NULL != p_cached) && (FSP_SUCCESS == mem_pool_stress (reconnects));
+    ok       = mem_pool_host_tls_blocks () && ok;
+    ok       = mem_pool_host_pkcs11_fallback () && ok;
+    g_host_mbedtls_free (p_cached);
+
+    mem_pool_print_stats ();
+    heap_trace_get_stats (HEAP_TRACE_TAG_TLS, &tls);
+    heap_trace_get_stats (HEAP_TRACE_TAG_PKCS11, &pkcs11);
+    vPortGetHeapStats (&heap);
+    ok = ok && (0U == tls.pooled) && (0U == pkcs11.pooled) && (0U == mem_pool_host_heap_held ()) &&
+         (1U == heap.xNumberOfFreeBlocks);
+
+    printf ("\n%s,reconnects,heap_held,free_blocks,largest_free,result\n", MEM_POOL_HOST_TAG);
+    printf ("%s,%u,%u,%u,%u,%s\n", MEM_POOL_HOST_TAG, reconnects, (uint32_t) mem_pool_host_heap_held (),
+            (uint32_t) heap.xNumberOfFreeBlocks, (uint32_t) heap.xSizeOfLargestFreeBlockInBytes, ok ? "pass" : "FAIL");
+    return ok ? 0 : 1;
+}
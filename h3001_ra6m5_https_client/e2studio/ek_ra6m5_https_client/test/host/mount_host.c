@@ -0,0 +1,105 @@
+/***********************************************************************************************************************
+ * File Name    : mount_host.c
+ * Description  : Host test of the LittleFS start of littlefs_app.c on the RAM device: formatting only as recovery, a
+ *                mount that keeps the data of the previous boot, the application superblock and the boot counter,
+ *                and a write error at boot that must not format. Every case resets the port as a reboot does and
+ *                prints one comma separated line:
+ *                  #MOUNTHOST,<case>,<result>,<boot count>,<flash_us>,<erases>
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#include "common_utils.h"
+#include "littlefs_app.h"
+#include "littlefs_bench.h"
+
+#define MOUNT_HOST_FILE                 "/mount_host"
+#define MOUNT_HOST_TAG                  "#MOUNTHOST"
+
+static const uint8_t g_marker[] = "kept across boots";
+
+/* Reboot, start LittleFS as app_startup.c does and report the case. cut_after fails the programs and erases from that
+ * one on, 0 for none */
+static bool mount_host_boot(const char * p_case, uint32_t expected_boot, uint32_t cut_after)
+{
+    littlefs_bench_counters_t before;
+    littlefs_bench_counters_t after;
+    fsp_err_t err = FSP_SUCCESS;
+
+    rm_littlefs_host_power_on (cut_after);
+    littlefs_bench_device_counters (&before);
+    err = hal_littlefs_init ();
+    littlefs_bench_device_counters (&after);
+
+    printf ("\n%s,%s,%s,%u,%u,%u\n", MOUNT_HOST_TAG, p_case,
+            ((FSP_SUCCESS == err) && (expected_boot == hal_littlefs_boot_count ())) ? "ok" : "FAILED",
+            hal_littlefs_boot_count (), (uint32_t) (after.flash_us - before.flash_us), after.erases - before.erases);
+    return (FSP_SUCCESS == err) && (expected_boot == hal_littlefs_boot_count ());
+}
+
+/* Tells whether the marker file written on an earlier boot is there */
+static bool mount_host_marker_kept(void)
+{
+    lfs_file_t file;
+    uint8_t data[sizeof(g_marker)];
+    lfs_ssize_t len = RESET_VALUE;
+
+    if (LFS_ERR_OK != lfs_file_open (&g_rm_littlefs0_lfs, &file, MOUNT_HOST_FILE, LFS_O_RDONLY))
+    {
+        return false;
+    }
+    len = lfs_file_read (&g_rm_littlefs0_lfs, &file, data, sizeof(data));
+    (void) lfs_file_close (&g_rm_littlefs0_lfs, &file);
+    return ((lfs_ssize_t) sizeof(data) == len) && (0 == memcmp (data, g_marker, sizeof(data)));
+}
+
+static bool mount_host_write(const char * p_path, const void * p_data, uint32_t size)
+{
+    lfs_file_t file;
+    lfs_ssize_t len = RESET_VALUE;
+
+    if (LFS_ERR_OK != lfs_file_open (&g_rm_littlefs0_lfs, &file, p_path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC))
+    {
+        return false;
+    }
+    len = lfs_file_write (&g_rm_littlefs0_lfs, &file, p_data, size);
+    return (LFS_ERR_OK == lfs_file_close (&g_rm_littlefs0_lfs, &file)) && ((lfs_ssize_t) size == len);
+}
+
+int main(void)
+{
+    littlefs_app_sb_t sb = {.magic = LITTLEFS_APP_SB_MAGIC, .layout_version = LITTLEFS_APP_LAYOUT_VERSION + 1U};
+    bool ok = true;
+
+    printf ("%s,case,result,boot,flash_us,erases\n", MOUNT_HOST_TAG);
+
+    /* Blank data flash: the mount fails and formatting recovers it */
+    rm_littlefs_host_attach ();
+    ok = mount_host_boot ("blank", 1U, 0U) && mount_host_write (MOUNT_HOST_FILE, g_marker, sizeof(g_marker));
+
+    /* Reboots mount the file system as it is, no format */
+    ok = ok && mount_host_boot ("reboot", 2U, 0U) && mount_host_marker_kept ();
+    ok = ok && mount_host_boot ("reboot", 3U, 0U) && mount_host_marker_kept ();
+
+    /* Application superblock of another layout: formatted, the old files are gone */
+    ok = ok && mount_host_write (LITTLEFS_APP_SB_FILE_NAME, &sb, sizeof(sb));
+    ok = ok && mount_host_boot ("layout", 1U, 0U) && !mount_host_marker_kept ();
+
+    /* Data flash overwritten by something else: formatted */
+    ok = ok && mount_host_write (MOUNT_HOST_FILE, g_marker, sizeof(g_marker));
+    memset (littlefs_bench_device_ram (), 0, LITTLEFS_BENCH_DEVICE_SIZE);
+    ok = ok && mount_host_boot ("corrupt", 1U, 0U) && !mount_host_marker_kept ();
+
+    /* And the next boot mounts again */
+    ok = ok && mount_host_boot ("reboot", 2U, 0U) && mount_host_write (MOUNT_HOST_FILE, g_marker, sizeof(g_marker));
+
+    /* The boot counter cannot be written: no format, the boot is not counted and the next one goes on from 2 */
+    ok = ok && mount_host_boot ("write_error", 0U, 1U);
+    ok = ok && mount_host_boot ("reboot", 3U, 0U) && mount_host_marker_kept ();
+
+    printf ("%s,end,%s\n", MOUNT_HOST_TAG, ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+/***********************************************************************************************************************
+ * File Name    : FreeRTOS.h
+ * Description  : Host stand-in for FreeRTOS.h, the types and macros of the kernel the host builds use, and the heap
+ *                functions of portable.h, served by the heap_4 model of heap_host.c
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define configTICK_RATE_HZ              (1000U)
+#define portTICK_PERIOD_MS              (1000U / configTICK_RATE_HZ)
+#define portMAX_DELAY                   ((TickType_t) 0xFFFFFFFFUL)
+#define pdFALSE                         ((BaseType_t) 0)
+#define pdTRUE                          ((BaseType_t) 1)
+#define pdPASS                          (pdTRUE)
+#define pdFAIL                          (pdFALSE)
+#define pdMS_TO_TICKS(ms)               ((TickType_t) (((uint64_t) (ms) * configTICK_RATE_HZ) / 1000U))
+#define configTOTAL_HEAP_SIZE           (0x20000U)  /* configuration.xml */
+
+typedef struct xHeapStats
+{
+    size_t xAvailableHeapSpaceInBytes;
+    size_t xSizeOfLargestFreeBlockInBytes;
+    size_t xSizeOfSmallestFreeBlockInBytes;
+    size_t xNumberOfFreeBlocks;
+    size_t xMinimumEverFreeBytesRemaining;
+    size_t xNumberOfSuccessfulAllocations;
+    size_t xNumberOfSuccessfulFrees;
+} HeapStats_t;
+
+void * pvPortMalloc(size_t xWantedSize);
+void vPortFree(void * pv);
+size_t xPortGetFreeHeapSize(void);
+void vPortGetHeapStats(HeapStats_t * pxHeapStats);
+
+#endif /* INC_FREERTOS_H */
@@ -0,0 +1,16 @@
+/***********************************************************************************************************************
+ * File Name    : FreeRTOS_DHCP.h
+ * Description  : Host stand-in for FreeRTOS_DHCP.h, included by user_app.h and not used by the host builds
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef FREERTOS_DHCP_H
+#define FREERTOS_DHCP_H
+
+#include "FreeRTOS.h"
+
+#endif /* FREERTOS_DHCP_H */
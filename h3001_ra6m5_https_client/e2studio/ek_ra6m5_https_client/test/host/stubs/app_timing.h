@@ -0,0 +1,43 @@
+/***********************************************************************************************************************
+ * File Name    : app_timing.h
+ * Description  : Host stand-in for app_timing.h, a "cycle" is one nanosecond of the monotonic clock. With
+ *                APP_HOST_FLASH_TIME the data flash time modelled by the RAM device of littlefs_bench.c is added, so
+ *                the timings the modules print include the flash as on the target
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef APP_TIMING_H_
+#define APP_TIMING_H_
+
+#include <time.h>
+#include "hal_data.h"
+#ifdef APP_HOST_FLASH_TIME
+ #include "littlefs_bench.h"
+#endif
+
+#define APP_TIMING_CYCLES_TO_US(cycles)     ((uint32_t) ((cycles) / 1000U))
+
+static inline void app_timing_init(void)
+{
+}
+
+static inline uint32_t app_timing_cycles(void)
+{
+    struct timespec now;
+    uint64_t flash_ns = 0;
+
+#ifdef APP_HOST_FLASH_TIME
+    littlefs_bench_counters_t counters;
+
+    littlefs_bench_device_counters (&counters);
+    flash_ns = counters.flash_us * 1000ULL;
+#endif
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (uint32_t) (((uint64_t) now.tv_sec * 1000000000ULL) + (uint64_t) now.tv_nsec + flash_ns);
+}
+
+#endif /* APP_TIMING_H_ */
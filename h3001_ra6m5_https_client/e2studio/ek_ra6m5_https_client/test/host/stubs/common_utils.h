@@ -0,0 +1,24 @@
+/***********************************************************************************************************************
+ * File Name    : common_utils.h
+ * Description  : Host stand-in for common_utils.h, the console print macros go to stdout
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef COMMON_UTILS_H_
+#define COMMON_UTILS_H_
+
+#include "hal_data.h"
+
+#define RESET_VALUE                     (0x00)
+
+#define APP_PRINT(...)                  printf (__VA_ARGS__)
+#define APP_ERR_PRINT(...)              printf (__VA_ARGS__)
+#define APP_WARN_PRINT(...)             printf (__VA_ARGS__)
+#define APP_INFO_PRINT(...)             printf (__VA_ARGS__)
+#define APP_DBG_PRINT(...)              do { } while (0)
+
+#endif /* COMMON_UTILS_H_ */
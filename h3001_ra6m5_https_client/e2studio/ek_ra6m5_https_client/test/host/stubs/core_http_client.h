@@ -0,0 +1,29 @@
+/***********************************************************************************************************************
+ * File Name    : core_http_client.h
+ * Description  : Host stand-in for core_http_client.h, the types user_app.h declares its functions with
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef CORE_HTTP_CLIENT_H_
+#define CORE_HTTP_CLIENT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum HTTPStatus
+{
+    HTTPSuccess = 0,
+} HTTPStatus_t;
+
+typedef struct HTTPRequestHeaders
+{
+    uint8_t * pBuffer;
+    size_t bufferLen;
+    size_t headersLen;
+} HTTPRequestHeaders_t;
+
+#endif /* CORE_HTTP_CLIENT_H_ */
@@ -0,0 +1,39 @@
+/***********************************************************************************************************************
+ * File Name    : credential_cache_host.c
+ * Description  : Host stand-in for the DRBG of credential_cache.c, seeded from the mbedTLS entropy sources of the host
+ *                as the target seeds it from its own. The credentials themselves are not cached on the host
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#include "mbedtls/entropy.h"
+#include "credential_cache.h"
+
+static mbedtls_entropy_context g_entropy;
+static mbedtls_ctr_drbg_context g_ctr_drbg;
+
+fsp_err_t credential_cache_init(void)
+{
+    mbedtls_entropy_init (&g_entropy);
+    mbedtls_ctr_drbg_init (&g_ctr_drbg);
+    if (0 != mbedtls_ctr_drbg_seed (&g_ctr_drbg, mbedtls_entropy_func, &g_entropy, NULL, 0))
+    {
+        credential_cache_deinit ();
+        return FSP_ERR_ASSERTION;
+    }
+    return FSP_SUCCESS;
+}
+
+void credential_cache_deinit(void)
+{
+    mbedtls_ctr_drbg_free (&g_ctr_drbg);
+    mbedtls_entropy_free (&g_entropy);
+}
+
+mbedtls_ctr_drbg_context * credential_cache_rng(void)
+{
+    return &g_ctr_drbg;
+}
@@ -0,0 +1,13 @@
+/***********************************************************************************************************************
+ * File Name    : freertos_host.c
+ * Description  : Host stand-in for the kernel state the host builds read
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#include "task.h"
+
+TickType_t g_host_tick = 0;
@@ -0,0 +1,75 @@
+/***********************************************************************************************************************
+ * File Name    : hal_data.h
+ * Description  : Host stand-in for the FSP generated hal_data.h, just the types and error codes the host builds of the
+ *                application modules use. With APP_HOST_LITTLEFS the LittleFS instance of the data flash is declared
+ *                too, rm_littlefs_host.c puts it on the RAM device of littlefs_bench.c
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef HAL_DATA_H_
+#define HAL_DATA_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef enum e_fsp_err
+{
+    FSP_SUCCESS             = 0,
+    FSP_ERR_ASSERTION       = 1,
+    FSP_ERR_INVALID_POINTER = 2,
+    FSP_ERR_INVALID_ARGUMENT = 3,
+    FSP_ERR_NOT_OPEN        = 6,
+    FSP_ERR_IN_USE          = 7,
+    FSP_ERR_OUT_OF_MEMORY   = 8,
+    FSP_ERR_ALREADY_OPEN    = 9,
+    FSP_ERR_OVERFLOW        = 14,
+    FSP_ERR_NOT_FOUND       = 15,
+    FSP_ERR_INVALID_DATA    = 28,
+    FSP_ERR_INVALID_STATE   = 30,
+    FSP_ERR_WRITE_FAILED    = 104,
+    FSP_ERR_READ_FAILED     = 105,
+    FSP_ERR_NOT_ENABLED     = 500,
+} fsp_err_t;
+
+#define FSP_PARAMETER_NOT_USED(p)       (void) ((p))
+
+#define BSP_DATA_FLASH_SIZE_BYTES       (8192U)
+
+/* app_timing_cycles() counts nanoseconds on the host */
+#define SystemCoreClock                 (1000000000U)
+
+#ifdef APP_HOST_LITTLEFS
+ #include "lfs.h"
+
+typedef struct st_rm_littlefs_flash_instance_ctrl
+{
+    uint32_t open;
+} rm_littlefs_flash_instance_ctrl_t;
+
+typedef struct st_rm_littlefs_cfg
+{
+    struct lfs_config const * p_lfs_cfg;
+} rm_littlefs_cfg_t;
+
+extern lfs_t g_rm_littlefs0_lfs;
+extern struct lfs_config g_rm_littlefs0_lfs_cfg;
+extern rm_littlefs_flash_instance_ctrl_t g_rm_littlefs0_ctrl;
+extern const rm_littlefs_cfg_t g_rm_littlefs0_cfg;
+
+fsp_err_t RM_LITTLEFS_FLASH_Open(rm_littlefs_flash_instance_ctrl_t * const p_ctrl,
+                                rm_littlefs_cfg_t const * const                p_cfg);
+fsp_err_t RM_LITTLEFS_FLASH_Close(rm_littlefs_flash_instance_ctrl_t * const p_ctrl);
+
+/* Host only: a blank device, and power back on after a reset with an optional cut armed */
+void rm_littlefs_host_attach(void);
+void rm_littlefs_host_power_on(uint32_t cut_after);
+#endif
+
+#endif /* HAL_DATA_H_ */
@@ -0,0 +1,184 @@
+/***********************************************************************************************************************
+ * File Name    : heap_host.c
+ * Description  : Host stand-in for the FreeRTOS heap. The blocks come from malloc(), so AddressSanitizer sees every
+ *                overrun and LeakSanitizer every block left at exit, while a model of heap_4 places them in a heap of
+ *                configTOTAL_HEAP_SIZE bytes: first fit in address order, an 8 byte header per block, splitting and
+ *                merging of free blocks as heap_4 does them. vPortGetHeapStats() reports that model, so free space,
+ *                largest free block and number of free blocks show the fragmentation the target heap would have.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+
+#define HEAP_HOST_HEADER                (8U)        /* BlockLink_t of a 32 bit port */
+#define HEAP_HOST_ALIGNMENT             (8U)        /* portBYTE_ALIGNMENT */
+#define HEAP_HOST_MIN_BLOCK             (2U * HEAP_HOST_HEADER)
+#define HEAP_HOST_SIZE                  (configTOTAL_HEAP_SIZE - HEAP_HOST_HEADER)  /* Less the end marker */
+#define HEAP_HOST_FREE_MAX              (512U)
+#define HEAP_HOST_USED_MAX              (1024U)
+
+typedef struct st_heap_host_range
+{
+    size_t offset;
+    size_t size;
+} heap_host_range_t;
+
+typedef struct st_heap_host_block
+{
+    void * p_block;                     /* From malloc() */
+    heap_host_range_t range;            /* Its place in the modelled heap, header included */
+} heap_host_block_t;
+
+/* Free blocks in address order, one free block spanning the heap at start */
+static heap_host_range_t g_free[HEAP_HOST_FREE_MAX] = {{0U, HEAP_HOST_SIZE}};
+static size_t g_free_count = 1U;
+static heap_host_block_t g_used[HEAP_HOST_USED_MAX];
+static size_t g_used_count = 0U;
+static size_t g_free_bytes = HEAP_HOST_SIZE;
+static size_t g_free_low = HEAP_HOST_SIZE;
+static size_t g_allocs = 0U;
+static size_t g_frees = 0U;
+
+/* The model ran out of table space, which says nothing about the target heap: stop the test */
+static void heap_host_abort(const char * p_what)
+{
+    fprintf (stderr, "heap_host: %s table full\n", p_what);
+    abort ();
+}
+
+void * pvPortMalloc(size_t xWantedSize)
+{
+    size_t wanted = xWantedSize + HEAP_HOST_HEADER;
+    size_t i = 0U;
+
+    if ((0U == xWantedSize) || (wanted < xWantedSize))
+    {
+        return NULL;
+    }
+    wanted = (wanted + (HEAP_HOST_ALIGNMENT - 1U)) & ~((size_t) HEAP_HOST_ALIGNMENT - 1U);
+
+    while ((i < g_free_count) && (g_free[i].size < wanted))
+    {
+        i++;
+    }
+    if (i == g_free_count)
+    {
+        return NULL;
+    }
+    if (HEAP_HOST_USED_MAX == g_used_count)
+    {
+        heap_host_abort ("block");
+    }
+
+    g_used[g_used_count].range.offset = g_free[i].offset;
+    g_used[g_used_count].range.size   = wanted;
+    if ((g_free[i].size - wanted) > HEAP_HOST_MIN_BLOCK)
+    {
+        g_free[i].offset += wanted;
+        g_free[i].size   -= wanted;
+    }
+    else
+    {
+        g_used[g_used_count].range.size = g_free[i].size;
+        memmove (&g_free[i], &g_free[i + 1U], (g_free_count - i - 1U) * sizeof(g_free[0]));
+        g_free_count--;
+    }
+
+    g_used[g_used_count].p_block = malloc (xWantedSize);
+    if (NULL == g_used[g_used_count].p_block)
+    {
+        heap_host_abort ("host");
+    }
+    g_free_bytes -= g_used[g_used_count].range.size;
+    g_free_low    = (g_free_bytes < g_free_low) ? g_free_bytes : g_free_low;
+    g_allocs++;
+    return g_used[g_used_count++].p_block;
+}
+
+void vPortFree(void * pv)
+{
+    heap_host_range_t range;
+    size_t u = 0U;
+    size_t i = 0U;
+
+    if (NULL == pv)
+    {
+        return;
+    }
+    while ((u < g_used_count) && (g_used[u].p_block != pv))
+    {
+        u++;
+    }
+    if (u == g_used_count)
+    {
+        /* Not from pvPortMalloc(): free() lets AddressSanitizer report it */
+        free (pv);
+        return;
+    }
+    range        = g_used[u].range;
+    g_used[u]    = g_used[--g_used_count];
+    g_free_bytes += range.size;
+    g_frees++;
+    free (pv);
+
+    /* Insert in address order and merge with the neighbours, as prvInsertBlockIntoFreeList() */
+    while ((i < g_free_count) && (g_free[i].offset < range.offset))
+    {
+        i++;
+    }
+    if ((i > 0U) && ((g_free[i - 1U].offset + g_free[i - 1U].size) == range.offset))
+    {
+        g_free[i - 1U].size += range.size;
+        if ((i < g_free_count) && ((range.offset + range.size) == g_free[i].offset))
+        {
+            g_free[i - 1U].size += g_free[i].size;
+            memmove (&g_free[i], &g_free[i + 1U], (g_free_count - i - 1U) * sizeof(g_free[0]));
+            g_free_count--;
+        }
+    }
+    else if ((i < g_free_count) && ((range.offset + range.size) == g_free[i].offset))
+    {
+        g_free[i].offset = range.offset;
+        g_free[i].size  += range.size;
+    }
+    else
+    {
+        if (HEAP_HOST_FREE_MAX == g_free_count)
+        {
+            heap_host_abort ("free block");
+        }
+        memmove (&g_free[i + 1U], &g_free[i], (g_free_count - i) * sizeof(g_free[0]));
+        g_free[i] = range;
+        g_free_count++;
+    }
+}
+
+size_t xPortGetFreeHeapSize(void)
+{
+    return g_free_bytes;
+}
+
+void vPortGetHeapStats(HeapStats_t * pxHeapStats)
+{
+    memset (pxHeapStats, 0, sizeof(*pxHeapStats));
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = (0U != g_free_count) ? SIZE_MAX : 0U;
+    for (size_t i = 0U; i < g_free_count; i++)
+    {
+        pxHeapStats->xSizeOfLargestFreeBlockInBytes  = (g_free[i].size > pxHeapStats->xSizeOfLargestFreeBlockInBytes) ?
+                                                       g_free[i].size : pxHeapStats->xSizeOfLargestFreeBlockInBytes;
+        pxHeapStats->xSizeOfSmallestFreeBlockInBytes = (g_free[i].size < pxHeapStats->xSizeOfSmallestFreeBlockInBytes) ?
+                                                       g_free[i].size : pxHeapStats->xSizeOfSmallestFreeBlockInBytes;
+    }
+    pxHeapStats->xAvailableHeapSpaceInBytes      = g_free_bytes;
+    pxHeapStats->xNumberOfFreeBlocks             = g_free_count;
+    pxHeapStats->xMinimumEverFreeBytesRemaining  = g_free_low;
+    pxHeapStats->xNumberOfSuccessfulAllocations  = g_allocs;
+    pxHeapStats->xNumberOfSuccessfulFrees        = g_frees;
+}
@@ -0,0 +1,66 @@
+/***********************************************************************************************************************
+ * File Name    : heap_trace_host.c
+ * Description  : Host stand-in for heap_trace.c and the allocator hook of mbedTLS. The heap wrappers go straight to
+ *                the FreeRTOS heap, and the bytes held per subsystem are counted as heap_trace.c counts them, so a
+ *                test can check that a subsystem holds nothing once it is done. No trace is recorded
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#include <string.h>
+#include "FreeRTOS.h"
+#include "mbedtls/platform.h"
+#include "heap_trace.h"
+
+void * (* g_host_mbedtls_calloc)(size_t count, size_t size) = NULL;
+void (* g_host_mbedtls_free)(void * p_block) = NULL;
+
+static heap_trace_stats_t g_stats[HEAP_TRACE_TAG_COUNT];
+
+int mbedtls_platform_set_calloc_free(void * (*calloc_func)(size_t, size_t), void (* free_func)(void *))
+{
+    g_host_mbedtls_calloc = calloc_func;
+    g_host_mbedtls_free   = free_func;
+    return 0;
+}
+
+/* Only the pool blocks are counted in current, the heap model keeps the figures of the heap blocks */
+void * heap_trace_malloc(heap_trace_tag_t tag, size_t size)
+{
+    void * p_block = pvPortMalloc (size);
+
+    g_stats[tag].allocs += (NULL != p_block) ? 1U : 0U;
+    g_stats[tag].failed += (NULL == p_block) ? 1U : 0U;
+    return p_block;
+}
+
+void heap_trace_free(void * p_block)
+{
+    vPortFree (p_block);
+}
+
+void heap_trace_pool_event(heap_trace_tag_t tag, heap_trace_op_t op, void * p_block, uint32_t size)
+{
+    (void) p_block;
+    if (HEAP_TRACE_OP_POOL_TAKE == op)
+    {
+        g_stats[tag].current += size;
+        g_stats[tag].pooled  += size;
+        g_stats[tag].peak     = (g_stats[tag].current > g_stats[tag].peak) ? g_stats[tag].current : g_stats[tag].peak;
+        g_stats[tag].allocs++;
+    }
+    else if (HEAP_TRACE_OP_POOL_GIVE == op)
+    {
+        g_stats[tag].current -= size;
+        g_stats[tag].pooled  -= size;
+        g_stats[tag].frees++;
+    }
+}
+
+void heap_trace_get_stats(heap_trace_tag_t tag, heap_trace_stats_t * p_stats)
+{
+    memcpy (p_stats, &g_stats[tag], sizeof(*p_stats));
+}
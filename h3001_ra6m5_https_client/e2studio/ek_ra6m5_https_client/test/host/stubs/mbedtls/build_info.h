@@ -0,0 +1,19 @@
+/***********************************************************************************************************************
+ * File Name    : build_info.h
+ * Description  : Host stand-in for mbedtls/build_info.h, the options of the mbedTLS configuration of configuration.xml
+ *                that the modules built on the host read. The content lengths are left at their default there
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef MBEDTLS_BUILD_INFO_H
+#define MBEDTLS_BUILD_INFO_H
+
+#define MBEDTLS_PLATFORM_MEMORY
+#define MBEDTLS_SSL_IN_CONTENT_LEN      (16384)
+#define MBEDTLS_SSL_OUT_CONTENT_LEN     (16384)
+
+#endif /* MBEDTLS_BUILD_INFO_H */
@@ -0,0 +1,23 @@
+/***********************************************************************************************************************
+ * File Name    : platform.h
+ * Description  : Host stand-in for mbedtls/platform.h. mbedtls_platform_set_calloc_free() records the allocator in
+ *                g_host_mbedtls_calloc and g_host_mbedtls_free for the test to check and call
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef MBEDTLS_PLATFORM_H
+#define MBEDTLS_PLATFORM_H
+
+#include <stddef.h>
+#include "mbedtls/build_info.h"
+
+extern void * (* g_host_mbedtls_calloc)(size_t count, size_t size);
+extern void (* g_host_mbedtls_free)(void * p_block);
+
+int mbedtls_platform_set_calloc_free(void * (*calloc_func)(size_t, size_t), void (* free_func)(void *));
+
+#endif /* MBEDTLS_PLATFORM_H */
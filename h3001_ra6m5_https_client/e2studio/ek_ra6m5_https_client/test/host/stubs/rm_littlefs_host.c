@@ -0,0 +1,73 @@
+/***********************************************************************************************************************
+ * File Name    : rm_littlefs_host.c
+ * Description  : Host stand-in for the LittleFS on Flash port. g_rm_littlefs0 is put on the RAM device of
+ *                littlefs_bench.c with the geometry of configuration.xml, so the application modules run their own
+ *                file system code on the host, with the data flash timing model and power cuts of the benchmark.
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#include "common_utils.h"
+#include "littlefs_bench.h"
+
+/* g_rm_littlefs0 in configuration.xml: block 128, cache 64, lookahead 16 */
+#define RM_LITTLEFS_HOST_GEOMETRY       {128U, 64U, 16U}
+
+lfs_t g_rm_littlefs0_lfs;
+struct lfs_config g_rm_littlefs0_lfs_cfg;
+rm_littlefs_flash_instance_ctrl_t g_rm_littlefs0_ctrl;
+const rm_littlefs_cfg_t g_rm_littlefs0_cfg = {.p_lfs_cfg = &g_rm_littlefs0_lfs_cfg};
+
+/* The port callbacks are copied once: littlefs_app.c replaces the erase callback after the first open, as on the
+ * target where the configuration is a static of hal_data.c */
+void rm_littlefs_host_attach(void)
+{
+    static const littlefs_bench_geometry_t geometry = RM_LITTLEFS_HOST_GEOMETRY;
+    static bool attached = false;
+    const struct lfs_config * p_cfg = littlefs_bench_device_init (&geometry);
+
+    if (!attached)
+    {
+        g_rm_littlefs0_lfs_cfg = *p_cfg;
+        attached = true;
+    }
+    rm_littlefs_host_power_on (RESET_VALUE);
+}
+
+/* A reset: the port is closed and the lfs_t of the earlier mount is abandoned, the device keeps its content */
+void rm_littlefs_host_power_on(uint32_t cut_after)
+{
+    memset (&g_rm_littlefs0_lfs, 0, sizeof(g_rm_littlefs0_lfs));
+    g_rm_littlefs0_ctrl.open = RESET_VALUE;
+    littlefs_bench_device_cut (cut_after);
+}
+
+fsp_err_t RM_LITTLEFS_FLASH_Open(rm_littlefs_flash_instance_ctrl_t * const p_ctrl,
+                                rm_littlefs_cfg_t const * const                p_cfg)
+{
+    if ((NULL == p_ctrl) || (NULL == p_cfg) || (NULL == g_rm_littlefs0_lfs_cfg.read))
+    {
+        return FSP_ERR_ASSERTION;
+    }
+    if (RESET_VALUE != p_ctrl->open)
+    {
+        return FSP_ERR_ALREADY_OPEN;
+    }
+    p_ctrl->open = 1U;
+
+    return FSP_SUCCESS;
+}
+
+fsp_err_t RM_LITTLEFS_FLASH_Close(rm_littlefs_flash_instance_ctrl_t * const p_ctrl)
+{
+    if (RESET_VALUE == p_ctrl->open)
+    {
+        return FSP_ERR_NOT_OPEN;
+    }
+    p_ctrl->open = RESET_VALUE;
+
+    return FSP_SUCCESS;
+}
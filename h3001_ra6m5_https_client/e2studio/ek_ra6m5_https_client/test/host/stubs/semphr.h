@@ -0,0 +1,27 @@
+/***********************************************************************************************************************
+ * File Name    : semphr.h
+ * Description  : Host stand-in for semphr.h, the host builds are single threaded so a mutex is always free
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+
+#include "FreeRTOS.h"
+
+typedef struct st_host_semaphore
+{
+    uint32_t taken;
+} StaticSemaphore_t;
+
+typedef StaticSemaphore_t * SemaphoreHandle_t;
+
+#define xSemaphoreCreateMutexStatic(p_mem)  (p_mem)
+#define xSemaphoreTake(mutex, ticks)        ((void) (mutex), (void) (ticks), pdTRUE)
+#define xSemaphoreGive(mutex)               ((void) (mutex), pdTRUE)
+
+#endif /* SEMAPHORE_H */
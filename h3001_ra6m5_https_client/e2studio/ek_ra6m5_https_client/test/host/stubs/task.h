@@ -0,0 +1,78 @@
+/***********************************************************************************************************************
+ * File Name    : task.h
+ * Description  : Host stand-in for task.h. The tick count is g_host_tick, advanced by the test. A created task gets a
+ *                handle but never runs, the test calls what it would do; notifications and critical sections do nothing
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef INC_TASK_H
+#define INC_TASK_H
+
+#include <stddef.h>
+#include <time.h>
+#include "FreeRTOS.h"
+
+typedef void * TaskHandle_t;
+typedef void (* TaskFunction_t)(void * pvParameters);
+
+#define taskENTER_CRITICAL()            do { } while (0)
+#define taskEXIT_CRITICAL()             do { } while (0)
+
+extern TickType_t g_host_tick;
+
+/* With APP_HOST_WALL_TICKS the tick count follows the monotonic clock too, for code timing itself in ticks */
+static inline TickType_t xTaskGetTickCount(void)
+{
+#ifdef APP_HOST_WALL_TICKS
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return g_host_tick + (TickType_t) (((uint64_t) now.tv_sec * configTICK_RATE_HZ) +
+                                       (((uint64_t) now.tv_nsec * configTICK_RATE_HZ) / 1000000000U));
+#else
+    return g_host_tick;
+#endif
+}
+
+static inline void vTaskDelay(TickType_t ticks)
+{
+    g_host_tick += ticks;
+}
+
+static inline TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return NULL;
+}
+
+static inline BaseType_t xTaskCreate(TaskFunction_t task, const char * p_name, uint32_t stack, void * p_param,
+                                     UBaseType_t priority, TaskHandle_t * p_task)
+{
+    static uint32_t handle;
+
+    (void) task;
+    (void) p_name;
+    (void) stack;
+    (void) p_param;
+    (void) priority;
+    *p_task = &handle;
+    return pdPASS;
+}
+
+static inline BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    (void) task;
+    return pdPASS;
+}
+
+static inline uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks)
+{
+    (void) clear;
+    (void) ticks;
+    return 0U;
+}
+
+#endif /* INC_TASK_H */
@@ -0,0 +1,19 @@
+/***********************************************************************************************************************
+ * File Name    : transport_mbedtls_pkcs11.h
+ * Description  : Host stand-in for transport_mbedtls_pkcs11.h, the type user_app.h declares its functions with
+ ***********************************************************************************************************************/
+/***********************************************************************************************************************
+* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+***********************************************************************************************************************/
+
+#ifndef TRANSPORT_MBEDTLS_PKCS11_H
+#define TRANSPORT_MBEDTLS_PKCS11_H
+
+typedef struct NetworkContext
+{
+    void * pParams;
+} NetworkContext_t;
+
+#endif /* TRANSPORT_MBEDTLS_PKCS11_H */
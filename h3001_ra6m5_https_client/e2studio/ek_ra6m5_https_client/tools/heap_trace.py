@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+#
+# SPDX-License-Identifier: BSD-3-Clause
+"""Decoder of the allocation trace the target streams on the RTT metrics channel after "mem trace on".
+
+Capture with tools/rtt_capture.py, which writes the trace records of the metrics channel to metrics_heap.bin, then
+decode them:
+
+    python3 tools/rtt_capture.py --out capture
+    python3 tools/heap_trace.py capture/metrics_heap.bin [--events] [--live] [--emit-c src/mem_pool_trace.h]
+
+Records are 3 little endian words: DWT cycles, block address, then size (bits 0-23), subsystem (bits 24-27) and
+operation (bits 28-31), see heap_trace.h. Prints one line per subsystem and, with --live, the blocks still allocated
+at the end of the capture, the leak candidates:
+    #HEAPTRACE,<subsystem>,<allocs>,<frees>,<failed>,<bytes held since the start>,<peak of them>
+    #HEAPTRACE,live,<subsystem>,<address>,<size>,<time us>
+
+--emit-c sizes the TLS pool from the TLS sessions of the capture and writes mem_pool_trace.h: the size classes, with
+one block of headroom over the peak of every class but the record buffers, the arena, and the session with the most
+bytes held as the trace the reconnect stress replays. Capture with MEM_POOL_ENABLE and "mem trace on" before a few
+reconnects ("post" or "get" after "mem trace on"), so the sessions include full handshakes. Prints per session and
+per class:
+    #HEAPTRACE,session,<index>,<allocations>,<blocks live at most>,<bytes requested at most>
+    #HEAPTRACE,class,<block size>,<blocks live at most>
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+TAG = "#HEAPTRACE"
+TAGS = ("app", "TLS", "PKCS#11", "TCP")
+OPS = {0: "malloc", 1: "free", 2: "failed", 3: "pool take", 4: "pool give", 5: "pool request", 6: "session",
+       15: "start"}
+RECORD = struct.Struct("<III")
+
+TAG_TLS = 1
+# Smaller classes of the TLS pool, a request above the largest goes to the record buffer class of mem_pool.h
+TLS_CLASSES = (32, 64, 128, 256, 512, 1024, 2048, 4096)
+RECORD_CLASS = "MEM_POOL_TLS_RECORD_SIZE"
+TRACE_SLOTS = 64                        # MEM_POOL_STRESS_LIVE_MAX
+
+
+class Session:
+    """Allocations and frees of one TLS session in slots, as MEM_POOL_TLS_TRACE holds them."""
+
+    def __init__(self):
+        self.entries = []               # ("alloc", slot, size) or ("free", slot)
+        self.slots = {}                 # Address of a live block to its slot
+        self.free_slots = []
+        self.used = 0
+        self.bytes = 0
+        self.peak_bytes = 0
+        self.sizes = {}                 # Slot to the requested size
+
+    def request(self, address, size):
+        if self.free_slots:
+            slot = min(self.free_slots)
+            self.free_slots.remove(slot)
+        else:
+            slot = self.used
+            self.used += 1
+        self.entries.append(("alloc", slot, size))
+        self.sizes[slot] = size
+        self.bytes += size
+        self.peak_bytes = max(self.peak_bytes, self.bytes)
+        if address:
+            self.slots[address] = slot
+        else:
+            self.entries.append(("free", slot))
+            self.release(slot)
+
+    def release(self, slot):
+        self.bytes -= self.sizes.pop(slot)
+        self.free_slots.append(slot)
+
+    def free(self, address):
+        slot = self.slots.pop(address, None)
+        if slot is not None:
+            self.entries.append(("free", slot))
+            self.release(slot)
+
+    def allocations(self):
+        return sum(1 for entry in self.entries if entry[0] == "alloc")
+
+
+def class_of(size):
+    """Smallest class the pool serves a request from when every class has a block free."""
+    return next((block for block in TLS_CLASSES if size <= block), RECORD_CLASS)
+
+
+def class_peaks(sessions):
+    """Blocks live at the same time in every class, over all sessions."""
+    peaks = {}
+    for session in sessions:
+        live = {}
+        sizes = {}
+        for entry in session.entries:
+            if entry[0] == "alloc":
+                sizes[entry[1]] = class_of(entry[2])
+                live[sizes[entry[1]]] = live.get(sizes[entry[1]], 0) + 1
+                peaks[sizes[entry[1]]] = max(peaks.get(sizes[entry[1]], 0), live[sizes[entry[1]]])
+            else:
+                live[sizes[entry[1]]] -= 1
+    return peaks
+
+
+def emit_c(path, capture, sessions):
+    """Writes mem_pool_trace.h: classes sized from the peaks, the session with the most bytes as the stress trace."""
+    peaks = class_peaks(sessions)
+    worst = max(range(len(sessions)), key=lambda i: sessions[i].peak_bytes)
+    classes = ["{%dU, %dU}" % (block, peaks[block] + 1) for block in TLS_CLASSES if block in peaks]
+    records = peaks.get(RECORD_CLASS, 0)
+    if records:
+        classes.append("{%s, %dU}" % (RECORD_CLASS, records))
+    fixed = sum(block * (peaks[block] + 1) for block in TLS_CLASSES if block in peaks)
+
+    trace = []
+    for entry in sessions[worst].entries:
+        if entry[0] == "free":
+            trace.append("MEM_POOL_TRACE_FREE(%d)" % entry[1])
+        else:
+            # Size 0 is a free in the trace, an empty request replays as 1 byte
+            size = RECORD_CLASS if class_of(entry[2]) == RECORD_CLASS else "%dU" % max(entry[2], 1)
+            trace.append("MEM_POOL_TRACE_ALLOC(%d, %s)" % (entry[1], size))
+
+    lines = ["/" + "*" * 119,
+             " * File Name    : mem_pool_trace.h",
+             " * Description  : TLS pool size classes and the TLS session the reconnect stress replays, written by",
+             " *                tools/heap_trace.py --emit-c from an allocation trace of the target. Do not edit,",
+             " *                capture again after changing the mbedTLS configuration, the credentials or the server",
+             " " + "*" * 119 + "/",
+             "/" + "*" * 119,
+             "* Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates",
+             "*",
+             "* SPDX-License-Identifier: BSD-3-Clause",
+             "*" * 119 + "/",
+             "",
+             "#ifndef MEM_POOL_TRACE_H_",
+             "#define MEM_POOL_TRACE_H_",
+             "",
+             "/* %s: %d TLS sessions, replayed session %d with %d allocations and at most %d bytes requested */"
+             % (os.path.basename(capture), len(sessions), worst, sessions[worst].allocations(),
+                sessions[worst].peak_bytes),
+             "#define MEM_POOL_TLS_TRACE_CAPTURED     (1)",
+             ""]
+    lines.append("#define MEM_POOL_TLS_CLASSES            { " + wrap(classes, 42) + " }")
+    lines.append("#define MEM_POOL_TLS_ARENA_SIZE         (%dU + (%dU * %s))" % (fixed, records, RECORD_CLASS))
+    lines.append("")
+    lines.append("#define MEM_POOL_TLS_TRACE              \\")
+    lines.append("{ \\")
+    lines.append("    " + wrap(trace, 4) + " \\")
+    lines.append("}")
+    lines.extend(["", "#endif /* MEM_POOL_TRACE_H_ */", ""])
+    with open(path, "w", encoding="utf-8") as header:
+        header.write("\n".join(lines))
+
+
+def wrap(items, indent):
+    """Joins the items with commas into lines of at most 120 characters, continued with a backslash."""
+    lines = [""]
+    for index, item in enumerate(items):
+        text = item + ", " if index < len(items) - 1 else item
+        if len(lines[-1]) + len(text) + indent + 2 > 118:
+            lines.append("")
+        lines[-1] += text
+    return (" \\\n" + " " * indent).join(line.rstrip() for line in lines)
+
+
+def decode(data):
+    """Yields (cycles, address, size, tag, op) for every whole record."""
+    for offset in range(0, len(data) - RECORD.size + 1, RECORD.size):
+        cycles, address, info = RECORD.unpack_from(data, offset)
+        yield cycles, address, info & 0xFFFFFF, (info >> 24) & 0xF, info >> 28
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", help="binary capture of the RTT channel")
+    parser.add_argument("--events", action="store_true", help="print every event")
+    parser.add_argument("--live", action="store_true", help="print the blocks not freed at the end of the capture")
+    parser.add_argument("--emit-c", metavar="HEADER", help="size the TLS pool from the capture, write mem_pool_trace.h")
+    args = parser.parse_args()
+
+    with open(args.capture, "rb") as capture:
+        data = capture.read()
+
+    clock = None
+    elapsed = 0
+    last = None
+    stats = {tag: {"allocs": 0, "frees": 0, "failed": 0, "bytes": 0, "peak": 0} for tag in range(len(TAGS))}
+    live = {}
+    sessions = []
+    session = None
+
+    for cycles, address, size, tag, op in decode(data):
+        if op == 15:
+            clock = address
+            last = cycles
+            continue
+        if clock is None or tag >= len(TAGS) or op not in OPS:
+            sys.exit("not a heap trace or out of sync: capture from the start record of \"mem trace on\"")
+        elapsed += (cycles - last) & 0xFFFFFFFF
+        last = cycles
+        time_us = elapsed * 1000000 // clock
+        entry = stats[tag]
+
+        if op in (0, 3):
+            entry["allocs"] += 1
+            entry["bytes"] += size
+            entry["peak"] = max(entry["peak"], entry["bytes"])
+            live[address] = (tag, size, time_us)
+        elif op in (1, 4):
+            entry["frees"] += 1
+            entry["bytes"] -= size
+            live.pop(address, None)
+            if session is not None and tag == TAG_TLS:
+                session.free(address)
+        elif op == 2:
+            entry["failed"] += 1
+        elif op == 5:
+            if session is not None and tag == TAG_TLS:
+                session.request(address, size)
+        elif size:
+            session = Session()
+        elif session is not None:
+            sessions.append(session)
+            session = None
+
+        if args.events:
+            print("%s,event,%d,%s,%s,0x%08x,%d" % (TAG, time_us, OPS[op], TAGS[tag], address, size))
+
+    for tag, entry in stats.items():
+        print("%s,%s,%d,%d,%d,%d,%d" % (TAG, TAGS[tag], entry["allocs"], entry["frees"], entry["failed"],
+                                        entry["bytes"], entry["peak"]))
+    if args.live:
+        for address, (tag, size, time_us) in sorted(live.items(), key=lambda item: item[1][2]):
+            print("%s,live,%s,0x%08x,%d,%d" % (TAG, TAGS[tag], address, size, time_us))
+    if args.emit_c:
+        if not sessions:
+            sys.exit("no complete TLS session in the capture: trace a reconnect with the pool enabled")
+        for index, done in enumerate(sessions):
+            if done.used > TRACE_SLOTS:
+                sys.exit("session %d has %d blocks live at once, raise MEM_POOL_STRESS_LIVE_MAX" % (index, done.used))
+            print("%s,session,%d,%d,%d,%d" % (TAG, index, done.allocations(), done.used, done.peak_bytes))
+        for block, peak in sorted(class_peaks(sessions).items(), key=lambda item: str(item[0]).zfill(8)):
+            print("%s,class,%s,%d" % (TAG, block, peak))
+        emit_c(args.emit_c, args.capture, sessions)
+    print("%s,end" % TAG)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+#
+# SPDX-License-Identifier: BSD-3-Clause
+"""Decoder of the tokenized log the target sends on RTT channel 2, formatted with the strings of the ELF.
+
+Capture the channel to a file with the J-Link RTT logger, then decode it with the ELF of the same build:
+
+    JLinkRTTLogger -Device R7FA6M5BH -If SWD -Speed 4000 -RTTChannel 2 log.bin
+    python3 tools/log_decode.py Debug/ek_ra6m5_https_client.elf log.bin
+
+tools/rtt_capture.py captures the channel to ch2_log_tokens.bin together with the others.
+
+A record is a little endian 16 bit offset of its format in the .log_fmt section, the 16 bit length of the arguments,
+then the arguments: 32 bit words, strings as an 8 bit length and the characters, see log_token.h. Conversions are
+those of SEGGER_RTT_printf(): %d %u %x %X %c %s %p and %%, with flags and width. A record cut short on the target
+prints its missing arguments as "?".
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+HEADER = struct.Struct("<HH")
+CONVERSION = re.compile(r"%([-0+ ]*)(\d*)(?:\.\d+)?[hl]*([diuxXcsp%])")
+
+
+def log_formats(path):
+    """Returns the .log_fmt section of an ELF32 file."""
+    with open(path, "rb") as elf:
+        data = elf.read()
+    if data[:4] != b"\x7fELF" or data[4] != 1:
+        sys.exit("%s: not an ELF32 file" % path)
+    shoff, = struct.unpack_from("<I", data, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+    sections = [struct.unpack_from("<IIIIII", data, shoff + i * shentsize) for i in range(shnum)]
+    names = sections[shstrndx][4]
+    for name, _type, _flags, _addr, offset, size in sections:
+        end = data.index(b"\0", names + name)
+        if data[names + name:end] == b".log_fmt":
+            return data[offset:offset + size]
+    sys.exit("%s: no .log_fmt section, not a build with log_token.c" % path)
+
+
+def pad(text, flags, width):
+    """Applies the flags and width of a conversion."""
+    width = int(width) if width else 0
+    if "-" in flags:
+        return text.ljust(width)
+    if "0" in flags and text[:1] != "-":
+        return text.rjust(width, "0")
+    if "0" in flags:
+        return "-" + text[1:].rjust(width - 1, "0")
+    return text.rjust(width)
+
+
+def format_record(fmt, args):
+    """Formats the arguments of one record."""
+    pos = 0
+
+    def convert(match):
+        nonlocal pos
+        flags, width, kind = match.groups()
+        if kind == "%":
+            return "%"
+        if kind == "s":
+            if pos >= len(args):
+                return "?"
+            length = args[pos]
+            text = args[pos + 1:pos + 1 + length].decode("latin-1")
+            pos += 1 + length
+            return pad(text, flags, width)
+        if pos + 4 > len(args):
+            pos = len(args)
+            return "?"
+        value, = struct.unpack_from("<I", args, pos)
+        pos += 4
+        if kind in "di":
+            text = str(value - (1 << 32) if value & 0x80000000 else value)
+        elif kind == "u":
+            text = str(value)
+        elif kind == "x":
+            text = "%x" % value
+        elif kind == "X":
+            text = "%X" % value
+        elif kind == "p":
+            text = "%08X" % value
+        else:
+            text = chr(value & 0xFF)
+        return pad(text, flags, width)
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def decode(formats, data):
+    """Yields the text of every whole record."""
+    offset = 0
+    while offset + HEADER.size <= len(data):
+        ident, length = HEADER.unpack_from(data, offset)
+        args = data[offset + HEADER.size:offset + HEADER.size + length]
+        offset += HEADER.size + length
+        if ident >= len(formats):
+            sys.exit("format %d out of the section: wrong ELF or capture out of sync" % ident)
+        fmt = formats[ident:formats.index(b"\0", ident)].decode("latin-1")
+        if len(args) < length:
+            yield format_record(fmt, args) + "<cut>"
+            return
+        yield format_record(fmt, args)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="ELF file of the build running on the target")
+    parser.add_argument("capture", help="binary capture of the RTT channel")
+    args = parser.parse_args()
+
+    formats = log_formats(args.elf)
+    with open(args.capture, "rb") as capture:
+        data = capture.read()
+    for text in decode(formats, data):
+        sys.stdout.write(text)
+    sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()
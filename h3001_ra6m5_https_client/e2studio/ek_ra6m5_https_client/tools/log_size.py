@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+#
+# SPDX-License-Identifier: BSD-3-Clause
+"""Code and string size the log calls cost, a default build against one with a lower APP_LOG_BUILD_LEVEL.
+
+Compiles every C file of src twice with the compiler, flags, defines and include paths of a build configuration of
+.cproject: once as it is and once with -DAPP_LOG_BUILD_LEVEL=<level> (1 keeps the errors only, see app_log.h). Then
+sums the .text* and .rodata* sections of each object. The objects are those of the project before linking, so the
+totals still count a string used by two files twice and sections the linker drops; for the figure of the linked
+image build both configurations in e2 studio and pass the two .elf files with --elf. Needs the GNU Arm toolchain on
+the PATH and the generated FSP tree (ra, ra_gen, ra_cfg) in the project.
+
+    python3 tools/log_size.py [--config Debug] [--level 1] [--cc arm-none-eabi-gcc] [--size arm-none-eabi-size]
+    python3 tools/log_size.py --elf <default.elf> <level.elf>
+
+Prints one comma separated line per file, the totals and the saving, in bytes:
+    #LOGSIZE,<file>,<text default>,<text level>,<rodata default>,<rodata level>
+    #LOGSIZE,total,<text default>,<text level>,<rodata default>,<rodata level>
+    #LOGSIZE,saving,<text>,<rodata>
+With --elf the lines are those of the linked images, where the RA linker script places .rodata in .text:
+    #LOGSIZE,elf,<text default>,<text level>,<data default>,<data level>
+    #LOGSIZE,saving,<text>,<data>
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+import xml.etree.ElementTree as ElementTree
+
+TAG = "#LOGSIZE"
+PROJECT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+OPTION = "ilg.gnuarmeclipse.managedbuild.cross.option."
+C_COMPILER = "ilg.gnuarmeclipse.managedbuild.cross.tool.c.compiler"
+
+# Values of the toolchain options of .cproject and the flags the managed build turns them into
+OPTIMIZATION = {"none": "-O0", "optimize": "-O1", "more": "-O2", "most": "-O3", "size": "-Os", "debug": "-Og"}
+FPU_UNIT = {"fpv5spd16": "-mfpu=fpv5-sp-d16", "fpv5d16": "-mfpu=fpv5-d16", "fpv4spd16": "-mfpu=fpv4-sp-d16"}
+FPU_ABI = {"hard": "-mfloat-abi=hard", "softfp": "-mfloat-abi=softfp", "soft": "-mfloat-abi=soft"}
+
+DEFAULTS = {
+    "config": "Debug",
+    "level": 1,
+    "cc": "arm-none-eabi-gcc",
+    "size": "arm-none-eabi-size",
+}
+
+
+def option_suffix(option):
+    """The last part of an enumerated option value, e.g. "more" of "...optimization.level.more"."""
+    return option.get("value", "").rsplit(".", 1)[-1]
+
+
+def project_path(value, project):
+    """Resolves an include path of .cproject against the project directory."""
+    value = value.strip('"')
+    for prefix in ("${workspace_loc:/${ProjName}", "${ProjDirPath}"):
+        if value.startswith(prefix):
+            value = value[len(prefix):].lstrip("/").rstrip("}")
+            break
+    return os.path.normpath(os.path.join(project, value))
+
+
+def read_flags(project, config):
+    """Returns the C compiler flags of a build configuration of .cproject."""
+    root = ElementTree.parse(os.path.join(project, ".cproject")).getroot()
+    configuration = next((c for c in root.iter("configuration") if c.get("name") == config), None)
+    if configuration is None:
+        sys.exit("no build configuration %s in .cproject" % config)
+
+    flags = []
+    for option in configuration.iter("option"):
+        kind = option.get("superClass", "")
+        if kind == OPTION + "optimization.level":
+            flags.append(OPTIMIZATION.get(option_suffix(option), "-O2"))
+        elif kind in (OPTION + "optimization.functionsections", OPTION + "optimization.datasections"):
+            if option.get("value") == "true":
+                flags.append("-f" + kind.rsplit(".", 1)[-1].replace("sections", "-sections"))
+        elif kind == OPTION + "arm.target.family":
+            flags.append("-mcpu=" + option_suffix(option))
+        elif kind == OPTION + "arm.target.instructionset":
+            flags.append("-m" + option_suffix(option))
+        elif kind == OPTION + "arm.target.fpu.unit":
+            flags.append(FPU_UNIT.get(option_suffix(option), ""))
+        elif kind == OPTION + "arm.target.fpu.abi":
+            flags.append(FPU_ABI.get(option_suffix(option), ""))
+
+    compiler = next((t for t in configuration.iter("tool") if t.get("superClass") == C_COMPILER), None)
+    if compiler is None:
+        sys.exit("no C compiler in build configuration %s" % config)
+    for option in compiler.iter("option"):
+        kind = option.get("superClass", "")
+        values = [v.get("value") for v in option.iter("listOptionValue")]
+        if kind == OPTION + "c.compiler.std":
+            flags.append("-std=" + option_suffix(option))
+        elif kind == OPTION + "c.compiler.other":
+            flags.extend(option.get("value", "").split())
+        elif kind == OPTION + "c.compiler.defs":
+            flags.extend("-D" + value for value in values)
+        elif kind == OPTION + "c.compiler.include.paths":
+            flags.extend("-I" + project_path(value, project) for value in values)
+    return [flag for flag in flags if flag]
+
+
+def sources(project):
+    """The C files of src, relative to the project."""
+    found = []
+    for folder, _, names in os.walk(os.path.join(project, "src")):
+        found.extend(os.path.relpath(os.path.join(folder, name), project) for name in names if name.endswith(".c"))
+    return sorted(found)
+
+
+def sections(size, path):
+    """Sums the .text* and .rodata* sections of an object, from the System V output of size."""
+    text = rodata = 0
+    output = subprocess.run([size, "-A", path], check=True, capture_output=True, text=True).stdout
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) < 2 or not fields[1].isdigit():
+            continue
+        if fields[0] == ".text" or fields[0].startswith(".text."):
+            text += int(fields[1])
+        elif fields[0] == ".rodata" or fields[0].startswith(".rodata."):
+            rodata += int(fields[1])
+    return text, rodata
+
+
+def compile_all(args, flags, files, out, extra):
+    """Compiles the files into out, returns {file: (text, rodata)}."""
+    sizes = {}
+    for name in files:
+        obj = os.path.join(out, name.replace(os.sep, "_")[:-2] + ".o")
+        command = [args.cc] + flags + extra + ["-c", "-o", obj, "-x", "c", os.path.join(args.project, name)]
+        result = subprocess.run(command, cwd=args.project, capture_output=True, text=True)
+        if result.returncode != 0:
+            sys.exit("%s failed:\n%s" % (name, result.stderr))
+        sizes[name] = sections(args.size, obj)
+    return sizes
+
+
+def compare_elf(args):
+    """Berkeley totals of the two linked images."""
+    totals = []
+    for path in args.elf:
+        output = subprocess.run([args.size, "-B", path], check=True, capture_output=True, text=True).stdout
+        fields = output.splitlines()[1].split()
+        totals.append((int(fields[0]), int(fields[1])))
+    print("%s,elf,%d,%d,%d,%d" % (TAG, totals[0][0], totals[1][0], totals[0][1], totals[1][1]))
+    print("%s,saving,%d,%d" % (TAG, totals[0][0] - totals[1][0], totals[0][1] - totals[1][1]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--project", default=PROJECT)
+    parser.add_argument("--elf", nargs=2, metavar=("DEFAULT", "LEVEL"))
+    for name, value in DEFAULTS.items():
+        parser.add_argument("--" + name.replace("_", "-"), type=type(value), default=value)
+    args = parser.parse_args()
+
+    if args.elf:
+        compare_elf(args)
+        print("%s,end" % TAG)
+        return
+
+    if not os.path.isdir(os.path.join(args.project, "ra_gen")):
+        sys.exit("no generated FSP tree in %s: generate the project content in e2 studio first" % args.project)
+    flags = read_flags(args.project, args.config)
+    files = sources(args.project)
+    with tempfile.TemporaryDirectory() as out:
+        os.mkdir(os.path.join(out, "default"))
+        os.mkdir(os.path.join(out, "level"))
+        default = compile_all(args, flags, files, os.path.join(out, "default"), [])
+        level = compile_all(args, flags, files, os.path.join(out, "level"), ["-DAPP_LOG_BUILD_LEVEL=%d" % args.level])
+
+    total = [0, 0, 0, 0]
+    for name in files:
+        row = (default[name][0], level[name][0], default[name][1], level[name][1])
+        total = [t + r for t, r in zip(total, row)]
+        print("%s,%s,%d,%d,%d,%d" % ((TAG, name) + row))
+    print("%s,total,%d,%d,%d,%d" % ((TAG,) + tuple(total)))
+    print("%s,saving,%d,%d" % (TAG, total[0] - total[1], total[2] - total[3]))
+    print("%s,end" % TAG)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+#
+# SPDX-License-Identifier: BSD-3-Clause
+"""Capture of all RTT up channels of the target at once, each into its own file, see rtt_streams.h.
+
+Needs a J-Link and pylink (pip install pylink-square). Captures until Ctrl+C or --seconds, then decodes:
+
+    python3 tools/rtt_capture.py --out capture [--seconds 600]
+    python3 tools/rtt_capture.py --out capture --offline
+
+Raw files, one per channel: ch0_terminal.txt, ch1_metrics.bin, ch2_log_tokens.bin, ch3_samples.bin. Decoded:
+    metrics_heap.bin        allocation trace records for tools/heap_trace.py
+    metrics.csv             #SYSSTATS,<time ms>,<window ms>,<tasks>,<load %>,<heap free>,<lowest heap free>
+                            #SYSSTATS,task,<name>,<priority>,<stack margin bytes>,<cpu %>
+                            #RTTSTATS,<time ms>,<channel>,<records>,<bytes>,<dropped>,<dropped bytes>
+    samples.csv             time_ms,count,raw_humidity,raw_temperature,temp_c,rh_pct
+The tokenized log in ch2_log_tokens.bin is decoded with tools/log_decode.py and the ELF of the build. --offline
+decodes the raw files of an earlier capture again.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+
+CHANNELS = ("ch0_terminal.txt", "ch1_metrics.bin", "ch2_log_tokens.bin", "ch3_samples.bin")
+METRIC_HEAP_TRACE = 1
+METRIC_SYS_STATS = 2
+METRIC_TASK = 3
+METRIC_STREAM_STATS = 4
+SYS_STATS = struct.Struct("<IIIIII")
+TASK = struct.Struct("<16sIII")
+STREAM_STATS = struct.Struct("<IIIII")
+SAMPLE = struct.Struct("<IIHHhH")
+
+
+def capture(args):
+    """Polls every up channel into its raw file until Ctrl+C or the time is up."""
+    try:
+        import pylink
+    except ImportError:
+        sys.exit("pylink is needed for a capture: pip install pylink-square")
+
+    jlink = pylink.JLink()
+    jlink.open(args.serial)
+    jlink.set_tif(pylink.enums.JLinkInterfaces.SWD)
+    jlink.connect(args.device, args.speed)
+    jlink.rtt_start()
+    while True:
+        try:
+            if jlink.rtt_get_num_up_buffers() >= len(CHANNELS):
+                break
+        except pylink.errors.JLinkRTTException:
+            pass
+        time.sleep(0.1)
+
+    files = [open(os.path.join(args.out, name), "wb") for name in CHANNELS]
+    end = time.time() + args.seconds if args.seconds else None
+    try:
+        while end is None or time.time() < end:
+            idle = True
+            for channel, out in enumerate(files):
+                data = jlink.rtt_read(channel, 4096)
+                if data:
+                    out.write(bytes(data))
+                    idle = False
+            if idle:
+                time.sleep(0.01)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        for out in files:
+            out.close()
+        jlink.rtt_stop()
+        jlink.close()
+
+
+def decode_metrics(data, heap, csv):
+    """Splits the metrics records by type. Returns the records of each type."""
+    counts = {}
+    time_ms = 0
+    offset = 0
+    while offset + 2 <= len(data):
+        kind, length = data[offset], data[offset + 1]
+        payload = data[offset + 2:offset + 2 + length]
+        offset += 2 + length
+        if len(payload) < length:
+            break
+        counts[kind] = counts.get(kind, 0) + 1
+        if kind == METRIC_HEAP_TRACE:
+            heap.write(payload)
+        elif kind == METRIC_SYS_STATS:
+            time_ms, window, tasks, load, heap_free, heap_min = SYS_STATS.unpack(payload)
+            csv.write("#SYSSTATS,%d,%d,%d,%d.%02d,%d,%d\n" % (time_ms, window, tasks, load // 100, load % 100,
+                                                             heap_free, heap_min))
+        elif kind == METRIC_TASK:
+            name, priority, margin, cpu = TASK.unpack(payload)
+            csv.write("#SYSSTATS,task,%s,%d,%d,%d.%02d\n" % (name.rstrip(b"\0").decode("latin-1"), priority, margin,
+                                                             cpu // 100, cpu % 100))
+        elif kind == METRIC_STREAM_STATS:
+            csv.write("#RTTSTATS,%d,%d,%d,%d,%d,%d\n" % ((time_ms,) + STREAM_STATS.unpack(payload)))
+        else:
+            sys.exit("unknown metrics record %d at byte %d: capture out of sync" % (kind, offset - 2 - length))
+    return counts
+
+
+def decode_samples(data, csv):
+    """Writes the samples as CSV. Returns the samples and the records lost on the target."""
+    last = None
+    lost = 0
+    csv.write("time_ms,count,raw_humidity,raw_temperature,temp_c,rh_pct\n")
+    for offset in range(0, len(data) - SAMPLE.size + 1, SAMPLE.size):
+        time_ms, count, raw_rh, raw_temp, temp, rh = SAMPLE.unpack_from(data, offset)
+        if last is not None and count != last + 1:
+            lost += (count - last - 1) & 0xFFFFFFFF
+        last = count
+        csv.write("%d,%d,0x%04x,0x%04x,%s%d.%02d,%d.%02d\n" % (time_ms, count, raw_rh, raw_temp, "-" * (temp < 0),
+                                                              abs(temp) // 100, abs(temp) % 100, rh // 100, rh % 100))
+    return len(data) // SAMPLE.size, lost
+
+
+def decode(out_dir):
+    """Decodes the raw files of a capture."""
+    def read(name):
+        path = os.path.join(out_dir, name)
+        if not os.path.exists(path):
+            return b""
+        with open(path, "rb") as raw:
+            return raw.read()
+
+    with open(os.path.join(out_dir, "metrics_heap.bin"), "wb") as heap, \
+            open(os.path.join(out_dir, "metrics.csv"), "w") as csv:
+        counts = decode_metrics(read(CHANNELS[1]), heap, csv)
+    with open(os.path.join(out_dir, "samples.csv"), "w") as csv:
+        samples, lost = decode_samples(read(CHANNELS[3]), csv)
+
+    print("terminal: %d bytes" % len(read(CHANNELS[0])))
+    print("metrics: %d heap trace, %d reports, %d channel counters" % (
+        counts.get(METRIC_HEAP_TRACE, 0), counts.get(METRIC_SYS_STATS, 0), counts.get(METRIC_STREAM_STATS, 0)))
+    print("log tokens: %d bytes" % len(read(CHANNELS[2])))
+    print("samples: %d, %d lost on the target" % (samples, lost))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--out", required=True, help="directory of the capture files")
+    parser.add_argument("--offline", action="store_true", help="decode the raw files of an earlier capture")
+    parser.add_argument("--device", default="R7FA6M5BH", help="J-Link device name")
+    parser.add_argument("--speed", type=int, default=4000, help="SWD speed in kHz")
+    parser.add_argument("--serial", type=int, default=None, help="J-Link serial number")
+    parser.add_argument("--seconds", type=float, default=0, help="capture time, 0 until Ctrl+C")
+    args = parser.parse_args()
+
+    os.makedirs(args.out, exist_ok=True)
+    if not args.offline:
+        capture(args)
+    decode(args.out)
+
+
+if __name__ == "__main__":
+    main()
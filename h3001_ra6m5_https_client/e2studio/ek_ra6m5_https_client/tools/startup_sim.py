@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+#
+# SPDX-License-Identifier: BSD-3-Clause
+"""Host simulation of the time to the first POST, staged startup against sequential startup.
+
+Plays the startup of user_app_thread_entry.c on one simulated core: the steps of each task in the order the code runs
+them, with the durations given as inputs. A step either needs the core (crypto, LittleFS, certificate parsing, the
+handshake arithmetic) or waits (DHCP, the HS3001 measurement, network round trips). Tasks of the same priority share
+the core as time slicing does, waits overlap with everything. The stages are those of app_startup.h, so the result
+compares line by line with the "Startup timeline" the target prints; take the durations from there.
+
+    python3 tools/startup_sim.py [--src src] [--mode staged|sequential|both] [--dhcp-ms 3000] ...
+
+Prints one comma separated line per mode and a line per stage, in ms since scheduler start:
+    #STARTSIM,<mode>,<time to first POST>
+    #STARTSIM,<mode>,<stage>,<done at>
+"""
+
+import argparse
+import os
+import re
+import sys
+
+TAG = "#STARTSIM"
+STEP_MS = 0.1
+
+# Target durations not visible in the headers, adjust to what the startup timeline of the target reports
+DEFAULTS = {
+    "crypto_ms": 30,            # mbedtls_platform_setup() and mem_pool_init(), core
+    "ip_init_ms": 5,            # FreeRTOS_IPInit(), core
+    "dhcp_ms": 2000,            # FreeRTOS_IPInit() to the network up notification, wait
+    "mount_ms": 60,             # LittleFS mount and the application superblock, core
+    "provision_ms": 40,         # Provisioning digest compare, core; a first boot writes the objects and takes longer
+    "cache_ms": 350,            # credential_cache_init(): certificate and key parsing, DRBG seeding, core
+    "sensor_ms": 5,             # I2C open and the HS3001 wakeup write, core (the measurement delay is a wait)
+    "connect_cpu_ms": 600,      # TLS handshake arithmetic, core
+    "connect_wait_ms": 300,     # TLS handshake and TCP round trips, wait
+    "post_cpu_ms": 20,          # Request build and record protection, core
+    "post_wait_ms": 150,        # Server response, wait
+}
+
+# Task priorities of configuration.xml and app_startup.h: the IP task only waits in this model
+USER_PRIORITY = 2
+STARTUP_TASK_PRIORITY = 2
+
+STAGES = ("Crypto engine", "LittleFS", "Provisioning", "Credential cache", "Sensor + first sample", "Network up",
+          "TLS connected", "First POST")
+
+
+def read_macros(src):
+    """Returns the numeric #defines of the headers the startup reads."""
+    macros = {}
+    pattern = re.compile(r"^\s*#define\s+(\w+)\s+\(?\s*(\d+)U?L?\s*\)?\s*(?:/\*.*)?$")
+    for name in ("hs300x_code.h",):
+        with open(os.path.join(src, name), encoding="utf-8", errors="replace") as header:
+            for line in header:
+                match = pattern.match(line)
+                if match:
+                    macros[match.group(1)] = int(match.group(2))
+    return macros
+
+
+def sensor(m, o):
+    """startup_sensor(): I2C open and wakeup, the measurement delay, then the read."""
+    return [("cpu", o["sensor_ms"]), ("wait", m["HS3001_MEASUREMENT_MS"]), ("cpu", 1),
+            ("done", "Sensor + first sample")]
+
+
+def credentials(o):
+    """app_startup_credentials_load()"""
+    return [("cpu", o["provision_ms"]), ("done", "Provisioning"), ("cpu", o["cache_ms"]),
+            ("done", "Credential cache")]
+
+
+def uplink(o):
+    """connect_aws_https_client() and the upload of the queued first sample."""
+    return [("cpu", o["connect_cpu_ms"]), ("wait", o["connect_wait_ms"]), ("done", "TLS connected"),
+            ("cpu", o["post_cpu_ms"]), ("wait", o["post_wait_ms"]), ("done", "First POST")]
+
+
+def tasks_for(mode, m, o):
+    """The steps of every task. ("start", name) makes a task runnable, ("await", stage) blocks until it is done."""
+    dhcp = [("wait", o["dhcp_ms"]), ("done", "Network up")]
+    if mode == "staged":
+        user = ([("cpu", o["crypto_ms"]), ("done", "Crypto engine"), ("cpu", o["ip_init_ms"]), ("start", "IP"),
+                 ("start", "Startup")] + sensor(m, o) + [("await", "Network up"), ("await", "Credential cache")] +
+                uplink(o))
+        startup = [("cpu", o["mount_ms"]), ("done", "LittleFS")] + credentials(o)
+        return {"User": (USER_PRIORITY, user), "Startup": (STARTUP_TASK_PRIORITY, startup), "IP": (None, dhcp)}
+
+    user = ([("cpu", o["mount_ms"]), ("done", "LittleFS")] + sensor(m, o) +
+            [("cpu", o["crypto_ms"]), ("done", "Crypto engine"), ("cpu", o["ip_init_ms"]), ("start", "IP"),
+             ("await", "Network up")] + credentials(o) + uplink(o))
+    return {"User": (USER_PRIORITY, user), "IP": (None, dhcp)}
+
+
+def simulate(tasks):
+    """Runs the tasks to the end, returns the time each stage was done."""
+    pos = {name: 0 for name in tasks}
+    left = {name: None for name in tasks}
+    runnable = {"User"}
+    done = {}
+    now = 0.0
+
+    while len(done) < len(STAGES):
+        # Steps that take no time
+        moved = True
+        while moved:
+            moved = False
+            for name in sorted(runnable):
+                steps = tasks[name][1]
+                if pos[name] >= len(steps):
+                    continue
+                kind, arg = steps[pos[name]]
+                if kind == "start":
+                    runnable.add(arg)
+                elif kind == "done":
+                    done.setdefault(arg, now)
+                elif kind != "await" or arg not in done:
+                    continue
+                pos[name] += 1
+                moved = True
+        if len(done) == len(STAGES):
+            break
+
+        # The core goes to the highest priority that has work, shared among the tasks of that priority
+        active = {name: tasks[name][1][pos[name]] for name in runnable if pos[name] < len(tasks[name][1])}
+        if not active:
+            sys.exit("startup stalls at %.1f ms, stages done: %s" % (now, ", ".join(done)))
+        cpu = [name for name, step in active.items() if step[0] == "cpu"]
+        top = max((tasks[name][0] for name in cpu), default=None)
+        sharing = [name for name in cpu if tasks[name][0] == top]
+        for name, (kind, arg) in active.items():
+            if kind not in ("cpu", "wait"):
+                continue
+            if left[name] is None:
+                left[name] = float(arg)
+            if kind == "wait":
+                left[name] -= STEP_MS
+            elif name in sharing:
+                left[name] -= STEP_MS / len(sharing)
+            if left[name] <= 1e-9:
+                left[name] = None
+                pos[name] += 1
+        now += STEP_MS
+    return done
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--src", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src"))
+    parser.add_argument("--mode", default="both", choices=("staged", "sequential", "both"))
+    for name, value in DEFAULTS.items():
+        parser.add_argument("--" + name.replace("_", "-"), type=int, default=value)
+    args = parser.parse_args()
+
+    macros = read_macros(args.src)
+    if "HS3001_MEASUREMENT_MS" not in macros:
+        sys.exit("missing macros in %s: HS3001_MEASUREMENT_MS" % args.src)
+
+    opts = {name: getattr(args, name) for name in DEFAULTS}
+    modes = ("staged", "sequential") if args.mode == "both" else (args.mode,)
+    first_post = {}
+    for mode in modes:
+        done = simulate(tasks_for(mode, macros, opts))
+        first_post[mode] = done["First POST"]
+        print("%s,%s,%d" % (TAG, mode, round(done["First POST"])))
+        for stage in STAGES:
+            print("%s,%s,%s,%d" % (TAG, mode, stage, round(done[stage])))
+    if len(first_post) == 2:
+        print("%s,saving,%d" % (TAG, round(first_post["sequential"] - first_post["staged"])))
+    print("%s,end" % TAG)
+
+
+if __name__ == "__main__":
+    main()
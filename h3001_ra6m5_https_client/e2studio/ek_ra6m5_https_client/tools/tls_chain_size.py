@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+#
+# SPDX-License-Identifier: BSD-3-Clause
+"""Size of the Certificate handshake message of the server, against the small TLS record profile.
+
+Fetches the certificate chain the server sends in a TLS 1.2 handshake with openssl s_client -showcerts (or reads a
+saved output of it, or any PEM bundle in the order the server sends it) and computes the Certificate message the
+client has to hold in one piece: mbedTLS does not reassemble a handshake message spread over several records, so with
+the small profile of app_mbedtls_config.h the whole message must fit one 4096 byte record. Enter the TLS 1.2 figure as
+TLS_SERVER_CERT_MSG_LEN there; measure again when the server renews its certificate.
+
+    python3 tools/tls_chain_size.py [--host io.adafruit.com] [--port 443] [--pem chain.pem] [--limit 4096]
+
+Prints one comma separated line per certificate and per protocol version, in bytes:
+    #CHAINSIZE,cert,<index>,<DER length>
+    #CHAINSIZE,<tls1_2|tls1_3>,<Certificate message length>,<fits|too large>
+"""
+
+import argparse
+import base64
+import os
+import re
+import subprocess
+import sys
+
+TAG = "#CHAINSIZE"
+
+DEFAULTS = {
+    "port": 443,
+    "limit": 4096,
+    "openssl": "openssl",
+}
+
+PEM = re.compile(r"-----BEGIN CERTIFICATE-----(.+?)-----END CERTIFICATE-----", re.S)
+
+
+def read_host(src):
+    """HTTPS_HOST_ADDRESS of user_app.h."""
+    with open(os.path.join(src, "user_app.h"), encoding="utf-8", errors="replace") as header:
+        match = re.search(r'#define\s+HTTPS_HOST_ADDRESS\s+"([^"]+)"', header.read())
+    return match.group(1) if match else None
+
+
+def fetch_chain(openssl, host, port):
+    """The -showcerts output of a TLS 1.2 handshake with SNI, as the client of the small profile makes it."""
+    command = [openssl, "s_client", "-connect", "%s:%d" % (host, port), "-servername", host, "-tls1_2", "-showcerts"]
+    result = subprocess.run(command, input="", capture_output=True, text=True, timeout=30)
+    if not PEM.search(result.stdout):
+        sys.exit("no certificate from %s:%d\n%s" % (host, port, result.stderr))
+    return result.stdout
+
+
+def message_lengths(ders):
+    """Certificate message with its 4 byte handshake header: TLS 1.2 (RFC 5246 7.4.2) and TLS 1.3 (RFC 8446 4.4.2)."""
+    tls1_2 = 4 + 3 + sum(3 + len(der) for der in ders)
+    tls1_3 = 4 + 1 + 3 + sum(3 + len(der) + 2 for der in ders)
+    return tls1_2, tls1_3
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--src", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src"))
+    parser.add_argument("--host")
+    parser.add_argument("--pem", help="saved s_client -showcerts output or PEM bundle instead of a connection")
+    for name, value in DEFAULTS.items():
+        parser.add_argument("--" + name.replace("_", "-"), type=type(value), default=value)
+    args = parser.parse_args()
+
+    if args.pem:
+        with open(args.pem, encoding="utf-8", errors="replace") as pem:
+            text = pem.read()
+    else:
+        host = args.host or read_host(args.src)
+        if not host:
+            sys.exit("no HTTPS_HOST_ADDRESS in %s, give --host" % args.src)
+        text = fetch_chain(args.openssl, host, args.port)
+
+    ders = [base64.b64decode("".join(block.split())) for block in PEM.findall(text)]
+    if not ders:
+        sys.exit("no certificate in the input")
+    for index, der in enumerate(ders):
+        print("%s,cert,%d,%d" % (TAG, index, len(der)))
+    for version, length in zip(("tls1_2", "tls1_3"), message_lengths(ders)):
+        print("%s,%s,%d,%s" % (TAG, version, length, "fits" if length <= args.limit else "too large"))
+    print("%s,end" % TAG)
+
+
+if __name__ == "__main__":
+    main()
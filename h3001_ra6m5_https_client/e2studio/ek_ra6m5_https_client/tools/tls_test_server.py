@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+#
+# SPDX-License-Identifier: BSD-3-Clause
+"""LAN stand-in for HTTPS_HOST_ADDRESS to benchmark the TLS handshake with TLS_HANDSHAKE_INJECT_RTT_MS.
+
+Creates a test root CA and a server certificate for --host (the address the board reaches this machine at, as an
+IP and DNS subjectAltName since the client checks the name) in --certs, then runs openssl s_server on --port with
+the protocol versions of --tls: 1.3 and 1.2 restrict the server to one version, both lets the client choose. The
+certificates are kept and used again on the next run, so the board is built once per --certs directory; --renew
+creates new ones. RSA 2048 keys by default, as the GeoTrust chain of io.adafruit.com; --key ec:P-256 for an ECDSA
+chain. --client-auth requests the client certificate as well, so the handshake carries CLIENT_CERTIFICATE_PEM and
+the CertificateVerify signature. s_server answers GET with its status page and nothing else: the figure to read is
+the "TLS handshake: <ms> ms" line of the board, not the request result.
+
+    python3 tools/tls_test_server.py --host 192.168.1.10 [--port 4433] [--tls both|1.3|1.2] [--certs tls_test]
+                                     [--key rsa:2048] [--groups P-256] [--client-auth] [--renew] [--no-serve]
+
+Copy <certs>/ca.h over HTTPS_TRUSTED_ROOT_CA of user_app.h and set the printed defines before the build. Prints one
+comma separated line per file and per setting before the server starts:
+    #TLSSERVER,<ca|cert|key|ca_h>,<path>
+    #TLSSERVER,define,<name>,<value>
+    #TLSSERVER,server,<openssl command line>
+"""
+
+import argparse
+import ipaddress
+import os
+import shlex
+import subprocess
+import sys
+
+TAG = "#TLSSERVER"
+
+DEFAULTS = {
+    "port": 4433,
+    "certs": "tls_test",
+    "key": "rsa:2048",
+    "groups": "",
+    "days": 365,
+    "rtt_ms": 100,
+    "openssl": "openssl",
+}
+
+TLS_OPTIONS = {"both": [], "1.3": ["-tls1_3"], "1.2": ["-tls1_2"]}
+
+
+def openssl(args, *command):
+    """Runs an openssl command, exits with its error output when it fails."""
+    result = subprocess.run([args.openssl] + list(command), capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.exit("openssl %s failed:\n%s" % (command[0], result.stderr))
+
+
+def key_options(key):
+    """-newkey and -pkeyopt of openssl req for rsa:<bits> or ec:<curve>."""
+    kind, _, value = key.partition(":")
+    if kind == "rsa":
+        return ["-newkey", key]
+    if kind == "ec":
+        return ["-newkey", "ec", "-pkeyopt", "ec_paramgen_curve:" + value]
+    sys.exit("--key %s: rsa:<bits> or ec:<curve>" % key)
+
+
+def subject_alt_name(host):
+    """IP and DNS entries for the host, a DNS entry only for a name."""
+    try:
+        ipaddress.ip_address(host)
+    except ValueError:
+        return "DNS:%s" % host
+    return "IP:%s,DNS:%s" % (host, host)
+
+
+def create_certs(args, paths):
+    """Test root CA and a server certificate it signs, with subjectAltName and serverAuth for --host."""
+    os.makedirs(args.certs, exist_ok=True)
+    days = str(args.days)
+    openssl(args, "req", "-x509", *key_options(args.key), "-nodes", "-keyout", paths["ca_key"], "-out", paths["ca"],
+            "-days", days, "-subj", "/CN=ek_ra6m5_https_client test CA",
+            "-addext", "basicConstraints=critical,CA:TRUE", "-addext", "keyUsage=critical,keyCertSign,cRLSign")
+    openssl(args, "req", *key_options(args.key), "-nodes", "-keyout", paths["key"], "-out", paths["csr"],
+            "-subj", "/CN=%s" % args.host)
+    with open(paths["ext"], "w", encoding="utf-8") as ext:
+        ext.write("basicConstraints=critical,CA:FALSE\n")
+        ext.write("keyUsage=critical,digitalSignature,keyEncipherment\n")
+        ext.write("extendedKeyUsage=serverAuth\n")
+        ext.write("subjectAltName=%s\n" % subject_alt_name(args.host))
+    openssl(args, "x509", "-req", "-in", paths["csr"], "-CA", paths["ca"], "-CAkey", paths["ca_key"],
+            "-CAcreateserial", "-out", paths["cert"], "-days", days, "-extfile", paths["ext"])
+
+
+def write_ca_h(paths):
+    """The CA as the HTTPS_TRUSTED_ROOT_CA macro of user_app.h."""
+    with open(paths["ca"], encoding="utf-8") as pem:
+        lines = [line.strip() for line in pem if line.strip()]
+    with open(paths["ca_h"], "w", encoding="utf-8") as header:
+        header.write("#define HTTPS_TRUSTED_ROOT_CA                               \\\n")
+        for line in lines[:-1]:
+            header.write('"%s\\n" \\\n' % line)
+        header.write('"%s\\n"\n' % lines[-1])
+
+
+def server_command(args, paths):
+    """openssl s_server with the test certificate, the protocol versions of --tls and the status page."""
+    command = [args.openssl, "s_server", "-accept", str(args.port), "-cert", paths["cert"], "-key", paths["key"],
+               "-www"] + TLS_OPTIONS[args.tls]
+    if args.groups:
+        command += ["-groups", args.groups]
+    if args.client_auth:
+        command += ["-verify", "1"]
+    return command
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--host", required=True, help="address the board connects to, the server name it checks")
+    parser.add_argument("--tls", choices=sorted(TLS_OPTIONS), default="both")
+    parser.add_argument("--client-auth", action="store_true", help="request the client certificate")
+    parser.add_argument("--renew", action="store_true", help="create new certificates even if --certs has them")
+    parser.add_argument("--no-serve", action="store_true", help="create the certificates and settings only")
+    for name, value in DEFAULTS.items():
+        parser.add_argument("--" + name.replace("_", "-"), type=type(value), default=value)
+    args = parser.parse_args()
+
+    paths = {name: os.path.join(args.certs, file) for name, file in
+             (("ca", "ca.pem"), ("ca_key", "ca.key"), ("cert", "server.pem"), ("key", "server.key"),
+              ("csr", "server.csr"), ("ext", "server.ext"), ("ca_h", "ca.h"))}
+    if args.renew or not all(os.path.isfile(paths[name]) for name in ("ca", "cert", "key")):
+        create_certs(args, paths)
+    write_ca_h(paths)
+
+    for name in ("ca", "cert", "key", "ca_h"):
+        print("%s,%s,%s" % (TAG, name, paths[name]))
+    print('%s,define,HTTPS_HOST_ADDRESS,"%s"' % (TAG, args.host))
+    print("%s,define,HTTPS_PORT,( ( uint16_t ) %dU )" % (TAG, args.port))
+    print("%s,define,TLS_HANDSHAKE_INJECT_RTT_MS,(%d)" % (TAG, args.rtt_ms))
+    command = server_command(args, paths)
+    print("%s,server,%s" % (TAG, " ".join(shlex.quote(part) for part in command)))
+    print("%s,end" % TAG)
+    sys.stdout.flush()
+
+    if not args.no_serve:
+        try:
+            subprocess.run(command, check=False)
+        except KeyboardInterrupt:
+            pass
+
+
+if __name__ == "__main__":
+    main()
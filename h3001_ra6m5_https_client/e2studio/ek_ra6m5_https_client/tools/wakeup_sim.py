@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 - 2024 Renesas Electronics Corporation and/or its affiliates
+#
+# SPDX-License-Identifier: BSD-3-Clause
+"""Host simulation of the CPU wakeups per hour of the application under tickless idle.
+
+Reads the schedule macros from the application headers and lays out one simulated hour of the events that end a
+tickless sleep: timeouts of the tasks and the interrupts their work causes. Events closer together than the kernel's
+minimum sleep share one wakeup. Compare the result with the "power" console command on the target.
+
+    python3 tools/wakeup_sim.py [--src src] [--scenario connected|offline|debug|all] [--legacy]
+
+Prints one comma separated line per scenario and a line per wake source:
+    #WAKESIM,<scenario>,<wakeups per hour>
+    #WAKESIM,<scenario>,<source>,<events per hour>
+"""
+
+import argparse
+import os
+import re
+import sys
+
+TAG = "#WAKESIM"
+HOUR_MS = 3600 * 1000
+
+# Kernel: configEXPECTED_IDLE_TIME_BEFORE_SLEEP ticks of 1 ms, shorter gaps are spent awake in the idle task
+MIN_SLEEP_MS = 2
+
+# Target behaviour not visible in the headers, adjust to what the "power" command reports
+DEFAULTS = {
+    "ip_timer_ms": 10000,       # FreeRTOS+TCP ARP cache check, the IP task's longest timeout
+    "post_irqs": 12,            # Ethernet interrupts of one HTTPS POST on a warm TLS session
+    "connect_irqs": 40,         # Ethernet interrupts of a failed connect attempt (ARP, DNS, TCP SYN retries)
+    "flush_ms": 30,             # Data flash programming of a journal flush, spent awake
+}
+
+# The fixed periods of the loops before tickless idle, for --legacy
+LEGACY = {
+    "service_ms": 1000,         # Main loop service period
+    "console_ms": 2000,         # Console task without a debugger
+    "maint_ms": 5000,           # LittleFS maintenance period
+}
+
+
+def read_macros(src):
+    """Returns the numeric #defines of the headers the schedule comes from."""
+    macros = {}
+    pattern = re.compile(r"^\s*#define\s+(\w+)\s+\(?\s*(\d+)U?L?\s*\)?\s*(?:/\*.*)?$")
+    for name in ("user_app.h", "console.h", "hs300x_code.h"):
+        with open(os.path.join(src, name), encoding="utf-8", errors="replace") as header:
+            for line in header:
+                match = pattern.match(line)
+                if match:
+                    macros[match.group(1)] = int(match.group(2))
+    return macros
+
+
+def periodic(period_ms, start_ms=0):
+    return list(range(start_ms + period_ms, HOUR_MS, period_ms)) if period_ms > 0 else []
+
+
+def sample_events(m, irqs_per_sample, uplink_ms):
+    """One sample: I2C write complete, measurement delay, I2C read complete, then the upload traffic."""
+    events = []
+    for t in periodic(m["APP_SAMPLE_PERIOD_MS"]):
+        events += [t, t + 1, t + 1 + m["HS3001_MEASUREMENT_MS"], t + 2 + m["HS3001_MEASUREMENT_MS"]]
+        start = t + 3 + m["HS3001_MEASUREMENT_MS"]
+        events += [start + (i * uplink_ms) // max(irqs_per_sample, 1) for i in range(irqs_per_sample)]
+    return events
+
+
+def simulate(m, scenario, opts, legacy):
+    sources = {}
+    connected = scenario != "offline"
+
+    sources["sampler"] = sample_events(m, opts["post_irqs"] if connected else 0, 200)
+    sources["ip task"] = periodic(opts["ip_timer_ms"])
+    sources["task report"] = periodic(m.get("SYS_STATS_PERIOD_MS", 0))
+
+    if not connected:
+        sources["reconnect"] = []
+        for t in periodic(m["APP_UPLINK_RETRY_MS"]):
+            sources["reconnect"] += [t + (i * 3000) // opts["connect_irqs"] for i in range(opts["connect_irqs"])]
+        flush = m["SAMPLE_JOURNAL_FLUSH_MS"] if m.get("SAMPLE_JOURNAL_WRITE_BACK", 1) else m["APP_SAMPLE_PERIOD_MS"]
+        sources["journal flush"] = periodic(flush, m["APP_SAMPLE_PERIOD_MS"])
+        if not legacy:
+            sources["lfs maint"] = [t + opts["flush_ms"] + m["LITTLEFS_MAINT_DELAY_MS"]
+                                    for t in sources["journal flush"]]
+
+    if scenario == "debug":
+        sources["console"] = periodic(m["CONSOLE_POLL_MAX_MS"])
+
+    if legacy:
+        sources["main loop"] = periodic(LEGACY["service_ms"])
+        sources["lfs maint"] = periodic(LEGACY["maint_ms"])
+        if scenario != "debug":
+            sources["console"] = periodic(LEGACY["console_ms"])
+
+    merged = sorted(t for events in sources.values() for t in events if t < HOUR_MS)
+    wakeups = 0
+    last = -MIN_SLEEP_MS
+    for t in merged:
+        if (t - last) >= MIN_SLEEP_MS:
+            wakeups += 1
+        last = t
+    return wakeups, {name: len(events) for name, events in sources.items()}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--src", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src"))
+    parser.add_argument("--scenario", default="all", choices=("connected", "offline", "debug", "all"))
+    parser.add_argument("--legacy", action="store_true", help="model the fixed period loops before tickless idle")
+    for name, value in DEFAULTS.items():
+        parser.add_argument("--" + name.replace("_", "-"), type=int, default=value)
+    args = parser.parse_args()
+
+    macros = read_macros(args.src)
+    missing = [name for name in ("APP_SAMPLE_PERIOD_MS", "APP_UPLINK_RETRY_MS", "SAMPLE_JOURNAL_FLUSH_MS",
+                                 "LITTLEFS_MAINT_DELAY_MS", "CONSOLE_POLL_MAX_MS", "HS3001_MEASUREMENT_MS")
+               if name not in macros]
+    if missing:
+        sys.exit("missing macros in %s: %s" % (args.src, ", ".join(missing)))
+
+    opts = {name: getattr(args, name) for name in DEFAULTS}
+    scenarios = ("connected", "offline", "debug") if args.scenario == "all" else (args.scenario,)
+    for scenario in scenarios:
+        wakeups, sources = simulate(macros, scenario, opts, args.legacy)
+        label = scenario + ("-legacy" if args.legacy else "")
+        print("%s,%s,%d" % (TAG, label, wakeups))
+        for name, count in sources.items():
+            print("%s,%s,%s,%d" % (TAG, label, name, count))
+    print("%s,end" % TAG)
+
+
+if __name__ == "__main__":
+    main()